@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _LATENCY_HISTOGRAM_H_
+#define _LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace uprotocol::benchmark {
+
+	/**
+	* Log-linear histogram of latencies in nanoseconds, in the style of an HDR
+	* histogram: every power of two is split into SubBuckets linear buckets, so a
+	* recorded value is reported within 1 / SubBuckets (about 3%) of itself over
+	* the whole range. Recording is a single relaxed atomic increment and can run
+	* on any number of threads.
+	*/
+	class LatencyHistogram {
+
+		public:
+
+			static constexpr unsigned SubBucketBits = 5;
+			static constexpr uint64_t SubBuckets = 1U << SubBucketBits;
+			static constexpr size_t Buckets = (64 - SubBucketBits + 1) * SubBuckets;
+
+			void record(uint64_t nanoseconds) {
+				counts_[indexOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+			}
+
+			void add(const LatencyHistogram &other) {
+				for (size_t i = 0; i < Buckets; ++i) {
+					counts_[i].fetch_add(other.counts_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+				}
+			}
+
+			uint64_t count() const {
+				uint64_t total = 0;
+				for (const auto &count : counts_) {
+					total += count.load(std::memory_order_relaxed);
+				}
+				return total;
+			}
+
+			/**
+			* @param quantile between 0 and 1, e.g. 0.999
+			* @return the latency below which quantile of the recorded values fall, 0 if empty
+			*/
+			uint64_t percentile(double quantile) const {
+				const auto total = count();
+				if (0 == total) {
+					return 0;
+				}
+				auto rank = static_cast<uint64_t>(quantile * static_cast<double>(total) + 0.5);
+				rank = (0 == rank) ? 1 : ((rank > total) ? total : rank);
+
+				uint64_t seen = 0;
+				for (size_t i = 0; i < Buckets; ++i) {
+					seen += counts_[i].load(std::memory_order_relaxed);
+					if (seen >= rank) {
+						return highestOf(i);
+					}
+				}
+				return highestOf(Buckets - 1);
+			}
+
+			uint64_t max() const {
+				for (size_t i = Buckets; i-- > 0;) {
+					if (0 != counts_[i].load(std::memory_order_relaxed)) {
+						return highestOf(i);
+					}
+				}
+				return 0;
+			}
+
+		private:
+
+			static size_t indexOf(uint64_t value) {
+				if (value < SubBuckets) {
+					return static_cast<size_t>(value);
+				}
+				const auto exponent = 63U - static_cast<unsigned>(__builtin_clzll(value));
+				const auto shift = exponent - SubBucketBits;
+				return static_cast<size_t>((shift + 1) * SubBuckets + ((value >> shift) & (SubBuckets - 1)));
+			}
+
+			/* largest value that falls into bucket index */
+			static uint64_t highestOf(size_t index) {
+				if (index < SubBuckets) {
+					return index;
+				}
+				const auto shift = index / SubBuckets - 1;
+				const auto mantissa = (index % SubBuckets) | SubBuckets;
+				return ((mantissa + 1) << shift) - 1;
+			}
+
+			std::array<std::atomic<uint64_t>, Buckets> counts_ {};
+	};
+}
+
+#endif /* _LATENCY_HISTOGRAM_H_ */
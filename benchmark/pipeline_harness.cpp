@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/*
+ * End-to-end pipeline harness: N publisher threads build attributes with
+ * UAttributesBuilder, wrap them with a payload in a UMessage and send it over a
+ * LoopbackTransport to M subscribers. Every delivery records the latency from
+ * the publish time stamped into the payload. The harness reports throughput,
+ * latency percentiles and heap allocations per message, as text and as JSON.
+ *
+ *   up-cpp-pipeline --publishers=1,2,4,8 --subscribers=4 --payload=256 --rate=0
+ *                   --duration=2 --delivery=sync|pool --workers=4 --out=pipeline.json
+ *
+ * With a rate (messages per second and publisher) the latency is measured from
+ * the time a message was due, not from when it was sent, so a stalled pipeline
+ * shows up in the percentiles instead of slowing the publishers down.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <up-cpp/transport/LoopbackTransport.h>
+#include <up-cpp/transport/builder/UAttributesBuilder.h>
+#include <up-cpp/utils/ThreadPool.h>
+#include "LatencyHistogram.h"
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::utils;
+using namespace uprotocol::v1;
+using uprotocol::benchmark::LatencyHistogram;
+using Clock = std::chrono::steady_clock;
+
+/* heap allocations of the whole process, counted by the replaced global operator new */
+static std::atomic<uint64_t> allocations { 0 };
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc((0 == size) ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+struct Options {
+    std::vector<size_t> publishers { 1 };
+    size_t subscribers = 1;
+    size_t payload = 64;
+    /* messages per second and publisher, 0 for as fast as possible */
+    double rate = 0;
+    double duration = 1.0;
+    bool pooled = false;
+    size_t workers = 2;
+    std::string out;
+};
+
+struct Result {
+    size_t publishers = 0;
+    uint64_t sent = 0;
+    uint64_t failed = 0;
+    uint64_t delivered = 0;
+    double seconds = 0;
+    uint64_t allocations = 0;
+    std::unique_ptr<LatencyHistogram> latency = std::make_unique<LatencyHistogram>();
+};
+
+uint64_t nowNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+class LatencyListener : public UListener {
+    public:
+        LatencyListener() = default;
+
+        UStatus onReceive(UMessage &message) const override {
+            const auto received = nowNanoseconds();
+            uint64_t stamp = 0;
+            if (message.payload().size() >= sizeof(stamp)) {
+                std::memcpy(&stamp, message.payload().data(), sizeof(stamp));
+            }
+            histogram_->record((received > stamp) ? (received - stamp) : 0);
+            return UStatus();
+        }
+
+        const LatencyHistogram &histogram() const {
+            return *histogram_;
+        }
+
+    private:
+        /* one per subscriber, merged after the run */
+        std::unique_ptr<LatencyHistogram> histogram_ = std::make_unique<LatencyHistogram>();
+};
+
+UUri topicOf(size_t publisher) {
+    UUri uri;
+    uri.mutable_entity()->set_name("pipeline");
+    uri.mutable_entity()->set_id(static_cast<uint32_t>(0x100 + publisher));
+    uri.mutable_entity()->set_version_major(1);
+    uri.mutable_resource()->set_name("sample");
+    uri.mutable_resource()->set_id(1);
+    return uri;
+}
+
+void publish(UTransport &transport, size_t publisher, const Options &options, Clock::time_point end,
+             std::atomic<bool> &start, uint64_t &sent, uint64_t &failed) {
+    const auto source = topicOf(publisher);
+    std::vector<uint8_t> payload(std::max(options.payload, sizeof(uint64_t)), 0x5a);
+    const auto interval = (options.rate > 0)
+        ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / options.rate))
+        : std::chrono::nanoseconds(0);
+
+    while (false == start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    auto due = Clock::now();
+    while (true) {
+        uint64_t stamp;
+        if (interval.count() > 0) {
+            std::this_thread::sleep_until(due);
+            stamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                due.time_since_epoch()).count());
+            due += interval;
+        } else {
+            stamp = nowNanoseconds();
+        }
+        if (Clock::now() >= end) {
+            break;
+        }
+
+        std::memcpy(payload.data(), &stamp, sizeof(stamp));
+        UMessage message(UPayload(payload.data(), payload.size(), UPayloadType::VALUE),
+                         UAttributesBuilder::publish(source, UPriority::UPRIORITY_CS1).build());
+        if (UCode::OK == transport.send(message).code()) {
+            ++sent;
+        } else {
+            ++failed;
+        }
+    }
+}
+
+Result run(const Options &options, size_t publishers) {
+    std::unique_ptr<ThreadPool> pool;
+    std::unique_ptr<LoopbackTransport> transport;
+    if (options.pooled) {
+        pool = std::make_unique<ThreadPool>(64 * 1024, options.workers);
+        DispatchOptions dispatch;
+        dispatch.capacity = 64 * 1024;
+        dispatch.policy = OverflowPolicy::BLOCK;
+        transport = std::make_unique<LoopbackTransport>(*pool, dispatch);
+    } else {
+        transport = std::make_unique<LoopbackTransport>();
+    }
+
+    Result result;
+    result.publishers = publishers;
+
+    std::vector<std::unique_ptr<LatencyListener>> listeners;
+    for (size_t s = 0; s < options.subscribers; ++s) {
+        listeners.push_back(std::make_unique<LatencyListener>());
+        for (size_t p = 0; p < publishers; ++p) {
+            transport->registerListener(topicOf(p), *listeners.back());
+        }
+    }
+
+    std::vector<uint64_t> sent(publishers, 0);
+    std::vector<uint64_t> failed(publishers, 0);
+    std::atomic<bool> start { false };
+    const auto duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+
+    std::vector<std::thread> threads;
+    const auto begin = Clock::now();
+    const auto end = begin + duration;
+    const auto allocationsBefore = allocations.load();
+    for (size_t p = 0; p < publishers; ++p) {
+        threads.emplace_back(publish, std::ref(*transport), p, std::cref(options), end, std::ref(start),
+                             std::ref(sent[p]), std::ref(failed[p]));
+    }
+    start.store(true, std::memory_order_release);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    /* the transport delivers what is still queued before it goes */
+    transport.reset();
+    result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    result.allocations = allocations.load() - allocationsBefore;
+    pool.reset();
+
+    for (size_t p = 0; p < publishers; ++p) {
+        result.sent += sent[p];
+        result.failed += failed[p];
+    }
+    for (const auto &listener : listeners) {
+        result.latency->add(listener->histogram());
+    }
+    result.delivered = result.latency->count();
+
+    return result;
+}
+
+bool parse(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        const auto eq = arg.find('=');
+        const auto key = arg.substr(0, eq);
+        const auto value = (std::string::npos == eq) ? std::string() : arg.substr(eq + 1);
+        if ("--publishers" == key) {
+            options.publishers.clear();
+            std::stringstream list(value);
+            for (std::string item; std::getline(list, item, ',');) {
+                options.publishers.push_back(std::max<size_t>(1, std::stoul(item)));
+            }
+        } else if ("--subscribers" == key) {
+            options.subscribers = std::stoul(value);
+        } else if ("--payload" == key) {
+            options.payload = std::stoul(value);
+        } else if ("--rate" == key) {
+            options.rate = std::stod(value);
+        } else if ("--duration" == key) {
+            options.duration = std::stod(value);
+        } else if ("--delivery" == key) {
+            options.pooled = ("pool" == value);
+        } else if ("--workers" == key) {
+            options.workers = std::max<size_t>(1, std::stoul(value));
+        } else if ("--out" == key) {
+            options.out = value;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--publishers=1,2,4] [--subscribers=M] [--payload=BYTES] [--rate=PER_SECOND]\n"
+                         "          [--duration=SECONDS] [--delivery=sync|pool] [--workers=K] [--out=FILE.json]\n",
+                         argv[0]);
+            return false;
+        }
+    }
+    return !options.publishers.empty();
+}
+
+std::string toJson(const Options &options, const std::vector<Result> &results) {
+    std::ostringstream json;
+    json << "{\n  \"context\": {\"subscribers\": " << options.subscribers << ", \"payload\": " << options.payload
+         << ", \"rate\": " << options.rate << ", \"duration\": " << options.duration << ", \"delivery\": \""
+         << (options.pooled ? "pool" : "sync") << "\", \"workers\": " << options.workers
+         << ", \"hardware_concurrency\": " << std::thread::hardware_concurrency() << "},\n  \"runs\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto &r = results[i];
+        const auto messages = static_cast<double>(std::max<uint64_t>(1, r.sent));
+        json << ((0 == i) ? "\n" : ",\n") << "    {\"publishers\": " << r.publishers << ", \"sent\": " << r.sent
+             << ", \"failed\": " << r.failed << ", \"delivered\": " << r.delivered << ", \"seconds\": " << r.seconds
+             << ", \"messages_per_second\": " << static_cast<double>(r.sent) / r.seconds
+             << ", \"deliveries_per_second\": " << static_cast<double>(r.delivered) / r.seconds
+             << ", \"allocations_per_message\": " << static_cast<double>(r.allocations) / messages
+             << ", \"latency_ns\": {\"p50\": " << r.latency->percentile(0.5) << ", \"p99\": "
+             << r.latency->percentile(0.99) << ", \"p99.9\": " << r.latency->percentile(0.999) << ", \"max\": "
+             << r.latency->max() << "}}";
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (false == parse(argc, argv, options)) {
+        return 1;
+    }
+    /* a failed send must not turn into a log line per message */
+    spdlog::set_level(spdlog::level::off);
+
+    std::printf("%10s %12s %12s %14s %10s %10s %10s %10s %8s\n", "publishers", "msg/s", "deliveries/s",
+                "allocs/msg", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "failed");
+    std::vector<Result> results;
+    for (auto publishers : options.publishers) {
+        results.push_back(run(options, publishers));
+        const auto &r = results.back();
+        std::printf("%10zu %12.0f %12.0f %14.2f %10llu %10llu %10llu %10llu %8llu\n", r.publishers,
+                    static_cast<double>(r.sent) / r.seconds, static_cast<double>(r.delivered) / r.seconds,
+                    static_cast<double>(r.allocations) / static_cast<double>(std::max<uint64_t>(1, r.sent)),
+                    static_cast<unsigned long long>(r.latency->percentile(0.5)),
+                    static_cast<unsigned long long>(r.latency->percentile(0.99)),
+                    static_cast<unsigned long long>(r.latency->percentile(0.999)),
+                    static_cast<unsigned long long>(r.latency->max()),
+                    static_cast<unsigned long long>(r.failed));
+    }
+
+    const auto json = toJson(options, results);
+    if (options.out.empty()) {
+        std::fputs(json.c_str(), stdout);
+    } else {
+        std::ofstream(options.out) << json;
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <up-cpp/transport/datamodel/UMessage.h>
+#include <up-cpp/transport/datamodel/UPayload.h>
+
+using namespace uprotocol::utransport;
+
+static void UPayloadConstructValue(benchmark::State &state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    for (auto _ : state) {
+        UPayload payload(data.data(), data.size(), UPayloadType::VALUE);
+        benchmark::DoNotOptimize(payload.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(UPayloadConstructValue)->Arg(64)->Arg(64 * 1024);
+
+static void UPayloadCopy(benchmark::State &state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    const UPayload payload(data.data(), data.size(), UPayloadType::VALUE);
+    for (auto _ : state) {
+        UPayload copy(payload);
+        benchmark::DoNotOptimize(copy.data());
+    }
+}
+BENCHMARK(UPayloadCopy)->Arg(64)->Arg(64 * 1024);
+
+static void UPayloadMove(benchmark::State &state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5a);
+    UPayload payload(data.data(), data.size(), UPayloadType::VALUE);
+    for (auto _ : state) {
+        UPayload moved(std::move(payload));
+        payload = std::move(moved);
+        benchmark::DoNotOptimize(payload.data());
+    }
+}
+BENCHMARK(UPayloadMove)->Arg(64)->Arg(64 * 1024);
+
+static void UMessageCopy(benchmark::State &state) {
+    uprotocol::v1::UAttributes attributes;
+    attributes.mutable_source()->mutable_entity()->set_id(0x1102);
+    attributes.mutable_source()->mutable_resource()->set_id(0x8001);
+    attributes.set_ttl(1000);
+    std::vector<uint8_t> data(256, 0x5a);
+    const UMessage message(UPayload(data.data(), data.size(), UPayloadType::VALUE), attributes);
+    for (auto _ : state) {
+        UMessage copy(message);
+        benchmark::DoNotOptimize(copy.payload().data());
+    }
+}
+BENCHMARK(UMessageCopy);
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+
+using namespace uprotocol::uri;
+using namespace uprotocol::v1;
+
+static const std::string LongUri = "//vcu.vin/body.access/1/door.front_left#Door";
+
+static UUri microUri() {
+    UUri uri;
+    uri.mutable_authority()->set_ip(std::string("\xc0\xa8\x01\x64", 4));
+    uri.mutable_entity()->set_id(0x1102);
+    uri.mutable_entity()->set_version_major(1);
+    uri.mutable_resource()->set_id(0x8001);
+    return uri;
+}
+
+static void LongUriSerialize(benchmark::State &state) {
+    const auto uri = LongUriSerializer::deserialize(LongUri);
+    std::string out;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LongUriSerializer::serialize(uri, out));
+    }
+}
+BENCHMARK(LongUriSerialize);
+
+static void LongUriDeserialize(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LongUriSerializer::deserialize(LongUri));
+    }
+}
+BENCHMARK(LongUriDeserialize);
+
+static void MicroUriSerialize(benchmark::State &state) {
+    const auto uri = microUri();
+    uint8_t buffer[MicroUriSerializer::MaxMicroUriLength];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MicroUriSerializer::serialize(uri, buffer, sizeof(buffer)));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(MicroUriSerialize);
+
+static void MicroUriDeserialize(benchmark::State &state) {
+    const auto bytes = MicroUriSerializer::serialize(microUri());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MicroUriSerializer::deserialize(bytes.data(), bytes.size()));
+    }
+}
+BENCHMARK(MicroUriDeserialize);
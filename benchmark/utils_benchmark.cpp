@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <up-cpp/utils/CyclicQueue.h>
+#include <up-cpp/utils/LockFreeQueue.h>
+#include <up-cpp/utils/ThreadPool.h>
+#include <up-cpp/utils/base64.h>
+
+using namespace uprotocol::utils;
+
+/* a full pool logs every rejected task, keep logging out of the timings */
+static const bool loggingOff = []() {
+    spdlog::set_level(spdlog::level::off);
+    return true;
+}();
+
+static std::vector<uint8_t> bytes(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+    return data;
+}
+
+static void Base64Encode(benchmark::State &state) {
+    const auto data = bytes(static_cast<size_t>(state.range(0)));
+    std::vector<char> out(Base64::encodedLen(data.size()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Base64::encode(data.data(), data.size(), out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Base64Encode)->Arg(64)->Arg(4096);
+
+static void Base64Decode(benchmark::State &state) {
+    const auto data = bytes(static_cast<size_t>(state.range(0)));
+    std::vector<char> text(Base64::encodedLen(data.size()));
+    const auto length = Base64::encode(data.data(), data.size(), text.data());
+    std::vector<uint8_t> out(Base64::maxDecodedLen(length));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Base64::decode(text.data(), length, out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Base64Decode)->Arg(64)->Arg(4096);
+
+/* every thread pushes and pops, so the queue stays short and the threads contend on it */
+template<typename Queue>
+static void QueuePushPop(benchmark::State &state) {
+    static Queue *queue = nullptr;
+    if (0 == state.thread_index()) {
+        queue = new Queue(1024, std::chrono::milliseconds(1));
+    }
+    /* threads only start measuring together, after thread 0 set up the queue */
+    for (auto _ : state) {
+        int value = 1;
+        queue->push(value);
+        queue->waitPop(value);
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (0 == state.thread_index()) {
+        delete queue;
+        queue = nullptr;
+    }
+}
+BENCHMARK_TEMPLATE(QueuePushPop, CyclicQueue<int>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(QueuePushPop, MpmcQueue<int>)->ThreadRange(1, 8)->UseRealTime();
+
+static void ThreadPoolSubmit(benchmark::State &state) {
+    ThreadPool pool(1024, static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto future = pool.submit([]() { return 1; });
+        benchmark::DoNotOptimize(future.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ThreadPoolSubmit)->Arg(1)->Arg(4)->UseRealTime();
+
+static void ThreadPoolSubmitDetached(benchmark::State &state) {
+    ThreadPool pool(4096, static_cast<size_t>(state.range(0)));
+    std::atomic<size_t> done { 0 };
+    size_t posted = 0;
+    size_t rejected = 0;
+    for (auto _ : state) {
+        /* back off while the queue is full, so only tasks that ran are counted */
+        while (false == pool.submitDetached([&done]() { done.fetch_add(1, std::memory_order_relaxed); })) {
+            ++rejected;
+            std::this_thread::yield();
+        }
+        ++posted;
+    }
+    while (done.load() != posted) {
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(posted));
+    state.counters["rejected"] = static_cast<double>(rejected);
+}
+BENCHMARK(ThreadPoolSubmitDetached)->Arg(1)->Arg(4)->UseRealTime();
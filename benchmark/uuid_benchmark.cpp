@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+#include <up-cpp/uuid/factory/Uuidv8Factory.h>
+#include <up-cpp/uuid/serializer/UuidSerializer.h>
+
+using namespace uprotocol::uuid;
+
+static void Uuidv8Create(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Uuidv8Factory::create());
+    }
+}
+BENCHMARK(Uuidv8Create);
+BENCHMARK(Uuidv8Create)->Threads(4);
+
+static void Uuidv8CreateBatch(benchmark::State &state) {
+    std::vector<UUID> uuids(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        Uuidv8Factory::createBatch(uuids.data(), uuids.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Uuidv8CreateBatch)->Arg(64);
+
+static void UuidSerializeToString(benchmark::State &state) {
+    const auto uuid = Uuidv8Factory::create();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(UuidSerializer::serializeToString(uuid));
+    }
+}
+BENCHMARK(UuidSerializeToString);
+
+static void UuidSerializeToChars(benchmark::State &state) {
+    const auto uuid = Uuidv8Factory::create();
+    char out[UuidSerializer::StringLength];
+    for (auto _ : state) {
+        UuidSerializer::serializeToChars(uuid, out);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(UuidSerializeToChars);
+
+static void UuidDeserializeFromString(benchmark::State &state) {
+    const auto text = UuidSerializer::serializeToString(Uuidv8Factory::create());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(UuidSerializer::deserializeFromString(text));
+    }
+}
+BENCHMARK(UuidDeserializeFromString);
+
+static void UuidBytesRoundTrip(benchmark::State &state) {
+    const auto uuid = Uuidv8Factory::create();
+    for (auto _ : state) {
+        const auto bytes = UuidSerializer::serializeToArray(uuid);
+        benchmark::DoNotOptimize(UuidSerializer::deserializeFromBytes(bytes));
+    }
+}
+BENCHMARK(UuidBytesRoundTrip);
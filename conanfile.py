@@ -17,12 +17,15 @@ class UpCpp(ConanFile):
     conan_version = None
     generators = "CMakeDeps", "PkgConfigDeps", "VirtualRunEnv", "VirtualBuildEnv"
     version = "0.1.1-dev"
-    exports_sources = "CMakeLists.txt", "up-core-api/*", "include/*" ,"src/*" , "test/*", "cmake/*"
+    exports_sources = "CMakeLists.txt", "up-core-api/*", "include/*" ,"src/*" , "test/*", "benchmark/*", "cmake/*"
 
     options = {
         "shared": [True, False],
         "fPIC": [True, False],
         "build_testing": [True, False],
+        "build_benchmarks": [True, False],
+        "build_metrics": [True, False],
+        "log_level": [None, "trace", "debug", "info", "warn", "error", "critical", "off"],
         "build_unbundled": [True, False],
         "build_cross_compiling": [True, False],
     }
@@ -31,6 +34,9 @@ class UpCpp(ConanFile):
         "shared": False,
         "fPIC": False,
         "build_testing": False,
+        "build_benchmarks": False,
+        "build_metrics": True,
+        "log_level": None,
         "build_unbundled": False,
         "build_cross_compiling": False,
     }
@@ -40,10 +46,16 @@ class UpCpp(ConanFile):
         self.requires("spdlog/1.13.0")
         if self.options.build_testing:
             self.requires("gtest/1.14.0")
+        if self.options.build_benchmarks:
+            self.requires("benchmark/1.8.3")
 
     def generate(self):
         tc = CMakeToolchain(self)
         tc.variables["BUILD_TESTING"] = self.options.build_testing
+        tc.variables["BUILD_BENCHMARKS"] = self.options.build_benchmarks
+        tc.variables["BUILD_METRICS"] = self.options.build_metrics
+        if self.options.log_level:
+            tc.variables["LOG_LEVEL"] = str(self.options.log_level)
         tc.variables["BUILD_UNBUNDLED"] = self.options.build_unbundled
         tc.variables["BUILD_SHARED_LIBS"] = self.options.shared
         tc.generate()
@@ -59,3 +71,6 @@ class UpCpp(ConanFile):
 
     def package_info(self):
         self.cpp_info.libs = ["up-cpp"]
+        self.cpp_info.defines = ["UP_CPP_METRICS=" + ("1" if self.options.build_metrics else "0")]
+        if self.options.log_level:
+            self.cpp_info.defines.append("UP_CPP_LOG_LEVEL=SPDLOG_LEVEL_" + str(self.options.log_level).upper())
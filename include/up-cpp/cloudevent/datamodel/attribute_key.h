@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2023 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_CLOUDEVENT_ATTRIBUTE_KEY_H
+#define CPP_CLOUDEVENT_ATTRIBUTE_KEY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace cloudevents::format {
+/**
+ * Compile time ids of the uProtocol CloudEvent attribute keys.
+ * Keys are looked up with a perfect hash over their first character and
+ * length, confirmed by a single compare, no string is hashed or allocated.
+ */
+class AttributeKey {
+ public:
+  enum class AttributeKey_E : uint8_t {
+    TTL,
+    SINK,
+    DATA_SCHEMA,
+    DATA_CONTENT_TYPE,
+    REQ_ID,
+    DATA,
+    HASH,
+    PRIORITY,
+    NOT_DEFINED,
+  };
+
+  static constexpr size_t COUNT =
+      static_cast<size_t>(AttributeKey_E::NOT_DEFINED);
+
+  /* a set of keys, one bit per key */
+  using Mask = uint32_t;
+
+  [[nodiscard]] static constexpr std::string_view ToString(AttributeKey_E key) {
+    return (key < AttributeKey_E::NOT_DEFINED) ? KEYS[static_cast<size_t>(key)]
+                                               : std::string_view();
+  }
+
+  [[nodiscard]] static constexpr AttributeKey_E getAttributeKeyE(
+      std::string_view key) {
+    if (key.empty()) {
+      return AttributeKey_E::NOT_DEFINED;
+    }
+    auto candidate = SLOTS[slot(key)];
+    if ((candidate == AttributeKey_E::NOT_DEFINED) ||
+        (KEYS[static_cast<size_t>(candidate)] != key)) {
+      return AttributeKey_E::NOT_DEFINED;
+    }
+    return candidate;
+  }
+
+  [[nodiscard]] static constexpr Mask mask(AttributeKey_E key) {
+    return static_cast<Mask>(1U << static_cast<size_t>(key));
+  }
+
+ private:
+  static constexpr size_t SLOT_COUNT = 16;
+
+  static constexpr std::array<std::string_view, COUNT> KEYS = {
+      "ttl",  "sink", "dataschema", "datacontenttype",
+      "reqid", "data", "hash",       "priority"};
+
+  [[nodiscard]] static constexpr size_t slot(std::string_view key) {
+    return ((2U * static_cast<unsigned char>(key[0])) + key.size()) &
+           (SLOT_COUNT - 1U);
+  }
+
+  [[nodiscard]] static constexpr std::array<AttributeKey_E, SLOT_COUNT>
+  make_slots() {
+    std::array<AttributeKey_E, SLOT_COUNT> slots{};
+    for (auto& entry : slots) {
+      entry = AttributeKey_E::NOT_DEFINED;
+    }
+    for (size_t i = 0; i < COUNT; ++i) {
+      auto& entry = slots[slot(KEYS[i])];
+      if (entry != AttributeKey_E::NOT_DEFINED) {
+        // not a constant expression: keys must not share a slot
+        throw "attribute keys collide";
+      }
+      entry = static_cast<AttributeKey_E>(i);
+    }
+    return slots;
+  }
+
+  static const std::array<AttributeKey_E, SLOT_COUNT> SLOTS;
+};
+
+inline constexpr std::array<AttributeKey::AttributeKey_E,
+                            AttributeKey::SLOT_COUNT>
+    AttributeKey::SLOTS = AttributeKey::make_slots();
+
+}  // namespace cloudevents::format
+
+#endif  // CPP_CLOUDEVENT_ATTRIBUTE_KEY_H
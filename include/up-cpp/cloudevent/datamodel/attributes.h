@@ -26,6 +26,8 @@
 #define CPP_COULDEVENT_ATTRIBUTES_H_
 #include <iostream>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <utility>
 
 #include "priority.h"
@@ -43,11 +45,7 @@ class UAttributes {
     } else {
       this->hash = hash;
     }
-    if (priority == cloudevents::format::Priority::Priority_E::NOT_DEFINED) {
-      this->priority.clear();
-    } else {
-      this->priority = Priority::ToString(priority);
-    }
+    this->priority = priority;
     if (ttl <= -1) {
       this->ttl = -1;
     } else {
@@ -55,15 +53,13 @@ class UAttributes {
     }
   }
 
-  UAttributes() {
-    this->hash.clear();
-    this->priority.clear();
-  }
+  UAttributes() { this->hash.clear(); }
 
   static UAttributes empty() { return {}; }
 
   [[nodiscard]] bool isEmpty() const {
-    if (hash.empty() && priority.empty() && ttl == -1) {
+    if (hash.empty() && (priority == Priority::Priority_E::NOT_DEFINED) &&
+        ttl == -1) {
       return true;
     }
     return false;
@@ -74,13 +70,24 @@ class UAttributes {
   }
 
   std::optional<std::string> get_priority_string() {
-    return priority.empty() ? std::nullopt : std::make_optional(priority);
+    auto name = get_priority_view();
+    return name.has_value() ? std::make_optional(std::string(*name))
+                            : std::nullopt;
+  }
+
+  /**
+   * @return priority name, not allocated
+   */
+  [[nodiscard]] std::optional<std::string_view> get_priority_view() const {
+    return (priority == Priority::Priority_E::NOT_DEFINED)
+               ? std::nullopt
+               : std::make_optional(Priority::ToString(priority));
   }
 
   std::optional<Priority::Priority_E> get_priority() {
-    return priority.empty()
+    return (priority == Priority::Priority_E::NOT_DEFINED)
                ? std::nullopt
-               : std::make_optional(Priority::getPriorityType(priority));
+               : std::make_optional(priority);
   }
 
   std::optional<uint32_t> get_ttl() {
@@ -94,7 +101,7 @@ class UAttributes {
 
   UAttributes* WithPriority(
       cloudevents::format::Priority::Priority_E m_priority) {
-    this->priority = Priority::ToString(m_priority);
+    this->priority = m_priority;
     return this;
   }
 
@@ -105,7 +112,8 @@ class UAttributes {
 
  private:
   std::string hash;
-  std::string priority;
+  // stored as the enum, converted to its name only when asked for
+  Priority::Priority_E priority = Priority::Priority_E::NOT_DEFINED;
   int32_t ttl = -1;
 };
 
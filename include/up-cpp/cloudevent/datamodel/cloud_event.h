@@ -31,6 +31,7 @@
 #include <memory>
 #include <optional>
 
+#include "attribute_key.h"
 #include "format.h"
 //#include <unordered_map>
 #include <cxxabi.h>
@@ -75,25 +76,23 @@ class Serializer {
       return false;
     }
 
-    if (unlikely(!is_type_ok(cloudEvent))) {
+    auto service_type = ServiceType::getEnumType(cloudEvent.type());
+    if (unlikely(service_type == ServiceType::MessageType_E::NOT_DEFINED)) {
+      spdlog::info("Service type not supported {0}\n", cloudEvent.type().c_str());
       return false;
     }
+
     if (unlikely(!is_spec_version_ok(cloudEvent))) {
       return false;
     }
 
-    auto e1 = mandatory_pram_validator_m[cloudEvent.type()];
-    for (auto entry : e1) {
-      if (!exists_attr(cloudEvent, entry)) {
-        return false;
-      }
-    }
-    return true;
+    return has_required_attributes(cloudEvent, service_type);
   }
   enum class Serializer_type_E {
     BINARY,
     TEXT,
     PROTOBUF,
+    RAW,
   };
 
   virtual ~Serializer() = default;
@@ -124,11 +123,6 @@ class Serializer {
       "application/cloudevents+json";
 
  private:
-  struct attr_entry {
-    std::string name;
-    io::cloudevents::v1::CloudEvent_CloudEventAttributeValue::AttrCase type;
-  };
-
   [[nodiscard]] static inline bool is_empty(
       const io::cloudevents::v1::CloudEvent& cloudEvent) {
     if (unlikely(cloudEvent.id().empty() || cloudEvent.source().empty() ||
@@ -140,17 +134,6 @@ class Serializer {
     return true;
   }
 
-  [[nodiscard]] static inline bool is_type_ok(
-      const io::cloudevents::v1::CloudEvent& cloudEvent) {
-    auto& type = cloudEvent.type();
-    auto service_type = ServiceType::getEnumType(type);
-    if (unlikely(service_type == ServiceType::MessageType_E::NOT_DEFINED)) {
-      spdlog::info("Service type not supported {0}\n", type.c_str());
-      return false;
-    }
-    return true;
-  }
-
   [[nodiscard]] static inline bool is_spec_version_ok(
       const io::cloudevents::v1::CloudEvent& cloudEvent) {
     auto& specVersion = cloudEvent.spec_version();
@@ -162,50 +145,98 @@ class Serializer {
     return true;
   }
 
-  [[nodiscard]] static inline bool exists_attr(
-      const io::cloudevents::v1::CloudEvent& cloudEvent, attr_entry& entry) {
-    auto res = (cloudEvent.attributes()).find(entry.name);
-    if (res == (cloudEvent.attributes()).end()) {
-      spdlog::info(
-          "Required attribute {0} of type {1} for "
-          "message {2} is missing\n",
-          entry.name.c_str(), attr_case_string(entry.type).c_str(),
-          cloudEvent.type().c_str());
-      return false;
+  /* attribute that a message type requires, with the value type it must have */
+  struct required_attr {
+    AttributeKey::AttributeKey_E key;
+    CloudEvent_CloudEventAttributeValue::AttrCase type;
+  };
+
+  struct required_attrs {
+    AttributeKey::Mask mask;
+    size_t count;
+    required_attr attrs[AttributeKey::COUNT];
+  };
+
+  /* required attributes, indexed by ServiceType::MessageType_E */
+  static constexpr required_attrs REQUIRED_ATTRS[] = {
+      /* PUBLISH */ {0, 0, {}},
+      /* FILE */ {0, 0, {}},
+      /* REQUEST */
+      {AttributeKey::mask(AttributeKey::AttributeKey_E::TTL) |
+           AttributeKey::mask(AttributeKey::AttributeKey_E::SINK),
+       2,
+       {{AttributeKey::AttributeKey_E::TTL,
+         CloudEvent_CloudEventAttributeValue::AttrCase::kCeInteger},
+        {AttributeKey::AttributeKey_E::SINK,
+         CloudEvent_CloudEventAttributeValue::AttrCase::kCeString}}},
+      /* RESPONSE */
+      {AttributeKey::mask(AttributeKey::AttributeKey_E::TTL) |
+           AttributeKey::mask(AttributeKey::AttributeKey_E::SINK) |
+           AttributeKey::mask(AttributeKey::AttributeKey_E::DATA) |
+           AttributeKey::mask(AttributeKey::AttributeKey_E::REQ_ID) |
+           AttributeKey::mask(AttributeKey::AttributeKey_E::DATA_SCHEMA),
+       5,
+       {{AttributeKey::AttributeKey_E::TTL,
+         CloudEvent_CloudEventAttributeValue::AttrCase::kCeInteger},
+        {AttributeKey::AttributeKey_E::SINK,
+         CloudEvent_CloudEventAttributeValue::AttrCase::kCeString},
+        {AttributeKey::AttributeKey_E::DATA,
+         CloudEvent_CloudEventAttributeValue::AttrCase::kCeString},
+        {AttributeKey::AttributeKey_E::REQ_ID,
+         CloudEvent_CloudEventAttributeValue::AttrCase::kCeString},
+        {AttributeKey::AttributeKey_E::DATA_SCHEMA,
+         CloudEvent_CloudEventAttributeValue::AttrCase::kCeString}}}};
+
+  /**
+   * Check all attributes required by the message type in a single sweep of
+   * the attributes map
+   */
+  [[nodiscard]] static inline bool has_required_attributes(
+      const io::cloudevents::v1::CloudEvent& cloudEvent,
+      ServiceType::MessageType_E service_type) {
+    const auto& required = REQUIRED_ATTRS[static_cast<size_t>(service_type)];
+    if (0 == required.mask) {
+      return true;
     }
-    if (res->second.attr_case() != entry.type) {
-      spdlog::info(
-          "Required attribute {0} of type {1} for "
-          "message "
-          "{2}, type is set to {3}\n",
-          entry.name.c_str(), attr_case_string(entry.type).c_str(),
-          cloudEvent.type().c_str(),
-          attr_case_string(res->second.attr_case()).c_str());
-      return false;
+
+    AttributeKey::Mask found = 0;
+    for (const auto& [name, value] : cloudEvent.attributes()) {
+      auto key = AttributeKey::getAttributeKeyE(name);
+      if ((key == AttributeKey::AttributeKey_E::NOT_DEFINED) ||
+          (0 == (required.mask & AttributeKey::mask(key)))) {
+        continue;
+      }
+      for (size_t i = 0; i < required.count; ++i) {
+        if ((required.attrs[i].key == key) &&
+            (value.attr_case() != required.attrs[i].type)) {
+          spdlog::info(
+              "Required attribute {0} of type {1} for "
+              "message "
+              "{2}, type is set to {3}\n",
+              name.c_str(), attr_case_string(required.attrs[i].type).c_str(),
+              cloudEvent.type().c_str(),
+              attr_case_string(value.attr_case()).c_str());
+          return false;
+        }
+      }
+      found |= AttributeKey::mask(key);
     }
-    return true;
-  }
 
-  std::unordered_map<std::string, std::vector<attr_entry>>
-      mandatory_pram_validator_m{
-          {ServiceType::PUBLISH_MSG_TYPE_V1, {}},
-          {ServiceType::FILE_MSG_TYPE_V1, {}},
-          {ServiceType::REQUEST_MSG_TYPE_V1,
-           {{Serializer::TTL_KEY,
-             CloudEvent_CloudEventAttributeValue::AttrCase::kCeInteger},
-            {Serializer::SINK_KEY,
-             CloudEvent_CloudEventAttributeValue::AttrCase::kCeString}}},
-          {ServiceType::RESPONSE_MSG_TYPE_V1,
-           {{Serializer::TTL_KEY,
-             CloudEvent_CloudEventAttributeValue::AttrCase::kCeInteger},
-            {Serializer::SINK_KEY,
-             CloudEvent_CloudEventAttributeValue::AttrCase::kCeString},
-            {Serializer::DATA_KEY,
-             CloudEvent_CloudEventAttributeValue::AttrCase::kCeString},
-            {Serializer::REQ_ID_KEY,
-             CloudEvent_CloudEventAttributeValue::AttrCase::kCeString},
-            {Serializer::DATA_SCHEMA_KEY,
-             CloudEvent_CloudEventAttributeValue::AttrCase::kCeString}}}};
+    if (likely(found == required.mask)) {
+      return true;
+    }
+    for (size_t i = 0; i < required.count; ++i) {
+      if (0 == (found & AttributeKey::mask(required.attrs[i].key))) {
+        spdlog::info(
+            "Required attribute {0} of type {1} for "
+            "message {2} is missing\n",
+            AttributeKey::ToString(required.attrs[i].key).data(),
+            attr_case_string(required.attrs[i].type).c_str(),
+            cloudEvent.type().c_str());
+      }
+    }
+    return false;
+  }
 
   [[nodiscard]] static std::string attr_case_string(
       const CloudEvent_CloudEventAttributeValue::AttrCase type) {
@@ -38,16 +38,19 @@ enum class DATA_TYPE_E {
   JSON,      // json may be clear text and may have different types like all
              // lower case
   PROTOBUF,  // proto.any we will not use it
+  RAW,       // byte array, not base 64 encoded, for 8-bit clean transports
 };
 
 /**
  * general purpose structure that hold ready to send data type
- * binary data will pass base 64 encoding and decoding to allow string
+ * binary data will pass base 64 encoding and decoding to allow string,
+ * RAW data holds the protobuf bytes as they are (may contain /0)
  */
 struct formatted_event {
   DATA_TYPE_E type;  //
   std::string
-      serialized_data;  // pay attention that BINARY type will need base 64
+      serialized_data;  // pay attention that BINARY type will need base 64,
+                        // RAW is not encoded
 };
 
 }  // namespace cloudevents::format
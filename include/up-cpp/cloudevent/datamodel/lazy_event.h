@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2023 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2023 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CPP_CLOUDEVENT_LAZY_EVENT_H
+#define CPP_CLOUDEVENT_LAZY_EVENT_H
+
+#include <cloudevents.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <google/protobuf/any.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "spdlog/spdlog.h"
+
+namespace cloudevents::format {
+/**
+ * View of a serialized CloudEvent that parses everything but the packed
+ * proto data (the Any payload). Routing code reads the attributes and the
+ * type URL of the payload without touching it; the payload is only parsed
+ * when it is unpacked, or handed over as bytes without being parsed at all.
+ *
+ * The view refers to the serialized bytes, which must outlive it.
+ */
+class LazyCloudEvent {
+ public:
+  /**
+   * Parse the envelope of a serialized event
+   * @return false if the bytes are not a valid CloudEvent encoding
+   */
+  [[nodiscard]] bool parse(const uint8_t* data, size_t size) {
+    using google::protobuf::internal::WireFormatLite;
+
+    reset(data, size);
+
+    // locate the proto data field, the rest is parsed around it
+    google::protobuf::io::CodedInputStream in(data, static_cast<int>(size));
+    int begin = -1;
+    int end = -1;
+    size_t occurrences = 0;
+    bool protoDataLast = false;
+    while (true) {
+      const auto position = in.CurrentPosition();
+      const auto tag = in.ReadTag();
+      if (0 == tag) {
+        break;
+      }
+      const auto field = WireFormatLite::GetTagFieldNumber(tag);
+      if ((io::cloudevents::v1::CloudEvent::kProtoDataFieldNumber == field) &&
+          (WireFormatLite::WIRETYPE_LENGTH_DELIMITED ==
+           WireFormatLite::GetTagWireType(tag))) {
+        uint32_t length = 0;
+        if (!in.ReadVarint32(&length)) {
+          return false;
+        }
+        const auto value = in.CurrentPosition();
+        if (!in.Skip(static_cast<int>(length))) {
+          return false;
+        }
+        begin = position;
+        end = in.CurrentPosition();
+        payload_ = std::string_view(reinterpret_cast<const char*>(data) + value,
+                                    length);
+        ++occurrences;
+        protoDataLast = true;
+      } else if ((io::cloudevents::v1::CloudEvent::kBinaryDataFieldNumber == field) ||
+                 (io::cloudevents::v1::CloudEvent::kTextDataFieldNumber == field)) {
+        // the last member of the data oneof wins
+        protoDataLast = false;
+        if (!WireFormatLite::SkipField(&in, tag)) {
+          return false;
+        }
+      } else if (!WireFormatLite::SkipField(&in, tag)) {
+        return false;
+      }
+    }
+    if (!in.ConsumedEntireMessage() ||
+        (static_cast<size_t>(in.CurrentPosition()) != size)) {
+      return false;
+    }
+
+    if (occurrences > 1) {
+      // repeated occurrences are merged by protobuf, leave that to a full parse
+      if (!envelope_.ParseFromArray(data, static_cast<int>(size))) {
+        return false;
+      }
+      payload_ = std::string_view();
+      any_ = std::make_unique<google::protobuf::Any>(envelope_.proto_data());
+      envelope_.clear_proto_data();
+      typeUrl_ = any_->type_url();
+      value_ = any_->value();
+      hasProtoData_ = true;
+      return true;
+    }
+
+    if (begin < 0) {
+      return envelope_.ParseFromArray(data, static_cast<int>(size));
+    }
+
+    google::protobuf::io::CodedInputStream suffix(data + end,
+                                                  static_cast<int>(size) - end);
+    if (!envelope_.ParseFromArray(data, begin) ||
+        !envelope_.MergeFromCodedStream(&suffix)) {
+      return false;
+    }
+    if (!protoDataLast) {
+      // replaced by a later binary or text data field
+      return true;
+    }
+    // drop binary or text data that came before the proto data
+    envelope_.clear_data();
+    hasProtoData_ = true;
+
+    return locateAnyFields();
+  }
+
+  /**
+   * @return the event without its proto data: id, source, type, attributes
+   * and binary or text data
+   */
+  [[nodiscard]] const io::cloudevents::v1::CloudEvent& envelope() const { return envelope_; }
+
+  [[nodiscard]] bool has_proto_data() const { return hasProtoData_; }
+
+  /**
+   * @return type URL of the packed payload, empty without proto data
+   */
+  [[nodiscard]] std::string_view type_url() const { return typeUrl_; }
+
+  /**
+   * @return serialized payload message, not parsed nor copied
+   */
+  [[nodiscard]] std::string_view payload_bytes() const { return value_; }
+
+  /**
+   * @return the serialized event, e.g. to forward it untouched
+   */
+  [[nodiscard]] std::string_view raw() const { return raw_; }
+
+  /**
+   * Parse the payload into msg if it is of the packed type
+   * @return false without proto data, on a type mismatch or parse failure
+   */
+  template <typename T>
+  [[nodiscard]] bool unpack(T& msg) const {
+    if (!hasProtoData_ || !is_type(T::descriptor()->full_name())) {
+      return false;
+    }
+    return msg.ParseFromArray(value_.data(), static_cast<int>(value_.size()));
+  }
+
+  /**
+   * @return the packed payload, materialized on first access
+   */
+  [[nodiscard]] const google::protobuf::Any& proto_data() const {
+    if (nullptr == any_) {
+      any_ = std::make_unique<google::protobuf::Any>();
+      if (hasProtoData_) {
+        any_->set_type_url(typeUrl_.data(), typeUrl_.size());
+        any_->set_value(value_.data(), value_.size());
+      }
+    }
+    return *any_;
+  }
+
+ private:
+  void reset(const uint8_t* data, size_t size) {
+    envelope_.Clear();
+    any_.reset();
+    raw_ = std::string_view(reinterpret_cast<const char*>(data), size);
+    payload_ = typeUrl_ = value_ = std::string_view();
+    hasProtoData_ = false;
+  }
+
+  /* find type_url and value inside the serialized Any without copying them */
+  [[nodiscard]] bool locateAnyFields() {
+    using google::protobuf::internal::WireFormatLite;
+
+    google::protobuf::io::CodedInputStream in(
+        reinterpret_cast<const uint8_t*>(payload_.data()),
+        static_cast<int>(payload_.size()));
+    while (true) {
+      const auto tag = in.ReadTag();
+      if (0 == tag) {
+        break;
+      }
+      const auto field = WireFormatLite::GetTagFieldNumber(tag);
+      const bool delimited = (WireFormatLite::WIRETYPE_LENGTH_DELIMITED ==
+                              WireFormatLite::GetTagWireType(tag));
+      if (delimited && ((google::protobuf::Any::kTypeUrlFieldNumber == field) ||
+                        (google::protobuf::Any::kValueFieldNumber == field))) {
+        uint32_t length = 0;
+        if (!in.ReadVarint32(&length)) {
+          return false;
+        }
+        const auto position = in.CurrentPosition();
+        if (!in.Skip(static_cast<int>(length))) {
+          return false;
+        }
+        // the last occurrence wins
+        auto view = payload_.substr(static_cast<size_t>(position), length);
+        if (google::protobuf::Any::kTypeUrlFieldNumber == field) {
+          typeUrl_ = view;
+        } else {
+          value_ = view;
+        }
+      } else if (!WireFormatLite::SkipField(&in, tag)) {
+        return false;
+      }
+    }
+    return in.ConsumedEntireMessage();
+  }
+
+  [[nodiscard]] bool is_type(std::string_view full_name) const {
+    // type.googleapis.com/full.name, the prefix is not checked (same as Any::Is)
+    return (typeUrl_.size() > full_name.size()) &&
+           ('/' == typeUrl_[typeUrl_.size() - full_name.size() - 1]) &&
+           (typeUrl_.substr(typeUrl_.size() - full_name.size()) == full_name);
+  }
+
+  io::cloudevents::v1::CloudEvent envelope_;
+  std::string_view raw_;
+  /* the serialized Any */
+  std::string_view payload_;
+  std::string_view typeUrl_;
+  std::string_view value_;
+  bool hasProtoData_ = false;
+  mutable std::unique_ptr<google::protobuf::Any> any_;
+};
+
+}  // namespace cloudevents::format
+
+#endif  // CPP_CLOUDEVENT_LAZY_EVENT_H
@@ -33,7 +33,10 @@
 // interactive High priority (rpc events) CS5  Signaling Important CS6  Network
 // control Safety Critical
 
+#include <cstddef>
 #include <iostream>
+#include <string>
+#include <string_view>
 
 #include "spdlog/spdlog.h"
 
@@ -60,48 +63,31 @@ class Priority {
   inline static const std::string PRIORITY_CS5 = "CS5";
   inline static const std::string PRIORITY_CS6 = "CS6";
 
-  [[nodiscard]] static std::string ToString(Priority_E type) {
-    switch (type) {
-      case Priority_E::LOW_PRIORITY:
-        return PRIORITY_CS0;
-      case Priority_E::STANDARD_PRIORITY:
-        return PRIORITY_CS1;
-      case Priority_E::OPERATIONS_PRIORITY:
-        return PRIORITY_CS2;
-      case Priority_E::MULTIMEDIA_PRIORITY:
-        return PRIORITY_CS3;
-      case Priority_E::REAL_TIME_PRIORITY:
-        return PRIORITY_CS4;
-      case Priority_E::SIGNALING_PRIORITY:
-        return PRIORITY_CS5;
-      case Priority_E::NETWORK_PRIORITY:
-        return PRIORITY_CS6;
-      default:
-        spdlog::warn("Type of message enum not defined");
-        return "";
+  [[nodiscard]] static constexpr std::string_view ToString(Priority_E type) {
+    if (type < Priority_E::NOT_DEFINED) {
+      return NAMES[static_cast<size_t>(type)];
     }
+    spdlog::warn("Type of message enum not defined");
+    return "";
   }
 
-  [[nodiscard]] static Priority_E getPriorityType(
+  [[nodiscard]] static constexpr Priority_E getPriorityType(
       const std::string_view& priority) {
-    if (priority == PRIORITY_CS0) {
-      return Priority_E::LOW_PRIORITY;
-    } else if (priority == PRIORITY_CS1) {
-      return Priority_E::STANDARD_PRIORITY;
-    } else if (priority == PRIORITY_CS2) {
-      return Priority_E::OPERATIONS_PRIORITY;
-    } else if (priority == PRIORITY_CS3) {
-      return Priority_E::MULTIMEDIA_PRIORITY;
-    } else if (priority == PRIORITY_CS4) {
-      return Priority_E::REAL_TIME_PRIORITY;
-    } else if (priority == PRIORITY_CS5) {
-      return Priority_E::SIGNALING_PRIORITY;
-    } else if (priority == PRIORITY_CS6) {
-      return Priority_E::NETWORK_PRIORITY;
+    // "CS0" .. "CS6", the class selector is the enum value
+    if ((priority.size() == 3) && (priority[0] == 'C') &&
+        (priority[1] == 'S') && (priority[2] >= '0') &&
+        (priority[2] < static_cast<char>('0' + COUNT))) {
+      return static_cast<Priority_E>(priority[2] - '0');
     }
     spdlog::warn("Priority not defined\n");
     return Priority_E::NOT_DEFINED;
   }
+
+ private:
+  static constexpr size_t COUNT = static_cast<size_t>(Priority_E::NOT_DEFINED);
+
+  static constexpr std::string_view NAMES[COUNT] = {"CS0", "CS1", "CS2", "CS3",
+                                                    "CS4", "CS5", "CS6"};
 };
 }  // namespace cloudevents::format
 #endif  // CPP_COULDEVENT_PRIORITY_H
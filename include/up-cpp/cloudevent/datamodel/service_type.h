@@ -26,8 +26,10 @@
 #ifndef CPP_CLOUDEVENT_SERVICE_TYPE_H
 #define CPP_CLOUDEVENT_SERVICE_TYPE_H
 
+#include <cstddef>
 #include <iostream>
 #include <string>
+#include <string_view>
 
 #include "spdlog/spdlog.h"
 
@@ -47,36 +49,46 @@ class ServiceType {
   inline static const std::string REQUEST_MSG_TYPE_V1 = "req.v1";
   inline static const std::string RESPONSE_MSG_TYPE_V1 = "res.v1";
 
-  [[nodiscard]] static std::string ToString(MessageType_E type) {
-    switch (type) {
-      case MessageType_E::PUBLISH:
-        return PUBLISH_MSG_TYPE_V1;
-      case MessageType_E::FILE:
-        return FILE_MSG_TYPE_V1;
-      case MessageType_E::REQUEST:
-        return REQUEST_MSG_TYPE_V1;
-      case MessageType_E::RESPONSE:
-        return RESPONSE_MSG_TYPE_V1;
-      default:
-        spdlog::info("type of message enum not defined");
-        return "";
+  [[nodiscard]] static constexpr std::string_view ToString(
+      MessageType_E type) {
+    if (type < MessageType_E::NOT_DEFINED) {
+      return NAMES[static_cast<size_t>(type)];
     }
+    spdlog::info("type of message enum not defined");
+    return "";
   }
 
-  [[nodiscard]] static MessageType_E getEnumType(
+  [[nodiscard]] static constexpr MessageType_E getEnumType(
       const std::string_view& msg_type) {
-    if (msg_type == PUBLISH_MSG_TYPE_V1) {
-      return MessageType_E::PUBLISH;
-    } else if (msg_type == FILE_MSG_TYPE_V1) {
-      return MessageType_E::FILE;
-    } else if (msg_type == REQUEST_MSG_TYPE_V1) {
-      return MessageType_E::REQUEST;
-    } else if (msg_type == RESPONSE_MSG_TYPE_V1) {
-      return MessageType_E::RESPONSE;
+    // the first characters tell the types apart, one compare confirms
+    auto type = MessageType_E::NOT_DEFINED;
+    if (msg_type.size() > 2) {
+      switch (msg_type[0]) {
+        case 'p':
+          type = MessageType_E::PUBLISH;
+          break;
+        case 'f':
+          type = MessageType_E::FILE;
+          break;
+        case 'r':
+          type = (msg_type[2] == 'q') ? MessageType_E::REQUEST
+                                      : MessageType_E::RESPONSE;
+          break;
+        default:
+          break;
+      }
+    }
+    if ((type != MessageType_E::NOT_DEFINED) &&
+        (NAMES[static_cast<size_t>(type)] == msg_type)) {
+      return type;
     }
     spdlog::info("message type not defined\n");
     return MessageType_E::NOT_DEFINED;
   }
+
+ private:
+  static constexpr std::string_view NAMES[] = {"pub.v1", "file.v1", "req.v1",
+                                               "res.v1"};
 };
 }  // namespace cloudevents::format
 
@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 
 #include "spdlog/spdlog.h"
 
@@ -41,23 +42,26 @@ class SpecVersion {
 
   inline static const std::string VERSION_SPEC_V1 = "v1";
 
-  [[nodiscard]] static std::string ToString(SpecVersion_E specVersionE) {
+  [[nodiscard]] static constexpr std::string_view ToString(
+      SpecVersion_E specVersionE) {
     if (specVersionE == SpecVersion_E::V1) {
-      return VERSION_SPEC_V1;
-    } else {
-      spdlog::info("type of message enum not defined");
-      return "";
+      return V1_NAME;
     }
+    spdlog::info("type of message enum not defined");
+    return "";
   }
 
-  [[nodiscard]] static SpecVersion_E getSpecVersionE(
+  [[nodiscard]] static constexpr SpecVersion_E getSpecVersionE(
       const std::string_view& version_spec) {
-    if (version_spec == VERSION_SPEC_V1) {
+    if (version_spec == V1_NAME) {
       return SpecVersion_E::V1;
     }
     spdlog::info("Version Spec is not defined\n");
     return SpecVersion_E::NOT_DEFINED;
   }
+
+ private:
+  static constexpr std::string_view V1_NAME = "v1";
 };
 }  // namespace cloudevents::format
 
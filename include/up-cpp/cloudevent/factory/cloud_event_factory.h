@@ -34,19 +34,20 @@
 #define CE io::cloudevents::v1::CloudEvent
 #define PMAP google::protobuf::Map
 #include <google/protobuf/any.pb.h>
+#include <google/protobuf/arena.h>
 #include <sys/time.h>
 
-#include "attributes.h"
-#include "cloud_event.h"
+#include <up-cpp/cloudevent/datamodel/attributes.h>
+#include <up-cpp/cloudevent/datamodel/cloud_event.h>
 #include "cloudevents.pb.h"
 #include "google/protobuf/util/time_util.h"
-#include "priority.h"
-#include "service_type.h"
+#include <up-cpp/cloudevent/datamodel/priority.h>
+#include <up-cpp/cloudevent/datamodel/service_type.h>
 #include "spdlog/spdlog.h"
-#include "spec_version.h"
-#include "UriValidator.h"
+#include <up-cpp/cloudevent/datamodel/spec_version.h>
+#include <up-cpp/uri/validator/UriValidator.h>
 
-#include "uprotocol/uuid.pb.h"
+#include <up-core-api/uuid.pb.h>
 #include <up-cpp/uuid/serializer/UuidSerializer.h>
 #include <up-cpp/uuid/factory/Uuidv8Factory.h>
 
@@ -82,10 +83,7 @@ struct factory {
   [[nodiscard]] static inline bool publish_factory(
       google::protobuf::Message& msg, const std::string& rpcUri,
       UAttributes& attributes, CE& ce) {
-    auto any = new google::protobuf::Any();
-    any->PackFrom(msg);
-
-    auto ok = createBaseCE(ServiceType::MessageType_E::PUBLISH, rpcUri, any,
+    auto ok = createBaseCE(ServiceType::MessageType_E::PUBLISH, rpcUri, msg,
                            attributes, ce);
 
     if (unlikely(!ok)) {
@@ -98,9 +96,7 @@ struct factory {
 
     // all opticeonal
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     }
 
     return ok;
@@ -130,9 +126,7 @@ struct factory {
 
     // all opticeonal
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     }
 
     return ok;
@@ -160,9 +154,7 @@ struct factory {
       return false;
     }
 
-    auto any = new google::protobuf::Any();
-    any->PackFrom(msg);
-    auto ok = createBaseCE(ServiceType::MessageType_E::PUBLISH, rpcUri, any,
+    auto ok = createBaseCE(ServiceType::MessageType_E::PUBLISH, rpcUri, msg,
                            attributes, ce);
 
     if (unlikely(!ok)) {
@@ -174,10 +166,7 @@ struct factory {
     }
 
     if (valid_uri(sinkUri)) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      std::string str = std::string(sinkUri);
-      attr->set_ce_string(str);
-      (*(ce).mutable_attributes())[Serializer::SINK_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::SINK_KEY].set_ce_string(sinkUri);
     } else {
       spdlog::error("Sink URI is not a Valid URI, {}, in {}\n",
                     sinkUri.empty() ? "EMPTY" : sinkUri.c_str(), __func__);
@@ -186,9 +175,7 @@ struct factory {
 
     // all optional
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     }
 
     return ok;
@@ -229,10 +216,7 @@ struct factory {
     }
 
     if (valid_uri(sinkUri)) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      std::string str = std::string(sinkUri);
-      attr->set_ce_string(str);
-      (*(ce).mutable_attributes())[Serializer::SINK_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::SINK_KEY].set_ce_string(sinkUri);
     } else {
       spdlog::error("Sink URI is not a Valid URI, {}, in {}\n",
                     sinkUri.empty() ? "EMPTY" : sinkUri.c_str(), __func__);
@@ -241,9 +225,7 @@ struct factory {
 
     // all optional
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     }
 
     return ok;
@@ -263,10 +245,7 @@ struct factory {
                                                 const std::string& sinkUri,
                                                 UAttributes& attributes,
                                                 CE& ce) {
-    auto any = new google::protobuf::Any();
-    any->PackFrom(msg);
-
-    auto ok = createBaseCE(ServiceType::MessageType_E::FILE, rpcUri, any,
+    auto ok = createBaseCE(ServiceType::MessageType_E::FILE, rpcUri, msg,
                            attributes, ce);
 
     if (unlikely(!ok)) {
@@ -278,18 +257,13 @@ struct factory {
     }
     if (!sinkUri.empty()) {
       if (valid_uri(sinkUri)) {
-        auto* attr = new CloudEvent_CloudEventAttributeValue();
-        std::string str = std::string(sinkUri);
-        attr->set_ce_string(str);
-        (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+        (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_string(sinkUri);
       }
     }
 
     // all optional
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     }
 
     return ok;
@@ -321,19 +295,13 @@ struct factory {
     }
     if (!sinkUri.empty()) {
       if (valid_uri(sinkUri)) {
-        auto* attr = new CloudEvent_CloudEventAttributeValue();
-        std::string str = std::string(sinkUri);
-        attr->set_ce_string(str);
-        (*(ce).mutable_attributes())[Serializer::SINK_KEY] = *attr;
+        (*ce.mutable_attributes())[Serializer::SINK_KEY].set_ce_string(sinkUri);
       }
     }
 
     // all optional
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     }
     return ok;
   }
@@ -351,10 +319,7 @@ struct factory {
   [[nodiscard]] static inline bool request_factory(
       google::protobuf::Message& msg, const std::string& rpcUri,
       const std::string& sinkUri, UAttributes& attributes, CE& ce) {
-    auto any = new google::protobuf::Any();
-    any->PackFrom(msg);
-
-    auto ok = createBaseCE(ServiceType::MessageType_E::REQUEST, rpcUri, any,
+    auto ok = createBaseCE(ServiceType::MessageType_E::REQUEST, rpcUri, msg,
                            attributes, ce);
     if (unlikely(!ok)) {
       spdlog::error(
@@ -365,19 +330,14 @@ struct factory {
     }
 
     if (valid_uri(sinkUri)) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      std::string str = std::string(sinkUri);
-      attr->set_ce_string(str);
-      (*(ce).mutable_attributes())[Serializer::SINK_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::SINK_KEY].set_ce_string(sinkUri);
     } else {
       spdlog::error("Sink URI is not a Valid URI, {} \n", sinkUri.c_str());
       return false;
     }
 
     if (auto ttl = attributes.get_ttl(); likely(ttl.has_value())) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     } else {
       spdlog::error("TTL is mandatory , and was not provided\n");
       return false;
@@ -410,19 +370,14 @@ struct factory {
     }
 
     if (valid_uri(sinkUri)) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      std::string str = std::string(sinkUri);
-      attr->set_ce_string(str);
-      (*(ce).mutable_attributes())[Serializer::SINK_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::SINK_KEY].set_ce_string(sinkUri);
     } else {
       spdlog::error("Sink URI is not a Valid URI, {} \n", sinkUri.c_str());
       return false;
     }
 
     if (auto ttl = attributes.get_ttl(); likely(ttl.has_value())) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     } else {
       spdlog::error("TTL is mandatory , and was not provided\n");
       return false;
@@ -447,10 +402,7 @@ struct factory {
       google::protobuf::Message& msg, const std::string& rpcUri,
       const std::string& sinkUri, const std::string& reqId,
       UAttributes& attributes, CE& ce) {
-    auto any = new google::protobuf::Any();
-    any->PackFrom(msg);
-
-    auto ok = createBaseCE(ServiceType::MessageType_E::REQUEST, sinkUri, any,
+    auto ok = createBaseCE(ServiceType::MessageType_E::REQUEST, sinkUri, msg,
                            attributes, ce);
     if (unlikely(!ok)) {
       spdlog::error(
@@ -464,25 +416,18 @@ struct factory {
       spdlog::error("Request ID is empty, Mandatory value");
       return false;
     } else {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(reqId);
-      (*(ce).mutable_attributes())[Serializer::REQ_ID_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::REQ_ID_KEY].set_ce_string(reqId);
     }
 
     if (unlikely(rpcUri.empty() || !valid_uri(rpcUri))) {
       spdlog::error("Sink URI is not a Valid URI, \"%s\"\n", rpcUri.c_str());
       return false;
     } else {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      std::string str = std::string(rpcUri);
-      attr->set_ce_string(str);
-      (*(ce).mutable_attributes())[Serializer::SINK_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::SINK_KEY].set_ce_string(rpcUri);
     }
 
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     } else {
       spdlog::error("TTL is mandatory , and was not provided\n");
       return false;
@@ -507,25 +452,18 @@ struct factory {
       spdlog::error("Request ID is empty, Mandatory value");
       return false;
     } else {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(reqId);
-      (*(ce).mutable_attributes())[Serializer::REQ_ID_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::REQ_ID_KEY].set_ce_string(reqId);
     }
 
     if (unlikely(rpcUri.empty() || !valid_uri(rpcUri))) {
       spdlog::error("Sink URI is not a Valid URI, \"%s\"\n", rpcUri.c_str());
       return false;
     } else {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      std::string str = std::string(rpcUri);
-      attr->set_ce_string(str);
-      (*(ce).mutable_attributes())[Serializer::SINK_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::SINK_KEY].set_ce_string(rpcUri);
     }
 
     if (auto ttl = attributes.get_ttl(); ttl.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_integer((int32_t)*ttl);
-      (*(ce).mutable_attributes())[Serializer::TTL_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer((int32_t)*ttl);
     } else {
       spdlog::error("TTL is mandatory , and was not provided\n");
       return false;
@@ -533,6 +471,55 @@ struct factory {
     return true;
   }
 
+  /**
+   * Arena variants of the factories above: the event, its attributes map and
+   * the packed data are all allocated on the given arena, nothing is freed or
+   * leaked per event. The event lives until the arena is reset or destroyed.
+   * @return the event, nullptr on failure
+   */
+  [[nodiscard]] static inline CE* publish_factory(
+      google::protobuf::Message& msg, const std::string& rpcUri,
+      UAttributes& attributes, google::protobuf::Arena& arena) {
+    auto* ce = google::protobuf::Arena::CreateMessage<CE>(&arena);
+    return publish_factory(msg, rpcUri, attributes, *ce) ? ce : nullptr;
+  }
+
+  [[nodiscard]] static inline CE* notify_factory(
+      google::protobuf::Message& msg, const std::string& rpcUri,
+      const std::string& sinkUri, UAttributes& attributes,
+      google::protobuf::Arena& arena) {
+    auto* ce = google::protobuf::Arena::CreateMessage<CE>(&arena);
+    return notify_factory(msg, rpcUri, sinkUri, attributes, *ce) ? ce
+                                                                   : nullptr;
+  }
+
+  [[nodiscard]] static inline CE* file_factory(
+      google::protobuf::Message& msg, const std::string& rpcUri,
+      const std::string& sinkUri, UAttributes& attributes,
+      google::protobuf::Arena& arena) {
+    auto* ce = google::protobuf::Arena::CreateMessage<CE>(&arena);
+    return file_factory(msg, rpcUri, sinkUri, attributes, *ce) ? ce : nullptr;
+  }
+
+  [[nodiscard]] static inline CE* request_factory(
+      google::protobuf::Message& msg, const std::string& rpcUri,
+      const std::string& sinkUri, UAttributes& attributes,
+      google::protobuf::Arena& arena) {
+    auto* ce = google::protobuf::Arena::CreateMessage<CE>(&arena);
+    return request_factory(msg, rpcUri, sinkUri, attributes, *ce) ? ce
+                                                                    : nullptr;
+  }
+
+  [[nodiscard]] static inline CE* response_factory(
+      google::protobuf::Message& msg, const std::string& rpcUri,
+      const std::string& sinkUri, const std::string& reqId,
+      UAttributes& attributes, google::protobuf::Arena& arena) {
+    auto* ce = google::protobuf::Arena::CreateMessage<CE>(&arena);
+    return response_factory(msg, rpcUri, sinkUri, reqId, attributes, *ce)
+               ? ce
+               : nullptr;
+  }
+
   /**
    * bool is_time_passed(CE &ce)
    * @param ce cloudevent message
@@ -567,7 +554,7 @@ struct factory {
 verification on them
    * @param type The message type to send
    * @param rpcUri Where to send of type URI
-   * @param payloadData string of the data to send
+   * @param msg the data to pack into the proto data of ce
    * @param schema the uri of the payload as defined by the protobuf
    * @param attributs Extra data that is not defined directly by the cloud
 events and mandatory or optional in the uProtocol
@@ -576,9 +563,13 @@ events and mandatory or optional in the uProtocol
    */
   [[nodiscard]] static inline bool createBaseCE(ServiceType::MessageType_E type,
                                                 const std::string& rpcUri,
-                                                google::protobuf::Any* any,
+                                                google::protobuf::Message& msg,
                                                 UAttributes& attributs,
                                                 CE& ce) {
+    // packed in place, on the arena of ce if it has one
+    auto* any = ce.mutable_proto_data();
+    any->PackFrom(msg);
+
     if (likely(valid_uri(rpcUri))) {
       ce.set_source(rpcUri);
     } else {
@@ -586,9 +577,7 @@ events and mandatory or optional in the uProtocol
       return false;
     }
     if (likely(!any->type_url().empty())) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(any->type_url());
-      (*(ce).mutable_attributes())[Serializer::DATA_SCHEMA_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::DATA_SCHEMA_KEY].set_ce_string(any->type_url());
     } else {
       spdlog::error("Schema is empty");
       return false;
@@ -602,21 +591,19 @@ events and mandatory or optional in the uProtocol
     //                = *attr;
     //            }
     if (auto hash = attributs.get_hash(); hash.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(*hash);
-      (*(ce).mutable_attributes())[Serializer::HASH_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::HASH_KEY].set_ce_string(*hash);
     }
 
-    if (auto priority = attributs.get_priority_string(); priority.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(*priority);
-      (*(ce).mutable_attributes())[Serializer::PRIORITY_KEY] = *attr;
+    if (auto priority = attributs.get_priority_view(); priority.has_value()) {
+      (*ce.mutable_attributes())[Serializer::PRIORITY_KEY].set_ce_string(
+          priority->data(), priority->size());
     }
     UUID uuid = Uuidv8Factory::create();
     ce.set_id(UuidSerializer::serializeToString(uuid));
-    ce.set_spec_version(SpecVersion::ToString(SpecVersion::SpecVersion_E::V1));
-    ce.set_type(ServiceType::ToString(type));
-    ce.set_allocated_proto_data(any);
+    auto spec_version = SpecVersion::ToString(SpecVersion::SpecVersion_E::V1);
+    ce.set_spec_version(spec_version.data(), spec_version.size());
+    auto type_name = ServiceType::ToString(type);
+    ce.set_type(type_name.data(), type_name.size());
     return true;
   }
 
@@ -645,9 +632,7 @@ events and mandatory or optional in the uProtocol
     std::string object_name{};
     auto ok = getObjectNameFromURI(rpcUri, object_name);
     if (likely(!object_name.empty())) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(object_name);
-      (*(ce).mutable_attributes())[Serializer::DATA_SCHEMA_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::DATA_SCHEMA_KEY].set_ce_string(object_name);
     } else {
       spdlog::error("Schema is empty");
       return false;
@@ -661,21 +646,20 @@ events and mandatory or optional in the uProtocol
     //                = *attr;
     //            }
     if (auto hash = attributs.get_hash(); hash.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(*hash);
-      (*(ce).mutable_attributes())[Serializer::HASH_KEY] = *attr;
+      (*ce.mutable_attributes())[Serializer::HASH_KEY].set_ce_string(*hash);
     }
 
-    if (auto priority = attributs.get_priority_string(); priority.has_value()) {
-      auto* attr = new CloudEvent_CloudEventAttributeValue();
-      attr->set_ce_string(*priority);
-      (*(ce).mutable_attributes())[Serializer::PRIORITY_KEY] = *attr;
+    if (auto priority = attributs.get_priority_view(); priority.has_value()) {
+      (*ce.mutable_attributes())[Serializer::PRIORITY_KEY].set_ce_string(
+          priority->data(), priority->size());
     }
 
     UUID uuid = Uuidv8Factory::create();
     ce.set_id(UuidSerializer::serializeToString(uuid));
-    ce.set_spec_version(SpecVersion::ToString(SpecVersion::SpecVersion_E::V1));
-    ce.set_type(ServiceType::ToString(type));
+    auto spec_version = SpecVersion::ToString(SpecVersion::SpecVersion_E::V1);
+    ce.set_spec_version(spec_version.data(), spec_version.size());
+    auto type_name = ServiceType::ToString(type);
+    ce.set_type(type_name.data(), type_name.size());
     ce.set_allocated_binary_data(body);
     return ok;
   }
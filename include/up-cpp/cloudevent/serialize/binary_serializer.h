@@ -28,10 +28,13 @@
 
 #include <cloudevents.pb.h>
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <google/protobuf/io/zero_copy_stream.h>
 #include <up-cpp/cloudevent/datamodel/cloud_event.h>
+#include <up-cpp/cloudevent/datamodel/lazy_event.h>
 #include <up-cpp/utils/base64.h>
 #include "google/protobuf/util/time_util.h"
 #include "spdlog/spdlog.h"
@@ -98,6 +101,154 @@ class binary_serializer : public Serializer {
     return Serializer_type_E::BINARY;
   }
 };
+/**
+ * Serializer for 8-bit clean transports: the protobuf bytes are neither base 64
+ * encoded nor copied through an intermediate string, they are written straight
+ * into a caller provided buffer or stream and parsed from it in place.
+ */
+class raw_binary_serializer : public Serializer {
+ public:
+  [[nodiscard]] std::optional<std::unique_ptr<formatted_event>> serialize(
+      const io::cloudevents::v1::CloudEvent& cloudEvent) override {
+    if (!is_valid_event(cloudEvent)) {
+      return std::nullopt;
+    }
+
+    auto ev = std::make_unique<formatted_event>();
+    if (!cloudEvent.SerializeToString(&ev->serialized_data)) {
+      spdlog::error("Failed to serialize cloudevent structure to byte array");
+      return std::nullopt;
+    }
+    ev->type = DATA_TYPE_E::RAW;
+
+    return ev;
+  }
+
+  [[nodiscard]] std::optional<std::unique_ptr<io::cloudevents::v1::CloudEvent>>
+  deserialized(const formatted_event& formatedEvent) override {
+    if (formatedEvent.type != DATA_TYPE_E::RAW) {
+      spdlog::error("Type is NOT RAW\n");
+      return std::nullopt;
+    }
+
+    return deserialize_from(
+        reinterpret_cast<const uint8_t*>(formatedEvent.serialized_data.data()),
+        formatedEvent.serialized_data.size());
+  }
+
+  /**
+   * @return number of bytes serialize_to() writes for the event
+   */
+  [[nodiscard]] static size_t serialized_size(
+      const io::cloudevents::v1::CloudEvent& cloudEvent) {
+    return cloudEvent.ByteSizeLong();
+  }
+
+  /**
+   * Serialize the event into buffer
+   * @return number of bytes written, std::nullopt if the event is not valid or
+   * does not fit into size bytes
+   */
+  [[nodiscard]] std::optional<size_t> serialize_to(
+      const io::cloudevents::v1::CloudEvent& cloudEvent, uint8_t* buffer,
+      size_t size) {
+    if (!is_valid_event(cloudEvent)) {
+      return std::nullopt;
+    }
+
+    const auto length = cloudEvent.ByteSizeLong();
+    if (length > size) {
+      spdlog::error("Buffer of {0} bytes is too small for {1} bytes", size,
+                    length);
+      return std::nullopt;
+    }
+    // the size computed above is cached, no second pass over the event
+    cloudEvent.SerializeWithCachedSizesToArray(buffer);
+
+    return length;
+  }
+
+  /**
+   * Serialize the event into a stream, e.g. one writing into transport buffers
+   * @return false if the event is not valid or the stream failed
+   */
+  [[nodiscard]] bool serialize_to(
+      const io::cloudevents::v1::CloudEvent& cloudEvent,
+      google::protobuf::io::ZeroCopyOutputStream* stream) {
+    if (!is_valid_event(cloudEvent)) {
+      return false;
+    }
+
+    if (!cloudEvent.SerializeToZeroCopyStream(stream)) {
+      spdlog::error("Failed to serialize cloudevent structure to stream");
+      return false;
+    }
+
+    return true;
+  }
+
+  [[nodiscard]] std::optional<std::unique_ptr<io::cloudevents::v1::CloudEvent>>
+  deserialize_from(const uint8_t* data, size_t size) {
+    if ((nullptr == data) || (0 == size)) {
+      spdlog::error("Empty raw cloudevent data\n");
+      return std::nullopt;
+    }
+
+    auto ce = std::make_unique<io::cloudevents::v1::CloudEvent>();
+    if (!ce->ParseFromArray(data, static_cast<int>(size))) {
+      spdlog::error("Failed to parse byte array to cloudevent structure\n");
+      return std::nullopt;
+    }
+
+    if (!is_valid_event(*ce)) {
+      spdlog::error("Event returned error: ");
+      return std::nullopt;
+    }
+
+    return ce;
+  }
+
+  /**
+   * Parse and validate the event without its proto data, which stays packed
+   * in data until it is unpacked from the view
+   * @return false if the bytes are not a valid event
+   */
+  [[nodiscard]] bool deserialize_lazy(const uint8_t* data, size_t size,
+                                      LazyCloudEvent& event) {
+    if (!event.parse(data, size)) {
+      spdlog::error("Failed to parse byte array to cloudevent structure\n");
+      return false;
+    }
+
+    if (!is_valid_event(event.envelope())) {
+      spdlog::error("Event returned error: ");
+      return false;
+    }
+
+    return true;
+  }
+
+  [[nodiscard]] std::optional<std::unique_ptr<io::cloudevents::v1::CloudEvent>>
+  deserialize_from(google::protobuf::io::ZeroCopyInputStream* stream) {
+    auto ce = std::make_unique<io::cloudevents::v1::CloudEvent>();
+    if (!ce->ParseFromZeroCopyStream(stream)) {
+      spdlog::error("Failed to parse stream to cloudevent structure\n");
+      return std::nullopt;
+    }
+
+    if (!is_valid_event(*ce)) {
+      spdlog::error("Event returned error: ");
+      return std::nullopt;
+    }
+
+    return ce;
+  }
+
+  [[nodiscard]] inline Serializer_type_E getSerializationType() override {
+    return Serializer_type_E::RAW;
+  }
+};
+
 class [[maybe_unused]] binary_serializer_base64 : public Serializer{
   public : [[nodiscard]] std::optional<std::unique_ptr<formatted_event>>
       serialize(const io::cloudevents::v1::CloudEvent& cloudEvent)
@@ -112,7 +263,7 @@ if (!cloudEvent.SerializeToString(
   return std::nullopt;
 }
 
-std::string encData = uprotocol::tools::Base64::encode(str);
+std::string encData = uprotocol::utils::Base64::encode(str);
 if (encData.empty()) {
   spdlog::error("Failed to encode cloudevent structure to base64");
   return std::nullopt;
@@ -136,7 +287,7 @@ deserialized(const formatted_event& formatedEvent) override {
     spdlog::error("formatedEvent.serialized_data.empty()\n");
     return std::nullopt;
   }
-  const std::string str(uprotocol::tools::Base64::decode(formatedEvent.serialized_data));
+  const std::string str(uprotocol::utils::Base64::decode(formatedEvent.serialized_data));
   if (str.empty()) {
     spdlog::error("Failed to decode from base64\n");
     return std::nullopt;
@@ -26,10 +26,13 @@
 #ifndef CPP_CLOUDEVENT_JSON_SERIALIZER_H
 #define CPP_CLOUDEVENT_JSON_SERIALIZER_H
 
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
 
 #include <up-cpp/cloudevent/datamodel/cloud_event.h>
@@ -37,6 +40,7 @@
 #include "cloudevents.pb.h"
 #include "google/protobuf/util/time_util.h"
 #include "rapidjson/document.h"
+#include "rapidjson/memorystream.h"
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/reader.h"
 #include "rapidjson/stringbuffer.h"
@@ -86,29 +90,18 @@ class Json_serializer : public Serializer {
         (*ce).set_text_data(m.value.GetString());
       } else {  // all are attributes
         if (type == rapidjson::kStringType) {
-          auto attr = std::make_unique<CloudEvent_CloudEventAttributeValue>();
-          // auto attr = new
-          // CloudEvent_CloudEventAttributeValue();
-          auto str = std::string(m.value.GetString());
-          attr->set_ce_string(str);
-          (*ce->mutable_attributes())[name] = *attr;
-          attr.release();
+          (*ce->mutable_attributes())[name].set_ce_string(
+              m.value.GetString(), m.value.GetStringLength());
         } else {  // numeric
-          std::cout << __func__ << ":" << __LINE__ << std::endl;
-          auto attr = std::make_unique<CloudEvent_CloudEventAttributeValue>();
-          attr->set_ce_integer(m.value.GetInt());
-          (*(*ce).mutable_attributes())[name] = *attr;
-          attr.release();
+          (*ce->mutable_attributes())[name].set_ce_integer(m.value.GetInt());
         }
       }
     }
 
-    std::cout << __func__ << ":" << __LINE__ << std::endl;
     if (!is_valid_event((*ce))) {
       spdlog::info("Error in Json_serializer::deserialized\n");
       return std::nullopt;
     }
-    std::cout << __func__ << ":" << __LINE__ << std::endl;
 
     return ce;
   }
@@ -159,6 +152,284 @@ class Json_serializer : public Serializer {
   }
 };
 
+/**
+ * Streaming JSON serializer: events are parsed with the RapidJSON SAX reader
+ * straight into the CloudEvent (which may live on the caller's arena) and
+ * written through a writer buffer that is reused between calls, no DOM is built.
+ *
+ * Mapping: id, source, specversion, type and data (text) / data_base64
+ * (binary) are members of the top level object, every other member is an
+ * attribute. Attributes are read as ce_boolean, ce_integer or ce_string;
+ * bytes are written base 64 encoded and timestamps in RFC 3339 format.
+ * Attributes without a value are not written and null attributes are read as
+ * absent. Nested objects, arrays, numbers outside of int32 and data_base64
+ * that is not valid padded base 64 are rejected.
+ */
+class Json_stream_serializer : public Serializer {
+ public:
+  [[nodiscard]] std::optional<std::unique_ptr<formatted_event>> serialize(
+      const io::cloudevents::v1::CloudEvent& cloudEvent) override {
+    auto ev = std::make_unique<formatted_event>();
+    if (!serialize_to(cloudEvent, ev->serialized_data)) {
+      return std::nullopt;
+    }
+    ev->type = DATA_TYPE_E::JSON;
+
+    return ev;
+  }
+
+  [[nodiscard]] std::optional<std::unique_ptr<io::cloudevents::v1::CloudEvent>>
+  deserialized(const formatted_event& formatedEvent) override {
+    if (formatedEvent.type != DATA_TYPE_E::JSON) {
+      spdlog::info("Type is not JSON, returning null\n");
+      return std::nullopt;
+    }
+
+    auto ce = std::make_unique<io::cloudevents::v1::CloudEvent>();
+    if (!deserialize_into(formatedEvent.serialized_data.data(),
+                          formatedEvent.serialized_data.size(), *ce)) {
+      return std::nullopt;
+    }
+
+    return ce;
+  }
+
+  /**
+   * Serialize the event into out, reusing its capacity
+   * @return false if the event is not valid or holds proto data
+   */
+  [[nodiscard]] bool serialize_to(
+      const io::cloudevents::v1::CloudEvent& cloudEvent, std::string& out) {
+    if (!is_valid_event(cloudEvent)) {
+      return false;
+    }
+    if (cloudEvent.has_proto_data()) {
+      spdlog::error("proto data is not supported in JSON format");
+      return false;
+    }
+
+    buffer_.Clear();
+    writer_.Reset(buffer_);
+
+    writer_.StartObject();
+    write_member("id", cloudEvent.id());
+    write_member("source", cloudEvent.source());
+    write_member("specversion", cloudEvent.spec_version());
+    write_member("type", cloudEvent.type());
+
+    for (const auto& [name, value] : cloudEvent.attributes()) {
+      if (CloudEvent_CloudEventAttributeValue::AttrCase::ATTR_NOT_SET ==
+          value.attr_case()) {
+        continue;
+      }
+      writer_.Key(name.data(), static_cast<rapidjson::SizeType>(name.size()));
+      switch (value.attr_case()) {
+        case CloudEvent_CloudEventAttributeValue::AttrCase::kCeBoolean:
+          writer_.Bool(value.ce_boolean());
+          break;
+        case CloudEvent_CloudEventAttributeValue::AttrCase::kCeInteger:
+          writer_.Int(value.ce_integer());
+          break;
+        case CloudEvent_CloudEventAttributeValue::AttrCase::kCeString:
+          write_string(value.ce_string());
+          break;
+        case CloudEvent_CloudEventAttributeValue::AttrCase::kCeUri:
+          write_string(value.ce_uri());
+          break;
+        case CloudEvent_CloudEventAttributeValue::AttrCase::kCeUriRef:
+          write_string(value.ce_uri_ref());
+          break;
+        case CloudEvent_CloudEventAttributeValue::AttrCase::kCeBytes:
+          write_base64(value.ce_bytes());
+          break;
+        case CloudEvent_CloudEventAttributeValue::AttrCase::kCeTimestamp:
+          write_string(TimeUtil::ToString(value.ce_timestamp()));
+          break;
+        case CloudEvent_CloudEventAttributeValue::AttrCase::ATTR_NOT_SET:
+          break;
+      }
+    }
+
+    if (cloudEvent.has_text_data()) {
+      write_member(Serializer::DATA_KEY.c_str(), cloudEvent.text_data());
+    } else if (cloudEvent.has_binary_data()) {
+      writer_.Key("data_base64");
+      write_base64(cloudEvent.binary_data());
+    }
+    writer_.EndObject();
+
+    out.assign(buffer_.GetString(), buffer_.GetSize());
+
+    return true;
+  }
+
+  /**
+   * Parse a JSON event into cloudEvent, e.g. one created on an arena; whatever
+   * cloudEvent held before is cleared
+   * @return false if the JSON is malformed, uses unsupported types or the
+   * event is not valid
+   */
+  [[nodiscard]] bool deserialize_into(const char* json, size_t len,
+                                      io::cloudevents::v1::CloudEvent& cloudEvent) {
+    cloudEvent.Clear();
+    handler_.reset(cloudEvent);
+    rapidjson::MemoryStream stream(json, len);
+    auto result = reader_.Parse(stream, handler_);
+    if (result.IsError()) {
+      spdlog::info("Failed to parse json event, error {0} at offset {1}\n",
+                   static_cast<int>(result.Code()), result.Offset());
+      return false;
+    }
+
+    if (!is_valid_event(cloudEvent)) {
+      spdlog::info("Error in Json_stream_serializer::deserialize_into\n");
+      return false;
+    }
+
+    return true;
+  }
+
+  [[nodiscard]] inline Serializer_type_E getSerializationType() override {
+    return Serializer_type_E::TEXT;
+  }
+
+ private:
+  /* SAX handler filling the event while the JSON is read */
+  class event_handler
+      : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, event_handler> {
+   public:
+    void reset(io::cloudevents::v1::CloudEvent& cloudEvent) {
+      ce_ = &cloudEvent;
+      depth_ = 0;
+      key_.clear();
+    }
+
+    /* everything not handled below is not supported */
+    bool Default() { return false; }
+
+    bool StartObject() { return 0 == depth_++; }
+
+    bool EndObject(rapidjson::SizeType) {
+      --depth_;
+      return true;
+    }
+
+    bool Key(const char* str, rapidjson::SizeType len, bool) {
+      key_.assign(str, len);
+      return true;
+    }
+
+    bool String(const char* str, rapidjson::SizeType len, bool) {
+      if ("id" == key_) {
+        ce_->set_id(str, len);
+      } else if ("source" == key_) {
+        ce_->set_source(str, len);
+      } else if ("specversion" == key_) {
+        ce_->set_spec_version(str, len);
+      } else if ("type" == key_) {
+        ce_->set_type(str, len);
+      } else if (Serializer::DATA_KEY == key_) {
+        ce_->set_text_data(str, len);
+      } else if ("data_base64" == key_) {
+        return set_binary_data(str, len);
+      } else {
+        (*ce_->mutable_attributes())[key_].set_ce_string(str, len);
+      }
+      return true;
+    }
+
+    bool Int(int value) { return set_integer(value); }
+
+    bool Uint(unsigned value) {
+      if (value > static_cast<unsigned>(std::numeric_limits<int32_t>::max())) {
+        return false;
+      }
+      return set_integer(static_cast<int32_t>(value));
+    }
+
+    bool Bool(bool value) {
+      if (is_context_key()) {
+        return false;
+      }
+      (*ce_->mutable_attributes())[key_].set_ce_boolean(value);
+      return true;
+    }
+
+    /* a null attribute or data is absent, the required members are not */
+    bool Null() {
+      return ("id" != key_) && ("source" != key_) && ("specversion" != key_) &&
+             ("type" != key_);
+    }
+
+   private:
+    /* decode would stop at the first character outside the alphabet, the
+     * length check rejects those as well as truncated input */
+    bool set_binary_data(const char* str, rapidjson::SizeType len) {
+      size_t padding = 0;
+      while ((padding < len) && (padding < 3) && ('=' == str[len - 1 - padding])) {
+        ++padding;
+      }
+      if ((0 != (len % 4)) || (padding > 2)) {
+        spdlog::info("data_base64 is not padded base 64\n");
+        return false;
+      }
+
+      auto data = ce_->mutable_binary_data();
+      data->resize(uprotocol::utils::Base64::maxDecodedLen(len));
+      const auto decoded = uprotocol::utils::Base64::decode(
+          str, len, reinterpret_cast<uint8_t*>(data->data()));
+      if (decoded != ((len / 4 * 3) - padding)) {
+        spdlog::info("data_base64 is not valid base 64\n");
+        return false;
+      }
+      data->resize(decoded);
+      return true;
+    }
+
+    bool set_integer(int32_t value) {
+      if (is_context_key()) {
+        return false;
+      }
+      (*ce_->mutable_attributes())[key_].set_ce_integer(value);
+      return true;
+    }
+
+    /* members that must hold strings */
+    bool is_context_key() const {
+      return ("id" == key_) || ("source" == key_) || ("specversion" == key_) ||
+             ("type" == key_) || (Serializer::DATA_KEY == key_) ||
+             ("data_base64" == key_);
+    }
+
+    io::cloudevents::v1::CloudEvent* ce_ = nullptr;
+    int depth_ = 0;
+    std::string key_;
+  };
+
+  void write_string(const std::string& value) {
+    writer_.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+  }
+
+  void write_member(const char* name, const std::string& value) {
+    writer_.Key(name);
+    write_string(value);
+  }
+
+  void write_base64(const std::string& value) {
+    encoded_.resize(uprotocol::utils::Base64::encodedLen(value.size()));
+    uprotocol::utils::Base64::encode(
+        reinterpret_cast<const uint8_t*>(value.data()), value.size(),
+        encoded_.data());
+    write_string(encoded_);
+  }
+
+  rapidjson::StringBuffer buffer_;
+  rapidjson::Writer<rapidjson::StringBuffer> writer_{buffer_};
+  rapidjson::Reader reader_;
+  event_handler handler_;
+  std::string encoded_;
+};
+
 }  // namespace cloudevents::format
 
-#endif  // CPP_CLOUDEVENT_JSON_SERIALIZER_H
\ No newline at end of file
+#endif  // CPP_CLOUDEVENT_JSON_SERIALIZER_H
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef _CONTINUATION_RPC_CLIENT_H_
+#define _CONTINUATION_RPC_CLIENT_H_
+
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+#include <up-cpp/rpc/RequestTable.h>
+#include <up-cpp/rpc/RpcClient.h>
+#include <up-cpp/transport/UTransport.h>
+#include <up-cpp/utils/ThreadPool.h>
+
+namespace uprotocol::rpc {
+
+    /**
+    * RpcClient over a UTransport that continues with the response instead of waiting on a future.
+    * No thread is blocked while a request is outstanding, so any number of requests can be in flight.
+    *
+    * The client builds the request attributes itself and matches the responses to the outstanding
+    * requests on their reqid through a RequestTable, which also times them out after their TTL.
+    * A single listener, registered with the transport for every method URI invoked and owned by the
+    * client, receives all responses, so a late or duplicate response only finds no request to complete.
+    * The transport must outlive the client.
+    */
+    class ContinuationRpcClient : public RpcClient
+    {
+        public:
+
+            /** Size of the chunks invokeStreamingMethod() cuts a response into by default */
+            static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+            /**
+            * @param transport transport sending the requests and delivering the responses
+            * @param source URI of this client, the source of the requests
+            * @param capacity maximum number of outstanding requests
+            */
+            ContinuationRpcClient(uprotocol::utransport::UTransport &transport,
+                                  const uprotocol::v1::UUri &source,
+                                  size_t capacity = 1024);
+
+            ContinuationRpcClient(const ContinuationRpcClient &) = delete;
+            ContinuationRpcClient & operator=(const ContinuationRpcClient &) = delete;
+
+            /**
+            * Unregisters the response listener, then resumes the continuations still waiting for a
+            * response with CANCELLED.
+            */
+            ~ContinuationRpcClient() override;
+
+            std::future<RpcResponse> invokeMethod(const uprotocol::v1::UUri &topic,
+                                                  const uprotocol::utransport::UPayload &payload,
+                                                  const uprotocol::v1::CallOptions &options) override;
+
+            /**
+            * The callback receives the response message; on a failure (e.g. the TTL elapsed) it receives
+            * a message without payload whose commstatus is the failure code.
+            */
+            uprotocol::v1::UStatus invokeMethod(const uprotocol::v1::UUri &topic,
+                                                const uprotocol::utransport::UPayload &payload,
+                                                const uprotocol::v1::CallOptions &options,
+                                                const uprotocol::utransport::UListener &callback) override;
+
+            /**
+            * API for clients to invoke a method and continue with the response instead of waiting on a future.
+            * @param topic The method URI to be invoked.
+            * @param payload The request message to be sent to the server.
+            * @param options RPC method invocation call options, see {@link CallOptions}
+            * @param continuation called exactly once with the response, DEADLINE_EXCEEDED once the TTL in
+            * options elapsed (see expire()) or CANCELLED when the client goes away, only if the request was sent
+            * @param executor pool the continuation is resumed on, nullptr to run it on the thread delivering
+            * the response
+            * @return Returns OKSTATUS if the request was sent, otherwise the failure (the continuation is not
+            * called), RESOURCE_EXHAUSTED if capacity requests are outstanding
+            */
+            uprotocol::v1::UStatus invokeMethod(const uprotocol::v1::UUri &topic,
+                                                const uprotocol::utransport::UPayload &payload,
+                                                const uprotocol::v1::CallOptions &options,
+                                                RpcContinuation &&continuation,
+                                                uprotocol::utils::ThreadPool *executor = nullptr);
+
+            /**
+            * API for clients to invoke a method whose response is streamed in chunks, so a large
+            * response (e.g. a map or OTA blob the server sends as UPayload::mapFile() slices) is
+            * handled chunk by chunk and never needs to be resident as a whole.
+            * The response is received as one message and its payload is handed to the handler as
+            * UPayload::slice() chunks of chunkSize bytes, which share the response buffer, so a mapped
+            * response is only paged in as the handler reads it.
+            * @param topic The method URI to be invoked.
+            * @param payload The request message to be sent to the server.
+            * @param options RPC method invocation call options, see {@link CallOptions}
+            * @param handler called for every chunk in order, the last one (or a failure) ends the
+            * stream, only if the request was sent
+            * @param executor pool the handler runs on, nullptr to run it on the thread delivering
+            * the chunks
+            * @param chunkSize maximum payload size of a chunk, 0 for the whole response in one chunk
+            * @return Returns OKSTATUS if the request was sent, otherwise the failure (the handler is not called)
+            */
+            uprotocol::v1::UStatus invokeStreamingMethod(const uprotocol::v1::UUri &topic,
+                                                         const uprotocol::utransport::UPayload &payload,
+                                                         const uprotocol::v1::CallOptions &options,
+                                                         RpcChunkHandler &&handler,
+                                                         uprotocol::utils::ThreadPool *executor = nullptr,
+                                                         size_t chunkSize = DefaultChunkSize);
+
+#if defined(__cpp_impl_coroutine)
+            /**
+            * Awaitable for {@code co_await client.awaitMethod(...)}; the coroutine is resumed on executor
+            * (or on the thread delivering the response) and receives the RpcResponse. If the request cannot
+            * be sent the coroutine is not suspended and the response carries the failure status.
+            */
+            class Awaitable {
+
+                public:
+
+                    Awaitable(ContinuationRpcClient &client,
+                              const uprotocol::v1::UUri &topic,
+                              const uprotocol::utransport::UPayload &payload,
+                              const uprotocol::v1::CallOptions &options,
+                              uprotocol::utils::ThreadPool *executor)
+                        : client_(client), topic_(topic), payload_(payload), options_(options), executor_(executor) {}
+
+                    bool await_ready() const noexcept {
+                        return false;
+                    }
+
+                    bool await_suspend(std::coroutine_handle<> handle) {
+                        /* the continuation may resume the coroutine before invokeMethod returns,
+                           so this object is only touched again if the request failed */
+                        auto status = client_.invokeMethod(topic_, payload_, options_,
+                            [this, handle](RpcResponse &&response) {
+                                response_ = std::move(response);
+                                handle.resume();
+                            },
+                            executor_);
+                        if (uprotocol::v1::UCode::OK != status.code()) {
+                            response_.status = std::move(status);
+                            return false;
+                        }
+
+                        return true;
+                    }
+
+                    RpcResponse await_resume() {
+                        return std::move(response_);
+                    }
+
+                private:
+
+                    ContinuationRpcClient &client_;
+                    const uprotocol::v1::UUri &topic_;
+                    const uprotocol::utransport::UPayload &payload_;
+                    const uprotocol::v1::CallOptions &options_;
+                    uprotocol::utils::ThreadPool *executor_;
+                    RpcResponse response_;
+            };
+
+            /**
+            * C++20 API for clients to {@code co_await} the response of a method invocation.
+            * The arguments must stay alive until the awaitable has been awaited.
+            */
+            Awaitable awaitMethod(const uprotocol::v1::UUri &topic,
+                                  const uprotocol::utransport::UPayload &payload,
+                                  const uprotocol::v1::CallOptions &options,
+                                  uprotocol::utils::ThreadPool *executor = nullptr) {
+                return Awaitable(*this, topic, payload, options, executor);
+            }
+#endif
+
+            /**
+            * Time out the requests whose TTL elapsed by now with DEADLINE_EXCEEDED. Meant to be called
+            * periodically from a timer thread, like RequestTable::expire(), not from a continuation.
+            * @return number of requests that timed out
+            */
+            size_t expire(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) {
+                return requests_.expire(now);
+            }
+
+            /**
+            * @return number of requests waiting for their response
+            */
+            size_t pending() const {
+                return requests_.size();
+            }
+
+        private:
+
+            /* completes the outstanding requests with the responses the transport delivers */
+            class ResponseListener : public uprotocol::utransport::UListener {
+
+                public:
+
+                    explicit ResponseListener(RequestTable &requests) : requests_(requests) {}
+
+                    uprotocol::v1::UStatus onReceive(uprotocol::utransport::UMessage &message) const override;
+
+                private:
+
+                    RequestTable &requests_;
+            };
+
+            /* a continuation resumed on an executor, together with the response it is resumed with */
+            struct Resumption {
+                RpcContinuation continuation;
+                uprotocol::utils::ThreadPool *executor;
+                RpcResponse response;
+            };
+
+            static void resume(std::unique_ptr<Resumption> resumption, RpcResponse &&response);
+
+            /* register the response listener for the method URI, once per URI */
+            uprotocol::v1::UStatus listenTo(const uprotocol::v1::UUri &topic);
+
+            uprotocol::utransport::UTransport &transport_;
+            const uprotocol::v1::UUri source_;
+            RequestTable requests_;
+            ResponseListener listener_;
+
+            std::mutex methodsMutex_;
+            /* method URIs the listener is registered for, keyed by their serialization */
+            std::unordered_map<std::string, uprotocol::v1::UUri> methods_;
+    };
+}
+#endif /*_CONTINUATION_RPC_CLIENT_H_*/
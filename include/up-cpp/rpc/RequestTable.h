@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _REQUEST_TABLE_H_
+#define _REQUEST_TABLE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <up-cpp/rpc/RpcClient.h>
+#include <up-cpp/utils/LockFreeQueue.h>
+#include <up-core-api/uattributes.pb.h>
+#include <up-core-api/uuid.pb.h>
+
+namespace uprotocol::rpc {
+
+	/**
+	* Table of outstanding RPC requests for RpcClient implementations, keyed by
+	* the request id (UAttributes reqid) and expiring requests after their TTL.
+	*
+	* The table is split into lock stripes; each stripe owns a fixed slab of
+	* requests, an open-addressing (linear probing) index on the UUID and a
+	* hierarchical timer wheel, so adding, completing and expiring a request is
+	* O(1) and nothing is allocated after construction. Continuations always
+	* run outside of the stripe lock.
+	*/
+	class RequestTable {
+
+		public:
+
+			/**
+			* @param capacity maximum number of outstanding requests
+			* @param tick resolution of the timeouts
+			*/
+			explicit RequestTable(size_t capacity,
+								  std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+
+			RequestTable(const RequestTable &) = delete;
+			RequestTable & operator=(const RequestTable &) = delete;
+
+			/**
+			* Fails the requests that are still outstanding with CANCELLED.
+			*/
+			~RequestTable();
+
+			/**
+			* Add an outstanding request.
+			* @param reqid id of the request message
+			* @param ttl time to wait for the response, 0 to never expire
+			* @param continuation called once with the response, the timeout or the cancellation
+			* @return OK, ALREADY_EXISTS if reqid is outstanding, RESOURCE_EXHAUSTED if the
+			* table is full (the continuation is not called in both cases)
+			*/
+			uprotocol::v1::UStatus add(const uprotocol::v1::UUID &reqid,
+									   std::chrono::milliseconds ttl,
+									   RpcContinuation &&continuation);
+
+			/**
+			* Same as add(), taking the TTL from the call options.
+			*/
+			uprotocol::v1::UStatus add(const uprotocol::v1::UUID &reqid,
+									   const uprotocol::v1::CallOptions &options,
+									   RpcContinuation &&continuation) {
+				return add(reqid, std::chrono::milliseconds((options.ttl() > 0) ? options.ttl() : 0),
+						   std::move(continuation));
+			}
+
+			/**
+			* Complete the request the response message answers (matched on its reqid).
+			* @return false if the request is unknown, already completed or expired
+			*/
+			bool complete(const uprotocol::utransport::UMessage &response);
+
+			/**
+			* Same as above, moving the response (and its payload buffer) to the continuation.
+			*/
+			bool complete(uprotocol::utransport::UMessage &&response);
+
+			/**
+			* Complete a request with a response message.
+			* @return false if the request is unknown, already completed or expired
+			*/
+			bool complete(const uprotocol::v1::UUID &reqid,
+						  const uprotocol::utransport::UMessage &response);
+
+			/**
+			* Complete a request, moving the response (and its payload buffer) to the continuation.
+			* @return false if the request is unknown, already completed or expired
+			*/
+			bool complete(const uprotocol::v1::UUID &reqid,
+						  uprotocol::utransport::UMessage &&response);
+
+			/**
+			* Fail a request with status, e.g. when sending the request failed.
+			* @return false if the request is unknown, already completed or expired
+			*/
+			bool cancel(const uprotocol::v1::UUID &reqid,
+						uprotocol::v1::UStatus status);
+
+			/**
+			* Drop a request without calling its continuation, e.g. when sending it failed
+			* and the caller reports the failure itself.
+			* @return false if the request is unknown, already completed or expired
+			*/
+			bool remove(const uprotocol::v1::UUID &reqid);
+
+			/**
+			* Fail the requests whose TTL elapsed by now with DEADLINE_EXCEEDED.
+			* Meant to be called periodically (about every tick) from a timer thread,
+			* not from a continuation.
+			* @return number of expired requests
+			*/
+			size_t expire(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+			/**
+			* @return number of outstanding requests
+			*/
+			size_t size() const;
+
+			size_t capacity() const {
+				return capacity_;
+			}
+
+		private:
+
+			static constexpr size_t Stripes = 16;
+			static constexpr uint32_t None = UINT32_MAX;
+
+			/* timer wheel geometry: 256 ticks in the first level, 64 slots in each further level */
+			static constexpr unsigned RootBits = 8;
+			static constexpr unsigned LevelBits = 6;
+			static constexpr unsigned Levels = 4;
+			static constexpr size_t RootSlots = 1U << RootBits;
+			static constexpr size_t LevelSlots = 1U << LevelBits;
+			static constexpr uint64_t MaxDelta = (1ULL << (RootBits + (Levels - 1) * LevelBits)) - 1;
+
+			struct Node {
+				uint64_t msb = 0;
+				uint64_t lsb = 0;
+				uint64_t expires = 0;
+				/* wheel list links, or the free list link in next */
+				uint32_t prev = None;
+				uint32_t next = None;
+				/* wheel list the node is linked into, None if it never expires */
+				uint32_t list = None;
+				RpcContinuation continuation;
+			};
+
+			struct alignas(uprotocol::utils::CacheLineSize) Stripe {
+				std::mutex mutex;
+				std::vector<Node> nodes;
+				/* open-addressing index, holds node indices */
+				std::vector<uint32_t> index;
+				size_t mask = 0;
+				uint32_t freeList = None;
+				size_t size = 0;
+				/* next tick to process and the heads of the wheel lists (root, then level 1..3) */
+				uint64_t base = 0;
+				std::vector<uint32_t> lists;
+				/* nodes linked into the wheel / into its root level */
+				size_t timed = 0;
+				size_t rooted = 0;
+			};
+
+			/* a continuation taken out of the table, run after the lock is released */
+			struct Ready {
+				RpcContinuation continuation;
+				RpcResponse response;
+			};
+
+			static uint64_t hash(uint64_t msb, uint64_t lsb);
+
+			Stripe &stripeOf(uint64_t hash) {
+				return *stripes_[hash >> 60];
+			}
+
+			uint64_t ticks(std::chrono::steady_clock::time_point time) const;
+
+			/* index slot holding the node for msb/lsb, or the empty slot ending its probe sequence */
+			static size_t find(const Stripe &stripe, uint64_t hash, uint64_t msb, uint64_t lsb);
+
+			/* double the nodes of a stripe that ran out of them */
+			static void grow(Stripe &stripe);
+
+			/* unlink and free a node, leaving its continuation in out */
+			void release(Stripe &stripe, size_t slot, RpcContinuation &out);
+
+			static void link(Stripe &stripe, uint32_t node);
+			static void unlink(Stripe &stripe, uint32_t node);
+			static uint32_t cascade(Stripe &stripe, unsigned level, uint32_t slot);
+
+			bool take(const uprotocol::v1::UUID &reqid, RpcContinuation &out);
+
+			const size_t capacity_;
+			const std::chrono::milliseconds tick_;
+			const std::chrono::steady_clock::time_point epoch_;
+			std::unique_ptr<Stripe> stripes_[Stripes];
+			/* requests in all stripes, bounds the table at capacity_ */
+			std::atomic<size_t> size_ {0};
+
+			/* serializes expire() so the expired continuations can be collected in a reused vector */
+			std::mutex expireMutex_;
+			std::vector<Ready> expired_;
+	};
+}
+
+#endif /* _REQUEST_TABLE_H_ */
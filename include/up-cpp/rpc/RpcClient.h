@@ -25,19 +25,49 @@
 #ifndef _RPC_CLIENT_H_
 #define _RPC_CLIENT_H_
 
+#include <cstddef>
 #include <future>
 #include <up-cpp/transport/UListener.h>
 #include <up-cpp/transport/datamodel/UMessage.h>
+#include <up-cpp/utils/InplaceFunction.h>
 #include <up-core-api/uattributes.pb.h>
 #include <up-core-api/ustatus.pb.h>
 
 namespace uprotocol::rpc {
 
+    /**
+    * Response of an RPC request. Build it by moving the received UMessage in (or by sharing
+    * its payload buffer), RpcResponse is moved all the way to the caller and the payload
+    * bytes are never copied on the way.
+    */
     struct RpcResponse {
         uprotocol::v1::UStatus status;
         uprotocol::utransport::UMessage message;
     };
 
+    /**
+    * Continuation receiving the response of an RPC request. It is stored in place,
+    * so registering one does not allocate.
+    */
+    using RpcContinuation = uprotocol::utils::InplaceFunction<void(RpcResponse &&)>;
+
+    /**
+    * One chunk of a streamed RPC response. The chunks of a response are delivered in
+    * order, offset is the position of the chunk's payload in the whole response and the
+    * last chunk (or a failure status) ends the stream.
+    */
+    struct RpcChunk {
+        uprotocol::v1::UStatus status;
+        uprotocol::utransport::UMessage message;
+        size_t offset = 0;
+        bool last = true;
+    };
+
+    /**
+    * Handler receiving the chunks of a streamed RPC response, stored in place.
+    */
+    using RpcChunkHandler = uprotocol::utils::InplaceFunction<void(RpcChunk &&)>;
+
     /**
     * RpcClient is an interface used by code generators for uProtocol services defined in proto files such as
     * the core uProtocol services found in https://github.com/eclipse-uprotocol/uprotocol-core-api. the interface 
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _COALESCING_TRANSPORT_H_
+#define _COALESCING_TRANSPORT_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <up-cpp/transport/UTransport.h>
+#include <up-cpp/utils/Futex.h>
+
+namespace uprotocol::utransport {
+
+	/**
+	* UTransport adaptor that coalesces sendAsync() calls into sendBatch() calls
+	* on the wrapped transport. A batch is flushed once it holds maxBatchSize
+	* messages or once the oldest queued message has waited for window,
+	* whichever comes first, so the wrapped transport can amortize syscalls
+	* and framing. Listener registration is forwarded unchanged.
+	*
+	* Every message reports the status the wrapped transport gave it, a message
+	* the wrapped transport did not report on fails with INTERNAL. sendAsync()
+	* returns right away and calls its completion once the batch is sent. send()
+	* and sendBatch() first send the messages already queued and then hand their
+	* messages straight to the wrapped transport, so they are neither copied nor
+	* coalesced and keep their order relative to sendAsync(). Queued messages
+	* retain their payload, so REFERENCE payloads may be released once
+	* sendAsync() returns. Completions run on the thread that sends the batch
+	* and must not call send() or sendBatch() of the same adaptor.
+	*/
+	class CoalescingTransport : public UTransport {
+
+		public:
+
+			/**
+			* @param transport transport that sends the batches, must outlive the adaptor
+			* @param maxBatchSize number of queued messages that triggers a flush
+			* @param window maximum time a message waits in the queue
+			* @param maxQueued maximum number of messages waiting in the queue,
+			* at least maxBatchSize
+			*/
+			CoalescingTransport(UTransport &transport,
+								size_t maxBatchSize,
+								std::chrono::microseconds window,
+								size_t maxQueued);
+
+			CoalescingTransport(const CoalescingTransport &) = delete;
+			CoalescingTransport & operator=(const CoalescingTransport &) = delete;
+
+			/**
+			* Flushes the queued messages and stops the flush thread.
+			*/
+			~CoalescingTransport() override;
+
+			/**
+			* Send the queued messages, then this one through the wrapped transport's
+			* send(). Use sendAsync() to coalesce without waiting.
+			* @return Returns the status the wrapped transport reported for the message
+			*/
+			uprotocol::v1::UStatus send(const UMessage &message) override;
+
+			/**
+			* Send the queued messages, then these through the wrapped transport's
+			* sendBatch(), in batches of at most maxBatchSize.
+			* @return Returns OKSTATUS if all messages have been sent, otherwise the
+			* status of the first message that failed
+			*/
+			uprotocol::v1::UStatus sendBatch(const UMessage *messages,
+											 size_t count,
+											 uprotocol::v1::UStatus *statuses = nullptr) override;
+
+			/**
+			* Queue a message for the next batch without waiting for it.
+			* @param onComplete called once with the status the wrapped transport
+			* reported for the message, from the thread sending the batch
+			* @return Returns OKSTATUS if the message is queued, RESOURCE_EXHAUSTED if
+			* maxQueued messages are already waiting (onComplete is not called)
+			*/
+			uprotocol::v1::UStatus sendAsync(const UMessage &message,
+											 SendCompletion &&onComplete) override;
+
+			uprotocol::v1::UStatus registerListener(const uprotocol::v1::UUri &uri,
+													const UListener &listener) override;
+
+			uprotocol::v1::UStatus unregisterListener(const uprotocol::v1::UUri &uri,
+													  const UListener &listener) override;
+
+			/**
+			* Send the queued messages now.
+			* @return Returns the status of the wrapped transport's sendBatch()
+			*/
+			uprotocol::v1::UStatus flush();
+
+		private:
+
+			/* queue a message, retaining its payload; flushes if the batch is full
+			   @return false if the queue is full */
+			bool enqueue(const UMessage &message, SendCompletion &&onComplete);
+
+			/* send the dequeued messages and complete them;
+			   the caller holds sendMutex_ but not queueMutex_ */
+			uprotocol::v1::UStatus sendQueued();
+
+			/* swap the queued messages and completions into the batch */
+			void takeQueued();
+
+			void flushLoop();
+
+			static constexpr std::chrono::milliseconds IdleTimeout { 100 };
+
+			UTransport &transport_;
+			const size_t maxBatchSize_;
+			const std::chrono::microseconds window_;
+			const size_t maxQueued_;
+
+			std::mutex queueMutex_;
+			std::vector<UMessage> queue_;
+			std::vector<SendCompletion> completions_;
+			std::chrono::steady_clock::time_point oldest_;
+
+			/* posted when the first message of a batch is queued and on shutdown */
+			uprotocol::utils::Futex wakeup_;
+			std::atomic<bool> terminate_ { false };
+
+			/* serializes batches so messages reach the wrapped transport in order */
+			std::mutex sendMutex_;
+			std::vector<UMessage> batch_;
+			std::vector<SendCompletion> batchCompletions_;
+			std::vector<uprotocol::v1::UStatus> statuses_;
+
+			std::thread flushThread_;
+	};
+}
+
+#endif /* _COALESCING_TRANSPORT_H_ */
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _COMPLETION_EXECUTOR_H_
+#define _COMPLETION_EXECUTOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <up-cpp/transport/MessageScheduler.h>
+#include <up-cpp/transport/UTransport.h>
+#include <up-cpp/utils/LockFreeQueue.h>
+#include <up-cpp/utils/ThreadPool.h>
+
+namespace uprotocol::utransport {
+
+	/**
+	* Runs send completions on a ThreadPool.
+	*
+	* Pending work lives in a bounded lock-free ring owned by the executor and
+	* the pool only receives a task holding a pointer back to it, so the executor
+	* allocates no queue node or task per send and completions are stored in
+	* place. The queued message is a copy, whose attributes allocate unless the
+	* message is moved in, and a REFERENCE payload is retained into a pooled
+	* buffer. Any number of sends can be outstanding while only the pool's
+	* workers run them, up to maxPending.
+	*
+	* A prioritizing executor keeps the pending work in a PriorityScheduler with
+	* one class per UPriority instead, behind its mutex, so CS5 and CS6 sends
+	* overtake the bulk sends queued before them; plain completions go to the
+	* top class. Every class preallocates room for maxPending items.
+	*/
+	class CompletionExecutor {
+
+		public:
+
+			/**
+			* @param pool pool running the completions, must outlive the executor
+			* @param maxPending maximum number of queued sends and completions
+			* @param prioritize run the queued sends by the priority of their
+			* message rather than in arrival order
+			*/
+			CompletionExecutor(uprotocol::utils::ThreadPool &pool,
+							   size_t maxPending,
+							   bool prioritize = false);
+
+			CompletionExecutor(const CompletionExecutor &) = delete;
+			CompletionExecutor & operator=(const CompletionExecutor &) = delete;
+
+			/**
+			* Runs the pending work that the pool has not picked up yet and waits for
+			* the pool tasks referring to the executor; must not be called from one
+			* of the pool's workers.
+			*/
+			~CompletionExecutor();
+
+			/**
+			* Call transport.send(message) on a pool worker and then onComplete with
+			* its status, unless onComplete is empty. The message is copied and its
+			* payload retained, the caller returns right away.
+			* @return Returns OKSTATUS if the send is queued, RESOURCE_EXHAUSTED if
+			* maxPending sends are already outstanding (onComplete is not called)
+			*/
+			uprotocol::v1::UStatus send(UTransport &transport,
+										const UMessage &message,
+										SendCompletion &&onComplete);
+
+			/**
+			* Same as above for a message the caller gives up, which is moved into
+			* the queue without copying its attributes, and handed back on failure.
+			*/
+			uprotocol::v1::UStatus send(UTransport &transport,
+										UMessage &&message,
+										SendCompletion &&onComplete);
+
+			/**
+			* Call onComplete(status) on a pool worker, or nothing if it is empty; for
+			* transports that learn about an ACK on their own I/O thread and must not
+			* run user code there.
+			* Runs onComplete on the calling thread if the executor is saturated.
+			*/
+			void complete(SendCompletion &&onComplete,
+						  uprotocol::v1::UStatus status);
+
+			/**
+			* @return number of queued sends and completions
+			*/
+			size_t pending() const {
+				return pending_.load(std::memory_order_acquire);
+			}
+
+		private:
+
+			struct Work {
+				/* nullptr for a plain completion */
+				UTransport *transport = nullptr;
+				UMessage message;
+				SendCompletion completion;
+				uprotocol::v1::UStatus status;
+			};
+
+			using Scheduler = uprotocol::utils::PriorityScheduler<Work, PriorityLevels>;
+
+			bool enqueue(Work &work);
+
+			/* run one queued work item, called by the pool (or inline)
+			 * @return false if the queue was empty */
+			bool runOne();
+
+			uprotocol::utils::ThreadPool &pool_;
+			const size_t maxPending_;
+			uprotocol::utils::MpmcQueue<Work> queue_;
+			/* holds the work in place of queue_ for a prioritizing executor */
+			std::unique_ptr<Scheduler> scheduler_;
+			std::atomic<size_t> pending_ { 0 };
+			/* pool tasks posted and not finished yet */
+			std::atomic<size_t> tasks_ { 0 };
+	};
+}
+
+#endif /* _COMPLETION_EXECUTOR_H_ */
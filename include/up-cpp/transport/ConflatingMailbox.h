@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _CONFLATING_MAILBOX_H_
+#define _CONFLATING_MAILBOX_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <up-cpp/transport/UListener.h>
+#include <up-cpp/utils/Futex.h>
+
+namespace uprotocol::utransport {
+
+	/**
+	* Latest-value mailbox for state topics (vehicle speed and the like) whose
+	* consumers only care about the newest sample.
+	*
+	* Every topic, keyed by the micro form of the message's source URI, has a
+	* single slot. A new sample is swapped into the slot, replacing the one the
+	* consumer has not picked up yet, and the topic is queued for the consumer
+	* at most once. A slow consumer therefore processes one fresh sample per
+	* topic instead of a backlog of stale copies, and a slot that already holds
+	* a message is overwritten by assignment, reusing its attribute storage.
+	*
+	* The mailbox is a UListener and can be registered with a transport as is.
+	* Topic slots are created on first use and kept for the lifetime of the
+	* mailbox, so the set of topics pushed to it is expected to be bounded.
+	*/
+	class ConflatingMailbox : public UListener {
+
+		public:
+
+			static constexpr std::chrono::milliseconds DefaultPopTimeout { 5U };
+
+			/**
+			* @param timeout longest waitPop() waits for a sample
+			*/
+			explicit ConflatingMailbox(std::chrono::milliseconds timeout = DefaultPopTimeout)
+				: timeout_(timeout) {
+			}
+
+			ConflatingMailbox(const ConflatingMailbox &) = delete;
+			ConflatingMailbox & operator=(const ConflatingMailbox &) = delete;
+
+			/**
+			* Same as push(message), for the mailbox registered as a listener.
+			*/
+			uprotocol::v1::UStatus onReceive(UMessage &message) const override;
+
+			/**
+			* Store message as the latest sample of its source topic. A REFERENCE
+			* payload is retained, so the caller's buffer may go away after push.
+			* @return OK, INVALID_ARGUMENT if the source URI has no micro form
+			*/
+			uprotocol::v1::UStatus push(const UMessage &message) const;
+
+			/**
+			* Store message as the latest sample of its source topic, taking it over.
+			*/
+			uprotocol::v1::UStatus push(UMessage &&message) const;
+
+			/**
+			* Take the latest sample of the topic that was updated first.
+			* @return false if no topic has a sample the consumer has not taken
+			*/
+			bool tryPop(UMessage &message);
+
+			/**
+			* Same as tryPop(), waiting for at most the timeout for a sample.
+			*/
+			bool waitPop(UMessage &message);
+
+			/**
+			* @return number of topics holding a sample the consumer has not taken
+			*/
+			size_t size() const;
+
+			bool isEmpty() const {
+				return 0 == size();
+			}
+
+			/**
+			* @return number of topics that ever received a sample
+			*/
+			size_t topics() const;
+
+			/**
+			* @return number of samples that were replaced before the consumer took them
+			*/
+			size_t conflated() const {
+				return conflated_.load(std::memory_order_relaxed);
+			}
+
+			/**
+			* Drop the samples the consumer has not taken yet.
+			*/
+			void clear();
+
+		private:
+
+			struct Slot {
+				std::mutex mutex;
+				UMessage message;
+				/* message holds a sample the consumer has not taken */
+				bool fresh = false;
+				/* the slot is in ready_, guarded by mutex_ */
+				bool queued = false;
+			};
+
+			/* find or create the slot of the message's source topic, nullptr if it has no micro form */
+			Slot *slotOf(const UMessage &message) const;
+
+			/* write message (a const or rvalue UMessage reference) into its slot */
+			template<typename M>
+			uprotocol::v1::UStatus store(M &&message) const;
+
+			/* queue a slot that was just written for the consumer */
+			void ready(Slot &slot) const;
+
+			/* the mailbox is filled behind the const UListener interface */
+			mutable std::mutex mutex_;
+			mutable std::unordered_map<std::string, std::unique_ptr<Slot>> slots_;
+			mutable std::deque<Slot *> ready_;
+
+			mutable uprotocol::utils::Futex available_;
+			mutable std::atomic<size_t> conflated_ { 0 };
+
+			const std::chrono::milliseconds timeout_;
+	};
+}
+
+#endif /* _CONFLATING_MAILBOX_H_ */
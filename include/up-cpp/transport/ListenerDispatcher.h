@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _LISTENER_DISPATCHER_H_
+#define _LISTENER_DISPATCHER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <up-cpp/transport/MessageScheduler.h>
+#include <up-cpp/transport/UListener.h>
+#include <up-cpp/utils/Futex.h>
+#include <up-cpp/utils/ThreadPool.h>
+
+namespace uprotocol::utransport {
+
+	class ListenerDispatcher;
+
+	/**
+	* What a listener queue does with a message that does not fit.
+	*/
+	enum class OverflowPolicy {
+		DROP,           /* reject the new message */
+		BLOCK,          /* block the receive thread until there is room, for at most blockTimeout */
+		COALESCE_LATEST /* replace the newest queued message of the same topic (source URI), drop the
+		                   message if its topic has none queued */
+	};
+
+	/**
+	* Called with true when a queue asks its producer to slow down and with
+	* false once it caught up again.
+	*/
+	using PressureHandler = std::function<void(bool throttle)>;
+
+	struct DispatchOptions {
+		/* maximum number of queued messages */
+		size_t capacity = 1024;
+		OverflowPolicy policy = OverflowPolicy::DROP;
+		/* longest a BLOCK queue keeps the receive thread waiting */
+		std::chrono::milliseconds blockTimeout { 100 };
+		/* depth that raises the throttle signal, 0 for 3/4 of capacity */
+		size_t highWatermark = 0;
+		/* depth that clears the throttle signal, 0 for 1/4 of capacity */
+		size_t lowWatermark = 0;
+		/* age of the oldest queued message that raises the throttle signal, 0 to ignore lag */
+		std::chrono::milliseconds maxLag { 0 };
+		/* optional, see PressureHandler */
+		PressureHandler onPressure;
+		/* deliver by UPriority instead of in arrival order, see ListenerQueue */
+		bool prioritize = false;
+	};
+
+	/**
+	* Bounded queue in front of one listener or a group of listeners.
+	*
+	* The queue is the UListener that gets registered with the transport:
+	* onReceive() only queues the message (retaining REFERENCE payloads) and
+	* returns, the listeners run on a ThreadPool worker. At most one worker
+	* drains a queue at a time, so its listeners see messages in order, and a
+	* worker hands the queue back to the pool after a batch so one busy queue
+	* cannot starve the others.
+	*
+	* With DispatchOptions::prioritize the queued messages are kept in a
+	* PriorityScheduler with one class per UPriority, so CS5 and CS6 overtake
+	* everything queued before them and CS0 to CS4 share the rest by weight.
+	* Capacity and overflow still apply to the queue as a whole; every class
+	* preallocates room for capacity messages. COALESCE_LATEST queues always
+	* deliver in arrival order.
+	*
+	* onReceive() reports backpressure through its status: OK when the message
+	* is queued (or coalesced), RESOURCE_EXHAUSTED when it was dropped and
+	* UNAVAILABLE once the queue is detached. The depth and lag signals are
+	* also available as isThrottled() and through DispatchOptions::onPressure.
+	*/
+	class ListenerQueue : public UListener {
+
+		public:
+
+			ListenerQueue(const ListenerQueue &) = delete;
+			ListenerQueue & operator=(const ListenerQueue &) = delete;
+
+			uprotocol::v1::UStatus onReceive(UMessage &message) const override;
+
+			/**
+			* @return number of queued messages
+			*/
+			size_t depth() const {
+				return depth_.load(std::memory_order_relaxed);
+			}
+
+			/**
+			* @return time the oldest queued message has been waiting, zero if the queue is empty
+			*/
+			std::chrono::nanoseconds lag() const;
+
+			/**
+			* @return true while the queue asks its producer to slow down
+			*/
+			bool isThrottled() const {
+				return throttled_.load(std::memory_order_acquire);
+			}
+
+			/**
+			* @return number of messages rejected because the queue was full
+			*/
+			size_t dropped() const {
+				return dropped_.load(std::memory_order_relaxed);
+			}
+
+			/**
+			* @return number of queued messages replaced by a newer one of the same topic
+			*/
+			size_t coalesced() const {
+				return coalesced_.load(std::memory_order_relaxed);
+			}
+
+		private:
+
+			friend class ListenerDispatcher;
+
+			/* number of messages a worker delivers before handing the queue back to the pool */
+			static constexpr size_t BatchSize = 32;
+
+			struct Entry {
+				UMessage message;
+				std::chrono::steady_clock::time_point queued;
+				std::string topic;
+			};
+
+			using Scheduler = uprotocol::utils::PriorityScheduler<Entry, PriorityLevels>;
+
+			static std::unique_ptr<Scheduler> makeScheduler(const DispatchOptions &options);
+
+			ListenerQueue(ListenerDispatcher &dispatcher,
+						  std::vector<const UListener *> listeners,
+						  const DispatchOptions &options);
+
+			/* number of queued messages and when the oldest one was queued, the caller holds mutex_ */
+			size_t queued() const;
+			bool oldest(std::chrono::steady_clock::time_point &since) const;
+
+			/* deliver queued messages until the queue is empty, called on a pool worker */
+			void drain() const;
+
+			/* post a drain task, draining on the calling thread if the pool refuses it
+			 * @return false if the calling thread drained the queue */
+			bool schedule() const;
+
+			/* re-evaluate the throttle signal, the caller holds mutex_
+			 * @return true if the signal changed */
+			bool updatePressure(std::chrono::steady_clock::time_point now) const;
+
+			/* hand the current throttle signal to onPressure if it was not handed over
+			 * yet, the caller does not hold mutex_ */
+			void signal() const;
+
+			/* reject new messages and wait until the queued ones are delivered */
+			void close();
+
+			ListenerDispatcher &dispatcher_;
+			const std::vector<const UListener *> listeners_;
+			const DispatchOptions options_;
+			const size_t highWatermark_;
+			const size_t lowWatermark_;
+
+			/* the queue is mutated behind the const UListener interface */
+			mutable std::mutex mutex_;
+			mutable std::deque<Entry> entries_;
+			/* holds the entries in place of entries_ for a prioritized queue */
+			const std::unique_ptr<Scheduler> scheduler_;
+			/* queued topic -> sequence number of its newest entry, COALESCE_LATEST only */
+			mutable std::unordered_map<std::string, uint64_t> latest_;
+			/* sequence number of entries_.front() */
+			mutable uint64_t head_ = 0;
+			mutable bool scheduled_ = false;
+			mutable bool closed_ = false;
+
+			/* posted when an entry leaves the queue */
+			mutable uprotocol::utils::Futex space_;
+
+			mutable std::mutex signalMutex_;
+			mutable bool signalled_ = false;
+
+			mutable std::atomic<size_t> depth_ { 0 };
+			mutable std::atomic<bool> throttled_ { false };
+			mutable std::atomic<size_t> dropped_ { 0 };
+			mutable std::atomic<size_t> coalesced_ { 0 };
+	};
+
+	/**
+	* Runs listeners off the transport's receive thread.
+	*
+	* attach() creates a ListenerQueue for a listener (or a group of listeners
+	* sharing one queue); register the returned queue with the transport in
+	* place of the listener. The queues are owned by the dispatcher and drained
+	* by the pool's workers.
+	*/
+	class ListenerDispatcher {
+
+		public:
+
+			/**
+			* @param pool pool running the listeners, must outlive the dispatcher
+			*/
+			explicit ListenerDispatcher(uprotocol::utils::ThreadPool &pool);
+
+			ListenerDispatcher(const ListenerDispatcher &) = delete;
+			ListenerDispatcher & operator=(const ListenerDispatcher &) = delete;
+
+			/**
+			* Delivers the queued messages and waits for the pool tasks referring to
+			* the dispatcher; the queues must be unregistered from their transports
+			* first and this must not be called from one of the pool's workers.
+			*/
+			~ListenerDispatcher();
+
+			/**
+			* Create a queue in front of listener, which must outlive the queue.
+			*/
+			ListenerQueue & attach(const UListener &listener,
+								   const DispatchOptions &options = DispatchOptions());
+
+			/**
+			* Create a queue shared by a group of listeners, each queued message is
+			* delivered to all of them in order.
+			*/
+			ListenerQueue & attach(std::vector<const UListener *> listeners,
+								   const DispatchOptions &options = DispatchOptions());
+
+			/**
+			* Close a queue, deliver what it still holds and destroy it; it must be
+			* unregistered from its transport first.
+			* @return OK, NOT_FOUND if the queue does not belong to this dispatcher
+			*/
+			uprotocol::v1::UStatus detach(const ListenerQueue &queue);
+
+			/**
+			* @return number of queues currently asking their producer to slow down
+			*/
+			size_t throttled() const {
+				return throttled_.load(std::memory_order_acquire);
+			}
+
+			/**
+			* @return number of messages queued over all queues
+			*/
+			size_t depth() const;
+
+		private:
+
+			friend class ListenerQueue;
+
+			uprotocol::utils::ThreadPool &pool_;
+
+			mutable std::mutex mutex_;
+			std::vector<std::unique_ptr<ListenerQueue>> queues_;
+
+			/* pool tasks posted and not finished yet */
+			std::atomic<size_t> tasks_ { 0 };
+			std::atomic<size_t> throttled_ { 0 };
+	};
+}
+
+#endif /* _LISTENER_DISPATCHER_H_ */
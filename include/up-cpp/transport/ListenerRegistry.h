@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _LISTENER_REGISTRY_H_
+#define _LISTENER_REGISTRY_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <up-cpp/transport/UListener.h>
+#include <up-core-api/uri.pb.h>
+#include <up-core-api/ustatus.pb.h>
+
+namespace uprotocol::utransport {
+
+	/**
+	* Reusable URI -> listener index for UTransport implementations.
+	*
+	* Listeners are indexed on the micro form of the URI: authority, entity id,
+	* major version and resource id. A part left out of the registered URI is a
+	* wildcard (no authority, entity id 0, no major version, resource id 0), so
+	* a message is matched by probing at most one hash bucket per wildcard
+	* combination that is actually registered, independent of the number of
+	* registrations.
+	*
+	* The buckets are copy-on-write snapshots: lookups bump a reader counter and
+	* load a plain atomic pointer, so they never take a lock; registration copies
+	* the one bucket it changes and swaps it in.
+	*
+	* Registration then waits for a grace period: every lookup that may still see
+	* the previous bucket has returned before registerListener / unregisterListener
+	* do, and only then is that bucket freed. Once unregisterListener returned, no
+	* lookup calls the listener anymore and it may be destroyed. The readers are
+	* counted in two epochs that the writer flips, so lookups that start during the
+	* wait do not prolong it. A listener may unregister from inside its own
+	* dispatch, the calling thread's own lookups are not waited for; two
+	* dispatches that unregister each other's listeners wait on each other.
+	*/
+	class ListenerRegistry {
+
+		public:
+
+			static constexpr size_t DefaultBuckets = 4096;
+
+			explicit ListenerRegistry(size_t buckets = DefaultBuckets)
+				: bucketCount_((0 == buckets) ? 1 : buckets),
+				  buckets_(new std::atomic<const Bucket *>[bucketCount_]) {
+				for (size_t i = 0; i < bucketCount_; ++i) {
+					buckets_[i].store(new Bucket(), std::memory_order_relaxed);
+				}
+			}
+
+			/**
+			* No lookup may be running.
+			*/
+			~ListenerRegistry() {
+				for (size_t i = 0; i < bucketCount_; ++i) {
+					delete buckets_[i].load(std::memory_order_relaxed);
+				}
+			}
+
+			ListenerRegistry(const ListenerRegistry &) = delete;
+			ListenerRegistry & operator=(const ListenerRegistry &) = delete;
+
+			/**
+			* Register a listener for a URI (pattern), waits for a grace period.
+			* @return OK, ALREADY_EXISTS if the listener is registered for the same
+			* pattern, INVALID_ARGUMENT if the URI names an entity or resource without its id
+			*/
+			uprotocol::v1::UStatus registerListener(const uprotocol::v1::UUri &uri,
+													const UListener &listener) {
+				Probe key;
+				if (false == makePattern(uri, key)) {
+					return status(uprotocol::v1::UCode::INVALID_ARGUMENT);
+				}
+
+				std::unique_lock<std::mutex> lock(writeMutex_);
+
+				auto &slot = buckets_[bucketOf(key)];
+				const auto *current = slot.load(std::memory_order_relaxed);
+				auto entry = std::find_if(current->begin(), current->end(),
+										  [&key](const Entry &e) { return e.key == key; });
+				if ((current->end() != entry) &&
+					(entry->listeners.end() != std::find(entry->listeners.begin(), entry->listeners.end(), &listener))) {
+					return status(uprotocol::v1::UCode::ALREADY_EXISTS);
+				}
+
+				auto bucket = std::make_unique<Bucket>(*current);
+				if (current->end() == entry) {
+					bucket->push_back(Entry{Key{key.pattern, key.authorityKind, std::string(key.authority),
+												key.entity, key.version, key.resource},
+											{&listener}});
+				} else {
+					(*bucket)[static_cast<size_t>(entry - current->begin())].listeners.push_back(&listener);
+				}
+				auto previous = publish(slot, std::move(bucket));
+
+				if (0 == patternCount_[key.pattern]++) {
+					patterns_.fetch_or(static_cast<uint16_t>(1U << key.pattern), std::memory_order_release);
+				}
+				++size_;
+
+				lock.unlock();
+				synchronize();
+
+				return status(uprotocol::v1::UCode::OK);
+			}
+
+			/**
+			* Unregister a listener from a URI (pattern) it was registered with.
+			* Waits for a grace period, so no lookup calls the listener for this
+			* pattern once it returned.
+			* @return OK, NOT_FOUND if the listener is not registered for the pattern
+			*/
+			uprotocol::v1::UStatus unregisterListener(const uprotocol::v1::UUri &uri,
+													  const UListener &listener) {
+				Probe key;
+				if (false == makePattern(uri, key)) {
+					return status(uprotocol::v1::UCode::INVALID_ARGUMENT);
+				}
+
+				std::unique_lock<std::mutex> lock(writeMutex_);
+
+				auto &slot = buckets_[bucketOf(key)];
+				const auto *current = slot.load(std::memory_order_relaxed);
+				auto entry = std::find_if(current->begin(), current->end(),
+										  [&key](const Entry &e) { return e.key == key; });
+				if ((current->end() == entry) ||
+					(entry->listeners.end() == std::find(entry->listeners.begin(), entry->listeners.end(), &listener))) {
+					return status(uprotocol::v1::UCode::NOT_FOUND);
+				}
+
+				auto bucket = std::make_unique<Bucket>(*current);
+				auto &listeners = (*bucket)[static_cast<size_t>(entry - current->begin())].listeners;
+				listeners.erase(std::find(listeners.begin(), listeners.end(), &listener));
+				if (listeners.empty()) {
+					bucket->erase(bucket->begin() + (entry - current->begin()));
+				}
+				auto previous = publish(slot, std::move(bucket));
+
+				if (0 == --patternCount_[key.pattern]) {
+					patterns_.fetch_and(static_cast<uint16_t>(~(1U << key.pattern)), std::memory_order_release);
+				}
+				--size_;
+
+				lock.unlock();
+				synchronize();
+
+				return status(uprotocol::v1::UCode::OK);
+			}
+
+			/**
+			* Call func(const UListener &) for every listener whose pattern matches uri.
+			* Never blocks on concurrent registration.
+			* @return number of matching listeners
+			*/
+			template<typename F>
+			size_t forEachListener(const uprotocol::v1::UUri &uri, F &&func) const {
+				const ReadGuard guard(*this);
+				const auto exact = makeProbe(uri);
+
+				size_t matches = 0;
+				auto patterns = patterns_.load(std::memory_order_acquire);
+				while (0 != patterns) {
+					auto pattern = static_cast<uint8_t>(__builtin_ctz(patterns));
+					patterns &= static_cast<uint16_t>(patterns - 1);
+
+					auto probe = exact.masked(pattern);
+					const auto *bucket = buckets_[bucketOf(probe)].load(std::memory_order_seq_cst);
+					for (const auto &entry : *bucket) {
+						if (entry.key == probe) {
+							for (const auto *listener : entry.listeners) {
+								func(*listener);
+								++matches;
+							}
+							break;
+						}
+					}
+				}
+
+				return matches;
+			}
+
+			/**
+			* Deliver a message to every listener matching uri.
+			* @return number of listeners called
+			*/
+			size_t dispatch(const uprotocol::v1::UUri &uri, UMessage &message) const {
+				return forEachListener(uri, [&message](const UListener &listener) {
+					listener.onReceive(message);
+				});
+			}
+
+			/**
+			* @return number of (pattern, listener) registrations
+			*/
+			size_t size() const {
+				std::lock_guard<std::mutex> lock(writeMutex_);
+				return size_;
+			}
+
+		private:
+
+			/* pattern bits, set for every part the registration is specific about */
+			static constexpr uint8_t AuthorityBit = 1U << 0;
+			static constexpr uint8_t EntityBit = 1U << 1;
+			static constexpr uint8_t VersionBit = 1U << 2;
+			static constexpr uint8_t ResourceBit = 1U << 3;
+			static constexpr size_t Patterns = 16;
+
+			/* a lookup key, viewing the authority bytes of the URI it was made from */
+			struct Probe {
+				uint8_t pattern = 0;
+				/* 0 local, 1 ip, 2 id, 3 name */
+				uint8_t authorityKind = 0;
+				std::string_view authority;
+				uint32_t entity = 0;
+				uint32_t version = 0;
+				uint32_t resource = 0;
+
+				Probe masked(uint8_t mask) const {
+					Probe probe;
+					probe.pattern = mask;
+					if (0 != (mask & AuthorityBit)) {
+						probe.authorityKind = authorityKind;
+						probe.authority = authority;
+					}
+					probe.entity = (0 != (mask & EntityBit)) ? entity : 0;
+					probe.version = (0 != (mask & VersionBit)) ? version : 0;
+					probe.resource = (0 != (mask & ResourceBit)) ? resource : 0;
+					return probe;
+				}
+			};
+
+			/* a registered pattern, owning its authority bytes */
+			struct Key {
+				uint8_t pattern = 0;
+				uint8_t authorityKind = 0;
+				std::string authority;
+				uint32_t entity = 0;
+				uint32_t version = 0;
+				uint32_t resource = 0;
+
+				bool operator==(const Probe &probe) const {
+					return pattern == probe.pattern && entity == probe.entity &&
+						version == probe.version && resource == probe.resource &&
+						authorityKind == probe.authorityKind && authority == probe.authority;
+				}
+			};
+
+			struct Entry {
+				Key key;
+				std::vector<const UListener *> listeners;
+			};
+
+			using Bucket = std::vector<Entry>;
+
+			struct alignas(64) ReaderCount {
+				std::atomic<size_t> value { 0 };
+			};
+
+			/* lookups running on this thread, to not wait for them from inside a dispatch */
+			struct Reading {
+				static constexpr size_t MaxDepth = 16;
+				const ListenerRegistry *registry[MaxDepth] = {};
+				uint32_t epoch[MaxDepth] = {};
+				size_t depth = 0;
+			};
+
+			static Reading &reading() {
+				static thread_local Reading reading;
+				return reading;
+			}
+
+			/* a running lookup, counted in the epoch it started in */
+			class ReadGuard {
+				public:
+					explicit ReadGuard(const ListenerRegistry &registry) : registry_(registry) {
+						epoch_ = registry_.epoch_.load(std::memory_order_seq_cst) & 1U;
+						registry_.readers_[epoch_].value.fetch_add(1, std::memory_order_seq_cst);
+						auto &reading = ListenerRegistry::reading();
+						if (reading.depth < Reading::MaxDepth) {
+							reading.registry[reading.depth] = &registry_;
+							reading.epoch[reading.depth] = epoch_;
+						}
+						++reading.depth;
+					}
+
+					~ReadGuard() {
+						--ListenerRegistry::reading().depth;
+						registry_.readers_[epoch_].value.fetch_sub(1, std::memory_order_release);
+					}
+
+					ReadGuard(const ReadGuard &) = delete;
+					ReadGuard & operator=(const ReadGuard &) = delete;
+
+				private:
+					const ListenerRegistry &registry_;
+					uint32_t epoch_;
+			};
+
+			/* lookups of this registry counted in epoch that run on the calling thread */
+			size_t ownReaders(uint32_t epoch) const {
+				const auto &reading = ListenerRegistry::reading();
+				size_t own = 0;
+				const auto depth = std::min(reading.depth, Reading::MaxDepth);
+				for (size_t i = 0; i < depth; ++i) {
+					if ((this == reading.registry[i]) && (epoch == reading.epoch[i])) {
+						++own;
+					}
+				}
+				return own;
+			}
+
+			/*
+			* Wait until every lookup that may have loaded a bucket before the last
+			* publish() returned. A lookup counts itself before it loads a bucket, so
+			* seeing both epoch counters drained (down to the calling thread's own
+			* lookups) once is enough; a lookup counted later loads the new bucket.
+			* The epoch is flipped away from the counter being drained, so lookups
+			* starting meanwhile do not prolong the wait. Runs without the write
+			* lock and may overlap with other writers.
+			*/
+			void synchronize() const {
+				for (uint32_t epoch = 0; epoch < 2; ++epoch) {
+					const auto own = ownReaders(epoch);
+					while (readers_[epoch].value.load(std::memory_order_seq_cst) > own) {
+						auto current = epoch_.load(std::memory_order_seq_cst);
+						if (epoch == (current & 1U)) {
+							epoch_.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+						}
+						std::this_thread::yield();
+					}
+				}
+			}
+
+			/* swap a bucket in, the previous one may only be freed after synchronize() */
+			static std::unique_ptr<const Bucket> publish(std::atomic<const Bucket *> &slot,
+														 std::unique_ptr<Bucket> bucket) {
+				return std::unique_ptr<const Bucket>(slot.exchange(bucket.release(), std::memory_order_seq_cst));
+			}
+
+			/* the fully specific probe of a message URI */
+			static Probe makeProbe(const uprotocol::v1::UUri &uri) {
+				Probe probe;
+				probe.pattern = AuthorityBit | EntityBit | VersionBit | ResourceBit;
+				const auto &authority = uri.authority();
+				if (authority.has_ip() && !authority.ip().empty()) {
+					probe.authorityKind = 1;
+					probe.authority = authority.ip();
+				} else if (authority.has_id() && !authority.id().empty()) {
+					probe.authorityKind = 2;
+					probe.authority = authority.id();
+				} else if (authority.has_name() && !authority.name().empty()) {
+					probe.authorityKind = 3;
+					probe.authority = authority.name();
+				}
+				probe.entity = uri.entity().id();
+				probe.version = uri.entity().version_major();
+				probe.resource = uri.resource().id();
+				return probe;
+			}
+
+			/* the probe of a registration, with wildcards for the parts left out */
+			static bool makePattern(const uprotocol::v1::UUri &uri, Probe &probe) {
+				const auto &entity = uri.entity();
+				const auto &resource = uri.resource();
+				if ((0 == entity.id()) && !entity.name().empty()) {
+					return false;
+				}
+				if ((0 == resource.id()) &&
+					(!resource.name().empty() || !resource.instance().empty() || !resource.message().empty())) {
+					return false;
+				}
+
+				uint8_t pattern = 0;
+				pattern |= uri.has_authority() ? AuthorityBit : 0;
+				pattern |= (0 != entity.id()) ? EntityBit : 0;
+				pattern |= entity.has_version_major() ? VersionBit : 0;
+				pattern |= (0 != resource.id()) ? ResourceBit : 0;
+				probe = makeProbe(uri).masked(pattern);
+
+				return true;
+			}
+
+			size_t bucketOf(const Probe &probe) const {
+				uint64_t hash = std::hash<std::string_view>{}(probe.authority);
+				hash ^= (static_cast<uint64_t>(probe.entity) << 32) | probe.resource;
+				hash ^= (static_cast<uint64_t>(probe.version) << 16) |
+					(static_cast<uint64_t>(probe.authorityKind) << 8) | probe.pattern;
+				hash *= 0x9E3779B97F4A7C15ULL;
+				return static_cast<size_t>((hash >> 32) % bucketCount_);
+			}
+
+			static uprotocol::v1::UStatus status(uprotocol::v1::UCode code) {
+				uprotocol::v1::UStatus result;
+				result.set_code(code);
+				return result;
+			}
+
+			const size_t bucketCount_;
+			std::unique_ptr<std::atomic<const Bucket *>[]> buckets_;
+			std::atomic<uint16_t> patterns_ { 0 };
+			mutable std::atomic<uint32_t> epoch_ { 0 };
+			mutable ReaderCount readers_[2];
+			size_t patternCount_[Patterns] = {};
+			size_t size_ = 0;
+			mutable std::mutex writeMutex_;
+	};
+}
+
+#endif /* _LISTENER_REGISTRY_H_ */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _LOOPBACK_TRANSPORT_H_
+#define _LOOPBACK_TRANSPORT_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <up-cpp/transport/ListenerDispatcher.h>
+#include <up-cpp/transport/ListenerRegistry.h>
+#include <up-cpp/transport/UTransport.h>
+#include <up-cpp/utils/ThreadPool.h>
+
+namespace uprotocol::utransport {
+
+	/**
+	* UTransport delivering messages to listeners of the same process, matched
+	* on the message's source URI through a ListenerRegistry.
+	*
+	* Without a pool the listeners run inside send() on the sender's thread,
+	* which is the cheapest path between components of one binary and measures
+	* the library's own overhead without any network cost. With a pool every
+	* listener gets a ListenerQueue of its own and send() only queues the message,
+	* reporting the queue's backpressure status.
+	*
+	* All listeners matching a message share one copy of it per send(); payload
+	* bytes are never copied.
+	*/
+	class LoopbackTransport : public UTransport {
+
+		public:
+
+			/**
+			* Synchronous delivery on the sender's thread.
+			*/
+			LoopbackTransport() = default;
+
+			/**
+			* Delivery on pool workers.
+			* @param pool pool running the listeners, must outlive the transport
+			* @param options options of every listener's queue
+			*/
+			explicit LoopbackTransport(uprotocol::utils::ThreadPool &pool,
+									   const DispatchOptions &options = DispatchOptions());
+
+			LoopbackTransport(const LoopbackTransport &) = delete;
+			LoopbackTransport & operator=(const LoopbackTransport &) = delete;
+
+			/**
+			* Delivers the messages still queued; no send() may be running.
+			*/
+			~LoopbackTransport() override;
+
+			/**
+			* Deliver a message to the listeners of its source URI.
+			* @return OK (also when no listener matches), otherwise the first failure
+			* returned by a listener or, with a pool, by a listener's queue
+			*/
+			uprotocol::v1::UStatus send(const UMessage &message) override;
+
+			uprotocol::v1::UStatus registerListener(const uprotocol::v1::UUri &uri,
+													const UListener &listener) override;
+
+			/**
+			* With a pool, unregistering the last URI of a listener waits for its queue
+			* to be delivered, so it must not be called from that listener.
+			*/
+			uprotocol::v1::UStatus unregisterListener(const uprotocol::v1::UUri &uri,
+													  const UListener &listener) override;
+
+			/**
+			* @return true if listeners run on a pool
+			*/
+			bool isPooled() const {
+				return nullptr != dispatcher_;
+			}
+
+			/**
+			* @return the dispatcher of the listener queues, nullptr without a pool
+			*/
+			const ListenerDispatcher * dispatcher() const {
+				return dispatcher_.get();
+			}
+
+		private:
+
+			struct Queued {
+				ListenerQueue *queue;
+				/* number of URIs the listener is registered for */
+				size_t registrations;
+			};
+
+			ListenerRegistry registry_;
+
+			const DispatchOptions options_ {};
+			std::unique_ptr<ListenerDispatcher> dispatcher_;
+			std::mutex queuesMutex_;
+			std::unordered_map<const UListener *, Queued> queues_;
+	};
+}
+
+#endif /* _LOOPBACK_TRANSPORT_H_ */
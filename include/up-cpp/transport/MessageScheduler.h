@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _MESSAGE_SCHEDULER_H_
+#define _MESSAGE_SCHEDULER_H_
+
+#include <cstddef>
+#include <up-core-api/uattributes.pb.h>
+#include <up-cpp/transport/datamodel/UMessage.h>
+#include <up-cpp/utils/PriorityScheduler.h>
+
+namespace uprotocol::utransport {
+
+	/** Number of uProtocol priority classes, CS0 to CS6 */
+	static constexpr size_t PriorityLevels = 7U;
+
+	/**
+	* Priority queue of messages for listener dispatch and send paths, one
+	* class per UPriority. With MessageScheduler::defaultOptions() CS5 and CS6
+	* are served with strict priority and CS0 to CS4 share by weight.
+	*/
+	using MessageScheduler = uprotocol::utils::PriorityScheduler<UMessage, PriorityLevels>;
+
+	/**
+	* @return scheduler level of a message, UPRIORITY_UNSPECIFIED is CS1 (the uProtocol default)
+	*/
+	inline size_t priorityLevel(const uprotocol::v1::UAttributes &attributes) {
+		const auto priority = attributes.priority();
+		if ((priority < uprotocol::v1::UPRIORITY_CS0) || (priority > uprotocol::v1::UPRIORITY_CS6)) {
+			return static_cast<size_t>(uprotocol::v1::UPRIORITY_CS1 - uprotocol::v1::UPRIORITY_CS0);
+		}
+		return static_cast<size_t>(priority - uprotocol::v1::UPRIORITY_CS0);
+	}
+
+	/**
+	* Queue a message in the class of its priority attribute
+	* @return false if the class is full and rejects new messages
+	*/
+	inline bool schedule(MessageScheduler &scheduler, UMessage &message) {
+		return scheduler.push(priorityLevel(message.attributes()), message);
+	}
+}
+
+#endif /* _MESSAGE_SCHEDULER_H_ */
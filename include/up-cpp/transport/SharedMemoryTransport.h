@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _SHARED_MEMORY_TRANSPORT_H_
+#define _SHARED_MEMORY_TRANSPORT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <up-cpp/transport/ListenerRegistry.h>
+#include <up-cpp/transport/UTransport.h>
+
+namespace uprotocol::utransport {
+
+	/**
+	* Layout of a shared memory segment, fixed by its creator.
+	*/
+	struct SharedMemoryOptions {
+		/* number of message slots */
+		size_t slots = 256;
+		/* largest payload a slot holds */
+		size_t payloadCapacity = 64 * 1024;
+		/* largest serialized UAttributes a slot holds */
+		size_t attributesCapacity = 1024;
+		/* number of subscribers that can attach at the same time */
+		size_t subscribers = 8;
+		/* messages a subscriber can lag behind, rounded up to a power of two */
+		size_t ringCapacity = 256;
+	};
+
+	/**
+	* Reference UTransport between processes of one host, over a POSIX shared
+	* memory segment.
+	*
+	* The creator of the segment is its only publisher. Every message is written
+	* once into a reference counted slot of the segment and the slot index is
+	* pushed to a single producer / single consumer ring per attached subscriber,
+	* so a subscriber receives a SHARED payload pointing straight into the
+	* segment, without copying it. A payload obtained with loan() is filled in
+	* place and is not copied by send() either. Neither side makes a syscall per
+	* message while the subscriber keeps up: the subscriber's thread is only
+	* woken through a futex in the segment when it went to sleep on an empty ring.
+	*
+	* Subscribers receive every message of the segment and deliver it to the
+	* listeners registered for the message's source URI. Listeners registered
+	* with the creator are called directly by send(), after the slot is
+	* published, so they may send themselves. Every receiver gets a read-only
+	* view of the slot: mutableData() copies it instead of changing what the
+	* other receivers read. A slot is reused once every subscriber and every
+	* payload copy released it; a full ring drops the messages for that
+	* subscriber only.
+	*
+	* A subscriber that dies while attached keeps its ring and slots; recovering
+	* them is left to the deployment (e.g. recreating the segment).
+	*/
+	class SharedMemoryTransport : public UTransport {
+
+		public:
+
+			/**
+			* Create (or replace) the segment name as its publisher.
+			* @param name POSIX shared memory name, e.g. "/body.access"
+			* @return the transport, nullptr if the segment could not be created
+			*/
+			static std::unique_ptr<SharedMemoryTransport> create(const std::string &name,
+																 const SharedMemoryOptions &options = SharedMemoryOptions());
+
+			/**
+			* Attach to the segment name as a subscriber.
+			* @return the transport, nullptr if the segment does not exist, is not a
+			* segment of this transport or has no free subscriber ring
+			*/
+			static std::unique_ptr<SharedMemoryTransport> open(const std::string &name);
+
+			SharedMemoryTransport(const SharedMemoryTransport &) = delete;
+			SharedMemoryTransport & operator=(const SharedMemoryTransport &) = delete;
+
+			/**
+			* Detaches a subscriber, releasing the messages it did not receive; the
+			* creator removes the segment name. Payloads still held stay valid.
+			*/
+			~SharedMemoryTransport() override;
+
+			/**
+			* Publish a message to the listeners of the creator and to every subscriber.
+			* @return OK, RESOURCE_EXHAUSTED if no slot is free or a subscriber ring was
+			* full (the other subscribers still receive the message), INVALID_ARGUMENT if
+			* the message does not fit a slot, FAILED_PRECONDITION for a subscriber
+			*/
+			uprotocol::v1::UStatus send(const UMessage &message) override;
+
+			uprotocol::v1::UStatus registerListener(const uprotocol::v1::UUri &uri,
+													const UListener &listener) override;
+
+			uprotocol::v1::UStatus unregisterListener(const uprotocol::v1::UUri &uri,
+													  const UListener &listener) override;
+
+			/**
+			* Reserve a slot for a payload of size bytes, to be written through
+			* mutableData() and then sent without being copied. It must not be
+			* written after it was sent.
+			* @return SHARED payload into the segment, empty if no slot is free, size is
+			* too large or this is a subscriber
+			*/
+			UPayload loan(size_t size);
+
+			/**
+			* @return true for the creator of the segment
+			*/
+			bool isPublisher() const {
+				return publisher_;
+			}
+
+			/**
+			* @return messages not delivered to a subscriber because its ring was full
+			*/
+			size_t dropped() const {
+				return dropped_.load(std::memory_order_relaxed);
+			}
+
+			/**
+			* @return number of slots currently holding a message or a loan
+			*/
+			size_t slotsInUse() const;
+
+		private:
+
+			struct Segment;
+			struct Slot;
+			struct Ring;
+
+			SharedMemoryTransport(std::shared_ptr<Segment> segment, bool publisher, size_t ring);
+
+			/* claim a free slot as a loan, nullptr if none; the caller holds sendMutex_ */
+			Slot *allocate();
+
+			/* the slot of a payload loaned from this segment and not sent yet, nullptr otherwise */
+			Slot *loanedSlot(const UPayload &payload) const;
+
+			/* payload sharing slot, releasing it when the last copy goes; only a loan is
+			 * written in place by mutableData() */
+			UPayload payloadOf(Slot *slot, size_t size, bool loaned) const;
+
+			void receiveLoop();
+
+			bool deliver(Ring &ring, uint64_t pos);
+
+			std::shared_ptr<Segment> segment_;
+			const bool publisher_;
+			/* subscriber ring index */
+			const size_t ring_;
+
+			std::mutex sendMutex_;
+			size_t cursor_ = 0;
+			std::atomic<size_t> dropped_ { 0 };
+
+			ListenerRegistry listeners_;
+
+			std::atomic<bool> terminate_ { false };
+			std::thread receiveThread_;
+	};
+}
+
+#endif /* _SHARED_MEMORY_TRANSPORT_H_ */
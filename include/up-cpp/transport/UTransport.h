@@ -28,14 +28,22 @@
 
 #include <stdint.h>
 #include <cstddef>
+#include <utility>
 #include <up-cpp/transport/UListener.h>
 #include <up-cpp/transport/datamodel/UPayload.h>
+#include <up-cpp/utils/InplaceFunction.h>
 #include <up-core-api/uri.pb.h>
 #include <up-core-api/ustatus.pb.h>
 #include <up-core-api/uattributes.pb.h>
 
 namespace uprotocol::utransport {
 
+     /**
+     * Callback receiving the final status of an asynchronous send. It is stored in place,
+     * so a completion never allocates.
+     */
+     using SendCompletion = uprotocol::utils::InplaceFunction<void(const uprotocol::v1::UStatus &)>;
+
      class UTransport {
 
           public:
@@ -48,6 +56,58 @@ namespace uprotocol::utransport {
                */
                virtual uprotocol::v1::UStatus send(const uprotocol::utransport::UMessage &message) = 0;
 
+               /**
+               * Transmit a batch of messages. Transports that can frame several messages at once
+               * should override this, the default implementation calls send() for each message.
+               * @param messages array of count messages to be sent
+               * @param count number of messages
+               * @param statuses optional array of count statuses, receives the result of each message
+               * @return Returns OKSTATUS if all messages have been sent, otherwise the status of the
+               * first message that failed.
+               */
+               virtual uprotocol::v1::UStatus sendBatch(const uprotocol::utransport::UMessage *messages,
+                                                        size_t count,
+                                                        uprotocol::v1::UStatus *statuses = nullptr) {
+                    uprotocol::v1::UStatus result;
+                    result.set_code(uprotocol::v1::UCode::OK);
+
+                    for (size_t i = 0; i < count; ++i) {
+                         auto status = send(messages[i]);
+                         if ((uprotocol::v1::UCode::OK != status.code()) &&
+                             (uprotocol::v1::UCode::OK == result.code())) {
+                              result = status;
+                         }
+                         if (nullptr != statuses) {
+                              statuses[i] = std::move(status);
+                         }
+                    }
+
+                    return result;
+               }
+
+               /**
+               * Transmit a message without waiting for it to be ACK'ed.
+               * Transports that are natively asynchronous should override this and call onComplete
+               * (for instance through a CompletionExecutor) once the ACK or the failure arrives.
+               * The default implementation calls send() and then onComplete on the calling thread,
+               * use CompletionExecutor::send to run a blocking send() off the caller's thread instead.
+               * @param message message to be sent
+               * @param onComplete called exactly once with the final status, only if the message was
+               * accepted; may be empty when the caller does not need the status
+               * @return Returns OKSTATUS if the message has been accepted for transmission, otherwise
+               * FAILSTATUS and onComplete is not called.
+               */
+               virtual uprotocol::v1::UStatus sendAsync(const uprotocol::utransport::UMessage &message,
+                                                        SendCompletion &&onComplete) {
+                    auto status = send(message);
+                    if (onComplete) {
+                         onComplete(status);
+                    }
+
+                    status.set_code(uprotocol::v1::UCode::OK);
+                    return status;
+               }
+
                /**
                * Register listener to be called when UPayload is received for the specific topic.
                * @param topic Resolved UUri for where the message arrived via the underlying transport technology.
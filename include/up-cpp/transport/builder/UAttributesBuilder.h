@@ -28,6 +28,7 @@
 
 #include <string>
 #include <spdlog/spdlog.h>
+#include <up-cpp/utils/ProtoTarget.h>
 #include <up-cpp/uuid/factory/Uuidv8Factory.h>
 #include <up-core-api/uattributes.pb.h>
 #include <up-core-api/uuid.pb.h>
@@ -39,13 +40,24 @@ namespace uprotocol::utransport {
 /// The class provides a fluent interface to build UAttributes objects with the desired attributes.
 class UAttributesBuilder {
     private:
-        uprotocol::v1::UAttributes attributes_;
+        uprotocol::utils::ProtoTarget<uprotocol::v1::UAttributes> attributes_;
 
     public:
         UAttributesBuilder() {
-            attributes_.Clear();
+            attributes_->Clear();
         }
 
+        /// @brief Constructor for UAttributesBuilder writing into a UAttributes allocated on arena.
+        ///
+        /// The attributes and all nested messages live on the arena and are released with it.
+        /// @param arena The arena to allocate the UAttributes object on.
+        explicit UAttributesBuilder(google::protobuf::Arena* arena) : attributes_(arena) {}
+
+        /// @brief Constructor for UAttributesBuilder writing directly into an existing UAttributes.
+        ///
+        /// @param target The UAttributes object to fill, e.g. UMessage::mutableAttributes().
+        explicit UAttributesBuilder(uprotocol::v1::UAttributes* target) : attributes_(target) {}
+
         /// @brief Constructor for UAttributesBuilder.
         ///
         /// The constructor initializes the UAttributes object with the required attributes that 
@@ -55,16 +67,18 @@ class UAttributesBuilder {
         /// @param id The unique identifier of the message.
         /// @param type The type of the message.
         /// @param priority The priority of the message.
+        /// @param arena Optional arena to allocate the UAttributes object on.
         UAttributesBuilder(uprotocol::v1::UUri source,
                            const uprotocol::v1::UUID& id, 
                            uprotocol::v1::UMessageType type, 
-                           uprotocol::v1::UPriority priority) {
+                           uprotocol::v1::UPriority priority,
+                           google::protobuf::Arena* arena = nullptr) : attributes_(arena) {
 
-            attributes_.Clear();
-            attributes_.mutable_id()->CopyFrom(id);
-            attributes_.mutable_source()->CopyFrom(source);
-            attributes_.set_type(type);
-            attributes_.set_priority(priority);
+            attributes_->Clear();
+            attributes_->mutable_id()->CopyFrom(id);
+            *attributes_->mutable_source() = std::move(source);
+            attributes_->set_type(type);
+            attributes_->set_priority(priority);
         }
 
         /// @brief Set the token attribute of the UAttributes object.
@@ -73,7 +87,7 @@ class UAttributesBuilder {
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setToken(const std::string& token) {
 
-            attributes_.set_token(token);
+            attributes_->set_token(token);
             return *this;
         }
 
@@ -83,7 +97,7 @@ class UAttributesBuilder {
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setId(const uprotocol::v1::UUID& id) {
 
-            attributes_.mutable_id()->CopyFrom(id);
+            attributes_->mutable_id()->CopyFrom(id);
             return *this;
         }
 
@@ -93,7 +107,7 @@ class UAttributesBuilder {
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setSource(const uprotocol::v1::UUri& source) {
 
-            attributes_.mutable_source()->CopyFrom(source);
+            attributes_->mutable_source()->CopyFrom(source);
             return *this;
         }
 
@@ -103,7 +117,7 @@ class UAttributesBuilder {
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setSink(const uprotocol::v1::UUri& sink) {
 
-            attributes_.mutable_sink()->CopyFrom(sink);
+            attributes_->mutable_sink()->CopyFrom(sink);
             return *this;
         }
 
@@ -113,7 +127,7 @@ class UAttributesBuilder {
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setReqid(const uprotocol::v1::UUID& reqid) {
 
-            attributes_.mutable_reqid()->CopyFrom(reqid);
+            attributes_->mutable_reqid()->CopyFrom(reqid);
             return *this;
         }
 
@@ -122,7 +136,7 @@ class UAttributesBuilder {
         /// @param type The type to set.
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setType(uprotocol::v1::UMessageType type) {
-            attributes_.set_type(type);
+            attributes_->set_type(type);
             return *this;
         }
 
@@ -131,7 +145,7 @@ class UAttributesBuilder {
         /// @param priority The priority to set.
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setPriority(uprotocol::v1::UPriority priority) {
-            attributes_.set_priority(priority);
+            attributes_->set_priority(priority);
             return *this;
         }
 
@@ -140,7 +154,7 @@ class UAttributesBuilder {
         /// @param ttl The ttl to set.
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setTTL(int32_t ttl) {
-            attributes_.set_ttl(ttl);
+            attributes_->set_ttl(ttl);
             return *this;
         }
 
@@ -149,7 +163,7 @@ class UAttributesBuilder {
         /// @param permission_level The permission_level to set.
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setPermissionLevel(int32_t permission_level) {
-            attributes_.set_permission_level(permission_level);
+            attributes_->set_permission_level(permission_level);
             return *this;
         }
 
@@ -158,7 +172,7 @@ class UAttributesBuilder {
         /// @param commstatus The commstatus to set.
         /// @return A reference to the UAttributesBuilder object.
         UAttributesBuilder& setCommstatus(uprotocol::v1::UCode commstatus) {
-            attributes_.set_commstatus(commstatus);
+            attributes_->set_commstatus(commstatus);
             return *this;
         }
 
@@ -166,7 +180,14 @@ class UAttributesBuilder {
         ///
         /// @return The UAttributes object with the set attributes.
         uprotocol::v1::UAttributes build() const {
-            return attributes_;
+            return *attributes_;
+        }
+
+        /// @brief Get the UAttributes object the builder writes into, without copying it.
+        ///
+        /// @return The UAttributes object, owned by the builder, the arena or the caller.
+        uprotocol::v1::UAttributes* buildInPlace() {
+            return attributes_.get();
         }
 
         /// @brief Static factory method to build request messages header.
@@ -174,10 +195,11 @@ class UAttributesBuilder {
         /// Build publish type of UAttributes header with the given source and priority.
         /// @param source The source URI of the message.
         /// @param priority The priority of the message.
+        /// @param arena Optional arena to allocate the UAttributes object on.
         /// @return A new UAttributesBuilder instance.
-        static UAttributesBuilder publish(const uprotocol::v1::UUri& source, uprotocol::v1::UPriority priority) {
+        static UAttributesBuilder publish(const uprotocol::v1::UUri& source, uprotocol::v1::UPriority priority, google::protobuf::Arena* arena = nullptr) {
             auto uuid = uprotocol::uuid::Uuidv8Factory::create();
-            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_PUBLISH, priority);
+            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_PUBLISH, priority, arena);
             return inst;
         }
 
@@ -187,10 +209,11 @@ class UAttributesBuilder {
         /// @param source The source URI of the message.
         /// @param sink The sink URI of the message.
         /// @param priority The priority of the message.
+        /// @param arena Optional arena to allocate the UAttributes object on.
         /// @return A new UAttributesBuilder instance.
-        static UAttributesBuilder notification(const uprotocol::v1::UUri& source, const uprotocol::v1::UUri& sink, uprotocol::v1::UPriority priority) {
+        static UAttributesBuilder notification(const uprotocol::v1::UUri& source, const uprotocol::v1::UUri& sink, uprotocol::v1::UPriority priority, google::protobuf::Arena* arena = nullptr) {
             auto uuid = uprotocol::uuid::Uuidv8Factory::create();
-            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_NOTIFICATION, priority);
+            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_NOTIFICATION, priority, arena);
             inst.setSink(sink);
             return inst;
         }
@@ -202,10 +225,11 @@ class UAttributesBuilder {
         /// @param sink The sink URI of the message.
         /// @param priority The priority of the message.
         /// @param ttl The time-to-live of the message.
+        /// @param arena Optional arena to allocate the UAttributes object on.
         /// @return A new UAttributesBuilder instance.
-        static UAttributesBuilder request(const uprotocol::v1::UUri& source, const uprotocol::v1::UUri& sink, uprotocol::v1::UPriority priority, int32_t ttl) {
+        static UAttributesBuilder request(const uprotocol::v1::UUri& source, const uprotocol::v1::UUri& sink, uprotocol::v1::UPriority priority, int32_t ttl, google::protobuf::Arena* arena = nullptr) {
             auto uuid = uprotocol::uuid::Uuidv8Factory::create();
-            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_REQUEST, priority);
+            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_REQUEST, priority, arena);
             inst.setSink(sink).setTTL(ttl);
             return inst;
         }
@@ -218,9 +242,10 @@ class UAttributesBuilder {
         /// @param sink The sink URI of the message.
         /// @param priority The priority of the message.
         /// @param uuid The unique identifier of the message.
+        /// @param arena Optional arena to allocate the UAttributes object on.
         /// @return A new UAttributesBuilder instance.
-        static UAttributesBuilder response(const uprotocol::v1::UUri& source, const uprotocol::v1::UUri& sink, uprotocol::v1::UPriority priority, const uprotocol::v1::UUID& uuid) {
-            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_RESPONSE, priority);
+        static UAttributesBuilder response(const uprotocol::v1::UUri& source, const uprotocol::v1::UUri& sink, uprotocol::v1::UPriority priority, const uprotocol::v1::UUID& uuid, google::protobuf::Arena* arena = nullptr) {
+            UAttributesBuilder inst(source, uuid, uprotocol::v1::UMessageType::UMESSAGE_TYPE_RESPONSE, priority, arena);
             inst.setSink(sink);
             return inst;
         }
@@ -0,0 +1,262 @@
+
+/// Copyright (c) 2024 General Motors GTO LLC
+/// 
+/// Licensed to the Apache Software Foundation (ASF) under one
+/// or more contributor license agreements.  See the NOTICE file
+/// distributed with this work for additional information
+/// regarding copyright ownership.  The ASF licenses this file
+/// to you under the Apache License, Version 2.0 (the
+/// "License"); you may not use this file except in compliance
+/// with the License.  You may obtain a copy of the License at
+///
+///   http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing,
+/// software distributed under the License is distributed on an
+/// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+/// KIND, either express or implied.  See the License for the
+/// specific language governing permissions and limitations
+/// under the License.
+/// 
+/// SPDX-FileType: SOURCE
+/// SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+/// SPDX-License-Identifier: Apache-2.0
+///
+
+#ifndef _UATTRIBUTESTEMPLATE_
+#define _UATTRIBUTESTEMPLATE_
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <up-cpp/transport/datamodel/UPayload.h>
+#include <up-core-api/uattributes.pb.h>
+#include <up-core-api/uuid.pb.h>
+
+namespace uprotocol::utransport {
+
+/// @brief Pre-encoded UAttributes for a stream of messages that share their header.
+///
+/// A publisher on one topic sends the same source, type, priority, sink and token
+/// with every message, only the id changes. The template serializes those fixed
+/// fields once and encodes a message header by copying them around the new id
+/// (and the ttl or reqid if given), with no UAttributes object built or walked.
+///
+/// The id is always the first field and is encoded with a fixed size, so it sits
+/// at IdOffset and an already encoded header can be reused with patchId(). The
+/// output parses to the same UAttributes as the builder would produce, and is
+/// byte-identical to its serialization for ids whose msb and lsb are both non
+/// zero, which every UUIDv8 id is.
+class UAttributesTemplate {
+    public:
+        /// @brief Offset of the id field in an encoded header.
+        static constexpr size_t IdOffset = 0;
+
+        /// @brief Encoded size of the id or reqid field: tag, length and two fixed64.
+        static constexpr size_t UuidFieldSize = 20;
+
+        /// @brief Create a template from the fixed attributes of a message stream.
+        ///
+        /// @param attributes The attributes, e.g. UAttributesBuilder::publish(...).build().
+        /// Their id is ignored, their ttl and reqid are the defaults of encodeTo().
+        explicit UAttributesTemplate(const uprotocol::v1::UAttributes& attributes) : attributes_(attributes) {
+            attributes_.clear_id();
+
+            uprotocol::v1::UAttributes head;
+            head.set_type(attributes_.type());
+            if (attributes_.has_source()) {
+                *head.mutable_source() = attributes_.source();
+            }
+            if (attributes_.has_sink()) {
+                *head.mutable_sink() = attributes_.sink();
+            }
+            head.set_priority(attributes_.priority());
+            head_ = head.SerializeAsString();
+
+            uprotocol::v1::UAttributes mid;
+            if (attributes_.has_permission_level()) {
+                mid.set_permission_level(attributes_.permission_level());
+            }
+            if (attributes_.has_commstatus()) {
+                mid.set_commstatus(attributes_.commstatus());
+            }
+            mid_ = mid.SerializeAsString();
+
+            uprotocol::v1::UAttributes tail;
+            if (attributes_.has_token()) {
+                tail.set_token(attributes_.token());
+            }
+            if (attributes_.has_traceparent()) {
+                tail.set_traceparent(attributes_.traceparent());
+            }
+            tail_ = tail.SerializeAsString();
+        }
+
+        /// @brief Get the fixed attributes the template encodes, without an id.
+        ///
+        /// @return The attributes, including the default ttl and reqid.
+        const uprotocol::v1::UAttributes& attributes() const {
+            return attributes_;
+        }
+
+        /// @brief Get the size of a header encoded with the given ttl and reqid.
+        ///
+        /// @param ttl The time-to-live of the message, the template's if not given.
+        /// @param reqid The request id of the message, the template's if nullptr.
+        /// @return The number of bytes encodeTo() writes.
+        size_t encodedSize(std::optional<int32_t> ttl = std::nullopt,
+                           const uprotocol::v1::UUID* reqid = nullptr) const {
+            ttl = effectiveTtl(ttl);
+            size_t size = UuidFieldSize + head_.size() + mid_.size() + tail_.size();
+            if (ttl.has_value()) {
+                size += 1 + varintSize(static_cast<uint64_t>(static_cast<int64_t>(*ttl)));
+            }
+            if ((nullptr != reqid) || attributes_.has_reqid()) {
+                size += UuidFieldSize;
+            }
+            return size;
+        }
+
+        /// @brief Encode the header of a message into a buffer.
+        ///
+        /// @param buffer The buffer to write to, at least encodedSize(ttl, reqid) bytes.
+        /// @param id The id of the message.
+        /// @param ttl The time-to-live of the message, the template's if not given.
+        /// @param reqid The request id of the message, the template's if nullptr.
+        /// @return The number of bytes written.
+        size_t encodeTo(uint8_t* buffer,
+                        const uprotocol::v1::UUID& id,
+                        std::optional<int32_t> ttl = std::nullopt,
+                        const uprotocol::v1::UUID* reqid = nullptr) const {
+            ttl = effectiveTtl(ttl);
+            if ((nullptr == reqid) && attributes_.has_reqid()) {
+                reqid = &attributes_.reqid();
+            }
+
+            uint8_t* out = buffer;
+            out = putUuid(out, IdTag, id);
+            out = put(out, head_);
+            if (ttl.has_value()) {
+                *out++ = TtlTag;
+                out = putVarint(out, static_cast<uint64_t>(static_cast<int64_t>(*ttl)));
+            }
+            out = put(out, mid_);
+            if (nullptr != reqid) {
+                out = putUuid(out, ReqidTag, *reqid);
+            }
+            out = put(out, tail_);
+
+            return static_cast<size_t>(out - buffer);
+        }
+
+        /// @brief Encode the header of a message into a pooled payload.
+        ///
+        /// @param id The id of the message.
+        /// @param ttl The time-to-live of the message, the template's if not given.
+        /// @param reqid The request id of the message, the template's if nullptr.
+        /// @return The encoded header as a PROTOBUF payload.
+        UPayload encode(const uprotocol::v1::UUID& id,
+                        std::optional<int32_t> ttl = std::nullopt,
+                        const uprotocol::v1::UUID* reqid = nullptr) const {
+            auto payload = UPayload::write(encodedSize(ttl, reqid), [&](uint8_t* buffer, size_t) {
+                return std::optional<size_t>(encodeTo(buffer, id, ttl, reqid));
+            });
+            payload.setFormat(UPayloadFormat::PROTOBUF);
+            return payload;
+        }
+
+        /// @brief Build the UAttributes object of a message, for APIs that take one.
+        ///
+        /// @param id The id of the message.
+        /// @param ttl The time-to-live of the message, the template's if not given.
+        /// @param reqid The request id of the message, the template's if nullptr.
+        /// @return The attributes of the message.
+        uprotocol::v1::UAttributes build(const uprotocol::v1::UUID& id,
+                                         std::optional<int32_t> ttl = std::nullopt,
+                                         const uprotocol::v1::UUID* reqid = nullptr) const {
+            uprotocol::v1::UAttributes attributes = attributes_;
+            *attributes.mutable_id() = id;
+            if (ttl.has_value()) {
+                attributes.set_ttl(*ttl);
+            }
+            if (nullptr != reqid) {
+                *attributes.mutable_reqid() = *reqid;
+            }
+            return attributes;
+        }
+
+        /// @brief Replace the id of an encoded header in place.
+        ///
+        /// @param encoded A header written by encodeTo() or encode().
+        /// @param id The new id of the message.
+        static void patchId(uint8_t* encoded, const uprotocol::v1::UUID& id) {
+            putUuid(encoded + IdOffset, IdTag, id);
+        }
+
+    private:
+        /* wire tags: field number << 3 | wire type */
+        static constexpr uint8_t IdTag = (1 << 3) | 2;
+        static constexpr uint8_t TtlTag = (6 << 3) | 0;
+        static constexpr uint8_t ReqidTag = (9 << 3) | 2;
+        static constexpr uint8_t MsbTag = (1 << 3) | 1;
+        static constexpr uint8_t LsbTag = (2 << 3) | 1;
+
+        std::optional<int32_t> effectiveTtl(std::optional<int32_t> ttl) const {
+            if ((false == ttl.has_value()) && attributes_.has_ttl()) {
+                return attributes_.ttl();
+            }
+            return ttl;
+        }
+
+        static size_t varintSize(uint64_t value) {
+            size_t size = 1;
+            while (value >= 0x80) {
+                value >>= 7;
+                ++size;
+            }
+            return size;
+        }
+
+        static uint8_t* putVarint(uint8_t* out, uint64_t value) {
+            while (value >= 0x80) {
+                *out++ = static_cast<uint8_t>(value | 0x80);
+                value >>= 7;
+            }
+            *out++ = static_cast<uint8_t>(value);
+            return out;
+        }
+
+        static uint8_t* putFixed64(uint8_t* out, uint64_t value) {
+            for (size_t i = 0; i < sizeof(value); ++i) {
+                *out++ = static_cast<uint8_t>(value >> (8 * i));
+            }
+            return out;
+        }
+
+        static uint8_t* putUuid(uint8_t* out, uint8_t tag, const uprotocol::v1::UUID& uuid) {
+            *out++ = tag;
+            *out++ = UuidFieldSize - 2;
+            *out++ = MsbTag;
+            out = putFixed64(out, uuid.msb());
+            *out++ = LsbTag;
+            return putFixed64(out, uuid.lsb());
+        }
+
+        static uint8_t* put(uint8_t* out, const std::string& bytes) {
+            if (false == bytes.empty()) {
+                std::memcpy(out, bytes.data(), bytes.size());
+            }
+            return out + bytes.size();
+        }
+
+        uprotocol::v1::UAttributes attributes_;
+        /* fields 2-5, 7-8 and 10-11, serialized around the id, ttl and reqid */
+        std::string head_;
+        std::string mid_;
+        std::string tail_;
+};
+
+} // namespace uprotocol::utransport
+
+#endif /* _UATTRIBUTESTEMPLATE_ */
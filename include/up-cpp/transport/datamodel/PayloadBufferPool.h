@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _PAYLOAD_BUFFER_POOL_H_
+#define _PAYLOAD_BUFFER_POOL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace uprotocol::utransport {
+
+    /**
+    * Process wide pool of payload buffers in power of two size classes, from
+    * MinBufferSize to MaxBufferSize.
+    *
+    * Every thread caches a few free buffers per class. A buffer goes back to the
+    * cache of the thread that drops its last reference, the cache hands surplus
+    * buffers over to a shared free list, so buffers flow freely between the
+    * receiving and the consuming threads. The shared_ptr control blocks are
+    * recycled the same way, so steady state traffic does not call malloc.
+    * Larger buffers are allocated directly.
+    */
+    class PayloadBufferPool {
+
+        public:
+
+            static constexpr size_t MinBufferSize = 64U;
+            static constexpr size_t MaxBufferSize = 1U << 20;
+            static constexpr size_t NumOfClasses = 15;
+
+            /* free bytes a thread keeps per size class, at least two buffers */
+            static constexpr size_t ThreadCacheBytes = 256U << 10;
+
+            /* free bytes the shared free list keeps per size class, at least four buffers */
+            static constexpr size_t SharedBytes = 4U << 20;
+
+            static PayloadBufferPool &instance();
+
+            PayloadBufferPool(const PayloadBufferPool &) = delete;
+            PayloadBufferPool & operator=(const PayloadBufferPool &) = delete;
+
+            /**
+            * @return writable buffer of at least size bytes, given back to the pool
+            * when the last reference drops
+            */
+            std::shared_ptr<uint8_t[]> acquire(size_t size);
+
+            /**
+            * Free the buffers cached by the calling thread and by the shared free lists.
+            */
+            void trim();
+
+            /**
+            * @return bytes held by the shared free lists
+            */
+            size_t sharedBytes() const;
+
+            /**
+            * @return size class of a buffer of size bytes, NumOfClasses if above MaxBufferSize
+            */
+            static constexpr size_t classOf(size_t size) {
+                size_t index = 0;
+                while ((index < NumOfClasses) && (classSize(index) < size)) {
+                    ++index;
+                }
+                return index;
+            }
+
+            static constexpr size_t classSize(size_t index) {
+                return MinBufferSize << index;
+            }
+
+        private:
+
+            friend struct PayloadBufferCache;
+
+            PayloadBufferPool() = default;
+
+            struct SharedList {
+                mutable std::mutex mutex;
+                std::vector<uint8_t *> buffers;
+            };
+
+            /* take a free buffer, nullptr if there is none */
+            uint8_t *take(size_t index);
+
+            /* keep a free buffer, false if the shared list is full */
+            bool give(size_t index, uint8_t *buffer);
+
+            std::array<SharedList, NumOfClasses> shared_;
+    };
+}
+
+#endif /* _PAYLOAD_BUFFER_POOL_H_ */
@@ -26,6 +26,7 @@
 #ifndef _UMESSAGE_H_
 #define _UMESSAGE_H_
 
+#include <utility>
 #include <up-core-api/uattributes.pb.h>
 #include <up-cpp/transport/datamodel/UPayload.h>
 
@@ -36,34 +37,68 @@ namespace uprotocol::utransport {
     public:
 
         // Default constructor with member initializer list
-        UMessage() : payload_(nullptr, 0, UPayloadType::REFERENCE), attributes_() {}
+        UMessage() : payload_(), attributes_() {}
 
         // Constructor with parameters and member initializer list
-        UMessage(uprotocol::utransport::UPayload &payload,
+        UMessage(const uprotocol::utransport::UPayload &payload,
                  uprotocol::v1::UAttributes attributes) :
             payload_(payload),
-            attributes_(attributes) { }
+            attributes_(std::move(attributes)) { }
 
-        // Setter for payload with move semantics
-        void setPayload(uprotocol::utransport::UPayload &payload) {
+        // Constructor taking ownership of the payload (and of the attributes when passed as rvalue)
+        UMessage(uprotocol::utransport::UPayload &&payload,
+                 uprotocol::v1::UAttributes attributes) :
+            payload_(std::move(payload)),
+            attributes_(std::move(attributes)) { }
+
+        // Constructor building the payload in place from the UPayload constructor arguments
+        template<typename... PayloadArgs>
+        UMessage(std::in_place_t,
+                 uprotocol::v1::UAttributes attributes,
+                 PayloadArgs&&... payloadArgs) :
+            payload_(std::forward<PayloadArgs>(payloadArgs)...),
+            attributes_(std::move(attributes)) { }
+
+        // Setter for payload, shares the payload buffer
+        void setPayload(const uprotocol::utransport::UPayload &payload) {
             payload_ = payload;
         }
 
-        // Setter for attributes with move semantics
-        void setAttributes(uprotocol::v1::UAttributes &attributes) {
+        // Setter for payload with move semantics
+        void setPayload(uprotocol::utransport::UPayload &&payload) {
+            payload_ = std::move(payload);
+        }
+
+        // Setter for attributes, copies the attributes
+        void setAttributes(const uprotocol::v1::UAttributes &attributes) {
             attributes_ = attributes;
         }
 
+        // Setter for attributes with move semantics (no CopyFrom when both live on the same arena)
+        void setAttributes(uprotocol::v1::UAttributes &&attributes) {
+            attributes_ = std::move(attributes);
+        }
+
         // Getter for payload
         const uprotocol::utransport::UPayload& payload() const {
             return payload_;
         }
 
+        // Getter for payload that can be modified in place, e.g. to retain() it
+        uprotocol::utransport::UPayload& mutablePayload() {
+            return payload_;
+        }
+
         // Getter for attributes
         const uprotocol::v1::UAttributes& attributes() const {
             return attributes_;
         }
 
+        // Getter for attributes that can be filled in place
+        uprotocol::v1::UAttributes& mutableAttributes() {
+            return attributes_;
+        }
+
     private:
 
         uprotocol::utransport::UPayload payload_;
@@ -27,8 +27,16 @@
 #define _UPAYLOAD_H_
 
 #include <memory>
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+#include <up-cpp/transport/datamodel/PayloadBufferPool.h>
 
 namespace uprotocol::utransport {
 
@@ -53,10 +61,34 @@ namespace uprotocol::utransport {
 
     /**
     * The UPayload contains the clean Payload information at its raw serialized structure of a byte[]
+    *
+    * Copies share the underlying buffer, the bytes themselves are only copied by:
+    *  - the pointer constructor for VALUE and SHARED types (one copy into a refcounted buffer)
+    *  - mutableData() unless the payload allocated the buffer itself and is its only owner
+    *  - retain() for a REFERENCE
+    * A transport can hand its receive buffer over (unique_ptr, vector or shared_ptr
+    * constructors) and the bytes reach the receiver without being copied.
+    * Copy construction / assignment and UMessage's payload setters never copy the bytes.
+    * The buffers of these copies come from the PayloadBufferPool.
+    *
+    * A payload can also be a list of segments (see gather()), e.g. a transport
+    * header followed by the user payload, which a transport writes out with
+    * writev() / sendmsg() (toIovec()) or copyTo() without concatenating them.
+    * data() and buffer() flatten the segments into one pooled buffer on first
+    * use, the flattened buffer is shared by all copies of the payload.
+    *
+    * mapFile() makes a SHARED payload of a read-only mapping of a file, the
+    * pages are only read in as they are accessed and the mapping goes away with
+    * the last payload referring to it. slice() cuts such a payload into chunks,
+    * e.g. for a streamed RPC response, without copying.
     */
     class UPayload {
 
         public:
+            // Default constructor - empty REFERENCE payload, does not allocate
+            UPayload() : dataSize_(0), type_(UPayloadType::REFERENCE) {
+            }
+
             // Constructor
             UPayload(const uint8_t* ptr, 
                      const size_t size, 
@@ -65,44 +97,152 @@ namespace uprotocol::utransport {
                 if (type == UPayloadType::REFERENCE) {
                     dataPtr_ = std::shared_ptr<const uint8_t[]>(ptr, [](const uint8_t*){});
                 } else {
-                    dataPtr_ = std::shared_ptr<const uint8_t[]>(new uint8_t[dataSize_], [](const uint8_t* p){ delete[] p; });
-                    if (nullptr != ptr) {
-                        std::memcpy(const_cast<uint8_t*>(dataPtr_.get()), ptr, dataSize_);
+                    auto buffer = PayloadBufferPool::instance().acquire(dataSize_);
+                    if ((nullptr != ptr) && (0 != dataSize_)) {
+                        std::memcpy(buffer.get(), ptr, dataSize_);
                     }
+                    dataPtr_ = std::move(buffer);
+                    writable_ = true;
                 }
             }
 
-            // Copy constructor
-            UPayload(const UPayload& other) 
-                : dataSize_(other.dataSize_), type_(other.type_), payloadFormat_(other.payloadFormat_) {
-                if (type_ == UPayloadType::REFERENCE) {
-                    dataPtr_ = other.dataPtr_;
-                } else {
-                    dataPtr_ = std::shared_ptr<const uint8_t[]>(new uint8_t[dataSize_], [](const uint8_t* p){ delete[] p; });
-                    std::memcpy(const_cast<uint8_t*>(dataPtr_.get()), other.dataPtr_.get(), dataSize_);
+            // Constructor taking shared ownership of an existing buffer without copying it
+            UPayload(std::shared_ptr<const uint8_t[]> data,
+                     const size_t size) 
+                : dataPtr_(std::move(data)), dataSize_(size), type_(UPayloadType::SHARED) {
+            }
+
+            // Constructor taking ownership of a receive buffer without copying it
+            UPayload(std::unique_ptr<uint8_t[]> data,
+                     const size_t size)
+                : dataPtr_(std::move(data)), dataSize_(size), type_(UPayloadType::SHARED) {
+            }
+
+            // Constructor taking ownership of a receive buffer without copying it
+            explicit UPayload(std::vector<uint8_t> &&data)
+                : dataSize_(data.size()), type_(UPayloadType::SHARED) {
+                auto owner = std::make_shared<std::vector<uint8_t>>(std::move(data));
+                dataPtr_ = std::shared_ptr<const uint8_t[]>(owner, owner->data());
+            }
+
+            /**
+            * Wrap storage the caller lends for writing, e.g. a transport's send slot:
+            * mutableData() writes it in place while the payload is its only owner.
+            * @return a SHARED payload of data
+            */
+            static UPayload lend(std::shared_ptr<uint8_t[]> data,
+                                 const size_t size) {
+                UPayload payload(std::shared_ptr<const uint8_t[]>(std::move(data)), size);
+                payload.writable_ = true;
+                return payload;
+            }
+
+            /**
+            * Build a payload in a pooled buffer, e.g. serializing a message straight into it.
+            * @param capacity size of the buffer handed to writer
+            * @param writer std::optional<size_t>(uint8_t *buffer, size_t capacity) returning
+            * the number of bytes it wrote, std::nullopt on failure
+            * @return the payload, empty if writer failed
+            */
+            template<typename Writer>
+            static UPayload write(size_t capacity, Writer &&writer) {
+                auto buffer = PayloadBufferPool::instance().acquire(capacity);
+                const std::optional<size_t> written = writer(buffer.get(), capacity);
+                if ((false == written.has_value()) || (*written > capacity)) {
+                    return UPayload();
                 }
+                UPayload payload(std::shared_ptr<const uint8_t[]>(std::move(buffer)), *written);
+                payload.writable_ = true;
+                return payload;
             }
 
-            // Assignment operator
-            UPayload& operator=(const UPayload& other) {
-                if (this != &other) {
-                    dataSize_ = other.dataSize_;
-                    type_ = other.type_;
-                    payloadFormat_ = other.payloadFormat_;
-                    if (type_ == UPayloadType::REFERENCE) {
-                        dataPtr_ = other.dataPtr_;
-                    } else {
-                        dataPtr_ = std::shared_ptr<const uint8_t[]>(new uint8_t[dataSize_], [](const uint8_t* p){ delete[] p; });
-                        std::memcpy(const_cast<uint8_t*>(dataPtr_.get()), other.dataPtr_.get(), dataSize_);
+            /**
+            * Serialize a protobuf message into a pooled buffer, without an intermediate string.
+            */
+            template<typename Message>
+            static UPayload fromMessage(const Message &message) {
+                auto payload = write(message.ByteSizeLong(), [&message](uint8_t *buffer, size_t size) {
+                    // the size computed above is cached, no second pass over the message
+                    message.SerializeWithCachedSizesToArray(buffer);
+                    return std::optional<size_t>(size);
+                });
+                payload.setFormat(UPayloadFormat::PROTOBUF);
+                return payload;
+            }
 
+            /**
+            * Build a payload of several segments, without copying their bytes.
+            * Segments that are themselves gathered are spliced in, empty ones are
+            * dropped. The payload is a REFERENCE payload if a segment is one.
+            * @return the payload, the segment itself if there is only one
+            */
+            static UPayload gather(std::vector<UPayload> segments) {
+                auto gathered = std::make_shared<Gather>();
+                UPayload payload;
+                payload.type_ = UPayloadType::SHARED;
+                for (auto &segment : segments) {
+                    if (nullptr != segment.gather_) {
+                        for (const auto &inner : segment.gather_->segments) {
+                            payload.add(*gathered, inner);
+                        }
+                    } else if (false == segment.isEmpty()) {
+                        payload.add(*gathered, std::move(segment));
                     }
                 }
-                return *this;
+
+                if (1 == gathered->segments.size()) {
+                    return std::move(gathered->segments.front());
+                }
+                if (false == gathered->segments.empty()) {
+                    payload.payloadFormat_ = gathered->segments.back().payloadFormat_;
+                    payload.gather_ = std::move(gathered);
+                }
+                return payload;
+            }
+
+            /**
+            * Map a region of a file read-only. The file can be closed, renamed or
+            * unlinked afterwards, it must not be truncated while the payload lives.
+            * The mapping is never written, mutableData() copies it first.
+            * @param path file to map
+            * @param offset first byte of the region, any alignment
+            * @param length bytes of the region, up to the end of the file
+            * @return a SHARED payload, empty if the file cannot be mapped or the region is empty
+            */
+            static UPayload mapFile(const std::string &path,
+                                    size_t offset = 0,
+                                    size_t length = std::numeric_limits<size_t>::max());
+
+            /**
+            * @return a payload of length bytes from offset (clamped to the payload),
+            * sharing the buffer instead of copying it
+            */
+            UPayload slice(size_t offset,
+                           size_t length = std::numeric_limits<size_t>::max()) const {
+                offset = std::min(offset, dataSize_);
+                length = std::min(length, dataSize_ - offset);
+
+                const auto &whole = buffer();
+                UPayload part;
+                part.dataPtr_ = std::shared_ptr<const uint8_t[]>(whole, whole.get() + offset);
+                part.dataSize_ = length;
+                part.type_ = (UPayloadType::REFERENCE == type_) ? UPayloadType::REFERENCE : UPayloadType::SHARED;
+                part.payloadFormat_ = payloadFormat_;
+                return part;
             }
 
+            // Copy constructor - shares the buffer
+            UPayload(const UPayload& other) = default;
+
+            // Assignment operator - shares the buffer
+            UPayload& operator=(const UPayload& other) = default;
+
             // Move constructor
             UPayload(UPayload&& other) noexcept 
-                : dataPtr_(std::move(other.dataPtr_)), dataSize_(other.dataSize_), type_(other.type_), payloadFormat_(other.payloadFormat_){
+                : dataPtr_(std::move(other.dataPtr_)), dataSize_(other.dataSize_), type_(other.type_), payloadFormat_(other.payloadFormat_),
+                gather_(std::move(other.gather_)), writable_(other.writable_) {
+                other.dataSize_ = 0;
+                other.writable_ = false;
             }
 
             // Move assignment operator
@@ -112,11 +252,84 @@ namespace uprotocol::utransport {
                     type_ = other.type_;
                     dataPtr_ = std::move(other.dataPtr_);
                     payloadFormat_ = other.payloadFormat_;
+                    gather_ = std::move(other.gather_);
+                    writable_ = other.writable_;
                     other.dataSize_ = 0;
+                    other.writable_ = false;
                 }
                 return *this;
             }
 
+            /**
+            * Writable access to the payload bytes (copy on write).
+            * Only a buffer the payload allocated itself (VALUE and SHARED copies, write(),
+            * fromMessage()) or was lent for writing (lend()) is written in place, and only
+            * while no other UPayload shares it.
+            * Any other buffer is copied first and the payload becomes a VALUE payload: a
+            * REFERENCE, a slice, a mapped file and every buffer handed in by the caller, even
+            * an adopted one, since its storage may be read-only or aliased elsewhere.
+            * @return writable data, valid until the payload is modified or destroyed
+            */
+            uint8_t* mutableData() {
+                if (nullptr != gather_) {
+                    dataPtr_ = flat();
+                    gather_.reset();
+                    type_ = UPayloadType::SHARED;
+                    /* the flattened buffer is pooled, it is still shared if copies of the gather exist */
+                    writable_ = true;
+                }
+                if ((false == writable_) || (dataPtr_.use_count() > 1)) {
+                    auto copy = PayloadBufferPool::instance().acquire(dataSize_);
+                    if ((nullptr != dataPtr_) && (0 != dataSize_)) {
+                        std::memcpy(copy.get(), dataPtr_.get(), dataSize_);
+                    }
+                    dataPtr_ = std::move(copy);
+                    type_ = UPayloadType::VALUE;
+                    writable_ = true;
+                }
+                return const_cast<uint8_t*>(dataPtr_.get());
+            }
+
+            /**
+            * Make the payload independent of a buffer it only references, so that it
+            * can outlive it (e.g. when a REFERENCE payload to a transport receive
+            * buffer is handed to another thread). Only a REFERENCE payload is copied
+            * (and becomes a VALUE payload), shared buffers are kept as they are.
+            */
+            void retain() {
+                if ((type_ == UPayloadType::REFERENCE) && (nullptr != gather_)) {
+                    auto retained = std::make_shared<Gather>();
+                    for (auto segment : gather_->segments) {
+                        segment.retain();
+                        retained->segments.push_back(std::move(segment));
+                    }
+                    gather_ = std::move(retained);
+                    type_ = UPayloadType::SHARED;
+                } else if ((type_ == UPayloadType::REFERENCE) && (nullptr != dataPtr_)) {
+                    auto copy = PayloadBufferPool::instance().acquire(dataSize_);
+                    if (0 != dataSize_) {
+                        std::memcpy(copy.get(), dataPtr_.get(), dataSize_);
+                    }
+                    dataPtr_ = std::move(copy);
+                    type_ = UPayloadType::VALUE;
+                    writable_ = true;
+                }
+            }
+
+            /**
+            * @return shared ownership of the payload buffer
+            */
+            const std::shared_ptr<const uint8_t[]>& buffer() const {
+                return (nullptr != gather_) ? flat() : dataPtr_;
+            }
+
+            /**
+            * @return payload type
+            */
+            UPayloadType type() const {
+                return type_;
+            }
+
             void setFormat(const UPayloadFormat &format) {
                 payloadFormat_ = format;
             }
@@ -125,7 +338,58 @@ namespace uprotocol::utransport {
             * @return data
             */
             const uint8_t* data() const {
-                return dataPtr_.get();
+                return buffer().get();
+            }
+
+            /**
+            * @return false if the payload is made of several segments
+            */
+            bool isContiguous() const {
+                return nullptr == gather_;
+            }
+
+            /**
+            * @return number of segments, 1 for a contiguous payload
+            */
+            size_t segmentCount() const {
+                return (nullptr != gather_) ? gather_->segments.size() : 1U;
+            }
+
+            /**
+            * @return a segment, the payload itself if it is contiguous
+            */
+            const UPayload& segment(size_t index) const {
+                return (nullptr != gather_) ? gather_->segments[index] : *this;
+            }
+
+            /**
+            * Describe the segments for writev() / sendmsg(), without flattening them.
+            * @return number of entries written, 0 if count is smaller than segmentCount()
+            */
+            size_t toIovec(struct iovec* iov, size_t count) const {
+                const auto segments = segmentCount();
+                if (count < segments) {
+                    return 0;
+                }
+                for (size_t i = 0; i < segments; ++i) {
+                    const auto& part = segment(i);
+                    iov[i].iov_base = const_cast<uint8_t*>(part.dataPtr_.get());
+                    iov[i].iov_len = part.dataSize_;
+                }
+                return segments;
+            }
+
+            /**
+            * Copy the bytes of all segments into out, which must hold size() bytes.
+            */
+            void copyTo(uint8_t* out) const {
+                for (size_t i = 0; i < segmentCount(); ++i) {
+                    const auto& part = segment(i);
+                    if (0 != part.dataSize_) {
+                        std::memcpy(out, part.dataPtr_.get(), part.dataSize_);
+                        out += part.dataSize_;
+                    }
+                }
             }
 
             /**
@@ -148,10 +412,38 @@ namespace uprotocol::utransport {
             }
 
         private:
+            /* the segments of a gathered payload, shared by its copies */
+            struct Gather {
+                std::vector<UPayload> segments;
+                std::once_flag flattened;
+                std::shared_ptr<const uint8_t[]> flat;
+            };
+
+            void add(Gather &gathered, UPayload segment) {
+                dataSize_ += segment.dataSize_;
+                if (UPayloadType::REFERENCE == segment.type_) {
+                    type_ = UPayloadType::REFERENCE;
+                }
+                gathered.segments.push_back(std::move(segment));
+            }
+
+            const std::shared_ptr<const uint8_t[]>& flat() const {
+                auto &gathered = *gather_;
+                std::call_once(gathered.flattened, [this, &gathered]() {
+                    auto buffer = PayloadBufferPool::instance().acquire(dataSize_);
+                    copyTo(buffer.get());
+                    gathered.flat = std::move(buffer);
+                });
+                return gathered.flat;
+            }
+
             std::shared_ptr<const uint8_t[]> dataPtr_;
             size_t dataSize_;
             UPayloadType type_;
             UPayloadFormat payloadFormat_ = UPayloadFormat::RAW;
+            std::shared_ptr<Gather> gather_;
+            /* dataPtr_ was allocated by the payload, mutableData() may write it in place */
+            bool writable_ = false;
     };
 }
 
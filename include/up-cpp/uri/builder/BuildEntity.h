@@ -36,20 +36,33 @@
 #include <array>
 #include <string_view>
 #include <arpa/inet.h>
-#include <spdlog/spdlog.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/ProtoTarget.h>
 #include "../tools/Utils.h"
 #include <up-core-api/uri.pb.h>
 
 namespace uprotocol::uri {
     class BuildUEntity {
-        uprotocol::v1::UEntity entity_;
+        uprotocol::utils::ProtoTarget<uprotocol::v1::UEntity> entity_;
     
     public:
         /**
          * BuildUEntity constractor
          * 
          */
-        BuildUEntity() { entity_.Clear();}
+        BuildUEntity() { entity_->Clear();}
+
+        /**
+         * BuildUEntity writing into a message allocated on arena, released together with the arena
+         * @param arena
+         */
+        explicit BuildUEntity(google::protobuf::Arena *arena) : entity_(arena) {}
+
+        /**
+         * BuildUEntity writing directly into an existing message, e.g. a field of a parent message
+         * @param target
+         */
+        explicit BuildUEntity(uprotocol::v1::UEntity *target) : entity_(target) {}
         
         /**
          * set name of the entity. if name is empty or blank, an error will be logged and the name will not be set
@@ -59,9 +72,9 @@ namespace uprotocol::uri {
          */
         auto setName(const std::string &name) -> BuildUEntity & {
             if (isBlank(name)) {
-                spdlog::error("UEntity name cannot be empty or blanks");
+                UP_LOG_ERROR("UEntity name cannot be empty or blanks");
             } else {
-                entity_.set_name(name);
+                entity_->set_name(name);
             }
             return *this;
         }
@@ -72,10 +85,10 @@ namespace uprotocol::uri {
          * @return 
          */
         auto setId(const uint32_t &id) -> BuildUEntity & {
-            if (0 == id || entity_.has_id()) {
+            if (0 == id || entity_->has_id()) {
                 return *this;
             }
-            entity_.set_id(id);
+            entity_->set_id(id);
             return *this;
         }
         
@@ -95,12 +108,12 @@ namespace uprotocol::uri {
                 if (ver < 0) {
                     return *this;
                 }
-                entity_.set_version_major(ver);
+                entity_->set_version_major(ver);
             } else {
                 auto ver = std::stoi(version.substr(0, res));
-                entity_.set_version_major(ver);
+                entity_->set_version_major(ver);
                 ver = std::stoi(version.substr(res + 1));
-                entity_.set_version_minor(ver);
+                entity_->set_version_minor(ver);
             }
             return *this;
         }
@@ -111,7 +124,7 @@ namespace uprotocol::uri {
          * @return 
          */
         auto setMajorVersion(const uint32_t &majorVersion) -> BuildUEntity & {
-            entity_.set_version_major(majorVersion);
+            entity_->set_version_major(majorVersion);
             return *this;
         }
         /**
@@ -120,7 +133,7 @@ namespace uprotocol::uri {
          * @return 
          */
         auto setMinorVersion(const uint32_t &minorVersion) -> BuildUEntity & {
-            entity_.set_version_minor(minorVersion);
+            entity_->set_version_minor(minorVersion);
             return *this;
         }
         /**
@@ -128,7 +141,15 @@ namespace uprotocol::uri {
          * @return uprotocol::v1::UEntity
          */
         auto build() const -> uprotocol::v1::UEntity {
-            return entity_;
+            return *entity_;
+        }
+        /**
+         * return the message the builder writes into, without copying it.
+         * the message is owned by the builder, the arena or the caller (see constructors)
+         * @return
+         */
+        auto buildInPlace() -> uprotocol::v1::UEntity * {
+            return entity_.get();
         }
     };
 }  // namespace uprotocol::uri
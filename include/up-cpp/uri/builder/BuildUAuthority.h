@@ -36,16 +36,29 @@
 #include <array>
 #include <string_view>
 #include <arpa/inet.h>
-#include <spdlog/spdlog.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/ProtoTarget.h>
 #include "../tools/IpAddress.h"
 #include "../tools/Utils.h"
 #include "up-core-api/uri.pb.h"
 
 namespace uprotocol::uri {
     class BuildUAuthority {
-        uprotocol::v1::UAuthority authority_;
+        uprotocol::utils::ProtoTarget<uprotocol::v1::UAuthority> authority_;
     public:
-        BuildUAuthority() { authority_.Clear(); }
+        BuildUAuthority() { authority_->Clear(); }
+
+        /**
+         * BuildUAuthority writing into a message allocated on arena, released together with the arena
+         * @param arena
+         */
+        explicit BuildUAuthority(google::protobuf::Arena *arena) : authority_(arena) {}
+
+        /**
+         * BuildUAuthority writing directly into an existing message, e.g. a field of a parent message
+         * @param target
+         */
+        explicit BuildUAuthority(uprotocol::v1::UAuthority *target) : authority_(target) {}
 
         /**
          * set name of the authority. if name is empty or blank, an error will be logged and the name will not be set
@@ -54,18 +67,18 @@ namespace uprotocol::uri {
          * @return
          */
         auto setName(const std::string &name) -> BuildUAuthority & {
-            if (authority_.has_name() && !authority_.name().empty()) {
-                spdlog::error("UAuthority already has a remote set. Ignoring setName()");
+            if (authority_->has_name() && !authority_->name().empty()) {
+                UP_LOG_ERROR("UAuthority already has a remote set. Ignoring setName()");
                 return *this;
             }
             if (isBlank(name)) {
-                spdlog::error("UAuthority name is blank. Ignoring setName()");
+                UP_LOG_ERROR("UAuthority name is blank. Ignoring setName()");
                 return *this;
             } else {
                 auto tmp  = name;
                 std::transform(tmp.begin(), tmp.end(), tmp.begin(),
                                [](unsigned char c) { return std::tolower(c); });
-                authority_.set_name(std::move(tmp));
+                authority_->set_name(std::move(tmp));
             }
             return *this;
         }
@@ -78,12 +91,12 @@ namespace uprotocol::uri {
          * @return
          */
         auto setName(const std::string &device, const std::string &domain) -> BuildUAuthority & {
-            if (authority_.has_name() && !authority_.name().empty()) {
-                spdlog::error("UAuthority already has a name {} set. Ignoring setName()", authority_.name());
+            if (authority_->has_name() && !authority_->name().empty()) {
+                UP_LOG_ERROR("UAuthority already has a name {} set. Ignoring setName()", authority_->name());
                 return *this;
             }
             if (isBlank(device) && isBlank(domain)) {
-                spdlog::error("UAuthority device or domain is blank. Ignoring setName()");
+                UP_LOG_ERROR("UAuthority device or domain is blank. Ignoring setName()");
                 return *this;
             }
             if (isBlank(device)) {
@@ -114,37 +127,46 @@ namespace uprotocol::uri {
          * @return
          */
         auto setIp(const IpAddress &address) -> BuildUAuthority & {
-            if (authority_.has_ip() && !authority_.ip().empty()) {
-                spdlog::error("UAuthority already has ip set {}. Ignoring setIp()", authority_.ip());
+            if (authority_->has_ip() && !authority_->ip().empty()) {
+                UP_LOG_ERROR("UAuthority already has ip set {}. Ignoring setIp()", authority_->ip());
                 return *this;
             }
 
             if (address.getType() == IpAddress::Type::Invalid) {
-                spdlog::error<std::string_view>("UAuthority address is not a valid IP address. Ignoring setIp()");
+                UP_LOG_ERROR("UAuthority address is not a valid IP address. Ignoring setIp()");
                 // Note: setting an empty string here will allow the micro
                 //       serializer to detect that something was wrong instead
                 //       of thinking it has been asked to serialize a Local
                 //       authority.
-                authority_.set_ip("");
+                authority_->set_ip("");
                 return *this;
             }
 
-            authority_.set_ip(address.getBytesString());
+            auto bytes = address.getBytesView();
+            authority_->set_ip(bytes.data(), bytes.size());
 
             return *this;
         }
 
         auto setId(const std::string &id) -> BuildUAuthority & {
-            if (authority_.has_id() && !authority_.id().empty()) {
-                spdlog::error("UAuthority already has a id set {}. Ignoring setId()", authority_.id());
+            if (authority_->has_id() && !authority_->id().empty()) {
+                UP_LOG_ERROR("UAuthority already has a id set {}. Ignoring setId()", authority_->id());
                 return *this;
             }
-            authority_.set_id(id);
+            authority_->set_id(id);
             return *this;
         }
 
         auto build() const -> uprotocol::v1::UAuthority {
-            return authority_;
+            return *authority_;
+        }
+        /**
+         * return the message the builder writes into, without copying it.
+         * the message is owned by the builder, the arena or the caller (see constructors)
+         * @return
+         */
+        auto buildInPlace() -> uprotocol::v1::UAuthority * {
+            return authority_.get();
         }
     };
 }  // namespace uprotocol::uri
@@ -36,16 +36,29 @@
 #include <array>
 #include <string_view>
 #include <arpa/inet.h>
-#include <spdlog/spdlog.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/ProtoTarget.h>
 #include <up-cpp/uri/tools/Utils.h>
 #include "up-core-api/uri.pb.h"
 
 namespace uprotocol::uri {
     class BuildUResource {
-        uprotocol::v1::UResource resource_;
+        uprotocol::utils::ProtoTarget<uprotocol::v1::UResource> resource_;
 
     public:
-        BuildUResource() { resource_.Clear();}
+        BuildUResource() { resource_->Clear();}
+
+        /**
+         * BuildUResource writing into a message allocated on arena, released together with the arena
+         * @param arena
+         */
+        explicit BuildUResource(google::protobuf::Arena *arena) : resource_(arena) {}
+
+        /**
+         * BuildUResource writing directly into an existing message, e.g. a field of a parent message
+         * @param target
+         */
+        explicit BuildUResource(uprotocol::v1::UResource *target) : resource_(target) {}
         /**
          * set name of the resource. if name is empty or blank, an error will be logged and the name will not be set
          * if name is already set, it will not be changed
@@ -54,9 +67,9 @@ namespace uprotocol::uri {
          */
         auto setName(const std::string &name) -> BuildUResource & {
             if (isBlank(name)) {
-                spdlog::error("UResource name cannot be empty");
+                UP_LOG_ERROR("UResource name cannot be empty");
             } else {
-                resource_.set_name(name);
+                resource_->set_name(name);
             }
             return *this;
         }
@@ -68,9 +81,9 @@ namespace uprotocol::uri {
          */
         auto setInstance(const std::string &instance) -> BuildUResource & {
             if (isBlank(instance)) {
-                spdlog::error("UResource instance cannot be empty");
+                UP_LOG_ERROR("UResource instance cannot be empty");
             } else {
-                resource_.set_instance(instance);
+                resource_->set_instance(instance);
             }
             return *this;
         }
@@ -82,9 +95,9 @@ namespace uprotocol::uri {
          */
         auto setMessage(const std::string &message) -> BuildUResource & {
             if (isBlank(message)) {
-                spdlog::error("UResource message cannot be empty");
+                UP_LOG_ERROR("UResource message cannot be empty");
             } else {
-                resource_.set_message(message);
+                resource_->set_message(message);
             }
             return *this;
         }
@@ -96,9 +109,9 @@ namespace uprotocol::uri {
          */
         auto setID(const uint32_t &id) -> BuildUResource & {
             if (0 == id) {
-                spdlog::error("UResource id cannot be 0");
+                UP_LOG_ERROR("UResource id cannot be 0");
             } else {
-                resource_.set_id(id);
+                resource_->set_id(id);
             }
             return *this;
         }
@@ -110,10 +123,10 @@ namespace uprotocol::uri {
          */
         auto setRpcRequest(const std::string &method) -> BuildUResource & {
             if (isBlank(method)) {
-                spdlog::error("UResource method cannot be empty");
+                UP_LOG_ERROR("UResource method cannot be empty");
             } else {
-                resource_.set_name("rpc");
-                resource_.set_instance(method);
+                resource_->set_name("rpc");
+                resource_->set_instance(method);
             }
             return *this;
         }
@@ -125,7 +138,7 @@ namespace uprotocol::uri {
          */
         auto setRpcRequest(const std::string &method, uint32_t id) -> BuildUResource & {
             if (isBlank(method) || 0 == id) {
-                spdlog::error("UResource method cannot be empty");
+                UP_LOG_ERROR("UResource method cannot be empty");
             } else {
                 setName("rpc");
                 setInstance(method);
@@ -141,7 +154,7 @@ namespace uprotocol::uri {
          */
         auto setRpcRequest(const uint32_t id) -> BuildUResource & {
             if (0 == id) {
-                spdlog::error("UResource id cannot be 0");
+                UP_LOG_ERROR("UResource id cannot be 0");
             } else {
                 setName("rpc");
                 setID(id);
@@ -163,7 +176,15 @@ namespace uprotocol::uri {
          * @return uprotocol::v1::UResource
          */
         auto build() const -> uprotocol::v1::UResource {
-            return resource_;
+            return *resource_;
+        }
+        /**
+         * return the message the builder writes into, without copying it.
+         * the message is owned by the builder, the arena or the caller (see constructors)
+         * @return
+         */
+        auto buildInPlace() -> uprotocol::v1::UResource * {
+            return resource_.get();
         }
     };
     
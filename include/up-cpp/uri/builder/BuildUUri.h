@@ -35,16 +35,29 @@
 #include <array>
 #include <string_view>
 #include <arpa/inet.h>
-#include <spdlog/spdlog.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/ProtoTarget.h>
 #include "../tools/Utils.h"
 #include "up-core-api/uri.pb.h"
 
 namespace uprotocol::uri {
     class BuildUUri {
-        uprotocol::v1::UUri uri_;
+        uprotocol::utils::ProtoTarget<uprotocol::v1::UUri> uri_;
     
     public:
-        BuildUUri() { uri_.Clear(); }
+        BuildUUri() { uri_->Clear(); }
+
+        /**
+         * BuildUUri writing into a message allocated on arena, released together with the arena
+         * @param arena
+         */
+        explicit BuildUUri(google::protobuf::Arena *arena) : uri_(arena) {}
+
+        /**
+         * BuildUUri writing directly into an existing message, e.g. a field of a parent message
+         * @param target
+         */
+        explicit BuildUUri(uprotocol::v1::UUri *target) : uri_(target) {}
         
         /**
          * Set the Autority part of the URI
@@ -52,12 +65,12 @@ namespace uprotocol::uri {
          * @return 
          */
         auto setAutority(uprotocol::v1::UAuthority const &authority) -> BuildUUri & {
-            if (uri_.has_authority() && !isEmpty(uri_.authority())) {
-                spdlog::error("UUri already has a authority set. Ignoring setAuthority()");
+            if (uri_->has_authority() && !isEmpty(uri_->authority())) {
+                UP_LOG_ERROR("UUri already has a authority set. Ignoring setAuthority()");
                 return *this;
             }
             
-            uri_.mutable_authority()->CopyFrom(authority);
+            uri_->mutable_authority()->CopyFrom(authority);
             return *this;
         }
         /**
@@ -66,12 +79,12 @@ namespace uprotocol::uri {
          * @return 
          */
         auto setEntity(uprotocol::v1::UEntity const &entity) -> BuildUUri & {
-            if (uri_.has_entity()) {
-                spdlog::error("UUri already has a entity set. Ignoring setEntity()");
+            if (uri_->has_entity()) {
+                UP_LOG_ERROR("UUri already has a entity set. Ignoring setEntity()");
                 return *this;
             }
 
-            uri_.mutable_entity()->CopyFrom(entity);
+            uri_->mutable_entity()->CopyFrom(entity);
             return *this;
         }
         /**
@@ -80,12 +93,12 @@ namespace uprotocol::uri {
          * @return 
          */
         auto setResource(uprotocol::v1::UResource const &resource) -> BuildUUri & {
-            if (uri_.has_resource() && !isEmpty(uri_.resource())) {
-                spdlog::error("UUri already has a resource set. Ignoring setResource()");
+            if (uri_->has_resource() && !isEmpty(uri_->resource())) {
+                UP_LOG_ERROR("UUri already has a resource set. Ignoring setResource()");
                 return *this;
             }
 
-            uri_.mutable_resource()->CopyFrom(resource);
+            uri_->mutable_resource()->CopyFrom(resource);
             return *this;
         }
         /**
@@ -93,7 +106,15 @@ namespace uprotocol::uri {
          * @return 
          */
         auto build() const -> v1::UUri {
-            return uri_;
+            return *uri_;
+        }
+        /**
+         * return the message the builder writes into, without copying it.
+         * the message is owned by the builder, the arena or the caller (see constructors)
+         * @return
+         */
+        auto buildInPlace() -> uprotocol::v1::UUri * {
+            return uri_.get();
         }
     };
     /**
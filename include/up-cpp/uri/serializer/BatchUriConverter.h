@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BATCH_URI_CONVERTER_H_
+#define BATCH_URI_CONVERTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <up-cpp/uri/serializer/UriError.h>
+#include <up-cpp/utils/ThreadPool.h>
+#include <up-core-api/uri.pb.h>
+
+namespace uprotocol::uri {
+
+/**
+ * Micro URIs stored back to back: entry i is bytes[offsets[i], offsets[i + 1]) and
+ * errors[i] is 0, or the UriError value of an entry that did not convert (which is empty).
+ */
+struct MicroUriColumn {
+    std::vector<uint8_t> bytes;
+    std::vector<std::size_t> offsets{0};
+    std::vector<uint8_t> errors;
+
+    [[nodiscard]] auto size() const -> std::size_t { return errors.size(); }
+
+    [[nodiscard]] auto at(std::size_t i) const -> std::vector<uint8_t> {
+        return {bytes.begin() + offsets[i], bytes.begin() + offsets[i + 1]};
+    }
+};
+
+/**
+ * Long URIs stored back to back, laid out like MicroUriColumn.
+ */
+struct LongUriColumn {
+    std::string chars;
+    std::vector<std::size_t> offsets{0};
+    std::vector<uint8_t> errors;
+
+    [[nodiscard]] auto size() const -> std::size_t { return errors.size(); }
+
+    [[nodiscard]] auto at(std::size_t i) const -> std::string_view {
+        return std::string_view(chars).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+/**
+ * Converts columns of URIs between the long and the micro form, e.g. for offline
+ * processing of logged URIs. Input is columnar as well: count URIs stored back to
+ * back in an arena, entry i at [offsets[i], offsets[i + 1]).
+ *
+ * The batch is cut into chunks that run in parallel on a ThreadPool (or on the calling
+ * thread without one), every chunk writes its own output which is then joined in input
+ * order. The long form carries names and the micro form ids, an optional resolver fills
+ * in what the target form needs; it is called concurrently from the pool's workers and
+ * an entry it returns false for fails with UriError::Unresolved. An entry that still
+ * lacks the ids fails with UriError::NotMicroForm, one without names with Empty.
+ * May be called from a worker of pool: the calling thread converts chunks as well and
+ * never waits for a task that did not start.
+ */
+class BatchUriConverter {
+public:
+    /** Fills in the ids (or names) of a deserialized UUri, false to fail the entry */
+    using Resolver = std::function<bool(v1::UUri&)>;
+
+    /** Entries per chunk, unless the batch is split more finely to keep every worker busy */
+    static constexpr std::size_t ChunkSize = 4096;
+
+    static auto longToMicro(std::string_view arena,
+                            const std::size_t* offsets,
+                            std::size_t count,
+                            utils::ThreadPool* pool = nullptr,
+                            const Resolver& resolve = nullptr) -> MicroUriColumn;
+
+    static auto microToLong(const uint8_t* arena,
+                            const std::size_t* offsets,
+                            std::size_t count,
+                            utils::ThreadPool* pool = nullptr,
+                            const Resolver& resolve = nullptr) -> LongUriColumn;
+
+    static auto microToLong(const MicroUriColumn& column,
+                            utils::ThreadPool* pool = nullptr,
+                            const Resolver& resolve = nullptr) -> LongUriColumn {
+        return microToLong(column.bytes.data(), column.offsets.data(), column.size(), pool, resolve);
+    }
+
+    static auto longToMicro(const LongUriColumn& column,
+                            utils::ThreadPool* pool = nullptr,
+                            const Resolver& resolve = nullptr) -> MicroUriColumn {
+        return longToMicro(column.chars, column.offsets.data(), column.size(), pool, resolve);
+    }
+
+private:
+    BatchUriConverter() = default;
+};
+
+}  // namespace uprotocol::uri
+
+#endif  // BATCH_URI_CONVERTER_H_
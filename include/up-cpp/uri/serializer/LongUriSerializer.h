@@ -29,12 +29,36 @@
 #include <up-cpp/uri/builder/BuildEntity.h>
 #include <up-cpp/uri/builder/BuildUAuthority.h>
 #include <up-cpp/uri/builder/BuildUUri.h>
+#include <up-cpp/uri/serializer/UriError.h>
 #include <up-cpp/uri/tools/Utils.h>
+#include <up-cpp/utils/Expected.h>
 #include <up-core-api/uri.pb.h>
 #include <string_view>
 
 namespace uprotocol::uri {
 
+/**
+ * Views into a long format URI string, as produced by LongUriSerializer::parse().
+ * The views point into the parsed string and are only valid as long as it is.
+ * Names that deserialize() would drop (blank ones) are left empty here too.
+ */
+struct LongUriParts {
+    /** true for local URIs ("/entity/..."), false for remote ones ("//authority/...") */
+    bool isLocal = true;
+    /** authority name of a remote URI, as written (deserialize() lower-cases it) */
+    std::string_view authority;
+    std::string_view entityName;
+    /** version token as written, e.g. "2" or "2.7" */
+    std::string_view entityVersion;
+    bool hasVersionMajor = false;
+    uint32_t versionMajor = 0;
+    bool hasVersionMinor = false;
+    uint32_t versionMinor = 0;
+    std::string_view resourceName;
+    std::string_view resourceInstance;
+    std::string_view resourceMessage;
+};
+
 /**
  * UUri Serializer that serializes a UUri to a string (long format) per
  * https://github.com/eclipse-uprotocol/uprotocol-spec/blob/main/basics/uri.adoc
@@ -49,12 +73,42 @@ public:
      */
     static auto serialize(const v1::UUri& uri) -> std::string;
 
+    /**
+     * Serialize a UUri into a caller supplied string, replacing its content.
+     * The exact output length is computed first and the string is written once,
+     * so reusing the same string across calls does not allocate once it has grown.
+     * @param uri UUri object to be serialized to the String format.
+     * @param out Receives the String format of the supplied UUri.
+     * @return Returns the length of the serialized UUri.
+     */
+    static auto serialize(const v1::UUri& uri, std::string& out) -> std::size_t;
+
     /**
      * Deserialize a String into a UUri object.
      * @param uProtocolUri A long format uProtocol URI.
      * @return Returns an UUri data object.
      */
-    static auto deserialize(std::string const& protocol_uri) -> v1::UUri;
+    static auto deserialize(std::string_view protocol_uri) -> v1::UUri;
+
+    /**
+     * Deserialize a String into a UUri object, reporting failures as an error
+     * code instead of an empty UUri. Does not throw.
+     * @param protocol_uri A long format uProtocol URI.
+     * @return Returns the UUri, UriError::Empty for an empty string,
+     * UriError::InvalidVersion for a version that is not a number and
+     * UriError::Malformed for anything else deserialize() makes an empty UUri of.
+     */
+    static auto tryDeserialize(std::string_view protocol_uri) -> utils::Expected<v1::UUri, UriError>;
+
+    /**
+     * Tokenize a long format URI in a single pass without allocating or building a UUri.
+     * Follows exactly the rules of deserialize(), including std::stoi like exceptions
+     * for malformed numeric versions.
+     * @param protocol_uri A long format uProtocol URI.
+     * @param parts Receives views into protocol_uri.
+     * @return false if deserialize() would return an empty UUri.
+     */
+    static auto parse(std::string_view protocol_uri, LongUriParts &parts) -> bool;
 
    /**
      * Create the resource part of the Uri from a resource object.
@@ -87,6 +141,11 @@ public:
 private:
     LongUriSerializer() = default;
 
+    /**
+     * Build the UUri of a parsed long format URI.
+     */
+    static auto build(const LongUriParts &parts) -> v1::UUri;
+
     /**
      * Trim from start of a string (in place).
      * @param s String to be trimmed.
@@ -145,53 +204,25 @@ private:
     }
 
     /**
-     * Splits this string around matches of the given string delimiter.
-     * Trailing empty strings are therefore not included in the resulting array.
-     * @param str String to be split.
-     * @param delimiter Delimiter to split the string.
-     * @return Returns a vector of strings.
+     * Split the resource token into name, instance and message views.
+     * @param resource_string token holding name + instance + message.
+     * @param parts Receives the resource views.
      */
-    [[nodiscard]] static auto split(std::string str,
-                      const std::string_view& delimiter) -> std::vector<std::string>;
-
-    [[nodiscard]] static auto parseUResource(const std::string& resource_string) -> v1::UResource;
+    static auto parseUResource(std::string_view resource_string, LongUriParts &parts) -> void;
 
     /**
-     * Static factory method for creating a UEntity using a string that contains
-     * name and version.
-     * @param entity String that contains the UEntity information.
-     * @param version String that contains the UEntity version.
-     * @return Returns a UEntity object.
+     * Parse the version token the same way BuildUEntity::setVersion() does.
+     * @param version version token.
+     * @param parts Receives the version numbers.
      */
-    [[nodiscard]] static auto parseUEntity(const std::string &entity, const std::string &version) -> v1::UEntity;
+    static auto parseVersion(std::string_view version, LongUriParts &parts) -> void;
 
     /**
-     * Static factory method for creating a UUri using a vector of strings that contains
-     * the Local UUri information.
-     * @param uri_parts Vector of strings that contains the Local UUri information.
-     * @return Returns a v1::UUri object.
-     */
-    [[nodiscard]] static auto parseLocalUUri(const std::vector<std::string>& uri_parts) -> v1::UUri;
-
-    /**
-     * Static factory method for creating a UUri using a vector of strings that contains
-     * the Remote UUri information.
-     * @param uriParts Vector of strings that contains the Remote UUri information.
-     * @return Returns a UUri object.
-    */
-    [[nodiscard]] static auto parseRemoteUUri(const std::vector<std::string>& uri_parts) -> v1::UUri;
-    /**
-     * Verify if the given URI string is local
-     * @param uri 
-     * @return 
-     */
-    [[nodiscard]] static auto inline isLocality(const std::string_view &uri) -> bool;
-    /**
-     * find the first not empty value in the vector and return location
-     * @param uri_parts 
-     * @return 
+     * std::stoi on a string_view, without copying it.
+     * @param str String holding the number.
+     * @return Returns the parsed number, throws std::invalid_argument / std::out_of_range as std::stoi.
      */
-    [[nodiscard]] static auto inline getFirstNotEmpty(const std::vector<std::string> &uri_parts) -> uint64_t ;
+    [[nodiscard]] static auto toInt(std::string_view str) -> int;
 }; // class LongUriSerializer
 
 } // namespace uprotocol::uri
@@ -30,6 +30,8 @@
 #include <up-cpp/uri/builder/BuildEntity.h>
 #include <up-cpp/uri/builder/BuildUResource.h>
 #include "up-cpp/uri/tools/IpAddress.h"
+#include <up-cpp/uri/serializer/UriError.h>
+#include <up-cpp/utils/Expected.h>
 
 namespace uprotocol::uri {
 
@@ -54,6 +56,29 @@ public:
      */
     [[nodiscard]] static auto serialize(const uprotocol::v1::UUri& u_uri) -> std::vector<uint8_t>;
 
+    /**
+     * Serialize a UUri into a caller provided buffer following the Micro-URI specifications.
+     * Nothing is allocated; a buffer of MaxMicroUriLength bytes fits any micro URI.
+     * @param u_uri The UUri data object.
+     * @param buffer destination of the serialized UUri.
+     * @param size size of buffer in bytes.
+     * @return Returns the number of bytes written, 0 if the UUri cannot be serialized
+     *         or does not fit into buffer.
+     */
+    [[nodiscard]] static auto serialize(const uprotocol::v1::UUri& u_uri,
+                                        uint8_t* buffer,
+                                        std::size_t size) -> std::size_t;
+
+    /**
+     * Same as serialize(u_uri, buffer, size), reporting why the UUri cannot be
+     * serialized instead of logging it.
+     * @return Returns the number of bytes written, or UriError::Empty,
+     *         NotMicroForm, InvalidAuthorityType or BufferTooSmall.
+     */
+    [[nodiscard]] static auto trySerialize(const uprotocol::v1::UUri& u_uri,
+                                           uint8_t* buffer,
+                                           std::size_t size) -> utils::Expected<std::size_t, UriError>;
+
     /**
      * Serialize a UAuthority into a vector<uint8_t> following the Micro-URI specifications.
      * @param u_auth The UAuthority data object.
@@ -68,6 +93,32 @@ public:
      */
     [[nodiscard]] static auto deserialize(std::vector<uint8_t> const& micro_uri) -> uprotocol::v1::UUri;
 
+    /**
+     * Deserialize a micro URI held in a caller provided buffer into a UUri object.
+     * @param micro_uri pointer to the uProtocol micro URI bytes.
+     * @param size number of bytes in micro_uri.
+     * @return Returns an UUri data object from the serialized format of a micro URI.
+     */
+    [[nodiscard]] static auto deserialize(const uint8_t* micro_uri, std::size_t size) -> uprotocol::v1::UUri;
+
+    /**
+     * Deserialize a micro URI into a UUri object, reporting failures as an
+     * error code instead of an empty UUri. Nothing is built or logged on failure.
+     * @param micro_uri A vector<uint8_t> uProtocol micro URI.
+     * @return Returns the UUri, or UriError::Empty, InvalidLength, InvalidVersion,
+     *         InvalidAuthorityType or IdLengthMismatch.
+     */
+    [[nodiscard]] static auto tryDeserialize(std::vector<uint8_t> const& micro_uri)
+        -> utils::Expected<uprotocol::v1::UUri, UriError>;
+
+    /**
+     * Same as above for a micro URI held in a caller provided buffer.
+     * @param micro_uri pointer to the uProtocol micro URI bytes.
+     * @param size number of bytes in micro_uri.
+     */
+    [[nodiscard]] static auto tryDeserialize(const uint8_t* micro_uri, std::size_t size)
+        -> utils::Expected<uprotocol::v1::UUri, UriError>;
+
 private:
     /**
      * Default MicroUriSerializer constructor.
@@ -79,6 +130,12 @@ private:
      * @return AuthorityType, with AuthorityType::Invalid indicating an unsupported type
      */
     [[nodiscard]] static auto getAuthorityType(uint8_t type) -> AuthorityType;
+    /**
+     * Get the AuthorityType a UAuthority serializes to
+     * @param u_auth
+     * @return AuthorityType, with AuthorityType::Invalid indicating an authority that cannot be serialized
+     */
+    [[nodiscard]] static auto getAuthorityType(const uprotocol::v1::UAuthority& u_auth) -> AuthorityType;
     /**
      * Check that the micro URI size fit the definitions
      * @param size 
@@ -92,7 +149,7 @@ private:
      * @param type 
      * @return uprotocol::v1::UAuthority if address is not valid UAuthority return empty
      */
-    [[nodiscard]] static auto getUauthority(const std::vector<uint8_t> &addr, AuthorityType type) -> uprotocol::v1::UAuthority;
+    [[nodiscard]] static auto getUauthority(const uint8_t* addr, std::size_t size, AuthorityType type) -> uprotocol::v1::UAuthority;
     /**
      * Debug function to print the ip address
      * @param ip 
@@ -145,6 +202,11 @@ private:
     static constexpr uint32_t IdMicroUriMaxLength =
         MicroUriHeaderLength + UAuthorityIdLenSize + UAuthorityIdMaxLength;
 public:
+    /**
+     * The maximum length of any micro URI, the buffer size that fits every
+     * serialize(u_uri, buffer, size) output.
+     */
+    static constexpr uint32_t MaxMicroUriLength = IdMicroUriMaxLength;
     /**
      * Starting position of the Authority in the micro URI.
      * @remarks Public because the Zenoh client URI mapping spec requires other
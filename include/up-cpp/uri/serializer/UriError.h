@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef URI_ERROR_H_
+#define URI_ERROR_H_
+
+#include <cstdint>
+#include <string_view>
+
+namespace uprotocol::uri {
+
+/**
+ * Why a URI could not be serialized or deserialized, as returned by the
+ * try* functions of LongUriSerializer and MicroUriSerializer.
+ */
+enum class UriError : uint8_t {
+    Empty = 1,             /* empty input, or a UUri with nothing to serialize */
+    Malformed,             /* long URI that does not deserialize to a UUri */
+    InvalidVersion,        /* long URI version that is not a number, or unknown micro URI version */
+    InvalidAuthorityType,  /* micro URI authority type that is not supported */
+    InvalidLength,         /* micro URI length that does not match its authority type */
+    IdLengthMismatch,      /* micro URI ID_LEN field that does not match the ID */
+    NotMicroForm,          /* UUri without the ids a micro URI needs */
+    BufferTooSmall,        /* caller buffer that cannot hold the micro URI */
+    Unresolved             /* UUri a resolver could not complete for the other form */
+};
+
+[[nodiscard]] constexpr auto toString(UriError error) -> std::string_view {
+    switch (error) {
+        case UriError::Empty:
+            return "empty";
+        case UriError::Malformed:
+            return "malformed";
+        case UriError::InvalidVersion:
+            return "invalid version";
+        case UriError::InvalidAuthorityType:
+            return "invalid authority type";
+        case UriError::InvalidLength:
+            return "invalid length";
+        case UriError::IdLengthMismatch:
+            return "ID length mismatch";
+        case UriError::NotMicroForm:
+            return "not micro form";
+        case UriError::BufferTooSmall:
+            return "buffer too small";
+        case UriError::Unresolved:
+            return "unresolved";
+    }
+    return "unknown";
+}
+
+}  // namespace uprotocol::uri
+
+#endif  // URI_ERROR_H_
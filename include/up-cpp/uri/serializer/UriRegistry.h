@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef URI_REGISTRY_H_
+#define URI_REGISTRY_H_
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <up-core-api/uri.pb.h>
+
+namespace uprotocol::uri {
+
+/**
+ * Thread safe cache of interned UUris.
+ * Every entry holds an immutable UUri together with its long form, its micro form and
+ * its packed 64 bit key, so translating a known URI between forms is a hash lookup.
+ * The long, micro and key indices are each split into shards with their own lock and
+ * LRU list; each index holds at most capacity entries.
+ */
+class UriRegistry {
+public:
+    /**
+     * An interned UUri in all its forms. Forms the UUri cannot be serialized to are empty
+     * (key 0). hash is the UriHash of the UUri, computed once for use as a container key.
+     */
+    struct Entry {
+        v1::UUri uri;
+        std::string longUri;
+        std::vector<uint8_t> microUri;
+        uint64_t key = 0;
+        std::size_t hash = 0;
+    };
+
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    static constexpr std::size_t DefaultCapacity = 4096;
+
+    /**
+     * @param capacity maximum number of entries kept by each index.
+     */
+    explicit UriRegistry(std::size_t capacity = DefaultCapacity);
+
+    UriRegistry(const UriRegistry&) = delete;
+    UriRegistry& operator=(const UriRegistry&) = delete;
+
+    /**
+     * Look up (or parse and intern) a long format URI.
+     * @param long_uri A long format uProtocol URI.
+     * @return Returns the entry, nullptr if the URI deserializes to an empty UUri.
+     */
+    auto fromLong(std::string_view long_uri) -> EntryPtr;
+
+    /**
+     * Look up (or parse and intern) a micro format URI.
+     * @param micro_uri pointer to the micro URI bytes.
+     * @param size number of bytes in micro_uri.
+     * @return Returns the entry, nullptr if the URI deserializes to an empty UUri.
+     */
+    auto fromMicro(const uint8_t* micro_uri, std::size_t size) -> EntryPtr;
+
+    auto fromMicro(const std::vector<uint8_t>& micro_uri) -> EntryPtr {
+        return fromMicro(micro_uri.data(), micro_uri.size());
+    }
+
+    /**
+     * Look up (or rebuild and intern) a UUri from its packed key.
+     * @param key packed key as returned by packKey().
+     * @return Returns the entry, nullptr if key is 0.
+     */
+    auto fromKey(uint64_t key) -> EntryPtr;
+
+    /**
+     * Intern a UUri, indexed by every form it can be serialized to.
+     * @param uri the UUri to intern.
+     * @return Returns the entry, nullptr if uri is empty.
+     */
+    auto intern(const v1::UUri& uri) -> EntryPtr;
+
+    /**
+     * Pack a local micro form UUri into a 64 bit key:
+     * bits 0-15 resource id, 16-31 entity id, 32-39 major version, 40-47 authority type,
+     * 48-63 reserved (0).
+     * @param uri the UUri to pack.
+     * @return Returns the key, 0 if the UUri is not a local micro form UUri.
+     */
+    [[nodiscard]] static auto packKey(const v1::UUri& uri) -> uint64_t;
+
+    /**
+     * Rebuild the UUri described by a packed key.
+     * @param key packed key as returned by packKey().
+     * @return Returns the UUri, empty if key is 0.
+     */
+    [[nodiscard]] static auto unpackKey(uint64_t key) -> v1::UUri;
+
+    /**
+     * @return number of entries in the long, micro and key indices together.
+     */
+    auto size() const -> std::size_t;
+
+    void clear();
+
+private:
+    static constexpr std::size_t Shards = 16;
+
+    /**
+     * One lock protected slice of an index. String keys are views into the node,
+     * which keeps its own copy of the looked up bytes.
+     */
+    template<typename Key>
+    struct Shard {
+        struct Node {
+            std::string storage;
+            Key key;
+            EntryPtr entry;
+        };
+
+        mutable std::mutex mutex;
+        std::list<Node> lru;
+        std::unordered_map<Key, typename std::list<Node>::iterator> index;
+    };
+
+    template<typename Key>
+    using Index = std::array<Shard<Key>, Shards>;
+
+    template<typename Key>
+    static auto shardOf(Index<Key>& index, const Key& key) -> Shard<Key>&;
+
+    template<typename Key>
+    auto find(Index<Key>& index, const Key& key) -> EntryPtr;
+
+    template<typename Key>
+    void insert(Index<Key>& index, const Key& key, const EntryPtr& entry);
+
+    auto makeEntry(v1::UUri&& uri) -> EntryPtr;
+
+    void insertAll(const EntryPtr& entry);
+
+    const std::size_t shardCapacity_;
+    Index<std::string_view> longIndex_;
+    Index<std::string_view> microIndex_;
+    Index<uint64_t> keyIndex_;
+};
+
+} // namespace uprotocol::uri
+
+#endif // URI_REGISTRY_H_
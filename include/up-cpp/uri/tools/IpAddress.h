@@ -25,9 +25,11 @@
 #ifndef IP_ADDRESS_H_
 #define IP_ADDRESS_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
-#include <type_traits>
 #include <vector>
 
 // Forward declare UAuthority so we can implement a constructor that consumes it
@@ -41,6 +43,11 @@ namespace uprotocol::uri {
 
 /**
  * IpAddress holds the string and byte representaion.
+ *
+ * Both are stored inline, so an IpAddress never allocates. The string form is
+ * kept as given when constructed from a string and is otherwise formatted (in
+ * the canonical form inet_ntop produces) when it is asked for. Strings are
+ * parsed by hand, accepting exactly what inet_pton accepts.
  */
 class IpAddress {
 
@@ -57,15 +64,22 @@ public:
     /**
      * Constructor with IP address in string format.
      */
-    explicit IpAddress(std::string_view const ipString) : ipString_(ipString) {
-        fromString();
+    explicit IpAddress(std::string_view const ipString) {
+        fromString(ipString);
     }
 
     /**
      * Constructor with IP address in byte format.
      */
-    IpAddress(std::vector<uint8_t> const& ipBytes, Type type) : type_(type), ipBytes_(ipBytes) {
-        fromBytes();
+    IpAddress(std::vector<uint8_t> const& ipBytes, Type type)
+        : IpAddress(ipBytes.data(), ipBytes.size(), type) {
+    }
+
+    /**
+     * Constructor with IP address in byte format, from a caller provided buffer.
+     */
+    IpAddress(const uint8_t* ipBytes, std::size_t size, Type type) : type_(type) {
+        fromBytes(ipBytes, size);
     }
 
     IpAddress(uprotocol::v1::UAuthority const&);
@@ -78,23 +92,39 @@ public:
     /**
      * Get the string format of IP address.
      */
-    auto getString() const -> std::string { return ipString_; }
+    auto getString() const -> std::string;
+
+    /**
+     * Write the string format of IP address into a caller provided buffer,
+     * without a terminating null character; MaxStringLength bytes fit any address.
+     * @return number of characters written, 0 if the address is invalid or
+     *         does not fit into buffer
+     */
+    auto format(char* buffer, std::size_t size) const -> std::size_t;
 
     /**
      * Get the byte format of IP address.
      */
-    auto getBytes() const { return ipBytes_; }
+    auto getBytes() const {
+        return std::vector<uint8_t>(ipBytes_.begin(), ipBytes_.begin() + ipLength_);
+    }
 
     /**
      * Get the byte format of IP address, but in a string-like container
      * to better interface with flat buffers.
      */
     auto getBytesString() const {
+        return static_cast<std::string>(getBytesView());
+    }
+
+    /**
+     * Get the byte format of IP address as a view of the bytes held by this
+     * instance, e.g. to set a UAuthority without an intermediate copy.
+     */
+    auto getBytesView() const -> std::string_view {
         // char is a signed int - explicit reinterpretation from unsigned char
         // is required here since we want to preserve the exact binary data
-        std::string_view ipBytesString(
-                reinterpret_cast<StrBytesPtr>(ipBytes_.data()), ipBytes_.size());
-        return static_cast<std::string>(ipBytesString);
+        return std::string_view(reinterpret_cast<const char*>(ipBytes_.data()), ipLength_);
     }
 
     /**
@@ -105,17 +135,22 @@ public:
      * Number of bytes in IPv6 address.
      */
     static constexpr uint8_t IpV6AddressBytes = 16;
+    /**
+     * Length of the longest valid IP address string
+     * ("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255").
+     */
+    static constexpr uint8_t MaxStringLength = 45;
 
 private:
     /**
-     *  Updates the state of this instance from the value of the ipString_ field
+     * Updates the state of this instance from an address string
      */
-    void fromString();
+    void fromString(std::string_view ipString);
 
     /**
-     * Updates state of this instance from the value of the ipBytes_ field
+     * Updates state of this instance from address bytes
      */
-    void fromBytes();
+    void fromBytes(const uint8_t* ipBytes, std::size_t size);
 
     /**
      * Type of the IP addess.
@@ -123,22 +158,24 @@ private:
     Type type_ = Type::Invalid;
 
     /**
-     * IP address in byte format.
+     * Number of valid bytes in ipBytes_, 0 if the address is invalid.
      */
-    std::vector<uint8_t> ipBytes_{};
+    uint8_t ipLength_ = 0;
 
     /**
-     * IP address in string format.
+     * Number of valid characters in ipString_, 0 unless constructed from a string.
      */
-    std::string ipString_{};
+    uint8_t stringLength_ = 0;
 
-    using Bytes = typename std::decay_t<decltype(ipBytes_)>::value_type;
-    using StrBytes = typename std::string_view::value_type;
-    using StrBytesPtr = typename std::string_view::const_pointer;
+    /**
+     * IP address in byte format.
+     */
+    std::array<uint8_t, IpV6AddressBytes> ipBytes_{};
 
-    static_assert(sizeof(StrBytes) == sizeof(Bytes),
-        "Mismatch in size between string_view value type and ipBytes_ "
-        "value type invalidates reinterpret_cast used in constructor.");
+    /**
+     * IP address in string format, as it was given to the string constructor.
+     */
+    std::array<char, MaxStringLength> ipString_{};
 
 }; // class IpAddress
 
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UPROTOCOL_CPP_STATIC_URI_H
+#define UPROTOCOL_CPP_STATIC_URI_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <up-cpp/uri/tools/UriHash.h>
+#include "up-core-api/uri.pb.h"
+
+namespace uprotocol::uri {
+
+/**
+ * A URI known at build time, validated and laid out by the compiler.
+ *
+ *     constexpr StaticUri DoorTopic("/body.access/1/door.front_left#Door", 0x1102, 0x8001);
+ *
+ * The long URI must be in the canonical form LongUriSerializer::serialize()
+ * writes: "/entity/major[.minor][/resource[.instance][#message]]" or the same
+ * after "//authority", without blanks or empty parts. A StaticUri that is
+ * evaluated at compile time does not compile if the string is not; at run time
+ * the constructor throws std::invalid_argument instead.
+ *
+ * With entity and resource ids a local URI is resolved and provides its micro
+ * URI bytes and UriRegistry key as constants. hash() equals UriHash of uri() and,
+ * without ids, of the long URI, so a StaticUri can probe a UriMap directly.
+ */
+class StaticUri {
+public:
+    static constexpr std::size_t MicroLength = 8;
+
+    constexpr explicit StaticUri(std::string_view long_uri, uint16_t entity_id = 0, uint16_t resource_id = 0)
+        : longUri_(long_uri) {
+        parse(long_uri);
+        fields_.foldAuthorityName = true;
+        fields_.hasEntityId = (0 != entity_id);
+        fields_.entityId = entity_id;
+        fields_.hasResourceId = (0 != resource_id);
+        fields_.resourceId = resource_id;
+        hash_ = fields_.hash();
+
+        if (fields_.authorityName.empty() && (0 != entity_id) && (0 != resource_id)) {
+            const auto version = static_cast<uint8_t>(fields_.versionMajor);
+            micro_ = {1, 0,
+                      static_cast<uint8_t>(resource_id >> 8), static_cast<uint8_t>(resource_id & 0xFF),
+                      static_cast<uint8_t>(entity_id >> 8), static_cast<uint8_t>(entity_id & 0xFF),
+                      version, 0};
+            key_ = static_cast<uint64_t>(resource_id) | (static_cast<uint64_t>(entity_id) << 16) |
+                   (static_cast<uint64_t>(version) << 32);
+        }
+    }
+
+    /**
+     * @return the long URI as written
+     */
+    [[nodiscard]] constexpr auto longUri() const -> std::string_view { return longUri_; }
+
+    [[nodiscard]] constexpr auto fields() const -> const UriFields & { return fields_; }
+
+    [[nodiscard]] constexpr auto hash() const -> std::size_t { return hash_; }
+
+    /**
+     * @return true for a local URI with entity and resource ids
+     */
+    [[nodiscard]] constexpr auto isMicroForm() const -> bool { return 0 != key_; }
+
+    /**
+     * @return the micro URI bytes, all 0 if not isMicroForm()
+     */
+    [[nodiscard]] constexpr auto micro() const -> const std::array<uint8_t, MicroLength> & { return micro_; }
+
+    [[nodiscard]] constexpr auto microView() const -> MicroUriView {
+        return isMicroForm() ? MicroUriView{micro_.data(), micro_.size()} : MicroUriView{};
+    }
+
+    /**
+     * @return the UriRegistry::packKey() of uri(), 0 if not isMicroForm()
+     */
+    [[nodiscard]] constexpr auto key() const -> uint64_t { return key_; }
+
+    /**
+     * Build the UUri, with the authority name lower-cased as
+     * LongUriSerializer::deserialize() does. Nothing is parsed.
+     */
+    [[nodiscard]] auto uri() const -> v1::UUri {
+        v1::UUri result;
+        auto *authority = result.mutable_authority();
+        if (!fields_.authorityName.empty()) {
+            auto *name = authority->mutable_name();
+            name->reserve(fields_.authorityName.size());
+            for (auto c : fields_.authorityName) {
+                name->push_back(((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c);
+            }
+        }
+        auto *entity = result.mutable_entity();
+        entity->set_name(fields_.entityName.data(), fields_.entityName.size());
+        if (fields_.hasEntityId) {
+            entity->set_id(fields_.entityId);
+        }
+        entity->set_version_major(fields_.versionMajor);
+        if (fields_.hasVersionMinor) {
+            entity->set_version_minor(fields_.versionMinor);
+        }
+        auto *resource = result.mutable_resource();
+        if (!fields_.resourceName.empty()) {
+            resource->set_name(fields_.resourceName.data(), fields_.resourceName.size());
+        }
+        if (!fields_.resourceInstance.empty()) {
+            resource->set_instance(fields_.resourceInstance.data(), fields_.resourceInstance.size());
+        }
+        if (!fields_.resourceMessage.empty()) {
+            resource->set_message(fields_.resourceMessage.data(), fields_.resourceMessage.size());
+        }
+        if (fields_.hasResourceId) {
+            resource->set_id(fields_.resourceId);
+        }
+        return result;
+    }
+
+    /**
+     * @return a key for a UriMap, sharing nothing with this StaticUri
+     */
+    [[nodiscard]] auto interned() const -> InternedUri { return InternedUri(uri()); }
+
+    /**
+     * Probe a UriMap without building the UUri.
+     */
+    [[nodiscard]] auto probe() const -> InternedUri { return InternedUri::probe(fields_); }
+
+private:
+    /* the next '/' separated part of the string, rejecting blanks and empty parts */
+    static constexpr auto token(std::string_view &rest) -> std::string_view {
+        const auto end = rest.find('/');
+        const auto part = rest.substr(0, end);
+        if (part.empty()) {
+            fail("empty part in static URI");
+        }
+        for (auto c : part) {
+            if ((c <= ' ') || ('\\' == c) || (0x7f == c)) {
+                fail("blank or separator in static URI");
+            }
+        }
+        rest = (std::string_view::npos == end) ? std::string_view() : rest.substr(end + 1);
+        return part;
+    }
+
+    static constexpr auto number(std::string_view digits) -> uint32_t {
+        if (digits.empty()) {
+            fail("missing version number in static URI");
+        }
+        uint32_t value = 0;
+        for (auto c : digits) {
+            if ((c < '0') || (c > '9') || (value > static_cast<uint32_t>((INT32_MAX - (c - '0')) / 10))) {
+                fail("invalid version number in static URI");
+            }
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+        }
+        return value;
+    }
+
+    static constexpr auto nonEmpty(std::string_view part) -> std::string_view {
+        if (part.empty()) {
+            fail("empty resource part in static URI");
+        }
+        return part;
+    }
+
+    constexpr void parse(std::string_view uri) {
+        if ((uri.size() < 2) || ('/' != uri[0])) {
+            fail("static URI must start with '/'");
+        }
+        auto rest = uri.substr(1);
+        if ('/' == rest[0]) {
+            rest = rest.substr(1);
+            fields_.authorityName = token(rest);
+        }
+        fields_.entityName = token(rest);
+
+        const auto version = token(rest);
+        const auto dot = version.find('.');
+        fields_.hasVersionMajor = true;
+        fields_.versionMajor = number(version.substr(0, dot));
+        if (std::string_view::npos != dot) {
+            fields_.hasVersionMinor = true;
+            fields_.versionMinor = number(version.substr(dot + 1));
+        }
+
+        if (rest.empty()) {
+            if ('/' == uri.back()) {
+                fail("empty part in static URI");
+            }
+            return;
+        }
+        auto resource = token(rest);
+        if (!rest.empty() || ('/' == uri.back())) {
+            fail("too many parts in static URI");
+        }
+        const auto hash = resource.find('#');
+        if (std::string_view::npos != hash) {
+            fields_.resourceMessage = nonEmpty(resource.substr(hash + 1));
+            if (std::string_view::npos != fields_.resourceMessage.find('#')) {
+                fail("second '#' in static URI");
+            }
+            resource = resource.substr(0, hash);
+        }
+        const auto dot_instance = resource.find('.');
+        fields_.resourceName = nonEmpty(resource.substr(0, dot_instance));
+        if (std::string_view::npos != dot_instance) {
+            fields_.resourceInstance = nonEmpty(resource.substr(dot_instance + 1));
+        }
+    }
+
+    /* not a constant expression: a StaticUri evaluated at compile time reports the error there */
+    [[noreturn]] static void fail(const char *reason) { throw std::invalid_argument(reason); }
+
+    std::string_view longUri_;
+    UriFields fields_;
+    std::size_t hash_ = 0;
+    std::array<uint8_t, MicroLength> micro_ = {};
+    uint64_t key_ = 0;
+};
+
+namespace literals {
+
+/**
+ * "/body.access/1/door.front_left#Door"_uri, a StaticUri without ids.
+ */
+constexpr auto operator""_uri(const char *uri, std::size_t size) -> StaticUri {
+    return StaticUri(std::string_view(uri, size));
+}
+
+}  // namespace literals
+
+}  // namespace uprotocol::uri
+
+#endif //UPROTOCOL_CPP_STATIC_URI_H
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UPROTOCOL_CPP_URI_HASH_H
+#define UPROTOCOL_CPP_URI_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/UriRegistry.h>
+#include <up-cpp/uri/tools/UriKey.h>
+#include "up-core-api/uri.pb.h"
+
+namespace uprotocol::uri {
+
+/**
+ * A micro format URI, to probe a map keyed by UUri without deserializing it.
+ */
+struct MicroUriView {
+    const uint8_t *data = nullptr;
+    std::size_t size = 0;
+};
+
+/**
+ * The fields of a URI that make up its identity, as views into a UUri, a
+ * micro URI or a long URI. Empty strings count as not set; the numeric
+ * fields count with their presence, as the serializers set them.
+ */
+struct UriFields {
+    std::string_view authorityName;
+    /* the name is compared lower-cased, as LongUriSerializer::deserialize() stores it */
+    bool foldAuthorityName = false;
+    std::string_view authorityIp;
+    std::string_view authorityId;
+    std::string_view entityName;
+    bool hasEntityId = false;
+    uint32_t entityId = 0;
+    bool hasVersionMajor = false;
+    uint32_t versionMajor = 0;
+    bool hasVersionMinor = false;
+    uint32_t versionMinor = 0;
+    std::string_view resourceName;
+    std::string_view resourceInstance;
+    std::string_view resourceMessage;
+    bool hasResourceId = false;
+    uint32_t resourceId = 0;
+
+    /**
+     * Fields of a UUri, valid while the UUri is.
+     */
+    static auto of(v1::UUri const &uri) -> UriFields {
+        UriFields fields;
+        const auto &authority = uri.authority();
+        fields.authorityName = authority.name();
+        fields.authorityIp = authority.ip();
+        fields.authorityId = authority.id();
+        const auto &entity = uri.entity();
+        fields.entityName = entity.name();
+        fields.hasEntityId = entity.has_id();
+        fields.entityId = entity.id();
+        fields.hasVersionMajor = entity.has_version_major();
+        fields.versionMajor = entity.version_major();
+        fields.hasVersionMinor = entity.has_version_minor();
+        fields.versionMinor = entity.version_minor();
+        const auto &resource = uri.resource();
+        fields.resourceName = resource.name();
+        fields.resourceInstance = resource.instance();
+        fields.resourceMessage = resource.message();
+        fields.hasResourceId = resource.has_id();
+        fields.resourceId = resource.id();
+        return fields;
+    }
+
+    /**
+     * Fields of the UUri MicroUriSerializer::deserialize() makes of a micro URI,
+     * valid while the bytes are.
+     */
+    static auto of(MicroUriView micro) -> UriFields {
+        UriFields fields;
+        const auto key = UriKey::fromMicro(micro.data, micro.size);
+        if (key.isEmpty()) {
+            return fields;
+        }
+
+        constexpr std::size_t HeaderLength = 8;
+        std::string_view address(reinterpret_cast<const char *>(micro.data) + HeaderLength, micro.size - HeaderLength);
+        switch (key.authorityKind()) {
+            case UriKey::AuthorityKind::IpV4:
+            case UriKey::AuthorityKind::IpV6:
+                fields.authorityIp = address;
+                break;
+            case UriKey::AuthorityKind::Id:
+                fields.authorityId = address.substr(1);
+                break;
+            default:
+                break;
+        }
+        fields.hasEntityId = (0 != key.entityId());
+        fields.entityId = key.entityId();
+        fields.hasVersionMajor = true;
+        fields.versionMajor = key.versionMajor();
+        fields.hasResourceId = (0 != key.resourceId());
+        fields.resourceId = key.resourceId();
+        return fields;
+    }
+
+    /**
+     * Fields of the UUri LongUriSerializer::deserialize() makes of a long URI,
+     * valid while the string is. Throws where deserialize() throws.
+     */
+    static auto of(std::string_view longUri) -> UriFields {
+        UriFields fields;
+        LongUriParts parts;
+        if (!LongUriSerializer::parse(longUri, parts)) {
+            return fields;
+        }
+        fields.authorityName = parts.authority;
+        fields.foldAuthorityName = true;
+        fields.entityName = parts.entityName;
+        fields.hasVersionMajor = parts.hasVersionMajor;
+        fields.versionMajor = parts.versionMajor;
+        fields.hasVersionMinor = parts.hasVersionMinor;
+        fields.versionMinor = parts.versionMinor;
+        fields.resourceName = parts.resourceName;
+        fields.resourceInstance = parts.resourceInstance;
+        fields.resourceMessage = parts.resourceMessage;
+        return fields;
+    }
+
+    /**
+     * Hash of the micro form fields first, then of the names.
+     */
+    [[nodiscard]] constexpr auto hash() const -> std::size_t {
+        uint64_t h = static_cast<uint64_t>(hasResourceId ? resourceId : UINT32_MAX) |
+                     (static_cast<uint64_t>(hasEntityId ? entityId : UINT32_MAX) << 32);
+        h = mix(h ^ (hasVersionMajor ? versionMajor : UINT32_MAX));
+        h = mix(h ^ (hasVersionMinor ? versionMinor : UINT32_MAX));
+        h = bytes(h ^ 1, authorityIp, false);
+        h = bytes(h ^ 2, authorityId, false);
+        h = bytes(h ^ 3, authorityName, foldAuthorityName);
+        h = bytes(h ^ 4, entityName, false);
+        h = bytes(h ^ 5, resourceName, false);
+        h = bytes(h ^ 6, resourceInstance, false);
+        h = bytes(h ^ 7, resourceMessage, false);
+        return static_cast<std::size_t>(h);
+    }
+
+    [[nodiscard]] constexpr auto operator==(UriFields const &other) const -> bool {
+        return resourceId == other.resourceId && hasResourceId == other.hasResourceId &&
+               entityId == other.entityId && hasEntityId == other.hasEntityId &&
+               versionMajor == other.versionMajor && hasVersionMajor == other.hasVersionMajor &&
+               versionMinor == other.versionMinor && hasVersionMinor == other.hasVersionMinor &&
+               authorityIp == other.authorityIp && authorityId == other.authorityId &&
+               same(authorityName, foldAuthorityName, other.authorityName, other.foldAuthorityName) &&
+               entityName == other.entityName && resourceName == other.resourceName &&
+               resourceInstance == other.resourceInstance && resourceMessage == other.resourceMessage;
+    }
+
+private:
+    static constexpr auto lower(char c) -> char {
+        return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    static constexpr auto mix(uint64_t h) -> uint64_t {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static constexpr auto bytes(uint64_t h, std::string_view s, bool fold) -> uint64_t {
+        for (auto c : s) {
+            h = (h ^ static_cast<uint8_t>(fold ? lower(c) : c)) * 0x100000001b3ULL;
+        }
+        return mix(h ^ s.size());
+    }
+
+    static constexpr auto same(std::string_view a, bool foldA, std::string_view b, bool foldB) -> bool {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        if (!foldA && !foldB) {
+            return a == b;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if ((foldA ? lower(a[i]) : a[i]) != (foldB ? lower(b[i]) : b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * A UUri map key with its hash computed once.
+ *
+ * An owning key shares an immutable UUri, e.g. an entry of a UriRegistry,
+ * whose cached hash is reused. A probe only views the bytes of a micro or long
+ * URI and compares equal to the owning key of the UUri the URI deserializes
+ * to, so a UriMap can be searched with the bytes off the wire (probes must not
+ * be inserted into a map).
+ */
+class InternedUri {
+public:
+    explicit InternedUri(v1::UUri uri) {
+        auto owned = std::make_shared<const v1::UUri>(std::move(uri));
+        fields_ = UriFields::of(*owned);
+        hash_ = fields_.hash();
+        uri_ = std::move(owned);
+    }
+
+    explicit InternedUri(UriRegistry::EntryPtr const &entry)
+        : uri_(entry, &entry->uri), fields_(UriFields::of(entry->uri)), hash_(entry->hash) {
+    }
+
+    /**
+     * Probe for the UUri a micro URI deserializes to, valid while the bytes are.
+     */
+    static auto probe(MicroUriView micro) -> InternedUri {
+        return InternedUri(UriFields::of(micro));
+    }
+
+    /**
+     * Probe for the UUri a long URI deserializes to, valid while the string is.
+     */
+    static auto probe(std::string_view longUri) -> InternedUri {
+        return InternedUri(UriFields::of(longUri));
+    }
+
+    /**
+     * Probe for the UUri with the given fields, valid while the viewed strings are.
+     */
+    static auto probe(UriFields const &fields) -> InternedUri {
+        return InternedUri(fields);
+    }
+
+    /**
+     * @return the UUri, nullptr for a probe
+     */
+    [[nodiscard]] auto uri() const -> const v1::UUri * { return uri_.get(); }
+
+    [[nodiscard]] auto fields() const -> const UriFields & { return fields_; }
+
+    [[nodiscard]] auto hash() const -> std::size_t { return hash_; }
+
+    auto operator==(InternedUri const &other) const -> bool {
+        return (hash_ == other.hash_) && ((uri_ == other.uri_ && uri_) || fields_ == other.fields_);
+    }
+
+    auto operator!=(InternedUri const &other) const -> bool { return !(*this == other); }
+
+private:
+    explicit InternedUri(UriFields const &fields) : fields_(fields), hash_(fields.hash()) {}
+
+    std::shared_ptr<const v1::UUri> uri_;
+    UriFields fields_;
+    std::size_t hash_ = 0;
+};
+
+/**
+ * Hash of a URI in any of its forms. Transparent, so with C++20 an
+ * std::unordered_map<UUri, V, UriHash, UriEqual> can be searched with a
+ * MicroUriView or a long URI string_view as well.
+ */
+struct UriHash {
+    using is_transparent = void;
+
+    auto operator()(v1::UUri const &uri) const -> std::size_t { return UriFields::of(uri).hash(); }
+    auto operator()(InternedUri const &uri) const -> std::size_t { return uri.hash(); }
+    auto operator()(MicroUriView micro) const -> std::size_t { return UriFields::of(micro).hash(); }
+    auto operator()(std::string_view longUri) const -> std::size_t { return UriFields::of(longUri).hash(); }
+};
+
+/**
+ * Equality of URIs in any of their forms, see UriFields.
+ */
+struct UriEqual {
+    using is_transparent = void;
+
+    template<typename A, typename B>
+    auto operator()(A const &a, B const &b) const -> bool {
+        return fieldsOf(a) == fieldsOf(b);
+    }
+
+    auto operator()(InternedUri const &a, InternedUri const &b) const -> bool { return a == b; }
+
+private:
+    static auto fieldsOf(v1::UUri const &uri) -> UriFields { return UriFields::of(uri); }
+    static auto fieldsOf(InternedUri const &uri) -> const UriFields & { return uri.fields(); }
+    static auto fieldsOf(MicroUriView micro) -> UriFields { return UriFields::of(micro); }
+    static auto fieldsOf(std::string_view longUri) -> UriFields { return UriFields::of(longUri); }
+};
+
+/**
+ * Map keyed by URI. Search it with InternedUri::probe() to look up micro or
+ * long URIs without building a UUri (C++17 has no heterogeneous lookup for
+ * unordered containers).
+ */
+template<typename V>
+using UriMap = std::unordered_map<InternedUri, V, UriHash, UriEqual>;
+
+}  // namespace uprotocol::uri
+
+namespace std {
+
+template<>
+struct hash<uprotocol::v1::UUri> : uprotocol::uri::UriHash {};
+
+template<>
+struct equal_to<uprotocol::v1::UUri> {
+    auto operator()(uprotocol::v1::UUri const &a, uprotocol::v1::UUri const &b) const -> bool {
+        return uprotocol::uri::UriFields::of(a) == uprotocol::uri::UriFields::of(b);
+    }
+};
+
+template<>
+struct hash<uprotocol::uri::InternedUri> : uprotocol::uri::UriHash {};
+
+}  // namespace std
+
+#endif //UPROTOCOL_CPP_URI_HASH_H
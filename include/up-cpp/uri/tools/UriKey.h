@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UPROTOCOL_CPP_URI_KEY_H
+#define UPROTOCOL_CPP_URI_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <up-cpp/uri/tools/Utils.h>
+#include "up-core-api/uri.pb.h"
+
+namespace uprotocol::uri {
+
+/**
+ * UriKey packs the micro form of a UUri and its classification into 64 bits.
+ *
+ *  bits  0..15  resource id
+ *  bits 16..31  entity id
+ *  bits 32..39  entity major version (the 8 bits a micro URI carries)
+ *  bits 40..42  authority type (MicroUriSerializer's AuthorityType)
+ *  bits 44..55  classification, one bit per isEmpty / isResolved / isLongForm /
+ *               isMicroForm of the authority, the entity and the resource
+ *  bits 56..63  fingerprint of the authority address, 0 for a local URI
+ *
+ * The fields of the UUri are read once when the key is made, after which the
+ * classification helpers are single mask tests without branches. They give
+ * the same answers as the functions in Utils.h and MicroUriSerializer.h.
+ * Keys of URIs with the same local authority, entity id, version and
+ * resource id compare equal; for remote URIs the fingerprint only narrows
+ * the authority down, compare the authorities when it matters.
+ */
+class UriKey {
+
+public:
+    /**
+     * Values of the authority type bits.
+     */
+    enum class AuthorityKind : uint8_t {
+        Local = 0,
+        IpV4,
+        IpV6,
+        Id,
+        Invalid
+    };
+
+    constexpr UriKey() = default;
+
+    constexpr explicit UriKey(uint64_t value) : value_(value) {}
+
+    /**
+     * Make the key of a UUri.
+     */
+    [[nodiscard]] static auto of(uprotocol::v1::UUri const &uri) -> UriKey;
+
+    /**
+     * Make the key of a micro URI without building a UUri; applies every check
+     * MicroUriSerializer::deserialize() makes, but does not log. A malformed
+     * micro URI gives the key of the empty UUri deserialize() returns for it.
+     */
+    [[nodiscard]] static auto fromMicro(const uint8_t *micro, std::size_t size) -> UriKey;
+
+    [[nodiscard]] constexpr auto value() const -> uint64_t { return value_; }
+
+    [[nodiscard]] constexpr auto resourceId() const -> uint16_t {
+        return static_cast<uint16_t>(value_);
+    }
+
+    [[nodiscard]] constexpr auto entityId() const -> uint16_t {
+        return static_cast<uint16_t>(value_ >> EntityShift);
+    }
+
+    [[nodiscard]] constexpr auto versionMajor() const -> uint8_t {
+        return static_cast<uint8_t>(value_ >> VersionShift);
+    }
+
+    [[nodiscard]] constexpr auto authorityKind() const -> AuthorityKind {
+        return static_cast<AuthorityKind>((value_ >> AuthorityShift) & 0x7);
+    }
+
+    [[nodiscard]] constexpr auto fingerprint() const -> uint8_t {
+        return static_cast<uint8_t>(value_ >> FingerprintShift);
+    }
+
+    /** isEmpty(UUri) */
+    [[nodiscard]] constexpr auto isEmpty() const -> bool {
+        return all(AuthorityEmpty | EntityEmpty | ResourceEmpty);
+    }
+
+    /** isResolved(UUri) */
+    [[nodiscard]] constexpr auto isResolved() const -> bool {
+        return all(AuthorityResolved | EntityResolved | ResourceResolved);
+    }
+
+    /** isMicroForm(UUri) */
+    [[nodiscard]] constexpr auto isMicroForm() const -> bool {
+        return all(AuthorityMicro | EntityMicro | ResourceMicro);
+    }
+
+    /** isLongForm(UUri): long form authority, entity and resource each long form or empty */
+    [[nodiscard]] constexpr auto isLongForm() const -> bool {
+        const auto bits = static_cast<unsigned>(value_ >> ClassShift);
+        return (0 != (bits & AuthorityLong)) &
+               (0 != (bits & (EntityLong | EntityEmpty))) &
+               (0 != (bits & (ResourceLong | ResourceEmpty)));
+    }
+
+    /** isLocal(UUri.authority()) */
+    [[nodiscard]] constexpr auto isLocal() const -> bool {
+        return all(AuthorityEmpty);
+    }
+
+    /** isRemote(UUri.authority()) */
+    [[nodiscard]] constexpr auto isRemote() const -> bool {
+        return !isLocal();
+    }
+
+    /**
+     * @return true for a key that MicroUriSerializer::serialize() accepts
+     */
+    [[nodiscard]] constexpr auto isSerializable() const -> bool {
+        return !isEmpty() && isMicroForm() && (AuthorityKind::Invalid != authorityKind());
+    }
+
+    constexpr auto operator==(UriKey const &other) const -> bool { return value_ == other.value_; }
+    constexpr auto operator!=(UriKey const &other) const -> bool { return value_ != other.value_; }
+
+private:
+    static constexpr unsigned EntityShift = 16;
+    static constexpr unsigned VersionShift = 32;
+    static constexpr unsigned AuthorityShift = 40;
+    static constexpr unsigned ClassShift = 44;
+    static constexpr unsigned FingerprintShift = 56;
+
+    /* classification bits, relative to ClassShift */
+    static constexpr unsigned AuthorityEmpty = 1U << 0;
+    static constexpr unsigned AuthorityResolved = 1U << 1;
+    static constexpr unsigned AuthorityLong = 1U << 2;
+    static constexpr unsigned AuthorityMicro = 1U << 3;
+    static constexpr unsigned EntityEmpty = 1U << 4;
+    static constexpr unsigned EntityResolved = 1U << 5;
+    static constexpr unsigned EntityLong = 1U << 6;
+    static constexpr unsigned EntityMicro = 1U << 7;
+    static constexpr unsigned ResourceEmpty = 1U << 8;
+    static constexpr unsigned ResourceResolved = 1U << 9;
+    static constexpr unsigned ResourceLong = 1U << 10;
+    static constexpr unsigned ResourceMicro = 1U << 11;
+
+    [[nodiscard]] constexpr auto all(unsigned mask) const -> bool {
+        return (static_cast<uint64_t>(mask) << ClassShift) == (value_ & (static_cast<uint64_t>(mask) << ClassShift));
+    }
+
+    [[nodiscard]] static constexpr auto pack(uint16_t resourceId, uint16_t entityId, uint8_t version,
+                                             AuthorityKind kind, unsigned classes, uint8_t fingerprint) -> UriKey {
+        return UriKey(static_cast<uint64_t>(resourceId) |
+                      (static_cast<uint64_t>(entityId) << EntityShift) |
+                      (static_cast<uint64_t>(version) << VersionShift) |
+                      (static_cast<uint64_t>(kind) << AuthorityShift) |
+                      (static_cast<uint64_t>(classes) << ClassShift) |
+                      (static_cast<uint64_t>(fingerprint) << FingerprintShift));
+    }
+
+    [[nodiscard]] static constexpr auto fingerprintOf(std::string_view address) -> uint8_t {
+        uint32_t hash = 2166136261U;
+        for (auto c : address) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619U;
+        }
+        hash ^= hash >> 16;
+        return static_cast<uint8_t>(hash ^ (hash >> 8));
+    }
+
+    uint64_t value_ = 0;
+};
+
+inline auto UriKey::of(uprotocol::v1::UUri const &uri) -> UriKey {
+    const auto &authority = uri.authority();
+    const auto &entity = uri.entity();
+    const auto &resource = uri.resource();
+
+    /* authority */
+    const bool hasName = authority.has_name() && !authority.name().empty();
+    const bool hasIp = authority.has_ip() && !authority.ip().empty();
+    const bool hasId = authority.has_id() && !authority.id().empty();
+    const bool authorityEmpty = !hasName && !hasIp && !hasId;
+
+    auto kind = AuthorityKind::Local;
+    std::string_view address;
+    if (authority.has_ip()) {
+        address = authority.ip();
+        kind = (4 == address.size()) ? AuthorityKind::IpV4 :
+               (16 == address.size()) ? AuthorityKind::IpV6 : AuthorityKind::Invalid;
+    } else if (authority.has_id()) {
+        address = authority.id();
+        kind = (!address.empty() && address.size() <= 255) ? AuthorityKind::Id : AuthorityKind::Invalid;
+    } else if (hasName) {
+        address = authority.name();
+    }
+
+    /* entity */
+    const auto &entityName = entity.name();
+    const bool entityBlank = isBlank(entityName);
+    const bool entityId = entity.has_id() && (0 != entity.id());
+
+    /* resource */
+    const auto &resourceName = resource.name();
+    const bool rpc = ("rpc" == resourceName);
+    const bool resourceBlank = isBlank(resourceName);
+    const bool instance = !resource.instance().empty();
+    const bool message = resource.has_message() && !resource.message().empty();
+    const bool resourceId = resource.has_id() && (0 != resource.id());
+
+    unsigned classes = 0;
+    classes |= authorityEmpty ? AuthorityEmpty : 0;
+    classes |= (hasName && hasId) ? AuthorityResolved : 0;
+    classes |= (authorityEmpty || hasName) ? AuthorityLong : 0;
+    classes |= (authorityEmpty || hasIp || hasId) ? AuthorityMicro : 0;
+
+    classes |= (entityName.empty() && !entity.has_version_major() && !entity.has_id()) ? EntityEmpty : 0;
+    classes |= (!entityBlank && entityId) ? EntityResolved : 0;
+    classes |= !entityBlank ? EntityLong : 0;
+    classes |= entityId ? EntityMicro : 0;
+
+    classes |= ((resourceName.empty() || rpc) && !instance && !message && !resourceId) ? ResourceEmpty : 0;
+    classes |= (!resourceBlank && resourceId && (!rpc || !isBlank(resource.instance()))) ? ResourceResolved : 0;
+    classes |= ((rpc && instance) || (!resourceName.empty() && !rpc)) ? ResourceLong : 0;
+    classes |= resourceId ? ResourceMicro : 0;
+
+    return pack(static_cast<uint16_t>(resource.id()),
+                static_cast<uint16_t>(entity.id()),
+                entity.has_version_major() ? static_cast<uint8_t>(entity.version_major()) : 0,
+                kind,
+                classes,
+                authorityEmpty ? 0 : fingerprintOf(address));
+}
+
+inline auto UriKey::fromMicro(const uint8_t *micro, std::size_t size) -> UriKey {
+    /* the key of the empty UUri */
+    constexpr auto Empty = pack(0, 0, 0, AuthorityKind::Local,
+                                AuthorityEmpty | AuthorityLong | AuthorityMicro | EntityEmpty | ResourceEmpty, 0);
+    constexpr std::size_t HeaderLength = 8;
+
+    if ((nullptr == micro) || (size < HeaderLength) || (0x01 != micro[0])) {
+        return Empty;
+    }
+
+    const auto kind = static_cast<AuthorityKind>(micro[1]);
+    std::string_view address(reinterpret_cast<const char *>(micro) + HeaderLength, size - HeaderLength);
+    switch (kind) {
+        case AuthorityKind::Local:
+            if (HeaderLength != size) {
+                return Empty;
+            }
+            break;
+        case AuthorityKind::IpV4:
+        case AuthorityKind::IpV6:
+            if (((AuthorityKind::IpV4 == kind) ? 4U : 16U) != address.size()) {
+                return Empty;
+            }
+            break;
+        case AuthorityKind::Id:
+            if ((address.size() < 2) || (address.size() > 256) ||
+                (static_cast<uint8_t>(address[0]) != address.size() - 1)) {
+                return Empty;
+            }
+            address.remove_prefix(1);
+            break;
+        default:
+            return Empty;
+    }
+
+    /* a blank id authority is dropped, which makes the URI local */
+    const bool local = (AuthorityKind::Local == kind) || ((AuthorityKind::Id == kind) && isBlank(address));
+
+    const auto resourceId = static_cast<uint16_t>((micro[2] << 8) | micro[3]);
+    const auto entityId = static_cast<uint16_t>((micro[4] << 8) | micro[5]);
+
+    /* the entity always carries a major version, so it is never empty */
+    unsigned classes = 0;
+    classes |= local ? (AuthorityEmpty | AuthorityLong) : 0;
+    classes |= AuthorityMicro;
+    classes |= (0 != entityId) ? EntityMicro : 0;
+    classes |= (0 != resourceId) ? ResourceMicro : ResourceEmpty;
+
+    return pack(resourceId, entityId, micro[6],
+                local ? AuthorityKind::Local : kind,
+                classes,
+                local ? 0 : fingerprintOf(address));
+}
+
+}  // namespace uprotocol::uri
+
+#endif //UPROTOCOL_CPP_URI_KEY_H
@@ -25,14 +25,33 @@
 #ifndef URI_VALIDATOR_H_
 #define URI_VALIDATOR_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/tools/UriKey.h>
 #include <up-cpp/uri/tools/Utils.h>
 
 namespace uprotocol::uri {
 
-bool valid_uri(const std::string& uri) {
-    auto uri_view = LongUriSerializer::deserialize(uri);
-    return !isEmpty(uri_view);
+/**
+ * Check a long format URI without building a UUri.
+ * @return true if LongUriSerializer::deserialize(uri) is not empty
+ */
+inline bool valid_uri(std::string_view uri) {
+    LongUriParts parts;
+    return LongUriSerializer::parse(uri, parts);
+}
+
+/**
+ * Check a micro format URI without building a UUri or logging, e.g. to filter
+ * incoming messages.
+ * @return true if MicroUriSerializer::deserialize(micro, size) is a non empty
+ * micro form UUri
+ */
+inline bool valid_micro_uri(const uint8_t* micro, std::size_t size) {
+    auto key = UriKey::fromMicro(micro, size);
+    return !key.isEmpty() && key.isMicroForm();
 }
 
 }  // namespace uprotocol::uri
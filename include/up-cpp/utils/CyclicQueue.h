@@ -25,9 +25,12 @@
 #ifndef __CYCLIC_QUEUE_HPP__
 #define __CYCLIC_QUEUE_HPP__
 
+#include <atomic>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <up-cpp/utils/Metrics.h>
+#include <up-cpp/utils/WaitStrategy.h>
 
 namespace uprotocol::utils {
 
@@ -35,24 +38,44 @@ namespace uprotocol::utils {
 	class CyclicQueue final
 	{
 	public:
+		/**
+		* @param maxSize capacity, the oldest element is dropped beyond it
+		* @param milliseconds waitPop() timeout, WaitForever to wait until an element or wakeAll()
+		* @param strategy how waitPop() waits on an empty queue
+		* @param spins polls of SpinYield / SpinPark before they yield or park
+		*/
 		explicit CyclicQueue(
 			const size_t maxSize,
-			const std::chrono::milliseconds milliseconds) :
+			const std::chrono::milliseconds milliseconds,
+			const WaitStrategy strategy = WaitStrategy::Blocking,
+			const size_t spins = DefaultSpinCount) :
 				queueMaxSize_{maxSize},
-				milliseconds_{milliseconds} {}
+				milliseconds_{milliseconds},
+				strategy_{strategy},
+				spins_{spins} {}
 
 		CyclicQueue(const CyclicQueue&) = delete;
 		CyclicQueue &operator=(const CyclicQueue&) = delete;
 
-		virtual ~CyclicQueue() = default;
+		virtual ~CyclicQueue() {
+			if constexpr (metrics::Enabled) {
+				queueMetrics().depth.sub(static_cast<int64_t>(queue_.size()));
+			}
+		}
 
 		bool push(T& data) noexcept	{
 			std::unique_lock<std::mutex> uniqueLock(mutex_);
 			if (queueMaxSize_ == queue_.size()) {
 				queue_.pop();
+				if constexpr (metrics::Enabled) {
+					queueMetrics().dropped.add();
+				}
+			} else if constexpr (metrics::Enabled) {
+				queueMetrics().depth.add();
 			}
 
 			queue_.push(std::move(data));
+			count_.store(queue_.size(), std::memory_order_release);
 			uniqueLock.unlock();
 
 			conditionVariable_.notify_one();
@@ -72,24 +95,79 @@ namespace uprotocol::utils {
 			return queue_.empty();
 		}
 
-		bool waitPop(T& popped_value) noexcept {
+		/**
+		* Pop the oldest element without waiting.
+		* @return false if the queue is empty
+		*/
+		bool tryPop(T& popped_value) noexcept {
 			std::unique_lock<std::mutex> uniqueLock(mutex_);
 			if (queue_.empty()) {
-				conditionVariable_.wait_for(
-					uniqueLock,
-					milliseconds_);
+				return false;
+			}
+			popLocked(popped_value);
+
+			return true;
+		}
 
-				if (queue_.empty())	{
-					return false;
+		/**
+		* Pop the oldest element, waiting with the queue's wait strategy for up
+		* to the configured timeout while the queue is empty. Spinning consumers
+		* poll the queue size and only take the lock once an element is there.
+		* @return false if the timeout expired or wakeAll() was called before an element arrived
+		*/
+		bool waitPop(T& popped_value) noexcept {
+			if (tryPop(popped_value)) {
+				return true;
+			}
+
+			const auto wakeups = wakeups_.load(std::memory_order_acquire);
+			bool popped = false;
+			auto ready = [&]() {
+				if (0U != count_.load(std::memory_order_acquire)) {
+					popped = tryPop(popped_value);
 				}
+				return popped || (wakeups != wakeups_.load(std::memory_order_acquire));
+			};
+
+			const WaitDeadline deadline(milliseconds_);
+			if (pollUntil(strategy_, spins_, deadline, ready)) {
+				return popped;
+			}
+			if (false == parks(strategy_)) {
+				return false;
 			}
 
-			popped_value = std::move(queue_.front());
-			queue_.pop();
+			std::unique_lock<std::mutex> uniqueLock(mutex_);
+			auto woken = [&]() {
+				return (false == queue_.empty()) || (wakeups != wakeups_.load(std::memory_order_relaxed));
+			};
+			/* a WaitForever deadline is the end of time, so this also covers untimed waits */
+			conditionVariable_.wait_until(uniqueLock, deadline.time(), woken);
+
+			if (queue_.empty()) {
+				return false;
+			}
+			popLocked(popped_value);
 
 			return true;
 		}
 
+		/**
+		* Make every consumer waiting in waitPop() return false, e.g. to stop
+		* consumers that wait forever.
+		*/
+		void wakeAll(void) noexcept {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				wakeups_.fetch_add(1, std::memory_order_release);
+			}
+			conditionVariable_.notify_all();
+		}
+
+		WaitStrategy waitStrategy(void) const noexcept {
+			return strategy_;
+		}
+
 		size_t size(void) const noexcept {
 			std::unique_lock<std::mutex> uniqueLock(mutex_);
 			return queue_.size();
@@ -97,18 +175,50 @@ namespace uprotocol::utils {
 
 		void clear(void) noexcept {
 			std::unique_lock<std::mutex> uniqueLock(mutex_);
+			if constexpr (metrics::Enabled) {
+				queueMetrics().depth.sub(static_cast<int64_t>(queue_.size()));
+			}
 			while (!queue_.empty()) {
 				queue_.pop();
 			}
+			count_.store(0U, std::memory_order_release);
 		}
 
 	private:
 		static constexpr std::chrono::milliseconds DefaultPopQueueTimeoutMilli { 5U };
 
+		/* shared by all cyclic queues of the process */
+		struct QueueMetrics {
+			metrics::Gauge &depth;
+			metrics::Counter &dropped;
+		};
+
+		static const QueueMetrics &queueMetrics() {
+			static const QueueMetrics queueMetrics {
+				metrics::Registry::instance().gauge("up_cyclic_queue_depth", "Entries held by cyclic queues"),
+				metrics::Registry::instance().counter("up_cyclic_queue_dropped_total",
+													  "Oldest entries dropped by full cyclic queues") };
+			return queueMetrics;
+		}
+
+		void popLocked(T& popped_value) noexcept {
+			popped_value = std::move(queue_.front());
+			queue_.pop();
+			count_.store(queue_.size(), std::memory_order_release);
+			if constexpr (metrics::Enabled) {
+				queueMetrics().depth.sub();
+			}
+		}
+
 		size_t queueMaxSize_;
 		mutable std::mutex mutex_;
 		std::condition_variable conditionVariable_;
 		std::chrono::milliseconds milliseconds_ { DefaultPopQueueTimeoutMilli };
+		const WaitStrategy strategy_;
+		const size_t spins_;
+		/* queue size readable without the lock, polled by spinning consumers */
+		std::atomic<size_t> count_ { 0 };
+		std::atomic<uint32_t> wakeups_ { 0 };
 		std::queue<T> queue_;
 	};
 }
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __EXPECTED_HPP__
+#define __EXPECTED_HPP__
+
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace uprotocol::utils {
+
+	/** Error of a failed Expected, see makeUnexpected() */
+	template<typename E>
+	class Unexpected {
+		public:
+			constexpr explicit Unexpected(E error) : error_(std::move(error)) {}
+
+			constexpr const E & error() const & noexcept {
+				return error_;
+			}
+
+		private:
+			E error_;
+	};
+
+	template<typename E>
+	constexpr Unexpected<std::decay_t<E>> makeUnexpected(E &&error) {
+		return Unexpected<std::decay_t<E>>(std::forward<E>(error));
+	}
+
+	/**
+	* Value or error, for APIs whose failures are part of the normal flow.
+	* A small error code is returned without building a placeholder value, and
+	* the caller checks once instead of validating the returned value again.
+	* The member names follow C++23 std::expected so that callers can switch
+	* to it unchanged. value() on an error throws std::bad_variant_access.
+	*/
+	template<typename T, typename E>
+	class [[nodiscard]] Expected {
+		static_assert(!std::is_same_v<T, E>, "value and error types must differ");
+
+		public:
+			constexpr Expected(const T &value) : storage_(std::in_place_index<0>, value) {}
+
+			constexpr Expected(T &&value) : storage_(std::in_place_index<0>, std::move(value)) {}
+
+			constexpr Expected(const Unexpected<E> &unexpected) : storage_(std::in_place_index<1>, unexpected.error()) {}
+
+			constexpr bool has_value() const noexcept {
+				return 0 == storage_.index();
+			}
+
+			constexpr explicit operator bool() const noexcept {
+				return has_value();
+			}
+
+			constexpr T & value() & {
+				return std::get<0>(storage_);
+			}
+
+			constexpr const T & value() const & {
+				return std::get<0>(storage_);
+			}
+
+			constexpr T && value() && {
+				return std::get<0>(std::move(storage_));
+			}
+
+			constexpr T & operator*() & noexcept {
+				return *std::get_if<0>(&storage_);
+			}
+
+			constexpr const T & operator*() const & noexcept {
+				return *std::get_if<0>(&storage_);
+			}
+
+			constexpr T && operator*() && noexcept {
+				return std::move(*std::get_if<0>(&storage_));
+			}
+
+			constexpr T * operator->() noexcept {
+				return std::get_if<0>(&storage_);
+			}
+
+			constexpr const T * operator->() const noexcept {
+				return std::get_if<0>(&storage_);
+			}
+
+			/** @return the error, only valid if has_value() is false */
+			constexpr const E & error() const noexcept {
+				return *std::get_if<1>(&storage_);
+			}
+
+			template<typename U>
+			constexpr T value_or(U &&fallback) const & {
+				return has_value() ? **this : static_cast<T>(std::forward<U>(fallback));
+			}
+
+			template<typename U>
+			constexpr T value_or(U &&fallback) && {
+				return has_value() ? std::move(**this) : static_cast<T>(std::forward<U>(fallback));
+			}
+
+		private:
+			std::variant<T, E> storage_;
+	};
+}
+
+#endif // __EXPECTED_HPP__
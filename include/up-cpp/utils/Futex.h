@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __FUTEX_HPP__
+#define __FUTEX_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#else
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace uprotocol::utils {
+
+	/**
+	* Futex is a 32 bit event counter that threads can sleep on without holding a lock.
+	* Producers call post() after publishing data, consumers read value() before
+	* checking for data and then wait(value) - the wait returns immediately if a
+	* post() happened in between, so no wake up can be lost.
+	* On Linux it maps directly onto the futex syscall, elsewhere it falls back to
+	* a mutex / condition variable pair.
+	*/
+	class Futex final
+	{
+	public:
+		Futex() = default;
+
+		Futex(const Futex&) = delete;
+		Futex &operator=(const Futex&) = delete;
+
+		/**
+		* @return the current value of the event counter
+		*/
+		uint32_t value() const noexcept {
+			return word_.load(std::memory_order_acquire);
+		}
+
+		/**
+		* Bump the event counter and wake up to count sleeping threads.
+		* The syscall is skipped when nobody is waiting.
+		*/
+		void post(int count = 1) noexcept {
+			word_.fetch_add(1, std::memory_order_seq_cst);
+			if (0 != waiters_.load(std::memory_order_seq_cst)) {
+				wake(count);
+			}
+		}
+
+		/**
+		* Bump the event counter and wake up all sleeping threads.
+		*/
+		void postAll() noexcept {
+			post(INT32_MAX);
+		}
+
+		/**
+		* Sleep while the event counter still holds expected, for at most timeout.
+		* std::chrono::nanoseconds::max() sleeps without a timeout.
+		* @return false if the timeout expired, true otherwise (spurious wake ups included)
+		*/
+		bool wait(uint32_t expected,
+				  std::chrono::nanoseconds timeout) noexcept {
+			waiters_.fetch_add(1, std::memory_order_seq_cst);
+			auto woken = sleep(expected, timeout);
+			waiters_.fetch_sub(1, std::memory_order_relaxed);
+			return woken;
+		}
+
+	private:
+#if defined(__linux__)
+		bool sleep(uint32_t expected,
+				   std::chrono::nanoseconds timeout) noexcept {
+			if (timeout <= std::chrono::nanoseconds::zero()) {
+				return false;
+			}
+			const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+			struct timespec ts;
+			ts.tv_sec = static_cast<time_t>(secs.count());
+			ts.tv_nsec = static_cast<long>((timeout - secs).count());
+			const bool forever = (std::chrono::nanoseconds::max() == timeout);
+
+			auto res = syscall(SYS_futex,
+							   reinterpret_cast<uint32_t*>(&word_),
+							   FUTEX_WAIT_PRIVATE,
+							   expected,
+							   forever ? nullptr : &ts,
+							   nullptr,
+							   0);
+			return !((-1 == res) && (ETIMEDOUT == errno));
+		}
+
+		void wake(int count) noexcept {
+			syscall(SYS_futex,
+					reinterpret_cast<uint32_t*>(&word_),
+					FUTEX_WAKE_PRIVATE,
+					count,
+					nullptr,
+					nullptr,
+					0);
+		}
+#else
+		bool sleep(uint32_t expected,
+				   std::chrono::nanoseconds timeout) noexcept {
+			std::unique_lock<std::mutex> uniqueLock(mutex_);
+			if (std::chrono::nanoseconds::max() == timeout) {
+				conditionVariable_.wait(
+					uniqueLock,
+					[this, expected]() { return expected != word_.load(); });
+				return true;
+			}
+			return conditionVariable_.wait_for(
+				uniqueLock,
+				timeout,
+				[this, expected]() { return expected != word_.load(); });
+		}
+
+		void wake(int count) noexcept {
+			/* taking the lock orders the counter update before a waiter's check */
+			{ std::lock_guard<std::mutex> lock(mutex_); }
+			if (1 == count) {
+				conditionVariable_.notify_one();
+			} else {
+				conditionVariable_.notify_all();
+			}
+		}
+
+		std::mutex mutex_;
+		std::condition_variable conditionVariable_;
+#endif
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+			"futex word must have the layout of a plain 32 bit integer");
+
+		std::atomic<uint32_t> word_ { 0 };
+		std::atomic<uint32_t> waiters_ { 0 };
+	};
+}
+#endif // __FUTEX_HPP__
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef __INPLACE_FUNCTION_HPP__
+#define __INPLACE_FUNCTION_HPP__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace uprotocol::utils {
+
+	template<typename Signature, size_t Capacity = 64U>
+	class InplaceFunction;
+
+	/**
+	* Move-only callable wrapper that stores the target inside the object itself.
+	* Unlike std::function it never allocates and accepts move-only callables;
+	* a target that does not fit into Capacity bytes is rejected at compile time.
+	*/
+	template<typename R, typename... Args, size_t Capacity>
+	class InplaceFunction<R(Args...), Capacity> final
+	{
+	public:
+		InplaceFunction() noexcept = default;
+
+		InplaceFunction(std::nullptr_t) noexcept {}
+
+		template<typename F,
+				 typename D = std::decay_t<F>,
+				 typename = std::enable_if_t<!std::is_same_v<D, InplaceFunction> &&
+											 std::is_invocable_r_v<R, D&, Args...>>>
+		InplaceFunction(F&& f) {
+			static_assert(sizeof(D) <= Capacity,
+				"callable does not fit into the in-place buffer, increase Capacity");
+			static_assert(alignof(D) <= alignof(std::max_align_t),
+				"callable is over-aligned for the in-place buffer");
+			static_assert(std::is_nothrow_move_constructible_v<D>,
+				"callable must be nothrow move constructible");
+
+			new (&storage_) D(std::forward<F>(f));
+			ops_ = &opsFor<D>;
+		}
+
+		InplaceFunction(InplaceFunction&& other) noexcept {
+			moveFrom(other);
+		}
+
+		InplaceFunction &operator=(InplaceFunction&& other) noexcept {
+			if (this != &other) {
+				reset();
+				moveFrom(other);
+			}
+			return *this;
+		}
+
+		InplaceFunction &operator=(std::nullptr_t) noexcept {
+			reset();
+			return *this;
+		}
+
+		InplaceFunction(const InplaceFunction&) = delete;
+		InplaceFunction &operator=(const InplaceFunction&) = delete;
+
+		~InplaceFunction() {
+			reset();
+		}
+
+		R operator()(Args... args) {
+			return ops_->invoke(&storage_, std::forward<Args>(args)...);
+		}
+
+		explicit operator bool() const noexcept {
+			return nullptr != ops_;
+		}
+
+		void reset() noexcept {
+			if (nullptr != ops_) {
+				ops_->destroy(&storage_);
+				ops_ = nullptr;
+			}
+		}
+
+	private:
+		struct Ops {
+			R (*invoke)(void*, Args&&...);
+			void (*move)(void*, void*) noexcept;
+			void (*destroy)(void*) noexcept;
+		};
+
+		template<typename D>
+		static constexpr Ops opsFor = {
+			[](void* self, Args&&... args) -> R {
+				return (*static_cast<D*>(self))(std::forward<Args>(args)...);
+			},
+			[](void* dst, void* src) noexcept {
+				new (dst) D(std::move(*static_cast<D*>(src)));
+				static_cast<D*>(src)->~D();
+			},
+			[](void* self) noexcept {
+				static_cast<D*>(self)->~D();
+			}
+		};
+
+		void moveFrom(InplaceFunction& other) noexcept {
+			if (nullptr != other.ops_) {
+				other.ops_->move(&storage_, &other.storage_);
+				ops_ = other.ops_;
+				other.ops_ = nullptr;
+			}
+		}
+
+		std::aligned_storage_t<Capacity, alignof(std::max_align_t)> storage_;
+		const Ops* ops_ = nullptr;
+	};
+}
+#endif // __INPLACE_FUNCTION_HPP__
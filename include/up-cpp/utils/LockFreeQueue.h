@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __LOCK_FREE_QUEUE_HPP__
+#define __LOCK_FREE_QUEUE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <up-cpp/utils/Futex.h>
+#include <up-cpp/utils/Metrics.h>
+#include <up-cpp/utils/WaitStrategy.h>
+
+namespace uprotocol::utils {
+
+	/** Size used to pad shared indices and cells so they never share a cache line */
+	static constexpr size_t CacheLineSize = 64U;
+
+	/**
+	* Bounded ring of sequenced cells (D. Vyukov's bounded MPMC algorithm).
+	* Every cell carries a sequence number that tells producers and consumers
+	* whether it is free for position pos (sequence == pos) or holds the value
+	* written for pos (sequence == pos + 1), so both sides only contend on their
+	* own index. The head is always claimed with a CAS, which lets a producer
+	* drop the oldest entry on overflow even in the single producer variant.
+	* Use MpmcQueue / SpscQueue below rather than this class directly.
+	*/
+	template<typename T, bool SingleProducer>
+	class BoundedRingQueue final
+	{
+	public:
+		/**
+		* @param maxSize capacity, the oldest element is dropped beyond it
+		* @param milliseconds waitPop() timeout, WaitForever to wait until an element or wakeAll()
+		* @param strategy how waitPop() waits on an empty queue
+		* @param spins polls of SpinYield / SpinPark before they yield or park
+		*/
+		explicit BoundedRingQueue(
+			const size_t maxSize,
+			const std::chrono::milliseconds milliseconds,
+			const WaitStrategy strategy = WaitStrategy::Blocking,
+			const size_t spins = DefaultSpinCount) :
+				capacity_{(0U == maxSize) ? 1U : maxSize},
+				mask_{isPowerOfTwo(capacity_) ? capacity_ - 1U : 0U},
+				cells_{new Cell[capacity_]},
+				milliseconds_{milliseconds},
+				strategy_{strategy},
+				spins_{spins} {
+
+			for (size_t i = 0; i < capacity_; ++i) {
+				cells_[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		BoundedRingQueue(const BoundedRingQueue&) = delete;
+		BoundedRingQueue &operator=(const BoundedRingQueue&) = delete;
+
+		~BoundedRingQueue() {
+			clear();
+		}
+
+		/**
+		* Push an element, dropping the oldest one when the queue is full
+		* (same overflow behaviour as CyclicQueue).
+		* @param data element to move into the queue
+		* @return true once the element is queued
+		*/
+		bool push(T& data) noexcept {
+			while (false == tryPush(data)) {
+				if (size() >= capacity_) {
+					T dropped;
+					if (tryPop(dropped)) {
+						if constexpr (metrics::Enabled) {
+							droppedMetric().add();
+						}
+					}
+				} else {
+					/* a consumer is still moving out of the cell we need */
+					std::this_thread::yield();
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		* Push an element only if there is room for it.
+		* @param data element to move into the queue, left untouched on failure
+		* @return false if the queue is full
+		*/
+		bool tryPush(T& data) noexcept {
+			Cell* cell;
+			size_t pos = tail_.value.load(std::memory_order_relaxed);
+			while (true) {
+				cell = &cells_[index(pos)];
+				const auto seq = cell->sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (0 == diff) {
+					if constexpr (SingleProducer) {
+						tail_.value.store(pos + 1, std::memory_order_relaxed);
+						break;
+					} else {
+						if (tail_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = tail_.value.load(std::memory_order_relaxed);
+				}
+			}
+
+			new (cell->ptr()) T(std::move(data));
+			cell->sequence.store(pos + 1, std::memory_order_release);
+			notifier_.post();
+
+			return true;
+		}
+
+		/**
+		* Pop the oldest element without waiting.
+		* @param popped_value receives the element
+		* @return false if the queue is empty
+		*/
+		bool tryPop(T& popped_value) noexcept {
+			Cell* cell;
+			size_t pos = head_.value.load(std::memory_order_relaxed);
+			while (true) {
+				cell = &cells_[index(pos)];
+				const auto seq = cell->sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+				if (0 == diff) {
+					if (head_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = head_.value.load(std::memory_order_relaxed);
+				}
+			}
+
+			popped_value = std::move(*cell->ptr());
+			cell->ptr()->~T();
+			cell->sequence.store(pos + capacity_, std::memory_order_release);
+
+			return true;
+		}
+
+		/**
+		* Pop the oldest element, waiting with the queue's wait strategy for up
+		* to the configured timeout while the queue is empty.
+		* @param popped_value receives the element
+		* @return false if the timeout expired or wakeAll() was called before an element arrived
+		*/
+		bool waitPop(T& popped_value) noexcept {
+			if (tryPop(popped_value)) {
+				return true;
+			}
+
+			const auto wakeups = wakeups_.load(std::memory_order_acquire);
+			bool popped = false;
+			auto ready = [&]() {
+				popped = tryPop(popped_value);
+				return popped || (wakeups != wakeups_.load(std::memory_order_acquire));
+			};
+
+			const WaitDeadline deadline(milliseconds_);
+			if (pollUntil(strategy_, spins_, deadline, ready)) {
+				return popped;
+			}
+			if (false == parks(strategy_)) {
+				return false;
+			}
+
+			while (true) {
+				const auto ticket = notifier_.value();
+				if (ready()) {
+					return popped;
+				}
+
+				const auto remaining = deadline.remaining();
+				if (remaining <= std::chrono::nanoseconds::zero()) {
+					return false;
+				}
+				notifier_.wait(ticket, remaining);
+			}
+		}
+
+		/**
+		* Make every consumer waiting in waitPop() return false, e.g. to stop
+		* consumers that wait forever.
+		*/
+		void wakeAll(void) noexcept {
+			wakeups_.fetch_add(1, std::memory_order_release);
+			notifier_.postAll();
+		}
+
+		WaitStrategy waitStrategy(void) const noexcept {
+			return strategy_;
+		}
+
+		bool isFull(void) const noexcept {
+			return size() >= capacity_;
+		}
+
+		bool isEmpty(void) const noexcept {
+			return 0U == size();
+		}
+
+		/**
+		* @return number of queued elements (a snapshot while other threads run)
+		*/
+		size_t size(void) const noexcept {
+			const auto head = head_.value.load(std::memory_order_acquire);
+			const auto tail = tail_.value.load(std::memory_order_acquire);
+			return (tail > head) ? (tail - head) : 0U;
+		}
+
+		size_t capacity(void) const noexcept {
+			return capacity_;
+		}
+
+		void clear(void) noexcept {
+			T dropped;
+			while (tryPop(dropped)) {
+			}
+		}
+
+	private:
+		/* shared by all bounded ring queues of the process */
+		static metrics::Counter &droppedMetric() {
+			static auto &dropped = metrics::Registry::instance().counter(
+				"up_ring_queue_dropped_total", "Oldest entries dropped by full lock-free ring queues");
+			return dropped;
+		}
+
+		struct alignas(CacheLineSize) Cell {
+			std::atomic<size_t> sequence;
+			alignas(T) unsigned char storage[sizeof(T)];
+
+			T* ptr() noexcept {
+				return std::launder(reinterpret_cast<T*>(storage));
+			}
+		};
+
+		struct alignas(CacheLineSize) PaddedIndex {
+			std::atomic<size_t> value { 0 };
+		};
+
+		static constexpr bool isPowerOfTwo(size_t value) {
+			return (0U != value) && (0U == (value & (value - 1U)));
+		}
+
+		size_t index(size_t pos) const noexcept {
+			return (0U != mask_) ? (pos & mask_) : (pos % capacity_);
+		}
+
+		static constexpr std::chrono::milliseconds DefaultPopQueueTimeoutMilli { 5U };
+
+		const size_t capacity_;
+		const size_t mask_;
+		std::unique_ptr<Cell[]> cells_;
+		PaddedIndex head_;
+		PaddedIndex tail_;
+		Futex notifier_;
+		std::atomic<uint32_t> wakeups_ { 0 };
+		std::chrono::milliseconds milliseconds_ { DefaultPopQueueTimeoutMilli };
+		const WaitStrategy strategy_;
+		const size_t spins_;
+	};
+
+	/**
+	* Lock-free bounded queue for any number of producers and consumers.
+	* Drop-in replacement for CyclicQueue on contended paths.
+	*/
+	template<typename T>
+	using MpmcQueue = BoundedRingQueue<T, false>;
+
+	/**
+	* Lock-free bounded queue for exactly one producer thread and one consumer
+	* thread; the producer side runs without any read-modify-write operation.
+	*/
+	template<typename T>
+	using SpscQueue = BoundedRingQueue<T, true>;
+}
+#endif // __LOCK_FREE_QUEUE_HPP__
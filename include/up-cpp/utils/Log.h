@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __LOG_HPP__
+#define __LOG_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <spdlog/spdlog.h>
+
+/**
+* Lowest level compiled into the library and into code using these macros, one
+* of the SPDLOG_LEVEL_* values (cmake -DLOG_LEVEL=warn). Calls below it expand
+* to nothing, so their arguments are neither evaluated nor formatted.
+*/
+#ifndef UP_CPP_LOG_LEVEL
+#define UP_CPP_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+namespace uprotocol::utils::log {
+
+	/** Messages a call site may log per interval before it is throttled */
+	static constexpr uint64_t DefaultBurst = 10U;
+
+	/** Length of a rate limiting interval */
+	static constexpr std::chrono::milliseconds DefaultInterval { 1000U };
+
+	/** Capacity of the async queue, the oldest pending message is dropped when it is full */
+	static constexpr size_t DefaultAsyncQueueSize = 8192U;
+
+	inline std::atomic<uint64_t> burst { DefaultBurst };
+	inline std::atomic<uint64_t> intervalNanoseconds {
+		static_cast<uint64_t>(std::chrono::nanoseconds(DefaultInterval).count()) };
+
+	/**
+	* Change the rate limit of every call site.
+	* @param messages per interval and call site, 0 to never throttle
+	* @param interval length of the interval
+	*/
+	inline void setRateLimit(uint64_t messages,
+							 std::chrono::milliseconds interval = DefaultInterval) {
+		burst.store(messages, std::memory_order_relaxed);
+		intervalNanoseconds.store(static_cast<uint64_t>(std::chrono::nanoseconds(interval).count()),
+								  std::memory_order_relaxed);
+	}
+
+	/**
+	* Hand formatting and writing over to a background thread: the default
+	* logger is replaced by an async logger writing to the same sinks. Call it
+	* at start-up, before other threads log.
+	* @param queueSize pending messages kept, the oldest is dropped when full
+	*/
+	void enableAsync(size_t queueSize = DefaultAsyncQueueSize);
+
+	/** Write the pending messages and go back to logging on the calling thread */
+	void disableAsync();
+
+	/**
+	* Per call site limiter: lets burst messages through per interval and
+	* counts the ones it holds back, so the next message that gets through can
+	* report them. Lock free, a throttled call costs a clock read and two
+	* relaxed atomic operations.
+	*/
+	class RateLimiter {
+		public:
+			/**
+			* @param suppressed receives the number of messages held back since
+			* the last one let through, if this one is let through
+			* @return true if the message should be logged
+			*/
+			bool allow(uint64_t &suppressed) noexcept {
+				const auto limit = burst.load(std::memory_order_relaxed);
+				if (0 == limit) {
+					suppressed = 0;
+					return true;
+				}
+
+				const auto now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count());
+				auto start = windowStart_.load(std::memory_order_relaxed);
+				if (((now - start) >= intervalNanoseconds.load(std::memory_order_relaxed)) &&
+					windowStart_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+					count_.store(0, std::memory_order_relaxed);
+				}
+
+				if (count_.fetch_add(1, std::memory_order_relaxed) < limit) {
+					suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+					return true;
+				}
+				suppressed_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+		private:
+			std::atomic<uint64_t> windowStart_ { 0 };
+			std::atomic<uint64_t> count_ { 0 };
+			std::atomic<uint64_t> suppressed_ { 0 };
+	};
+}
+
+/* log through the default logger, rate limited per call site; the level is checked before anything else */
+#define UP_LOG_AT_(level, ...) \
+	do { \
+		static ::uprotocol::utils::log::RateLimiter upLogLimiter_; \
+		auto *upLogger_ = ::spdlog::default_logger_raw(); \
+		uint64_t upLogSuppressed_ = 0; \
+		if (upLogger_->should_log(level) && upLogLimiter_.allow(upLogSuppressed_)) { \
+			const ::spdlog::source_loc upLogLocation_ { __FILE__, __LINE__, SPDLOG_FUNCTION }; \
+			if (0 != upLogSuppressed_) { \
+				upLogger_->log(upLogLocation_, level, "{} similar messages suppressed", upLogSuppressed_); \
+			} \
+			upLogger_->log(upLogLocation_, level, __VA_ARGS__); \
+		} \
+	} while (false)
+
+#if UP_CPP_LOG_LEVEL <= SPDLOG_LEVEL_TRACE
+#define UP_LOG_TRACE(...) UP_LOG_AT_(::spdlog::level::trace, __VA_ARGS__)
+#else
+#define UP_LOG_TRACE(...) (void)0
+#endif
+
+#if UP_CPP_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define UP_LOG_DEBUG(...) UP_LOG_AT_(::spdlog::level::debug, __VA_ARGS__)
+#else
+#define UP_LOG_DEBUG(...) (void)0
+#endif
+
+#if UP_CPP_LOG_LEVEL <= SPDLOG_LEVEL_INFO
+#define UP_LOG_INFO(...) UP_LOG_AT_(::spdlog::level::info, __VA_ARGS__)
+#else
+#define UP_LOG_INFO(...) (void)0
+#endif
+
+#if UP_CPP_LOG_LEVEL <= SPDLOG_LEVEL_WARN
+#define UP_LOG_WARN(...) UP_LOG_AT_(::spdlog::level::warn, __VA_ARGS__)
+#else
+#define UP_LOG_WARN(...) (void)0
+#endif
+
+#if UP_CPP_LOG_LEVEL <= SPDLOG_LEVEL_ERROR
+#define UP_LOG_ERROR(...) UP_LOG_AT_(::spdlog::level::err, __VA_ARGS__)
+#else
+#define UP_LOG_ERROR(...) (void)0
+#endif
+
+#endif // __LOG_HPP__
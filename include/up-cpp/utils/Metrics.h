@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __METRICS_HPP__
+#define __METRICS_HPP__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/* build with UP_CPP_METRICS=0 (cmake -DBUILD_METRICS=OFF) to compile the metrics out */
+#ifndef UP_CPP_METRICS
+#define UP_CPP_METRICS 1
+#endif
+
+namespace uprotocol::utils::metrics {
+
+	/** false when the metrics are compiled out: updates are empty and scrapes report nothing */
+	static constexpr bool Enabled = (0 != UP_CPP_METRICS);
+
+	/** Number of per-thread shards of a counter or gauge */
+	static constexpr size_t Shards = 16U;
+
+	/** Shards are padded to a cache line (same size as utils::CacheLineSize) */
+	static constexpr size_t ShardAlignment = 64U;
+
+	/** shard of the calling thread, assigned round-robin on first use */
+	inline size_t shardOfThread() noexcept {
+		static std::atomic<size_t> next { 0 };
+		static thread_local size_t shard = Shards;
+		if (Shards == shard) {
+			shard = next.fetch_add(1, std::memory_order_relaxed) % Shards;
+		}
+		return shard;
+	}
+
+	/** nanoseconds of the monotonic clock, for durations recorded into a Histogram */
+	inline uint64_t now() noexcept {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	/**
+	* Sharded signed sum. Every thread adds to its own cache line, a read sums
+	* the shards, so updates from many threads never contend.
+	*/
+	template<typename T>
+	class ShardedSum {
+		public:
+			void add(T n = 1) noexcept {
+				if constexpr (Enabled) {
+					shards_[shardOfThread()].value.fetch_add(n, std::memory_order_relaxed);
+				}
+			}
+
+			T value() const noexcept {
+				T sum = 0;
+				for (const auto &shard : shards_) {
+					sum += shard.value.load(std::memory_order_relaxed);
+				}
+				return sum;
+			}
+
+		private:
+			struct alignas(ShardAlignment) Shard {
+				std::atomic<T> value { 0 };
+			};
+
+			std::array<Shard, Enabled ? Shards : 1> shards_;
+	};
+
+	/** Monotonic event count (drops, calls, failures) */
+	class Counter : public ShardedSum<uint64_t> {
+	};
+
+	/** Level that goes up and down (queue depth), updated with add() / sub() */
+	class Gauge : public ShardedSum<int64_t> {
+		public:
+			void sub(int64_t n = 1) noexcept {
+				add(-n);
+			}
+	};
+
+	/**
+	* Log-linear histogram of durations in nanoseconds. Every power of two is
+	* split into SubBuckets linear buckets, so a value is reported within
+	* 1 / SubBuckets (12.5%) of itself over the whole uint64_t range in 4KB of
+	* counters. Recording is one relaxed increment on the bucket and one on a
+	* sharded sum.
+	*/
+	class Histogram {
+		public:
+			static constexpr unsigned SubBucketBits = 3U;
+			static constexpr uint64_t SubBuckets = 1U << SubBucketBits;
+			static constexpr size_t Buckets = (64U - SubBucketBits + 1U) * SubBuckets;
+
+			void record(uint64_t nanoseconds) noexcept {
+				if constexpr (Enabled) {
+					counts_[indexOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+					sum_.add(nanoseconds);
+				}
+			}
+
+			/** record the time elapsed since start, a value of now() */
+			void recordSince(uint64_t start) noexcept {
+				if constexpr (Enabled) {
+					const auto end = now();
+					record((end > start) ? (end - start) : 0);
+				}
+			}
+
+			uint64_t count() const noexcept {
+				uint64_t total = 0;
+				for (const auto &count : counts_) {
+					total += count.load(std::memory_order_relaxed);
+				}
+				return total;
+			}
+
+			/** @return sum of the recorded values (wraps after ~584 years) */
+			uint64_t sum() const noexcept {
+				return sum_.value();
+			}
+
+			/** @return number of recorded values below limit, rounded to bucket bounds */
+			uint64_t countBelow(uint64_t limit) const noexcept {
+				uint64_t total = 0;
+				for (size_t i = 0; i < counts_.size(); ++i) {
+					if (upperBound(i) > limit) {
+						break;
+					}
+					total += counts_[i].load(std::memory_order_relaxed);
+				}
+				return total;
+			}
+
+			/**
+			* @return the value below which quantile (0..1) of the recorded values
+			* fall, reported as the upper bound of its bucket, 0 if empty
+			*/
+			uint64_t percentile(double quantile) const noexcept {
+				const auto total = count();
+				if (0 == total) {
+					return 0;
+				}
+				auto rank = static_cast<uint64_t>(quantile * static_cast<double>(total));
+				rank = (rank >= total) ? total - 1 : rank;
+				uint64_t seen = 0;
+				for (size_t i = 0; i < counts_.size(); ++i) {
+					seen += counts_[i].load(std::memory_order_relaxed);
+					if (seen > rank) {
+						return upperBound(i) - 1;
+					}
+				}
+				return 0;
+			}
+
+			static size_t indexOf(uint64_t value) noexcept {
+				if (value < SubBuckets) {
+					return static_cast<size_t>(value);
+				}
+				const unsigned shift = 63U - static_cast<unsigned>(__builtin_clzll(value)) - SubBucketBits;
+				return static_cast<size_t>((shift + 1U) * SubBuckets + ((value >> shift) & (SubBuckets - 1U)));
+			}
+
+			/** @return first value past bucket index (saturates at UINT64_MAX) */
+			static uint64_t upperBound(size_t index) noexcept {
+				if (index < SubBuckets) {
+					return index + 1;
+				}
+				const auto shift = index / SubBuckets - 1U;
+				const auto next = SubBuckets + (index % SubBuckets) + 1U;
+				if ((63U - SubBucketBits) <= shift && (2U * SubBuckets) == next) {
+					return UINT64_MAX;
+				}
+				return next << shift;
+			}
+
+		private:
+			std::array<std::atomic<uint64_t>, Enabled ? Buckets : 1> counts_ {};
+			ShardedSum<uint64_t> sum_;
+	};
+
+	/**
+	* Process wide, pull based registry. Metrics are created on first lookup and
+	* live until the process exits, so components keep references to them and
+	* only the lookup takes the registry lock. A metric is identified by its
+	* name and its label set, written in Prometheus syntax without the braces
+	* (e.g. serializer="long_uri",op="serialize").
+	*/
+	class Registry {
+		public:
+			static Registry & instance();
+
+			Counter & counter(std::string_view name, std::string_view help, std::string_view labels = {});
+
+			Gauge & gauge(std::string_view name, std::string_view help, std::string_view labels = {});
+
+			Histogram & histogram(std::string_view name, std::string_view help, std::string_view labels = {});
+
+			/** @return the metric, nullptr if it was never created */
+			const Counter * findCounter(std::string_view name, std::string_view labels = {}) const;
+
+			const Gauge * findGauge(std::string_view name, std::string_view labels = {}) const;
+
+			const Histogram * findHistogram(std::string_view name, std::string_view labels = {}) const;
+
+			/**
+			* Render every metric in the Prometheus text exposition format.
+			* Histograms are exported in seconds (name_seconds_bucket/_sum/_count)
+			* with power of two buckets from 256ns to ~69s.
+			* @return empty string if the metrics are compiled out
+			*/
+			std::string scrape() const;
+
+		private:
+			Registry() = default;
+
+			enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+			struct Family {
+				Type type;
+				std::string help;
+				std::map<std::string, std::unique_ptr<Counter>, std::less<>> counters;
+				std::map<std::string, std::unique_ptr<Gauge>, std::less<>> gauges;
+				std::map<std::string, std::unique_ptr<Histogram>, std::less<>> histograms;
+			};
+
+			Family & family(std::string_view name, std::string_view help, Type type);
+
+			const Family * findFamily(std::string_view name, Type type) const;
+
+			mutable std::mutex mutex_;
+			std::map<std::string, Family, std::less<>> families_;
+	};
+
+	/** Call count and failure count of one serializer operation */
+	struct SerializerMetrics {
+		Counter &calls;
+		Counter &failures;
+
+		static SerializerMetrics of(std::string_view serializer, std::string_view operation) {
+			const auto labels = std::string("serializer=\"") + std::string(serializer) +
+				"\",op=\"" + std::string(operation) + "\"";
+			auto &registry = Registry::instance();
+			return SerializerMetrics {
+				registry.counter("up_serializer_calls_total", "Serializer calls", labels),
+				registry.counter("up_serializer_failures_total", "Serializer calls that failed", labels) };
+		}
+	};
+}
+
+#endif // __METRICS_HPP__
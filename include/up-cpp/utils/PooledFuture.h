@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef __POOLED_FUTURE_HPP__
+#define __POOLED_FUTURE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <up-cpp/utils/Futex.h>
+#include <up-cpp/utils/LockFreeQueue.h>
+
+namespace uprotocol::utils {
+
+	template<typename T>
+	class PromisePool;
+
+	template<typename T>
+	class PooledPromise;
+
+	template<typename T>
+	class PooledFuture;
+
+	namespace detail {
+
+		/**
+		* Shared state of a pooled promise / future pair.
+		* The promise and the future each hold one reference; the state goes back
+		* to its pool once both are gone.
+		*/
+		template<typename T>
+		struct PooledState {
+			using Value = std::conditional_t<std::is_void_v<T>, char, T>;
+
+			PromisePool<T>* pool = nullptr;
+			std::atomic<uint32_t> refs { 0 };
+			Futex ready;
+			uint32_t armed = 0U;
+			std::exception_ptr exception;
+			bool hasValue = false;
+			alignas(Value) unsigned char storage[sizeof(Value)];
+
+			Value* value() noexcept {
+				return std::launder(reinterpret_cast<Value*>(storage));
+			}
+
+			bool isReady() const noexcept {
+				return armed != ready.value();
+			}
+
+			void reset() noexcept {
+				if (true == hasValue) {
+					value()->~Value();
+					hasValue = false;
+				}
+				exception = nullptr;
+			}
+
+			void release() noexcept;
+		};
+	}
+
+	/**
+	* Fixed-size pool of promise / future states.
+	* acquire() and the release of a state are lock-free and never allocate, so
+	* callers that need a result back do not pay for std::promise's heap state.
+	* The pool must outlive every promise and future taken from it.
+	*/
+	template<typename T>
+	class PromisePool final
+	{
+	public:
+		explicit PromisePool(const size_t capacity) :
+			states_{new detail::PooledState<T>[(0U == capacity) ? 1U : capacity]},
+			free_{(0U == capacity) ? 1U : capacity, std::chrono::milliseconds(0)} {
+
+			for (size_t i = 0; i < free_.capacity(); ++i) {
+				auto* state = &states_[i];
+				state->pool = this;
+				free_.tryPush(state);
+			}
+		}
+
+		PromisePool(const PromisePool&) = delete;
+		PromisePool &operator=(const PromisePool&) = delete;
+
+		/**
+		* @return a promise bound to a free state, or an invalid promise if the pool is exhausted
+		*/
+		PooledPromise<T> acquire() noexcept {
+			detail::PooledState<T>* state = nullptr;
+			if (false == free_.tryPop(state)) {
+				return PooledPromise<T>();
+			}
+			state->armed = state->ready.value();
+			state->refs.store(2U, std::memory_order_relaxed);
+			return PooledPromise<T>(state);
+		}
+
+		/**
+		* @return number of states currently available
+		*/
+		size_t available() const noexcept {
+			return free_.size();
+		}
+
+	private:
+		friend struct detail::PooledState<T>;
+
+		void recycle(detail::PooledState<T>* state) noexcept {
+			state->reset();
+			free_.tryPush(state);
+		}
+
+		std::unique_ptr<detail::PooledState<T>[]> states_;
+		MpmcQueue<detail::PooledState<T>*> free_;
+	};
+
+	/**
+	* Producer side of a pooled result; set exactly once with setValue() or setException().
+	* A promise dropped without a result completes its future with std::future_error.
+	*/
+	template<typename T>
+	class PooledPromise final
+	{
+	public:
+		PooledPromise() noexcept = default;
+
+		PooledPromise(PooledPromise&& other) noexcept :
+			state_{std::exchange(other.state_, nullptr)},
+			futureRetrieved_{other.futureRetrieved_} {}
+
+		PooledPromise &operator=(PooledPromise&& other) noexcept {
+			if (this != &other) {
+				abandon();
+				state_ = std::exchange(other.state_, nullptr);
+				futureRetrieved_ = other.futureRetrieved_;
+			}
+			return *this;
+		}
+
+		PooledPromise(const PooledPromise&) = delete;
+		PooledPromise &operator=(const PooledPromise&) = delete;
+
+		~PooledPromise() {
+			abandon();
+		}
+
+		bool valid() const noexcept {
+			return nullptr != state_;
+		}
+
+		/**
+		* @return the future bound to this promise; only the first call returns a valid future
+		*/
+		PooledFuture<T> getFuture() noexcept {
+			if ((nullptr == state_) || (true == futureRetrieved_)) {
+				return PooledFuture<T>();
+			}
+			futureRetrieved_ = true;
+			return PooledFuture<T>(state_);
+		}
+
+		template<typename... V>
+		void setValue(V&&... value) {
+			if (nullptr == state_) {
+				return;
+			}
+			new (state_->storage) typename detail::PooledState<T>::Value(std::forward<V>(value)...);
+			state_->hasValue = true;
+			complete();
+		}
+
+		void setException(std::exception_ptr exception) noexcept {
+			if (nullptr == state_) {
+				return;
+			}
+			state_->exception = std::move(exception);
+			complete();
+		}
+
+	private:
+		friend class PromisePool<T>;
+
+		explicit PooledPromise(detail::PooledState<T>* state) noexcept : state_{state} {}
+
+		void complete() noexcept {
+			state_->ready.postAll();
+			release();
+		}
+
+		void abandon() noexcept {
+			if (nullptr == state_) {
+				return;
+			}
+			if (false == state_->isReady()) {
+				state_->exception = std::make_exception_ptr(
+					std::future_error(std::future_errc::broken_promise));
+				state_->ready.postAll();
+			}
+			release();
+		}
+
+		void release() noexcept {
+			auto* state = std::exchange(state_, nullptr);
+			if (false == futureRetrieved_) {
+				/* nobody can observe the result, drop the future's reference too */
+				state->refs.fetch_sub(1U, std::memory_order_acq_rel);
+			}
+			state->release();
+		}
+
+		detail::PooledState<T>* state_ = nullptr;
+		bool futureRetrieved_ = false;
+	};
+
+	/**
+	* Consumer side of a pooled result, mirrors the std::future interface.
+	*/
+	template<typename T>
+	class PooledFuture final
+	{
+	public:
+		PooledFuture() noexcept = default;
+
+		PooledFuture(PooledFuture&& other) noexcept :
+			state_{std::exchange(other.state_, nullptr)} {}
+
+		PooledFuture &operator=(PooledFuture&& other) noexcept {
+			if (this != &other) {
+				if (nullptr != state_) {
+					state_->release();
+				}
+				state_ = std::exchange(other.state_, nullptr);
+			}
+			return *this;
+		}
+
+		PooledFuture(const PooledFuture&) = delete;
+		PooledFuture &operator=(const PooledFuture&) = delete;
+
+		~PooledFuture() {
+			if (nullptr != state_) {
+				state_->release();
+			}
+		}
+
+		bool valid() const noexcept {
+			return nullptr != state_;
+		}
+
+		/**
+		* Block until the result is available.
+		*/
+		void wait() const noexcept {
+			while (false == state_->isReady()) {
+				state_->ready.wait(state_->armed, std::chrono::seconds(1));
+			}
+		}
+
+		/**
+		* Block until the result is available or the timeout expires.
+		* @return std::future_status::ready or std::future_status::timeout
+		*/
+		template<typename Rep, typename Period>
+		std::future_status waitFor(const std::chrono::duration<Rep, Period>& timeout) const noexcept {
+			const auto deadline = std::chrono::steady_clock::now() + timeout;
+			while (false == state_->isReady()) {
+				const auto remaining = deadline - std::chrono::steady_clock::now();
+				if (remaining <= std::chrono::steady_clock::duration::zero()) {
+					return std::future_status::timeout;
+				}
+				state_->ready.wait(state_->armed, remaining);
+			}
+			return std::future_status::ready;
+		}
+
+		/**
+		* Wait for the result and move it out; the future is invalid afterwards.
+		* Rethrows the exception stored by the producer.
+		*/
+		T get() {
+			wait();
+			auto* state = std::exchange(state_, nullptr);
+			struct Release {
+				detail::PooledState<T>* state;
+				~Release() { state->release(); }
+			} guard { state };
+
+			if (nullptr != state->exception) {
+				std::rethrow_exception(state->exception);
+			}
+			if constexpr (!std::is_void_v<T>) {
+				return std::move(*state->value());
+			}
+		}
+
+	private:
+		friend class PooledPromise<T>;
+
+		explicit PooledFuture(detail::PooledState<T>* state) noexcept : state_{state} {}
+
+		detail::PooledState<T>* state_ = nullptr;
+	};
+
+	template<typename T>
+	void detail::PooledState<T>::release() noexcept {
+		if (1U == refs.fetch_sub(1U, std::memory_order_acq_rel)) {
+			pool->recycle(this);
+		}
+	}
+}
+#endif // __POOLED_FUTURE_HPP__
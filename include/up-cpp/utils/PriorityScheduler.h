@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __PRIORITY_SCHEDULER_HPP__
+#define __PRIORITY_SCHEDULER_HPP__
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <up-cpp/utils/Futex.h>
+
+namespace uprotocol::utils {
+
+	/**
+	* Multi-level queue for dispatch and send paths, one bounded ring per
+	* priority class (level 0 is the lowest).
+	*
+	* The top strictLevels classes are served with strict priority, the others
+	* share what is left by weight (deficit round robin), so low classes are
+	* never starved but cannot delay the strict ones by more than the element
+	* being processed. Every class has its own capacity and overflow policy, a
+	* flood in one class never evicts elements of another.
+	*/
+	template<typename T, size_t Levels = 8U>
+	class PriorityScheduler final
+	{
+	public:
+		static_assert(Levels > 0U, "at least one priority level is needed");
+
+		enum class DropPolicy {
+			DropOldest,  /* make room by discarding the oldest element of the class */
+			RejectNewest /* refuse the element being pushed */
+		};
+
+		struct ClassConfig {
+			size_t capacity;
+			/* elements served per round among the weighted classes */
+			uint32_t weight;
+			DropPolicy policy;
+		};
+
+		struct Options {
+			std::array<ClassConfig, Levels> classes;
+			/* number of top levels served with strict priority */
+			size_t strictLevels;
+		};
+
+		/**
+		* Options with the same capacity for every class, weights growing with
+		* the level, the two top levels strict, low classes dropping their oldest
+		* element and strict classes rejecting new ones when full.
+		*/
+		static Options defaultOptions(size_t capacityPerClass) {
+			Options options{};
+			options.strictLevels = (Levels > 2U) ? 2U : 0U;
+			for (size_t level = 0; level < Levels; ++level) {
+				options.classes[level].capacity = capacityPerClass;
+				options.classes[level].weight = static_cast<uint32_t>(level + 1U);
+				options.classes[level].policy = (level >= Levels - options.strictLevels) ?
+					DropPolicy::RejectNewest : DropPolicy::DropOldest;
+			}
+			return options;
+		}
+
+		PriorityScheduler(const Options &options,
+						  const std::chrono::milliseconds milliseconds) :
+				strictLevels_{(options.strictLevels > Levels) ? Levels : options.strictLevels},
+				milliseconds_{milliseconds} {
+
+			for (size_t level = 0; level < Levels; ++level) {
+				auto &queue = classes_[level];
+				queue.config = options.classes[level];
+				queue.config.capacity = (0U == queue.config.capacity) ? 1U : queue.config.capacity;
+				queue.config.weight = (0U == queue.config.weight) ? 1U : queue.config.weight;
+				queue.ring.resize(queue.config.capacity);
+			}
+			credit_ = classes_[0].config.weight;
+		}
+
+		PriorityScheduler(const PriorityScheduler&) = delete;
+		PriorityScheduler &operator=(const PriorityScheduler&) = delete;
+
+		/**
+		* Queue an element in the class of the given level (clamped to the top level)
+		* @param data element to move into the queue, left untouched when rejected
+		* @return false if the class is full and rejects new elements
+		*/
+		bool push(size_t level, T& data) noexcept {
+			if (level >= Levels) {
+				level = Levels - 1U;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				auto &queue = classes_[level];
+				if (queue.count == queue.config.capacity) {
+					++queue.dropped;
+					if (DropPolicy::RejectNewest == queue.config.policy) {
+						return false;
+					}
+					queue.ring[queue.head] = T();
+					queue.head = next(queue, queue.head);
+					--queue.count;
+					--size_;
+				}
+				queue.ring[(queue.head + queue.count) % queue.config.capacity] = std::move(data);
+				++queue.count;
+				++size_;
+			}
+
+			available_.post();
+
+			return true;
+		}
+
+		/**
+		* Take the next element by priority without waiting
+		* @return false if all classes are empty
+		*/
+		bool tryPop(T& popped_value) noexcept {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return popLocked(popped_value);
+		}
+
+		/**
+		* Take the next element by priority, waiting up to the timeout for one
+		* @return false if all classes stayed empty
+		*/
+		bool waitPop(T& popped_value) noexcept {
+			auto ticket = available_.value();
+			if (true == tryPop(popped_value)) {
+				return true;
+			}
+			available_.wait(ticket, milliseconds_);
+
+			return tryPop(popped_value);
+		}
+
+		/**
+		* @return number of queued elements over all classes
+		*/
+		size_t size() const noexcept {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return size_;
+		}
+
+		/**
+		* @return number of queued elements of a class
+		*/
+		size_t size(size_t level) const noexcept {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return (level < Levels) ? classes_[level].count : 0U;
+		}
+
+		bool isEmpty() const noexcept {
+			return 0U == size();
+		}
+
+		/**
+		* @return oldest element of a class, nullptr if the class is empty; it is
+		* only valid until the next push, pop or clear
+		*/
+		const T *front(size_t level) const noexcept {
+			std::lock_guard<std::mutex> lock(mutex_);
+			if ((level >= Levels) || (0U == classes_[level].count)) {
+				return nullptr;
+			}
+			return &classes_[level].ring[classes_[level].head];
+		}
+
+		/**
+		* @return number of elements a class dropped or rejected on overflow
+		*/
+		uint64_t dropped(size_t level) const noexcept {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return (level < Levels) ? classes_[level].dropped : 0U;
+		}
+
+		void clear() noexcept {
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto &queue : classes_) {
+				while (0U != queue.count) {
+					queue.ring[queue.head] = T();
+					queue.head = next(queue, queue.head);
+					--queue.count;
+				}
+			}
+			size_ = 0U;
+		}
+
+	private:
+		struct Class {
+			ClassConfig config {};
+			std::vector<T> ring;
+			size_t head = 0U;
+			size_t count = 0U;
+			uint64_t dropped = 0U;
+		};
+
+		static size_t next(const Class &queue, size_t pos) noexcept {
+			return (pos + 1U == queue.config.capacity) ? 0U : pos + 1U;
+		}
+
+		static void take(Class &queue, T& popped_value) noexcept {
+			popped_value = std::move(queue.ring[queue.head]);
+			queue.head = next(queue, queue.head);
+			--queue.count;
+		}
+
+		bool popLocked(T& popped_value) noexcept {
+			if (0U == size_) {
+				return false;
+			}
+
+			/* strict classes, highest first */
+			for (size_t level = Levels; level > Levels - strictLevels_; --level) {
+				auto &queue = classes_[level - 1U];
+				if (0U != queue.count) {
+					take(queue, popped_value);
+					--size_;
+					return true;
+				}
+			}
+
+			/* weighted classes, deficit round robin */
+			const size_t weighted = Levels - strictLevels_;
+			if (0U == weighted) {
+				return false;
+			}
+			for (size_t visited = 0; visited <= weighted; ++visited) {
+				auto &queue = classes_[current_];
+				if ((0U != queue.count) && (0U != credit_)) {
+					take(queue, popped_value);
+					--credit_;
+					--size_;
+					return true;
+				}
+				/* an idle class does not keep its credit */
+				current_ = (current_ + 1U == weighted) ? 0U : current_ + 1U;
+				credit_ = classes_[current_].config.weight;
+			}
+
+			return false;
+		}
+
+		const size_t strictLevels_;
+		std::array<Class, Levels> classes_;
+		size_t size_ = 0U;
+		/* weighted class being served and what it may still take this round */
+		size_t current_ = 0U;
+		uint32_t credit_ = 0U;
+		mutable std::mutex mutex_;
+		Futex available_;
+		std::chrono::milliseconds milliseconds_;
+	};
+}
+#endif // __PRIORITY_SCHEDULER_HPP__
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef __PROTO_TARGET_HPP__
+#define __PROTO_TARGET_HPP__
+
+#include <utility>
+#include <google/protobuf/arena.h>
+
+namespace uprotocol::utils {
+
+	/**
+	* The protobuf message a builder writes into. It is either
+	*  - owned by the builder (default),
+	*  - allocated on a google::protobuf::Arena, so a whole batch of messages
+	*    is released at once together with the arena, or
+	*  - an existing message owned by the caller, e.g. attributes.mutable_source(),
+	*    so nested messages are built in place without a CopyFrom into the parent.
+	* Copies of a builder with an owned message get their own copy of it, copies of a
+	* builder writing into an arena or caller message write into the same message.
+	*/
+	template<typename T>
+	class ProtoTarget final
+	{
+	public:
+		ProtoTarget() : target_{&owned_} {}
+
+		explicit ProtoTarget(google::protobuf::Arena* arena) :
+			target_{(nullptr == arena) ? &owned_ : google::protobuf::Arena::CreateMessage<T>(arena)} {}
+
+		explicit ProtoTarget(T* target) :
+			target_{(nullptr == target) ? &owned_ : target} {}
+
+		ProtoTarget(const ProtoTarget& other) :
+			owned_{other.owned_},
+			target_{other.isOwned() ? &owned_ : other.target_} {}
+
+		ProtoTarget &operator=(const ProtoTarget& other) {
+			if (this != &other) {
+				owned_ = other.owned_;
+				target_ = other.isOwned() ? &owned_ : other.target_;
+			}
+			return *this;
+		}
+
+		ProtoTarget(ProtoTarget&& other) noexcept :
+			owned_{std::move(other.owned_)},
+			target_{other.isOwned() ? &owned_ : other.target_} {}
+
+		ProtoTarget &operator=(ProtoTarget&& other) noexcept {
+			if (this != &other) {
+				owned_ = std::move(other.owned_);
+				target_ = other.isOwned() ? &owned_ : other.target_;
+			}
+			return *this;
+		}
+
+		T* operator->() noexcept {
+			return target_;
+		}
+
+		const T* operator->() const noexcept {
+			return target_;
+		}
+
+		T& operator*() noexcept {
+			return *target_;
+		}
+
+		const T& operator*() const noexcept {
+			return *target_;
+		}
+
+		T* get() noexcept {
+			return target_;
+		}
+
+		bool isOwned() const noexcept {
+			return &owned_ == target_;
+		}
+
+	private:
+		T owned_;
+		T* target_;
+	};
+}
+#endif // __PROTO_TARGET_HPP__
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __THREAD_AFFINITY_HPP__
+#define __THREAD_AFFINITY_HPP__
+
+#include <string_view>
+#include <vector>
+
+namespace uprotocol::utils::affinity {
+
+	/**
+	* @return NUMA node of every online CPU, indexed by CPU number. All CPUs
+	* are on node 0 when the topology is not available.
+	*/
+	std::vector<int> cpuNodes();
+
+	/** @return online CPUs of a NUMA node, empty if the node does not exist */
+	std::vector<unsigned> cpusOfNode(int node);
+
+	/** @return CPU the calling thread runs on, -1 if unknown */
+	int currentCpu() noexcept;
+
+	/**
+	* Restrict the calling thread to a set of CPUs.
+	* @return false if the set is empty or the OS refuses it
+	*/
+	bool pinCurrentThread(const std::vector<unsigned> &cpus);
+
+	/** Name the calling thread, truncated to the 15 characters the OS keeps */
+	bool nameCurrentThread(std::string_view name);
+
+	/**
+	* Set the scheduling policy of the calling thread, e.g. SCHED_FIFO for a
+	* latency critical path. Real-time policies need CAP_SYS_NICE.
+	* @return false if the OS refuses the policy or priority
+	*/
+	bool scheduleCurrentThread(int policy,
+							   int priority);
+}
+
+#endif // __THREAD_AFFINITY_HPP__
@@ -24,127 +24,593 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <algorithm>
 #include <functional>
 #include <future>
 #include <thread>
 #include <vector>
 #include <atomic>
 #include <mutex>
-#include <spdlog/spdlog.h>
-#include <up-cpp/utils/CyclicQueue.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <sched.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/Futex.h>
+#include <up-cpp/utils/InplaceFunction.h>
+#include <up-cpp/utils/LockFreeQueue.h>
+#include <up-cpp/utils/Metrics.h>
+#include <up-cpp/utils/PooledFuture.h>
+#include <up-cpp/utils/ThreadAffinity.h>
+#include <up-cpp/utils/WaitStrategy.h>
 
 using namespace std;
 
 namespace uprotocol::utils {
 
+    /**
+    * Thread pool with a fixed set of long-lived workers.
+    * Every worker owns a fixed ring of task slots; tasks submitted from a worker
+    * go to its own ring, tasks submitted from other threads are spread
+    * round-robin, and a task spills over to the next worker when its ring is
+    * full. An idle worker steals from the other rings before parking on a futex,
+    * so workers are never torn down and re-spawned between bursts. The rings
+    * hold maxQueueSize slots in total and are allocated when the pool is built,
+    * so queueing a task never allocates.
+    *
+    * Options place the workers: a CPU set (shared or one CPU per worker),
+    * per NUMA node worker groups, thread names and a scheduling policy. With
+    * NUMA groups, tasks submitted from outside the pool go to a worker of the
+    * submitting thread's node, and idle workers steal from their own node
+    * before crossing to another one.
+    */
     class ThreadPool
     {
         public:
 
+            /** Size of the in-place buffer holding a posted callable and its captures */
+            static constexpr size_t TaskCapacity = 64U;
+
+            /** Move-only task type stored by the pool, never allocates */
+            using Task = InplaceFunction<void(), TaskCapacity>;
+
             ThreadPool(const ThreadPool &) = delete;
             ThreadPool(ThreadPool &&) = delete;
 
             ThreadPool & operator=(const ThreadPool &) = delete;
             ThreadPool & operator=(ThreadPool &&) = delete;
 
+            /** Placement and scheduling of the workers */
+            struct Options {
+                size_t maxQueueSize = 0;
+                size_t numOfThreads = 1;
+                /* CPUs the workers run on, empty to leave placement to the OS */
+                std::vector<unsigned> cpus;
+                /* pin every worker to a single CPU of the set instead of the whole set */
+                bool pinEachWorker = false;
+                /* spread the workers over the NUMA nodes of the CPUs (all CPUs if cpus is empty),
+                   each worker runs on the CPUs of its node */
+                bool numaGroups = false;
+                /* thread name prefix, workers are named "<name>-<index>" */
+                std::string name;
+                /* e.g. SCHED_FIFO for the safety path, needs CAP_SYS_NICE */
+                int schedPolicy = SCHED_OTHER;
+                int schedPriority = 0;
+                /* how an idle worker waits for tasks, spinning keeps the worker's CPU busy */
+                WaitStrategy waitStrategy = WaitStrategy::Blocking;
+                size_t spins = DefaultSpinCount;
+                /* longest sleep of an idle worker, WaitForever to sleep until a task is posted */
+                std::chrono::milliseconds idleTimeout { 100 };
+            };
+
             ThreadPool(const size_t maxQueueSize,
                        const size_t maxNumOfThreads)
-                : queue_(maxQueueSize, 
-                        std::chrono::milliseconds(timeoutMillisec_)),
+                : ThreadPool(sizedOptions(maxQueueSize, maxNumOfThreads)) {
+            }
+
+            explicit ThreadPool(Options options)
+                : maxQueueSize_(options.maxQueueSize),
                 terminate_(false),
-                maxNumOfThreads_(maxNumOfThreads),
-                numOfThreads_(0) {};
-            
+                maxNumOfThreads_((0 == options.numOfThreads) ? 1 : options.numOfThreads),
+                queued_(0),
+                nextWorker_(0),
+                options_(std::move(options)),
+                metrics_(poolMetrics()) {
+
+                workers_.reserve(maxNumOfThreads_);
+                // the rings share maxQueueSize slots, so a reserved slot always fits one of them
+                const auto ringCapacity = std::max<size_t>(1U,
+                    (maxQueueSize_ + maxNumOfThreads_ - 1) / maxNumOfThreads_);
+                for (size_t i = 0; i < maxNumOfThreads_; ++i) {
+                    workers_.push_back(std::make_unique<Worker>(ringCapacity));
+                }
+                place();
+
+                threads_.reserve(maxNumOfThreads_);
+                for (size_t i = 0; i < maxNumOfThreads_; ++i) {
+                    threads_.emplace_back(&ThreadPool::worker, this, i);
+                }
+            };
+
             ~ThreadPool() {
 
                 terminate_ = true;
+                idle_.postAll();
 
-                /* wait for the threads to terminate*/
+                /* wait for the threads to drain their queues and terminate*/
                 for (size_t i = 0; i < threads_.size(); ++i) {
-                    threads_[i].get();
+                    threads_[i].join();
                 }
             }
 
-            static void worker(CyclicQueue<std::function<void()>> &queue, 
-                               bool &terminate) {
+            // Submit a function to be executed asynchronously by the pool
+            template<typename F, typename...Args>
+            auto submit(F&& f, Args&&... args) -> std::future<decltype(f(args...))> {
+
+                using ResultType = decltype(f(args...));
+
+                if (true == terminate_) {
+                    UP_LOG_ERROR("Thread pool is marked for termination");
+                    return std::future<ResultType>();
+                }
+
+                // packaged_task is move-only, the in-place task owns it directly
+                std::packaged_task<ResultType()> task(
+                    std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+
+                auto future = task.get_future();
 
-                std::function<void()> funcPtr;
-                while (true == queue.waitPop(funcPtr) && (!terminate)) {
-                    funcPtr();
-                } 
+                if (false == enqueue(Task([task = std::move(task)]() mutable { task(); }))) {
+                    return std::future<ResultType>();
+                }
+
+                // Return future from promise
+                return future;
             }
 
-            // Submit a function to be executed asynchronously by the pool
+            /**
+            * Submit a function whose result is delivered through a state taken from
+            * promisePool instead of a heap allocated std::promise.
+            * @return invalid future if the pool is terminating, the queue is full or
+            * promisePool is exhausted
+            */
             template<typename F, typename...Args>
-            auto submit(F&& f, Args&&... args) -> std::future<decltype(f(args...))> {
+            auto submit(PromisePool<decltype(std::declval<F>()(std::declval<Args>()...))> &promisePool,
+                        F&& f,
+                        Args&&... args) -> PooledFuture<decltype(f(args...))> {
+
+                using ResultType = decltype(f(args...));
+
+                auto promise = promisePool.acquire();
+                if (false == promise.valid()) {
+                    UP_LOG_ERROR("promise pool is exhausted");
+                    return PooledFuture<ResultType>();
+                }
+                auto future = promise.getFuture();
+
+                auto posted = submitDetached(
+                    [promise = std::move(promise)](auto &&func, auto &&...funcArgs) mutable {
+                        try {
+                            if constexpr (std::is_void_v<ResultType>) {
+                                func(std::forward<decltype(funcArgs)>(funcArgs)...);
+                                promise.setValue();
+                            } else {
+                                promise.setValue(func(std::forward<decltype(funcArgs)>(funcArgs)...));
+                            }
+                        } catch (...) {
+                            promise.setException(std::current_exception());
+                        }
+                    },
+                    std::forward<F>(f),
+                    std::forward<Args>(args)...);
+
+                if (false == posted) {
+                    return PooledFuture<ResultType>();
+                }
+
+                return future;
+            }
+
+            /**
+            * Queue a callable without producing a future. The callable and its
+            * captures are stored in place (up to TaskCapacity bytes), so nothing
+            * is allocated on this path.
+            * @return false if the pool is terminating or the queue is full
+            */
+            bool post(Task task) {
 
                 if (true == terminate_) {
-                    spdlog::error("Thread pool is marked for termination");
-                    return std::future<typename std::result_of<F(Args...)>::type>();
+                    UP_LOG_ERROR("Thread pool is marked for termination");
+                    return false;
                 }
 
-                std::lock_guard<std::mutex> lock(mutex_);
+                return enqueue(std::move(task));
+            }
 
-                // Create a function with bounded parameters ready to execute
-                std::function<decltype(f(args...))()> func = std::bind(std::forward<F>(f), 
-                                                                       std::forward<Args>(args)...);
+            /**
+            * Same as post() for a callable and its arguments, which are moved into
+            * the task and passed to the callable when it runs.
+            */
+            template<typename F, typename...Args>
+            bool submitDetached(F&& f, Args&&... args) {
+
+                return post(Task(
+                    [f = std::forward<F>(f),
+                     tuple = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                        std::apply(f, std::move(tuple));
+                    }));
+            }
+
+            /**
+            * @return number of worker threads owned by the pool
+            */
+            size_t numOfThreads() const {
+                return maxNumOfThreads_;
+            }
+
+            /**
+            * @return number of tasks waiting for a worker
+            */
+            size_t queueSize() const {
+                return queued_.load(std::memory_order_relaxed);
+            }
+
+            /**
+            * @return CPUs a worker is restricted to, empty if it is not pinned
+            */
+            const std::vector<unsigned> & workerCpus(size_t index) const {
+                return workers_[index]->cpus;
+            }
+
+            /**
+            * @return NUMA node a worker is grouped on, 0 without NUMA groups
+            */
+            int workerNode(size_t index) const {
+                return workers_[index]->node;
+            }
+
+    private:
+
+        /* time a task was queued at, left out when the metrics are compiled out */
+        struct Stamp {
+            uint64_t queuedAt = 0;
+        };
+
+        struct NoStamp {
+        };
+
+        static void setQueuedAt(Stamp &stamp, uint64_t time) { stamp.queuedAt = time; }
+        static void setQueuedAt(NoStamp &, uint64_t) {}
+        static uint64_t queuedAt(const Stamp &stamp) { return stamp.queuedAt; }
+        static uint64_t queuedAt(const NoStamp &) { return 0; }
+
+        struct Queued : std::conditional_t<metrics::Enabled, Stamp, NoStamp> {
+            Task task;
+        };
 
-                // Encapsulate it into a shared ptr in order to be able to copy construct / assign 
-                auto task_ptr = std::make_shared<std::packaged_task<decltype(f(args...))()>>(func);
+        /* fixed capacity ring of queued tasks, guarded by the worker's mutex */
+        class TaskRing {
+            public:
+                explicit TaskRing(size_t capacity)
+                    : slots_(new Queued[capacity]), capacity_(capacity) {}
 
-                // Wrap packaged task into void function
-                std::function<void()> wrapper_func = [task_ptr]() {
-                    (*task_ptr)(); 
-                };
+                bool empty() const { return 0 == size_; }
 
-                if (true == queue_.isFull()) {
-                    spdlog::error("queue is full");
-                    return std::future<typename std::result_of<F(Args...)>::type>();
+                bool full() const { return capacity_ == size_; }
+
+                void pushBack(Queued &&queued) {
+                    slots_[(head_ + size_) % capacity_] = std::move(queued);
+                    ++size_;
+                }
+
+                void popFront(Queued &queued) {
+                    queued = std::move(slots_[head_]);
+                    slots_[head_].task = nullptr;
+                    head_ = (head_ + 1) % capacity_;
+                    --size_;
+                }
+
+                void popBack(Queued &queued) {
+                    auto &slot = slots_[(head_ + size_ - 1) % capacity_];
+                    queued = std::move(slot);
+                    slot.task = nullptr;
+                    --size_;
                 }
 
-                if (false == queue_.push(wrapper_func)) {
-                    spdlog::error("failed to push to queue");
-                    return std::future<typename std::result_of<F(Args...)>::type>();
+            private:
+                std::unique_ptr<Queued[]> slots_;
+                size_t capacity_;
+                size_t head_ = 0;
+                size_t size_ = 0;
+        };
+
+        struct alignas(CacheLineSize) Worker {
+            explicit Worker(size_t capacity) : tasks(capacity) {}
+
+            std::mutex mutex;
+            TaskRing tasks;
+            /* placement, set up before the threads start */
+            std::vector<unsigned> cpus;
+            int node = 0;
+            /* workers to steal from, same node first */
+            std::vector<size_t> victims;
+        };
+
+        /* shared by all pools of the process */
+        struct PoolMetrics {
+            metrics::Gauge &queued;
+            metrics::Counter &rejected;
+            metrics::Histogram &wait;
+            metrics::Histogram &run;
+        };
+
+        static Options sizedOptions(size_t maxQueueSize, size_t numOfThreads) {
+            Options options;
+            options.maxQueueSize = maxQueueSize;
+            options.numOfThreads = numOfThreads;
+            return options;
+        }
+
+        static const PoolMetrics &poolMetrics() {
+            auto &registry = metrics::Registry::instance();
+            static const PoolMetrics poolMetrics {
+                registry.gauge("up_threadpool_queued_tasks", "Tasks waiting for a thread pool worker"),
+                registry.counter("up_threadpool_rejected_total", "Tasks rejected by a full thread pool queue"),
+                registry.histogram("up_threadpool_task_wait_seconds", "Time from submission until a worker runs the task"),
+                registry.histogram("up_threadpool_task_run_seconds", "Time a worker spends running a task") };
+            return poolMetrics;
+        }
+
+        bool enqueue(Task &&task) {
+
+            if (queued_.fetch_add(1, std::memory_order_relaxed) >= maxQueueSize_) {
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                if constexpr (metrics::Enabled) {
+                    metrics_.rejected.add();
                 }
+                UP_LOG_ERROR("queue is full");
+                return false;
+            }
+
+            Queued queued;
+            queued.task = std::move(task);
+            if constexpr (metrics::Enabled) {
+                setQueuedAt(queued, metrics::now());
+                metrics_.queued.add();
+            }
 
-                /* cleanup finished threads */
-                for (size_t i = 0; i < threads_.size();) {
-                    std::future_status status = threads_[i].wait_for(0ms);
-                    if (std::future_status::ready == status) {
-                        // Remove the thread from the vector
-                        threads_.erase(threads_.begin() + i);
-                        // Decrease the count of threads
-                        numOfThreads_.fetch_sub(1);
+            // keep the task on the submitting worker, otherwise spread the load
+            size_t index;
+            if (this == currentPool_) {
+                index = currentIndex_;
+            } else if (false == nodeWorkers_.empty()) {
+                index = nodeLocalWorker();
+            } else {
+                index = nextWorker_.fetch_add(1, std::memory_order_relaxed) % maxNumOfThreads_;
+            }
+
+            // the slot reserved above is free in some ring, spill over until it is found
+            while (true) {
+                auto &worker = *workers_[index];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                if (false == worker.tasks.full()) {
+                    worker.tasks.pushBack(std::move(queued));
+                    break;
+                }
+                index = (index + 1) % maxNumOfThreads_;
+            }
+
+            idle_.post();
+
+            return true;
+        }
+
+        // the owner takes the oldest task of its own ring
+        bool popLocal(size_t index, Queued &task) {
+            auto &worker = *workers_[index];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.tasks.empty()) {
+                return false;
+            }
+            worker.tasks.popFront(task);
+
+            return true;
+        }
+
+        // a worker of the submitting thread's node, any worker if the node has none
+        size_t nodeLocalWorker() {
+            const auto next = nextWorker_.fetch_add(1, std::memory_order_relaxed);
+            const auto cpu = affinity::currentCpu();
+            if ((cpu >= 0) && (static_cast<size_t>(cpu) < cpuNodes_.size())) {
+                const auto node = static_cast<size_t>(cpuNodes_[cpu]);
+                if ((node < nodeWorkers_.size()) && (false == nodeWorkers_[node].empty())) {
+                    return nodeWorkers_[node][next % nodeWorkers_[node].size()];
+                }
+            }
+
+            return next % maxNumOfThreads_;
+        }
+
+        // thieves take from the back so they rarely collide with the owner
+        bool steal(size_t index, Queued &task) {
+            for (auto victimIndex : workers_[index]->victims) {
+                auto &victim = *workers_[victimIndex];
+                std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+                if (!lock.owns_lock() || victim.tasks.empty()) {
+                    continue;
+                }
+                victim.tasks.popBack(task);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        // work out the CPUs, node and steal order of every worker
+        void place() {
+
+            std::vector<unsigned> cpus = options_.cpus;
+            if (options_.numaGroups) {
+                cpuNodes_ = affinity::cpuNodes();
+                if (cpus.empty()) {
+                    for (unsigned cpu = 0; cpu < cpuNodes_.size(); ++cpu) {
+                        cpus.push_back(cpu);
+                    }
+                }
+
+                // the CPUs of the set, grouped by node
+                std::vector<std::vector<unsigned>> nodeCpus;
+                for (auto cpu : cpus) {
+                    const auto node = (cpu < cpuNodes_.size()) ? static_cast<size_t>(cpuNodes_[cpu]) : 0U;
+                    if (nodeCpus.size() <= node) {
+                        nodeCpus.resize(node + 1);
+                    }
+                    nodeCpus[node].push_back(cpu);
+                }
+                std::vector<size_t> nodes;
+                for (size_t node = 0; node < nodeCpus.size(); ++node) {
+                    if (false == nodeCpus[node].empty()) {
+                        nodes.push_back(node);
+                    }
+                }
+
+                nodeWorkers_.resize(nodeCpus.size());
+                for (size_t i = 0; i < maxNumOfThreads_; ++i) {
+                    const auto node = nodes[i % nodes.size()];
+                    const auto &local = nodeCpus[node];
+                    auto &worker = *workers_[i];
+                    worker.node = static_cast<int>(node);
+                    if (options_.pinEachWorker) {
+                        worker.cpus = { local[(i / nodes.size()) % local.size()] };
+                    } else {
+                        worker.cpus = local;
+                    }
+                    nodeWorkers_[node].push_back(i);
+                }
+            } else if (false == cpus.empty()) {
+                for (size_t i = 0; i < maxNumOfThreads_; ++i) {
+                    if (options_.pinEachWorker) {
+                        workers_[i]->cpus = { cpus[i % cpus.size()] };
                     } else {
-                        ++i;
+                        workers_[i]->cpus = cpus;
                     }
                 }
+            }
 
-                if (numOfThreads_.load() < maxNumOfThreads_) {
-                    threads_.push_back(std::async(std::launch::async, worker, std::ref(queue_), std::ref(terminate_)));
-                    numOfThreads_.fetch_add(1);
+            for (size_t i = 0; i < maxNumOfThreads_; ++i) {
+                auto &victims = workers_[i]->victims;
+                for (size_t k = 1; k < maxNumOfThreads_; ++k) {
+                    victims.push_back((i + k) % maxNumOfThreads_);
                 }
+                std::stable_partition(victims.begin(), victims.end(), [this, i](size_t victim) {
+                    return workers_[victim]->node == workers_[i]->node;
+                });
+            }
+        }
 
-                // Return future from promise
-                return task_ptr->get_future();
+        // apply the placement and scheduling options to the calling worker
+        void configure(size_t index) {
+
+            const auto &cpus = workers_[index]->cpus;
+            if ((false == cpus.empty()) && (false == affinity::pinCurrentThread(cpus))) {
+                UP_LOG_WARN("thread pool worker {} could not be pinned to its {} CPUs", index, cpus.size());
+            }
+            if (false == options_.name.empty()) {
+                affinity::nameCurrentThread(options_.name + "-" + std::to_string(index));
             }
+            if ((SCHED_OTHER != options_.schedPolicy) || (0 != options_.schedPriority)) {
+                if (false == affinity::scheduleCurrentThread(options_.schedPolicy, options_.schedPriority)) {
+                    UP_LOG_WARN("thread pool worker {} could not set scheduling policy {} priority {}",
+                                index, options_.schedPolicy, options_.schedPriority);
+                }
+            }
+        }
 
-    private:
+        void worker(size_t index) {
+
+            configure(index);
+
+            currentPool_ = this;
+            currentIndex_ = index;
+
+            Queued task;
+            while (true) {
+                if (popLocal(index, task) || steal(index, task)) {
+                    queued_.fetch_sub(1, std::memory_order_relaxed);
+                    if constexpr (metrics::Enabled) {
+                        metrics_.queued.sub();
+                        metrics_.wait.recordSince(queuedAt(task));
+                        const auto start = metrics::now();
+                        task.task();
+                        metrics_.run.recordSince(start);
+                    } else {
+                        task.task();
+                    }
+                    task.task = nullptr;
+                    continue;
+                }
+
+                if ((WaitStrategy::Blocking != options_.waitStrategy) && (false == terminate_)) {
+                    const WaitDeadline deadline(options_.idleTimeout);
+                    auto hasWork = [this]() {
+                        return (0 != queued_.load(std::memory_order_acquire)) || (true == terminate_);
+                    };
+                    if (pollUntil(options_.waitStrategy, options_.spins, deadline, hasWork) ||
+                        (false == parks(options_.waitStrategy))) {
+                        continue;
+                    }
+                }
+
+                auto ticket = idle_.value();
+                if (0 != queued_.load(std::memory_order_seq_cst)) {
+                    // a task is being pushed or sits in a ring we failed to lock
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if (true == terminate_) {
+                    break;
+                }
+
+                idle_.wait(ticket, (WaitForever == options_.idleTimeout) ?
+                           std::chrono::nanoseconds::max() :
+                           std::chrono::nanoseconds(options_.idleTimeout));
+            }
+
+            currentPool_ = nullptr;
+        }
+
+        size_t maxQueueSize_;
+
+        std::atomic<bool> terminate_;
 
-        CyclicQueue<std::function<void()>> queue_;
-       
-        bool terminate_;
-        
         size_t maxNumOfThreads_;
 
-        std::atomic<std::size_t> numOfThreads_;
-    
-        std::vector<std::future<void>> threads_;
-        
-        std::mutex mutex_;
+        std::atomic<std::size_t> queued_;
+
+        std::atomic<std::size_t> nextWorker_;
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        std::vector<std::thread> threads_;
+
+        Futex idle_;
+
+        const Options options_;
+
+        /* NUMA node of every CPU and the workers of every node, empty without NUMA groups */
+        std::vector<int> cpuNodes_;
+
+        std::vector<std::vector<size_t>> nodeWorkers_;
+
+        const PoolMetrics &metrics_;
+
+        static inline thread_local ThreadPool *currentPool_ = nullptr;
 
-        static constexpr auto timeoutMillisec_ = 100;
+        static inline thread_local size_t currentIndex_ = 0;
     };
 }
 
-#endif //THREADPOOL_H
\ No newline at end of file
+#endif //THREADPOOL_H
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __WAIT_STRATEGY_HPP__
+#define __WAIT_STRATEGY_HPP__
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace uprotocol::utils {
+
+	/**
+	* How a consumer waits for the next element of an empty queue.
+	* BusySpin    polls until an element or the timeout, never enters the kernel
+	* SpinYield   polls for a spin budget, then yields the CPU between polls
+	* SpinPark    polls for a spin budget, then sleeps until woken or the timeout
+	* Blocking    sleeps right away until woken or the timeout
+	* Spinning gives sub-microsecond hand-off at the cost of a busy core, so it
+	* fits consumers that own a CPU; background queues block, and with a WaitForever
+	* timeout they sleep until an element arrives or the queue is woken up.
+	*/
+	enum class WaitStrategy : uint8_t {
+		BusySpin,
+		SpinYield,
+		SpinPark,
+		Blocking
+	};
+
+	/** Timeout of a wait that only ends with an element or an explicit wake up */
+	static constexpr std::chrono::milliseconds WaitForever = std::chrono::milliseconds::max();
+
+	/** Polls a spinning strategy makes before it yields or parks */
+	static constexpr size_t DefaultSpinCount = 4096U;
+
+	/**
+	* @return true if the strategy ends its wait asleep in the kernel
+	*/
+	constexpr bool parks(WaitStrategy strategy) noexcept {
+		return (WaitStrategy::SpinPark == strategy) || (WaitStrategy::Blocking == strategy);
+	}
+
+	/**
+	* Tell the CPU we are in a spin loop, which frees the pipeline for the
+	* sibling hyper-thread and saves power.
+	*/
+	inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		asm volatile("yield" ::: "memory");
+#endif
+	}
+
+	/**
+	* Deadline of one wait, without overflow for WaitForever.
+	*/
+	class WaitDeadline final
+	{
+	public:
+		explicit WaitDeadline(const std::chrono::milliseconds timeout) noexcept :
+				forever_{WaitForever == timeout},
+				deadline_{forever_ ? std::chrono::steady_clock::time_point::max() :
+									 std::chrono::steady_clock::now() + timeout} {}
+
+		bool forever() const noexcept {
+			return forever_;
+		}
+
+		bool expired() const noexcept {
+			return (false == forever_) && (std::chrono::steady_clock::now() >= deadline_);
+		}
+
+		/**
+		* @return time left, std::chrono::nanoseconds::max() for WaitForever
+		*/
+		std::chrono::nanoseconds remaining() const noexcept {
+			if (forever_) {
+				return std::chrono::nanoseconds::max();
+			}
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				deadline_ - std::chrono::steady_clock::now());
+		}
+
+		std::chrono::steady_clock::time_point time() const noexcept {
+			return deadline_;
+		}
+
+	private:
+		bool forever_;
+		std::chrono::steady_clock::time_point deadline_;
+	};
+
+	/**
+	* Run the polling part of a wait strategy.
+	* @param strategy wait strategy of the consumer
+	* @param spins poll budget of SpinYield / SpinPark
+	* @param deadline end of the wait
+	* @param ready bool() polled until it returns true
+	* @return true once ready() returned true; false when a parking strategy
+	* has used its budget and should sleep, or when the deadline expired
+	*/
+	template<typename Ready>
+	bool pollUntil(const WaitStrategy strategy,
+				   const size_t spins,
+				   const WaitDeadline &deadline,
+				   Ready &&ready) {
+		/* reading the clock costs more than a poll, only look at it now and then */
+		static constexpr size_t ClockInterval = 64U;
+
+		if (WaitStrategy::Blocking == strategy) {
+			return false;
+		}
+
+		size_t polls = 0;
+		while (true) {
+			if (ready()) {
+				return true;
+			}
+			++polls;
+
+			if (WaitStrategy::BusySpin == strategy) {
+				cpuRelax();
+			} else if (polls < spins) {
+				cpuRelax();
+				continue;
+			} else if (WaitStrategy::SpinPark == strategy) {
+				return false;
+			} else {
+				std::this_thread::yield();
+			}
+
+			if ((0U == (polls % ClockInterval)) && deadline.expired()) {
+				return ready();
+			}
+		}
+	}
+}
+#endif // __WAIT_STRATEGY_HPP__
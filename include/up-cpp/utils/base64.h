@@ -25,9 +25,17 @@
 
 #ifndef _BASE64_H_
 #define _BASE64_H_
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace uprotocol::utils {
+/**
+ * Base64 codec. Full blocks are encoded / decoded with AVX2 (selected at run time)
+ * or NEON where available, the output is always sized up front.
+ * Decoding stops at the first character that is not part of the alphabet
+ * (padding included), or after len characters.
+ */
 class Base64 {
     public:
         static std::string encode(const char* string, 
@@ -40,10 +48,111 @@ class Base64 {
         
         static std::string decode(std::string const& str);
 
+        /**
+         * Encode len bytes into out, which must have room for encodedLen(len) characters.
+         * @return number of characters written (encodedLen(len), padding included)
+         */
+        static size_t encode(const uint8_t* data,
+                             size_t len,
+                             char* out);
+
+        /**
+         * Decode up to len characters into out, which must have room for
+         * maxDecodedLen(len) bytes.
+         * @return number of bytes written
+         */
+        static size_t decode(const char* string,
+                             size_t len,
+                             uint8_t* out);
+
         static size_t encodedLen(size_t len);
 
         static size_t decodedLen(const char* string);
 
+        /**
+         * @return number of bytes decoding len characters can produce at most
+         */
+        static constexpr size_t maxDecodedLen(size_t len) {
+            return (len + 3) / 4 * 3;
+        }
+
+        /**
+         * Incremental encoder for data arriving in chunks; the output is the same
+         * as encoding all chunks at once.
+         */
+        class Encoder {
+            public:
+                /**
+                 * Encode a chunk; out must have room for maxOutput(len) characters.
+                 * @return number of characters written
+                 */
+                size_t update(const uint8_t* data,
+                              size_t len,
+                              char* out);
+
+                /**
+                 * Encode the bytes left over by update() with padding; out must have
+                 * room for 4 characters. The encoder can be reused afterwards.
+                 * @return number of characters written
+                 */
+                size_t finish(char* out);
+
+                /**
+                 * @return number of characters update() writes for len bytes at most
+                 */
+                static constexpr size_t maxOutput(size_t len) {
+                    return (len + 2) / 3 * 4;
+                }
+
+            private:
+                uint8_t pending_[2] = {};
+                size_t pendingSize_ = 0;
+        };
+
+        /**
+         * Incremental decoder for encoded data arriving in chunks; the output is
+         * the same as decoding all chunks at once.
+         */
+        class Decoder {
+            public:
+                /**
+                 * Decode a chunk; out must have room for maxOutput(len) bytes.
+                 * Input after the end of the encoded data (padding or any other
+                 * character outside of the alphabet) is ignored.
+                 * @return number of bytes written
+                 */
+                size_t update(const char* string,
+                              size_t len,
+                              uint8_t* out);
+
+                /**
+                 * Decode the characters left over by update(); out must have room
+                 * for 2 bytes. The decoder can be reused afterwards.
+                 * @return number of bytes written
+                 */
+                size_t finish(uint8_t* out);
+
+                /**
+                 * @return true once the end of the encoded data has been seen
+                 */
+                bool done() const {
+                    return done_;
+                }
+
+                /**
+                 * @return number of bytes update() writes for len characters at most
+                 */
+                static constexpr size_t maxOutput(size_t len) {
+                    return (len + 3) / 4 * 3;
+                }
+
+            private:
+                /* 6 bit values of an incomplete group */
+                uint8_t pending_[3] = {};
+                size_t pendingSize_ = 0;
+                bool done_ = false;
+        };
+
     private:
         Base64() = default;
 };
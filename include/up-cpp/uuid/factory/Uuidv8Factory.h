@@ -25,6 +25,7 @@
 #ifndef _UUID_V8_FACTORY_H_
 #define _UUID_V8_FACTORY_H_
 
+#include <atomic>
 #include "RandomGen.h"
 #include "UuidFactory.h"
 #include <up-core-api/uuid.pb.h>
@@ -63,9 +64,33 @@ namespace uprotocol::uuid {
 * */
 class Uuidv8Factory : public UuidFactory {
 public:
-    /** factory function that generates the UUID */
+    /** factory function that generates the UUID, safe to call from any number of threads.
+     *  Once the 12 bit counter is exhausted within one millisecond the UUIDs continue in
+     *  the following millisecond, so no two calls ever return the same UUID */
     static UUID create();
+
+    /** UUID as the plain MSB / LSB pair, without a protobuf message */
+    struct RawUuid {
+        uint64_t msb;
+        uint64_t lsb;
+    };
+
+    /** Generates count consecutive UUIDs reading the clock once; the counter runs
+     *  on into the next millisecond(s) when 4096 UUIDs do not fit into this one */
+    static void createBatch(UUID *uuids, size_t count);
+
+    /** Same as above, writing plain MSB / LSB pairs */
+    static void createBatch(RawUuid *uuids, size_t count);
 private:
+    /** Reserves count consecutive MSBs, returns the first one */
+    static uint64_t reserve(size_t count);
+
+    /** Returns the MSB n counter steps after msb */
+    static uint64_t advanceMsb(uint64_t msb, uint64_t n) {
+        const auto sequence = (msb >> 16) * (maxCount_ + 1) + (msb & maxCount_) + n;
+        return ((sequence / (maxCount_ + 1)) << 16) | version_ | (sequence % (maxCount_ + 1));
+    }
+
     /** Retrieves the past UUID's MSB part    */
     static uint64_t getLastMsb() { return lastMsb_; }
 
@@ -84,15 +109,16 @@ private:
     /** Represents the maxCount of UUID nodes to track previous history  */
     static constexpr uint64_t maxCount_ = 0xfff;
 
+    /** Computes the MSB following prevMsb at time now (in ms) */
+    static uint64_t nextMsb(uint64_t prevMsb, uint64_t now);
+
     /* Using atomic, so we need not implment locking
     *  lastMsb_ to maintain the previous values of msb
     *  so that they help in tracking the past UUID's time and count.
-    *  It will be shared across all UUID instanaces
+    *  It will be shared across all UUID instanaces and is only
+    *  ever updated with a compare-exchange, on a cache line of its own
     */
-    static inline std::atomic<uint64_t> lastMsb_;
-
-    /** Represents MSB part of UUID */
-    static inline uint64_t msb_;
+    alignas(64) static inline std::atomic<uint64_t> lastMsb_;
 
     /** Represents LSB part of UUID */
     static inline uint64_t lsb_ = (RandomGenerator::GenerateRandom()
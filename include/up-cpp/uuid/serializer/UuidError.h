@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _UUID_ERROR_H_
+#define _UUID_ERROR_H_
+
+#include <cstdint>
+#include <string_view>
+
+namespace uprotocol::uuid {
+
+/**
+* Why a UUID could not be deserialized, as returned by the try* functions of
+* UuidSerializer.
+*/
+enum class UuidError : uint8_t {
+    InvalidLength = 1,  /* byte stream that is not ByteLength bytes, or more than 32 hex digits */
+    InvalidCharacter    /* string with a character that is neither a hex digit nor a dash */
+};
+
+[[nodiscard]] constexpr std::string_view toString(UuidError error) {
+    switch (error) {
+        case UuidError::InvalidLength:
+            return "invalid length";
+        case UuidError::InvalidCharacter:
+            return "invalid character";
+    }
+    return "unknown";
+}
+
+} // namespace uprotocol::uuid
+
+#endif //_UUID_ERROR_H_
@@ -25,7 +25,15 @@
 #ifndef _UUID_SERIALIZER_H_
 #define _UUID_SERIALIZER_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
 #include <up-core-api/uuid.pb.h>
+#include <up-cpp/utils/Expected.h>
+#include <up-cpp/uuid/serializer/UuidError.h>
 #include <spdlog/spdlog.h>
 
 namespace uprotocol::uuid {
@@ -38,13 +46,68 @@ using namespace uprotocol::v1;
 */
 class UuidSerializer {
     public:
+
+        /** Length of the String format, 32 hex digits grouped 8-4-4-4-12 */
+        static constexpr size_t StringLength = 36;
+
+        /** Length of the byte stream format */
+        static constexpr size_t ByteLength = 16;
+
+        /** UUID in the byte stream format */
+        using Bytes = std::array<uint8_t, ByteLength>;
+
+        /**
+        * @brief Pack MSB and LSB into the byte stream format, usable in constant expressions.
+        * @param[out] out buffer receiving ByteLength bytes
+        */
+        static constexpr void pack(uint64_t msb,
+                                   uint64_t lsb,
+                                   uint8_t *out) {
+            for (size_t i = 0; i < 8; i++) {
+                out[i] = static_cast<uint8_t>(msb >> (8 * i));
+                out[i + 8] = static_cast<uint8_t>(lsb >> (8 * i));
+            }
+        }
+
+        static constexpr Bytes pack(uint64_t msb,
+                                    uint64_t lsb) {
+            Bytes bytes{};
+            for (size_t i = 0; i < 8; i++) {
+                bytes[i] = static_cast<uint8_t>(msb >> (8 * i));
+                bytes[i + 8] = static_cast<uint8_t>(lsb >> (8 * i));
+            }
+            return bytes;
+        }
+
+        /**
+        * @brief Unpack MSB and LSB from ByteLength bytes of the byte stream format,
+        * usable in constant expressions.
+        */
+        static constexpr void unpack(const uint8_t *bytes,
+                                     uint64_t &msb,
+                                     uint64_t &lsb) {
+            msb = 0;
+            lsb = 0;
+            for (size_t i = 8; i-- > 0;) {
+                msb = (msb << 8) | bytes[i];
+                lsb = (lsb << 8) | bytes[i + 8];
+            }
+        }
  
         /**
         * @brief Support for serializing UUID objects into their String format.
         * @param uuid UUID object  to be serialized to the String format.
         * @return Returns the String format of the supplied UUID
         */
-        static std::string serializeToString(UUID uuid);
+        static std::string serializeToString(const UUID &uuid);
+
+        /**
+        * @brief Serialize a UUID into a caller provided buffer, without allocating.
+        * @param uuid UUID object to be serialized to the String format.
+        * @param[out] out buffer receiving exactly StringLength characters (not null terminated)
+        */
+        static void serializeToChars(const UUID &uuid,
+                                     char *out);
 
         /**
         *
@@ -53,21 +116,81 @@ class UuidSerializer {
         * @return Returns  UUIDv8 in  vector of byte stream
         *
         */
-        static std::vector<uint8_t> serializeToBytes(UUID uuid);
+        static std::vector<uint8_t> serializeToBytes(const UUID &uuid);
+
+        /**
+        * @brief Serialize a UUID into a caller provided buffer, e.g. straight into a wire frame.
+        * @param uuid UUID object to be serialized to the byte array format.
+        * @param[out] out buffer receiving exactly ByteLength bytes
+        */
+        static void serializeToBytes(const UUID &uuid,
+                                     uint8_t *out) {
+            pack(uuid.msb(), uuid.lsb(), out);
+        }
+
+        /**
+        * @brief Serialize a UUID into a fixed size array, without allocating.
+        */
+        static Bytes serializeToArray(const UUID &uuid) {
+            return pack(uuid.msb(), uuid.lsb());
+        }
 
         /**
         * @brief Deserialize a String into a UUID object.
         * @param uuid String equivalent UUID
         * @return Returns an UUID data object.
         */
-        static UUID deserializeFromString(std::string uuidStr);
+        static UUID deserializeFromString(std::string_view uuidStr);
+
+        /**
+        * @brief Deserialize a String into a UUID object, reporting malformed input
+        * as an error code instead of the nil UUID. Does not log.
+        * @param uuidStr String equivalent UUID
+        * @return Returns the UUID, or UuidError::InvalidCharacter / InvalidLength.
+        */
+        [[nodiscard]] static utils::Expected<UUID, UuidError> tryDeserializeFromString(std::string_view uuidStr);
+
+        /**
+        * @brief Deserialize exactly the String format (StringLength characters, dashes at
+        * the 8-4-4-4-12 positions), validating every character in the same pass.
+        * @param str characters to parse
+        * @param length number of characters
+        * @param[out] uuid receives the UUID, untouched on failure
+        * @return Returns false if str is not a well formed UUID string
+        */
+        static bool deserializeFromChars(const char *str,
+                                         size_t length,
+                                         UUID &uuid);
 
         /**
         * @brief Deserialize a byte stream into a UUID object.
         * @param uuid UUID represented in byte stream equivalent
         * @return Returns an UUID data object.
         */
-        static UUID deserializeFromBytes(std::vector<uint8_t> bytes);
+        static UUID deserializeFromBytes(const std::vector<uint8_t> &bytes);
+
+        /**
+        * @brief Deserialize a byte stream held in a caller buffer into a UUID object.
+        * @param bytes UUID represented in byte stream equivalent
+        * @param size number of bytes, must be ByteLength
+        * @return Returns an UUID data object, the nil UUID if size is wrong.
+        */
+        static UUID deserializeFromBytes(const uint8_t *bytes,
+                                         size_t size);
+
+        static UUID deserializeFromBytes(const Bytes &bytes) {
+            return deserializeFromBytes(bytes.data(), bytes.size());
+        }
+
+        /**
+        * @brief Deserialize a byte stream held in a caller buffer into a UUID object,
+        * reporting a wrong size as an error code instead of the nil UUID. Does not log.
+        * @param bytes UUID represented in byte stream equivalent
+        * @param size number of bytes, must be ByteLength
+        * @return Returns the UUID, or UuidError::InvalidLength.
+        */
+        [[nodiscard]] static utils::Expected<UUID, UuidError> tryDeserializeFromBytes(const uint8_t *bytes,
+                                                                                      size_t size);
 
         /**
         * @brief extracts UTC time at from current UUID object
@@ -99,9 +222,9 @@ class UuidSerializer {
         * @brief takes uuid in the string form and writes it to uuidOut
         * @param str uuid in string
         * @param[out]  uuidOut  uuid is stored in vector of size 16
-        * @return int - failure status
+        * @return int - failure status, -1 for an invalid character, -2 for more than 32 digits
         */
-        static int uuidFromString(std::string str,
+        static int uuidFromString(std::string_view str,
                                   std::vector<uint8_t> &uuidOut);
 
         /** UUID array size */
@@ -26,8 +26,15 @@
  *  Refer :https://en.wikipedia.org/wiki/Base64 */
 
 #include <up-cpp/utils/base64.h>
-#include "spdlog/spdlog.h"
-#include <iostream>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BASE64_AVX2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BASE64_NEON 1
+#endif
 
 using namespace uprotocol::utils;
 
@@ -57,67 +64,300 @@ static const uint8_t pr2six[256] = {
 static constexpr const char basis64[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-std::string Base64::encode(const char* string,
-                           const size_t len) {
-    std::string encoded;
-    size_t i;
-
-    for (i = 0U; i < len - 2; i += 3) {
-        encoded.push_back(basis64[(string[i] >> 2) & 0x3Fu]);
-        encoded.push_back(basis64[((string[i] & 0x03u) << 4) |
-                                  ((static_cast<size_t>(string[i + 1]) & 0xF0u) >> 4)]);
-        encoded.push_back(basis64[((string[i + 1] & 0x0Fu) << 2) |
-                                  ((static_cast<size_t>(string[i + 2]) & 0xC0u) >> 6)]);
-        encoded.push_back(basis64[string[i + 2] & 0x3Fu]);
-    }
-
-    if (i < len) {
-        encoded.push_back(basis64[(string[i] >> 2) & 0x3Fu]);
-        if (i == (len - 1)) {
-            encoded.push_back(basis64[((string[i] & 0x03u) << 4)]);
-            encoded.push_back('=');
-        } else {
-            encoded.push_back(basis64[((string[i] & 0x03u) << 4) |
-                                      ((static_cast<size_t>(string[i + 1]) & 0xF0u) >> 4)]);
-            encoded.push_back(basis64[((string[i + 1] & 0x0Fu) << 2)]);
+namespace {
+
+inline void encodeGroup(const uint8_t* in, char* out) {
+    out[0] = basis64[in[0] >> 2];
+    out[1] = basis64[((in[0] & 0x03u) << 4) | (in[1] >> 4)];
+    out[2] = basis64[((in[1] & 0x0Fu) << 2) | (in[2] >> 6)];
+    out[3] = basis64[in[2] & 0x3Fu];
+}
+
+/* encode the last 1 or 2 bytes with padding */
+inline void encodeTail(const uint8_t* in, size_t len, char* out) {
+    out[0] = basis64[in[0] >> 2];
+    if (1 == len) {
+        out[1] = basis64[(in[0] & 0x03u) << 4];
+        out[2] = '=';
+    } else {
+        out[1] = basis64[((in[0] & 0x03u) << 4) | (in[1] >> 4)];
+        out[2] = basis64[(in[1] & 0x0Fu) << 2];
+    }
+    out[3] = '=';
+}
+
+inline void decodeGroup(const uint8_t* values, uint8_t* out) {
+    out[0] = static_cast<uint8_t>((values[0] << 2) | (values[1] >> 4));
+    out[1] = static_cast<uint8_t>((values[1] << 4) | (values[2] >> 2));
+    out[2] = static_cast<uint8_t>((values[2] << 6) | values[3]);
+}
+
+/* decode an incomplete group of 6 bit values, a single value carries no full byte */
+inline size_t decodeTail(const uint8_t* values, size_t count, uint8_t* out) {
+    size_t written = 0;
+    if (count > 1) {
+        out[written++] = static_cast<uint8_t>((values[0] << 2) | (values[1] >> 4));
+    }
+    if (count > 2) {
+        out[written++] = static_cast<uint8_t>((values[1] << 4) | (values[2] >> 2));
+    }
+    return written;
+}
+
+void encodeBlocksScalar(const uint8_t* in, size_t groups, char* out) {
+    for (size_t i = 0U; i < groups; ++i) {
+        encodeGroup(in + (i * 3U), out + (i * 4U));
+    }
+}
+
+/* @return number of groups decoded, stops before the first group holding a character outside of the alphabet */
+size_t decodeBlocksScalar(const uint8_t* in, size_t groups, uint8_t* out) {
+    size_t i = 0U;
+    for (; i < groups; ++i) {
+        const uint8_t values[4] = {
+            pr2six[in[i * 4U]], pr2six[in[(i * 4U) + 1U]], pr2six[in[(i * 4U) + 2U]], pr2six[in[(i * 4U) + 3U]] };
+        /* 64 marks an invalid character, it is the only value with bit 6 set */
+        if ((values[0] | values[1] | values[2] | values[3]) > 63U) {
+            break;
         }
-        encoded.push_back('=');
+        decodeGroup(values, out + (i * 3U));
     }
+    return i;
+}
 
-    return encoded;
+#if defined(BASE64_AVX2)
+
+/* 8 groups (24 bytes) per iteration, reading 28 bytes of input */
+__attribute__((target("avx2")))
+size_t encodeBlocksAvx2(const uint8_t* in, size_t groups, char* out) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    /* offset from a 6 bit value to its character, indexed by the reduced value */
+    const __m256i offsets = _mm256_setr_epi8(
+        71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 65, 0, 0,
+        71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 65, 0, 0);
+
+    size_t done = 0U;
+    while ((groups - done) >= 10U) {
+        const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + (done * 3U)));
+        const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + (done * 3U) + 12U));
+        auto v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+
+        /* move every 6 bit value into its own byte */
+        const auto t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)),
+                                           _mm256_set1_epi32(0x04000040));
+        const auto t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)),
+                                           _mm256_set1_epi32(0x01000010));
+        const auto indices = _mm256_or_si256(t0, t1);
+
+        /* 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12 */
+        auto reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        reduced = _mm256_or_si256(reduced,
+            _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+        const auto chars = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, reduced), indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + (done * 4U)), chars);
+        done += 8U;
+    }
+    return done;
 }
 
-std::string Base64::decode(const char* string,
-                           const size_t len) {
+/* 8 groups (32 characters) per iteration, stops at a block holding a character outside of the alphabet */
+__attribute__((target("avx2")))
+size_t decodeBlocksAvx2(const uint8_t* in, size_t groups, uint8_t* out) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
 
-    (void)len;
-    std::string decoded;
+    size_t done = 0U;
+    while ((groups - done) >= 8U) {
+        const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + (done * 4U)));
 
-    auto bufin = reinterpret_cast<const uint8_t*>(string);
-    while (pr2six[*(bufin++)] <= 63);
+        /* signed compares, characters above 0x7f never match a range */
+        const auto upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+        const auto lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('a' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), v));
+        const auto digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        const auto plus = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('+'));
+        const auto slash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
 
-    auto nprbytes = (bufin - reinterpret_cast<const uint8_t*>(string)) - 1;
+        const auto valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                           _mm256_or_si256(digit, _mm256_or_si256(plus, slash)));
+        if (-1 != _mm256_movemask_epi8(valid)) {
+            break;
+        }
 
-    bufin = reinterpret_cast<const uint8_t*>(string);
+        auto shift = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(19)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+        const auto values = _mm256_add_epi8(v, shift);
 
-    while (nprbytes > 4) {
-        decoded.push_back(static_cast<uint8_t>((pr2six[*bufin] << 2 | pr2six[bufin[1]] >> 4)));
-        decoded.push_back(static_cast<uint8_t>((pr2six[bufin[1]] << 4 | pr2six[bufin[2]] >> 2)));
-        decoded.push_back(static_cast<uint8_t>((pr2six[bufin[2]] << 6 | pr2six[bufin[3]])));
+        /* pack 4 x 6 bits into 24 bits per 32 bit lane */
+        const auto pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const auto packed = _mm256_shuffle_epi8(_mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000)), shuffle);
 
-        bufin += 4;
-        nprbytes -= 4;
+        alignas(32) uint8_t bytes[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bytes), packed);
+        std::memcpy(out + (done * 3U), bytes, 12U);
+        std::memcpy(out + (done * 3U) + 12U, bytes + 16U, 12U);
+        done += 8U;
     }
+    return done;
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#elif defined(BASE64_NEON)
 
-    if (nprbytes > 1) {
-        decoded.push_back(static_cast<uint8_t>((pr2six[*bufin] << 2 | pr2six[bufin[1]] >> 4)));
+/* 16 groups (48 bytes) per iteration */
+size_t encodeBlocksNeon(const uint8_t* in, size_t groups, char* out) {
+    uint8x16x4_t table;
+    for (size_t i = 0U; i < 4U; ++i) {
+        table.val[i] = vld1q_u8(reinterpret_cast<const uint8_t*>(basis64) + (i * 16U));
     }
-    if (nprbytes > 2) {
-        decoded.push_back(static_cast<uint8_t>((pr2six[bufin[1]] << 4 | pr2six[bufin[2]] >> 2)));
+    const auto mask6 = vdupq_n_u8(0x3F);
+
+    size_t done = 0U;
+    while ((groups - done) >= 16U) {
+        const auto bytes = vld3q_u8(in + (done * 3U));
+        uint8x16x4_t chars;
+        chars.val[0] = vshrq_n_u8(bytes.val[0], 2);
+        chars.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[0], 4), vshrq_n_u8(bytes.val[1], 4)), mask6);
+        chars.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[1], 2), vshrq_n_u8(bytes.val[2], 6)), mask6);
+        chars.val[3] = vandq_u8(bytes.val[2], mask6);
+        for (size_t i = 0U; i < 4U; ++i) {
+            chars.val[i] = vqtbl4q_u8(table, chars.val[i]);
+        }
+        vst4q_u8(reinterpret_cast<uint8_t*>(out + (done * 4U)), chars);
+        done += 16U;
     }
-    if (nprbytes > 3) {
-        decoded.push_back(static_cast<uint8_t>((pr2six[bufin[2]] << 6 | pr2six[bufin[3]])));
+    return done;
+}
+
+/* maps characters to 6 bit values, sets valid to 0xff for characters of the alphabet */
+inline uint8x16_t decodeValuesNeon(uint8x16_t v, uint8x16_t &valid) {
+    const auto upper = vcltq_u8(vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(26));
+    const auto lower = vcltq_u8(vsubq_u8(v, vdupq_n_u8('a')), vdupq_n_u8(26));
+    const auto digit = vcltq_u8(vsubq_u8(v, vdupq_n_u8('0')), vdupq_n_u8(10));
+    const auto plus = vceqq_u8(v, vdupq_n_u8('+'));
+    const auto slash = vceqq_u8(v, vdupq_n_u8('/'));
+
+    auto values = vbslq_u8(upper, vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(0));
+    values = vbslq_u8(lower, vsubq_u8(v, vdupq_n_u8('a' - 26)), values);
+    values = vbslq_u8(digit, vaddq_u8(v, vdupq_n_u8(52 - '0')), values);
+    values = vbslq_u8(plus, vdupq_n_u8(62), values);
+    values = vbslq_u8(slash, vdupq_n_u8(63), values);
+
+    valid = vandq_u8(valid, vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, vorrq_u8(plus, slash))));
+    return values;
+}
+
+/* 16 groups (64 characters) per iteration, stops at a block holding a character outside of the alphabet */
+size_t decodeBlocksNeon(const uint8_t* in, size_t groups, uint8_t* out) {
+    size_t done = 0U;
+    while ((groups - done) >= 16U) {
+        const auto chars = vld4q_u8(in + (done * 4U));
+        auto valid = vdupq_n_u8(0xFF);
+        uint8x16_t values[4];
+        for (size_t i = 0U; i < 4U; ++i) {
+            values[i] = decodeValuesNeon(chars.val[i], valid);
+        }
+        if (0xFF != vminvq_u8(valid)) {
+            break;
+        }
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(values[0], 2), vshrq_n_u8(values[1], 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(values[1], 4), vshrq_n_u8(values[2], 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(values[2], 6), values[3]);
+        vst3q_u8(out + (done * 3U), bytes);
+        done += 16U;
     }
+    return done;
+}
+
+#endif
+
+void encodeBlocks(const uint8_t* in, size_t groups, char* out) {
+    size_t done = 0U;
+#if defined(BASE64_AVX2)
+    if (hasAvx2()) {
+        done = encodeBlocksAvx2(in, groups, out);
+    }
+#elif defined(BASE64_NEON)
+    done = encodeBlocksNeon(in, groups, out);
+#endif
+    encodeBlocksScalar(in + (done * 3U), groups - done, out + (done * 4U));
+}
+
+size_t decodeBlocks(const uint8_t* in, size_t groups, uint8_t* out) {
+    size_t done = 0U;
+#if defined(BASE64_AVX2)
+    if (hasAvx2()) {
+        done = decodeBlocksAvx2(in, groups, out);
+    }
+#elif defined(BASE64_NEON)
+    done = decodeBlocksNeon(in, groups, out);
+#endif
+    return done + decodeBlocksScalar(in + (done * 4U), groups - done, out + (done * 3U));
+}
+
+}  // namespace
+
+size_t Base64::encode(const uint8_t* data,
+                      size_t len,
+                      char* out) {
+    const size_t groups = len / 3U;
+    encodeBlocks(data, groups, out);
+    if (0U != (len % 3U)) {
+        encodeTail(data + (groups * 3U), len % 3U, out + (groups * 4U));
+    }
+
+    return encodedLen(len);
+}
+
+size_t Base64::decode(const char* string,
+                      size_t len,
+                      uint8_t* out) {
+    auto in = reinterpret_cast<const uint8_t*>(string);
+    const size_t groups = decodeBlocks(in, len / 4U, out);
+
+    /* at most 3 valid characters are left: the rest of the input or the
+     * characters before the invalid one */
+    uint8_t values[4];
+    size_t count = 0U;
+    for (size_t pos = groups * 4U; (pos < len) && (count < 4U); ++pos) {
+        values[count] = pr2six[in[pos]];
+        if (values[count] > 63U) {
+            break;
+        }
+        ++count;
+    }
+
+    return (groups * 3U) + decodeTail(values, count, out + (groups * 3U));
+}
+
+std::string Base64::encode(const char* string,
+                           const size_t len) {
+    std::string encoded(encodedLen(len), '\0');
+    encode(reinterpret_cast<const uint8_t*>(string), len, encoded.data());
+
+    return encoded;
+}
+
+std::string Base64::decode(const char* string,
+                           const size_t len) {
+    std::string decoded(maxDecodedLen(len), '\0');
+    decoded.resize(decode(string, len, reinterpret_cast<uint8_t*>(decoded.data())));
 
     return decoded;
 }
@@ -144,4 +384,101 @@ size_t Base64::decodedLen(const char* string) {
     size_t nbytesdecoded = ((nprbytes + 3) / 4) * 3;
 
     return nbytesdecoded + 1;
-}
\ No newline at end of file
+}
+
+size_t Base64::Encoder::update(const uint8_t* data,
+                               size_t len,
+                               char* out) {
+    size_t pos = 0U;
+    size_t written = 0U;
+
+    if (0U != pendingSize_) {
+        if ((pendingSize_ + len) < 3U) {
+            std::memcpy(pending_ + pendingSize_, data, len);
+            pendingSize_ += len;
+            return 0U;
+        }
+        uint8_t group[3] = { pending_[0], pending_[1], 0U };
+        pos = 3U - pendingSize_;
+        std::memcpy(group + pendingSize_, data, pos);
+        encodeGroup(group, out);
+        pendingSize_ = 0U;
+        written = 4U;
+    }
+
+    const size_t groups = (len - pos) / 3U;
+    encodeBlocks(data + pos, groups, out + written);
+    pos += groups * 3U;
+    written += groups * 4U;
+
+    pendingSize_ = len - pos;
+    std::memcpy(pending_, data + pos, pendingSize_);
+
+    return written;
+}
+
+size_t Base64::Encoder::finish(char* out) {
+    if (0U == pendingSize_) {
+        return 0U;
+    }
+    encodeTail(pending_, pendingSize_, out);
+    pendingSize_ = 0U;
+
+    return 4U;
+}
+
+size_t Base64::Decoder::update(const char* string,
+                               size_t len,
+                               uint8_t* out) {
+    if (true == done_) {
+        return 0U;
+    }
+
+    auto in = reinterpret_cast<const uint8_t*>(string);
+    size_t pos = 0U;
+    size_t written = 0U;
+
+    /* feeds single characters, returns false at the end of the encoded data */
+    auto push = [&](uint8_t c) {
+        const auto value = pr2six[c];
+        if (value > 63U) {
+            done_ = true;
+            return false;
+        }
+        if (3U == pendingSize_) {
+            const uint8_t values[4] = { pending_[0], pending_[1], pending_[2], value };
+            decodeGroup(values, out + written);
+            written += 3U;
+            pendingSize_ = 0U;
+        } else {
+            pending_[pendingSize_++] = value;
+        }
+        return true;
+    };
+
+    while ((0U != pendingSize_) && (pos < len)) {
+        if (false == push(in[pos++])) {
+            return written;
+        }
+    }
+
+    const size_t groups = decodeBlocks(in + pos, (len - pos) / 4U, out + written);
+    pos += groups * 4U;
+    written += groups * 3U;
+
+    while (pos < len) {
+        if (false == push(in[pos++])) {
+            break;
+        }
+    }
+
+    return written;
+}
+
+size_t Base64::Decoder::finish(uint8_t* out) {
+    const size_t written = decodeTail(pending_, pendingSize_, out);
+    pendingSize_ = 0U;
+    done_ = false;
+
+    return written;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <up-cpp/rpc/ContinuationRpcClient.h>
+#include <up-cpp/transport/builder/UAttributesBuilder.h>
+#include <up-cpp/utils/Log.h>
+
+using namespace uprotocol::rpc;
+using namespace uprotocol::utransport;
+using namespace uprotocol::utils;
+using namespace uprotocol::v1;
+
+static UStatus status(UCode code) {
+    UStatus status;
+    status.set_code(code);
+    return status;
+}
+
+ContinuationRpcClient::ContinuationRpcClient(UTransport &transport,
+                                             const UUri &source,
+                                             size_t capacity)
+    : transport_(transport),
+      source_(source),
+      requests_(capacity),
+      listener_(requests_) {}
+
+ContinuationRpcClient::~ContinuationRpcClient() {
+    /* no response reaches the table once the listener is gone, requests_ then cancels the rest */
+    std::lock_guard<std::mutex> lock(methodsMutex_);
+    for (const auto &method : methods_) {
+        static_cast<void>(transport_.unregisterListener(method.second, listener_));
+    }
+}
+
+std::future<RpcResponse> ContinuationRpcClient::invokeMethod(const UUri &topic,
+                                                             const UPayload &payload,
+                                                             const CallOptions &options) {
+    std::promise<RpcResponse> promise;
+    auto future = promise.get_future();
+
+    auto sent = invokeMethod(topic, payload, options,
+        [promise = std::move(promise)](RpcResponse &&response) mutable {
+            promise.set_value(std::move(response));
+        });
+    if (UCode::OK != sent.code()) {
+        /* the continuation holding the promise is gone, answer with a promise of our own */
+        std::promise<RpcResponse> failed;
+        future = failed.get_future();
+        RpcResponse response;
+        response.status = std::move(sent);
+        failed.set_value(std::move(response));
+    }
+
+    return future;
+}
+
+UStatus ContinuationRpcClient::invokeMethod(const UUri &topic,
+                                            const UPayload &payload,
+                                            const CallOptions &options,
+                                            const UListener &callback) {
+    return invokeMethod(topic, payload, options,
+        [&callback](RpcResponse &&response) {
+            if (UCode::OK != response.status.code()) {
+                response.message.mutableAttributes().set_commstatus(response.status.code());
+            }
+            static_cast<void>(callback.onReceive(response.message));
+        });
+}
+
+UStatus ContinuationRpcClient::invokeMethod(const UUri &topic,
+                                            const UPayload &payload,
+                                            const CallOptions &options,
+                                            RpcContinuation &&continuation,
+                                            ThreadPool *executor) {
+    auto listening = listenTo(topic);
+    if (UCode::OK != listening.code()) {
+        return listening;
+    }
+
+    auto builder = UAttributesBuilder::request(source_, topic, options.priority(), options.ttl());
+    if (options.has_token()) {
+        builder.setToken(options.token());
+    }
+    UMessage request(payload, builder.build());
+    const auto &reqid = request.attributes().id();
+
+    /* added before the request goes out, the response may arrive before send() returns */
+    UStatus added;
+    if (nullptr == executor) {
+        added = requests_.add(reqid, options, std::move(continuation));
+    } else {
+        /* the continuation and the executor do not fit next to each other in place */
+        auto resumption = std::make_unique<Resumption>();
+        resumption->continuation = std::move(continuation);
+        resumption->executor = executor;
+        added = requests_.add(reqid, options,
+            [resumption = std::move(resumption)](RpcResponse &&response) mutable {
+                resume(std::move(resumption), std::move(response));
+            });
+    }
+    if (UCode::OK != added.code()) {
+        return added;
+    }
+
+    auto sent = transport_.send(request);
+    if (UCode::OK != sent.code()) {
+        /* a response is not expected, the failure is reported to the caller instead */
+        static_cast<void>(requests_.remove(reqid));
+    }
+
+    return sent;
+}
+
+UStatus ContinuationRpcClient::invokeStreamingMethod(const UUri &topic,
+                                                     const UPayload &payload,
+                                                     const CallOptions &options,
+                                                     RpcChunkHandler &&handler,
+                                                     ThreadPool *executor,
+                                                     size_t chunkSize) {
+
+    /* the handler does not fit next to the continuation's own captures */
+    auto owned = std::make_unique<RpcChunkHandler>(std::move(handler));
+
+    return invokeMethod(topic, payload, options,
+        [owned = std::move(owned), chunkSize](RpcResponse &&response) mutable {
+            const auto size = response.message.payload().size();
+            if ((UCode::OK != response.status.code()) || (0 == chunkSize) || (size <= chunkSize)) {
+                (*owned)(RpcChunk{std::move(response.status), std::move(response.message), 0, true});
+                return;
+            }
+
+            const auto whole = response.message.payload();
+            for (size_t offset = 0; offset < size; offset += chunkSize) {
+                const bool last = (size - offset <= chunkSize);
+                RpcChunk chunk;
+                chunk.status = response.status;
+                /* every chunk carries the response attributes, the last one takes them over */
+                if (true == last) {
+                    chunk.message = std::move(response.message);
+                } else {
+                    chunk.message = response.message;
+                }
+                chunk.message.setPayload(whole.slice(offset, chunkSize));
+                chunk.offset = offset;
+                chunk.last = last;
+                (*owned)(std::move(chunk));
+            }
+        },
+        executor);
+}
+
+void ContinuationRpcClient::resume(std::unique_ptr<Resumption> resumption, RpcResponse &&response) {
+    /* the continuation runs after the transport reused a referenced receive buffer */
+    response.message.mutablePayload().retain();
+    resumption->response = std::move(response);
+
+    /* only a pointer is posted, the response stays in the resumption */
+    auto *posted = resumption.release();
+    auto *executor = posted->executor;
+    if (false == executor->post([posted]() {
+            std::unique_ptr<Resumption> owned(posted);
+            owned->continuation(std::move(owned->response));
+        })) {
+        UP_LOG_WARN("RPC executor refused the continuation, resuming inline");
+        std::unique_ptr<Resumption> owned(posted);
+        owned->continuation(std::move(owned->response));
+    }
+}
+
+UStatus ContinuationRpcClient::listenTo(const UUri &topic) {
+    auto key = topic.SerializeAsString();
+
+    std::lock_guard<std::mutex> lock(methodsMutex_);
+    if (methods_.end() != methods_.find(key)) {
+        return status(UCode::OK);
+    }
+
+    auto registered = transport_.registerListener(topic, listener_);
+    if (UCode::OK == registered.code()) {
+        methods_.emplace(std::move(key), topic);
+    }
+
+    return registered;
+}
+
+UStatus ContinuationRpcClient::ResponseListener::onReceive(UMessage &message) const {
+    /* requests for the method and responses to other clients arrive here too, they are ignored */
+    if (UMessageType::UMESSAGE_TYPE_RESPONSE == message.attributes().type()) {
+        static_cast<void>(requests_.complete(message));
+    }
+
+    return status(UCode::OK);
+}
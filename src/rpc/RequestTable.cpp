@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <up-cpp/rpc/RequestTable.h>
+
+using namespace uprotocol::rpc;
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+static size_t roundUpPow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+RequestTable::RequestTable(size_t capacity,
+                           std::chrono::milliseconds tick)
+    : capacity_(capacity),
+      tick_((tick.count() > 0) ? tick : std::chrono::milliseconds(1)),
+      epoch_(std::chrono::steady_clock::now()) {
+
+    /* requests hash unevenly onto the stripes, give every stripe about three
+       standard deviations of headroom so that growing a stripe is rare */
+    const size_t perStripe = (capacity + Stripes - 1) / Stripes;
+    const size_t nodes = perStripe + static_cast<size_t>(3.0 * std::sqrt(static_cast<double>(perStripe))) + 4;
+
+    for (auto &stripe : stripes_) {
+        stripe = std::make_unique<Stripe>();
+        stripe->nodes.resize(nodes);
+        for (size_t i = 0; i < nodes; ++i) {
+            stripe->nodes[i].next = (i + 1 < nodes) ? static_cast<uint32_t>(i + 1) : None;
+        }
+        stripe->freeList = 0;
+        stripe->index.assign(roundUpPow2(2 * nodes), None);
+        stripe->mask = stripe->index.size() - 1;
+        stripe->lists.assign(RootSlots + (Levels - 1) * LevelSlots, None);
+    }
+}
+
+RequestTable::~RequestTable() {
+    for (auto &stripe : stripes_) {
+        for (auto &node : stripe->nodes) {
+            if (node.continuation) {
+                RpcResponse response;
+                response.status.set_code(UCode::CANCELLED);
+                node.continuation(std::move(response));
+            }
+        }
+    }
+}
+
+UStatus RequestTable::add(const UUID &reqid,
+                          std::chrono::milliseconds ttl,
+                          RpcContinuation &&continuation) {
+    const auto h = hash(reqid.msb(), reqid.lsb());
+    auto &stripe = stripeOf(h);
+    const auto now = ticks(std::chrono::steady_clock::now());
+
+    UStatus status;
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    const auto slot = find(stripe, h, reqid.msb(), reqid.lsb());
+    if (None != stripe.index[slot]) {
+        status.set_code(UCode::ALREADY_EXISTS);
+        return status;
+    }
+    if (size_.fetch_add(1, std::memory_order_relaxed) >= capacity_) {
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        status.set_code(UCode::RESOURCE_EXHAUSTED);
+        return status;
+    }
+    auto free = slot;
+    if (None == stripe.freeList) {
+        /* the table is not full, this stripe just got more than its share */
+        grow(stripe);
+        free = find(stripe, h, reqid.msb(), reqid.lsb());
+    }
+
+    const auto n = stripe.freeList;
+    auto &node = stripe.nodes[n];
+    stripe.freeList = node.next;
+
+    node.msb = reqid.msb();
+    node.lsb = reqid.lsb();
+    node.continuation = std::move(continuation);
+    node.prev = None;
+    node.next = None;
+    node.list = None;
+    stripe.index[free] = n;
+    ++stripe.size;
+
+    if (ttl.count() > 0) {
+        node.expires = now + static_cast<uint64_t>((ttl.count() + tick_.count() - 1) / tick_.count());
+        link(stripe, n);
+    }
+
+    status.set_code(UCode::OK);
+    return status;
+}
+
+bool RequestTable::complete(const UMessage &response) {
+    return complete(response.attributes().reqid(), response);
+}
+
+bool RequestTable::complete(UMessage &&response) {
+    /* the reqid is copied out before the message is moved away */
+    const auto reqid = response.attributes().reqid();
+    return complete(reqid, std::move(response));
+}
+
+bool RequestTable::complete(const UUID &reqid,
+                            const UMessage &response) {
+    return complete(reqid, UMessage(response));
+}
+
+bool RequestTable::complete(const UUID &reqid,
+                            UMessage &&response) {
+    RpcContinuation continuation;
+    if (false == take(reqid, continuation)) {
+        return false;
+    }
+
+    RpcResponse result;
+    result.status.set_code(UCode::OK);
+    result.message = std::move(response);
+    continuation(std::move(result));
+
+    return true;
+}
+
+bool RequestTable::cancel(const UUID &reqid,
+                          UStatus status) {
+    RpcContinuation continuation;
+    if (false == take(reqid, continuation)) {
+        return false;
+    }
+
+    RpcResponse result;
+    result.status = std::move(status);
+    continuation(std::move(result));
+
+    return true;
+}
+
+bool RequestTable::remove(const UUID &reqid) {
+    RpcContinuation continuation;
+    return take(reqid, continuation);
+}
+
+size_t RequestTable::expire(std::chrono::steady_clock::time_point now) {
+    const auto target = ticks(now);
+    size_t expired = 0;
+
+    std::lock_guard<std::mutex> expireLock(expireMutex_);
+
+    for (auto &stripe : stripes_) {
+        {
+            std::lock_guard<std::mutex> lock(stripe->mutex);
+
+            while (stripe->base <= target) {
+                if (0 == stripe->timed) {
+                    /* nothing can expire, skip the idle ticks */
+                    stripe->base = target + 1;
+                    break;
+                }
+
+                auto index = static_cast<uint32_t>(stripe->base & (RootSlots - 1));
+                if ((0 == stripe->rooted) && (0 != index)) {
+                    /* the root level is empty, jump to where the next level cascades into it */
+                    stripe->base = std::min(stripe->base + (RootSlots - index), target + 1);
+                    continue;
+                }
+                /* refill the root level from the coarser levels once it wrapped around */
+                if (0 == index) {
+                    for (unsigned level = 1; level < Levels; ++level) {
+                        const auto slot = static_cast<uint32_t>(
+                            (stripe->base >> (RootBits + (level - 1) * LevelBits)) & (LevelSlots - 1));
+                        if (0 != cascade(*stripe, level, slot)) {
+                            break;
+                        }
+                    }
+                }
+
+                while (None != stripe->lists[index]) {
+                    const auto &node = stripe->nodes[stripe->lists[index]];
+                    const auto slot = find(*stripe, hash(node.msb, node.lsb), node.msb, node.lsb);
+                    expired_.emplace_back();
+                    release(*stripe, slot, expired_.back().continuation);
+                }
+
+                ++stripe->base;
+            }
+        }
+
+        for (auto &ready : expired_) {
+            ready.response.status.set_code(UCode::DEADLINE_EXCEEDED);
+            ready.continuation(std::move(ready.response));
+        }
+        expired += expired_.size();
+        expired_.clear();
+    }
+
+    return expired;
+}
+
+size_t RequestTable::size() const {
+    size_t total = 0;
+    for (const auto &stripe : stripes_) {
+        std::lock_guard<std::mutex> lock(stripe->mutex);
+        total += stripe->size;
+    }
+    return total;
+}
+
+uint64_t RequestTable::hash(uint64_t msb, uint64_t lsb) {
+    uint64_t h = msb ^ (lsb * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 29;
+    return h;
+}
+
+uint64_t RequestTable::ticks(std::chrono::steady_clock::time_point time) const {
+    if (time <= epoch_) {
+        return 0;
+    }
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(time - epoch_).count() / tick_.count());
+}
+
+size_t RequestTable::find(const Stripe &stripe, uint64_t hash, uint64_t msb, uint64_t lsb) {
+    auto slot = static_cast<size_t>(hash) & stripe.mask;
+    while (None != stripe.index[slot]) {
+        const auto &node = stripe.nodes[stripe.index[slot]];
+        if ((node.msb == msb) && (node.lsb == lsb)) {
+            break;
+        }
+        slot = (slot + 1) & stripe.mask;
+    }
+    return slot;
+}
+
+void RequestTable::grow(Stripe &stripe) {
+    const auto used = stripe.nodes.size();
+    const auto nodes = 2 * used;
+    stripe.nodes.resize(nodes);
+    for (size_t i = used; i < nodes; ++i) {
+        stripe.nodes[i].next = (i + 1 < nodes) ? static_cast<uint32_t>(i + 1) : None;
+    }
+    stripe.freeList = static_cast<uint32_t>(used);
+
+    /* keep the index at most half full, the node indices (and so the wheel lists) stay valid */
+    if (stripe.index.size() < 2 * nodes) {
+        std::vector<uint32_t> index(roundUpPow2(2 * nodes), None);
+        stripe.index.swap(index);
+        stripe.mask = stripe.index.size() - 1;
+        for (const auto n : index) {
+            if (None != n) {
+                const auto &node = stripe.nodes[n];
+                stripe.index[find(stripe, hash(node.msb, node.lsb), node.msb, node.lsb)] = n;
+            }
+        }
+    }
+}
+
+void RequestTable::release(Stripe &stripe, size_t slot, RpcContinuation &out) {
+    const auto n = stripe.index[slot];
+    auto &node = stripe.nodes[n];
+
+    if (None != node.list) {
+        unlink(stripe, n);
+    }
+    out = std::move(node.continuation);
+    node.next = stripe.freeList;
+    stripe.freeList = n;
+    --stripe.size;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+
+    /* backward shift deletion keeps the probe sequences intact without tombstones */
+    auto hole = slot;
+    auto next = slot;
+    while (true) {
+        next = (next + 1) & stripe.mask;
+        if (None == stripe.index[next]) {
+            break;
+        }
+        const auto &moved = stripe.nodes[stripe.index[next]];
+        const auto home = static_cast<size_t>(hash(moved.msb, moved.lsb)) & stripe.mask;
+        /* the entry may fill the hole if its home is not in (hole, next] (cyclically) */
+        const bool between = (hole <= next) ? ((home > hole) && (home <= next))
+                                            : ((home > hole) || (home <= next));
+        if (false == between) {
+            stripe.index[hole] = stripe.index[next];
+            hole = next;
+        }
+    }
+    stripe.index[hole] = None;
+}
+
+void RequestTable::link(Stripe &stripe, uint32_t n) {
+    auto &node = stripe.nodes[n];
+
+    uint32_t list;
+    if (node.expires < stripe.base) {
+        list = static_cast<uint32_t>(stripe.base & (RootSlots - 1));
+    } else if (node.expires - stripe.base < RootSlots) {
+        list = static_cast<uint32_t>(node.expires & (RootSlots - 1));
+    } else {
+        if (node.expires - stripe.base > MaxDelta) {
+            node.expires = stripe.base + MaxDelta;
+        }
+        const auto delta = node.expires - stripe.base;
+        unsigned level = 1;
+        while ((level < Levels - 1) && (delta >= (1ULL << (RootBits + level * LevelBits)))) {
+            ++level;
+        }
+        const auto shift = RootBits + (level - 1) * LevelBits;
+        list = static_cast<uint32_t>(RootSlots + (level - 1) * LevelSlots +
+                                     ((node.expires >> shift) & (LevelSlots - 1)));
+    }
+
+    node.list = list;
+    stripe.rooted += (list < RootSlots) ? 1 : 0;
+    ++stripe.timed;
+    node.prev = None;
+    node.next = stripe.lists[list];
+    if (None != node.next) {
+        stripe.nodes[node.next].prev = n;
+    }
+    stripe.lists[list] = n;
+}
+
+void RequestTable::unlink(Stripe &stripe, uint32_t n) {
+    auto &node = stripe.nodes[n];
+
+    if (None != node.prev) {
+        stripe.nodes[node.prev].next = node.next;
+    } else {
+        stripe.lists[node.list] = node.next;
+    }
+    if (None != node.next) {
+        stripe.nodes[node.next].prev = node.prev;
+    }
+    stripe.rooted -= (node.list < RootSlots) ? 1 : 0;
+    --stripe.timed;
+    node.prev = None;
+    node.next = None;
+    node.list = None;
+}
+
+uint32_t RequestTable::cascade(Stripe &stripe, unsigned level, uint32_t slot) {
+    const auto list = RootSlots + (level - 1) * LevelSlots + slot;
+
+    auto n = stripe.lists[list];
+    stripe.lists[list] = None;
+    while (None != n) {
+        const auto next = stripe.nodes[n].next;
+        /* link() counts the node again */
+        --stripe.timed;
+        link(stripe, n);
+        n = next;
+    }
+
+    return slot;
+}
+
+bool RequestTable::take(const UUID &reqid, RpcContinuation &out) {
+    const auto h = hash(reqid.msb(), reqid.lsb());
+    auto &stripe = stripeOf(h);
+
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    const auto slot = find(stripe, h, reqid.msb(), reqid.lsb());
+    if (None == stripe.index[slot]) {
+        return false;
+    }
+    release(stripe, slot, out);
+
+    return true;
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/transport/CoalescingTransport.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+namespace {
+
+/* adaptor whose batch completions run on this thread */
+thread_local const CoalescingTransport *completing = nullptr;
+
+/* a status the wrapped transport does not fill in must not read as success */
+void presetStatuses(UStatus *statuses, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        statuses[i].Clear();
+        statuses[i].set_code(UCode::INTERNAL);
+    }
+}
+
+UStatus status(UCode code) {
+    UStatus result;
+    result.set_code(code);
+    return result;
+}
+
+}
+
+CoalescingTransport::CoalescingTransport(UTransport &transport,
+                                         size_t maxBatchSize,
+                                         std::chrono::microseconds window,
+                                         size_t maxQueued)
+    : transport_(transport),
+      maxBatchSize_((0 == maxBatchSize) ? 1 : maxBatchSize),
+      window_(window),
+      maxQueued_((maxQueued < maxBatchSize_) ? maxBatchSize_ : maxQueued) {
+
+    queue_.reserve(maxBatchSize_);
+    completions_.reserve(maxBatchSize_);
+    batch_.reserve(maxBatchSize_);
+    batchCompletions_.reserve(maxBatchSize_);
+    statuses_.resize(maxBatchSize_);
+    flushThread_ = std::thread(&CoalescingTransport::flushLoop, this);
+}
+
+CoalescingTransport::~CoalescingTransport() {
+    terminate_.store(true);
+    wakeup_.postAll();
+    flushThread_.join();
+
+    flush();
+}
+
+UStatus CoalescingTransport::send(const UMessage &message) {
+    if (this == completing) {
+        UP_LOG_ERROR("a send completion must not send through the adaptor it completes");
+        return status(UCode::FAILED_PRECONDITION);
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    /* the messages queued before go first */
+    takeQueued();
+    sendQueued();
+
+    return transport_.send(message);
+}
+
+UStatus CoalescingTransport::sendBatch(const UMessage *messages,
+                                       size_t count,
+                                       UStatus *statuses) {
+    if (this == completing) {
+        UP_LOG_ERROR("a send completion must not send through the adaptor it completes");
+        return status(UCode::FAILED_PRECONDITION);
+    }
+    if (nullptr != statuses) {
+        presetStatuses(statuses, count);
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    takeQueued();
+    sendQueued();
+
+    auto result = status(UCode::OK);
+    for (size_t sent = 0; sent < count; sent += maxBatchSize_) {
+        const auto size = std::min(maxBatchSize_, count - sent);
+        auto batch = transport_.sendBatch(messages + sent, size,
+                                          (nullptr == statuses) ? nullptr : (statuses + sent));
+        if ((UCode::OK != batch.code()) && (UCode::OK == result.code())) {
+            result = std::move(batch);
+        }
+    }
+
+    return result;
+}
+
+UStatus CoalescingTransport::sendAsync(const UMessage &message,
+                                       SendCompletion &&onComplete) {
+    if (false == enqueue(message, std::move(onComplete))) {
+        return status(UCode::RESOURCE_EXHAUSTED);
+    }
+
+    return status(UCode::OK);
+}
+
+UStatus CoalescingTransport::registerListener(const UUri &uri,
+                                              const UListener &listener) {
+    return transport_.registerListener(uri, listener);
+}
+
+UStatus CoalescingTransport::unregisterListener(const UUri &uri,
+                                                const UListener &listener) {
+    return transport_.unregisterListener(uri, listener);
+}
+
+UStatus CoalescingTransport::flush() {
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    takeQueued();
+
+    return sendQueued();
+}
+
+bool CoalescingTransport::enqueue(const UMessage &message, SendCompletion &&onComplete) {
+    bool first;
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        /* a full batch is flushed by its caller, the queue only grows past it
+           while a batch is sent, e.g. from completions that queue more messages */
+        if (queue_.size() >= maxQueued_) {
+            return false;
+        }
+        first = queue_.empty();
+        if (true == first) {
+            oldest_ = std::chrono::steady_clock::now();
+        }
+        queue_.push_back(message);
+        /* the caller's buffer may be gone before the batch is sent */
+        queue_.back().mutablePayload().retain();
+        completions_.push_back(std::move(onComplete));
+        full = (queue_.size() >= maxBatchSize_);
+    }
+
+    if ((true == full) && (this != completing)) {
+        flush();
+    } else if ((true == first) || (true == full)) {
+        /* a completion already holds sendMutex_, the flush thread sends the batch */
+        wakeup_.post();
+    }
+
+    return true;
+}
+
+void CoalescingTransport::takeQueued() {
+    batch_.clear();
+    batchCompletions_.clear();
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    /* the swaps hand the reserved storage back and forth between the vectors */
+    queue_.swap(batch_);
+    completions_.swap(batchCompletions_);
+}
+
+UStatus CoalescingTransport::sendQueued() {
+    auto result = status(UCode::OK);
+    if (batch_.empty()) {
+        return result;
+    }
+
+    if (statuses_.size() < batch_.size()) {
+        statuses_.resize(batch_.size());
+    }
+    presetStatuses(statuses_.data(), batch_.size());
+    result = transport_.sendBatch(batch_.data(), batch_.size(), statuses_.data());
+
+    size_t unreported = 0;
+    const auto *previous = completing;
+    completing = this;
+    for (size_t i = 0; i < batch_.size(); ++i) {
+        if (batchCompletions_[i]) {
+            batchCompletions_[i](statuses_[i]);
+        } else if (UCode::OK != statuses_[i].code()) {
+            ++unreported;
+        }
+    }
+    completing = previous;
+
+    if (0 != unreported) {
+        UP_LOG_ERROR("failed to send {} of {} coalesced messages without a completion, first error {}",
+                     unreported, batch_.size(), static_cast<int>(result.code()));
+    }
+    batch_.clear();
+    batchCompletions_.clear();
+
+    return result;
+}
+
+void CoalescingTransport::flushLoop() {
+    while (false == terminate_.load()) {
+        const auto ticket = wakeup_.value();
+
+        bool empty;
+        bool full;
+        std::chrono::steady_clock::time_point deadline;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            empty = queue_.empty();
+            full = (queue_.size() >= maxBatchSize_);
+            deadline = oldest_ + window_;
+        }
+
+        if (true == empty) {
+            wakeup_.wait(ticket, IdleTimeout);
+            continue;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if ((false == full) && (remaining > std::chrono::steady_clock::duration::zero())) {
+            wakeup_.wait(ticket, remaining);
+            continue;
+        }
+
+        flush();
+    }
+}
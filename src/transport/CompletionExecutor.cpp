@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <chrono>
+#include <thread>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/transport/CompletionExecutor.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+CompletionExecutor::CompletionExecutor(uprotocol::utils::ThreadPool &pool,
+                                       size_t maxPending,
+                                       bool prioritize)
+    : pool_(pool),
+      maxPending_((0 == maxPending) ? 1 : maxPending),
+      queue_(prioritize ? 1 : maxPending, std::chrono::milliseconds(0)) {
+
+    if (true == prioritize) {
+        /* pending_ never exceeds maxPending, so no class ever overflows */
+        auto options = Scheduler::defaultOptions(maxPending_);
+        for (auto &config : options.classes) {
+            config.policy = Scheduler::DropPolicy::RejectNewest;
+        }
+        scheduler_ = std::make_unique<Scheduler>(options, std::chrono::milliseconds(0));
+    }
+}
+
+CompletionExecutor::~CompletionExecutor() {
+    /* queued pool tasks still hold a pointer to this executor, wait until they ran */
+    while ((0 != tasks_.load(std::memory_order_acquire)) ||
+           (0 != pending_.load(std::memory_order_acquire))) {
+        if (false == runOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+UStatus CompletionExecutor::send(UTransport &transport,
+                                 const UMessage &message,
+                                 SendCompletion &&onComplete) {
+    UMessage copy(message);
+    return send(transport, std::move(copy), std::move(onComplete));
+}
+
+UStatus CompletionExecutor::send(UTransport &transport,
+                                 UMessage &&message,
+                                 SendCompletion &&onComplete) {
+    Work work;
+    work.transport = &transport;
+    work.message = std::move(message);
+    /* the caller's buffer may be gone by the time a worker sends the message */
+    work.message.mutablePayload().retain();
+    work.completion = std::move(onComplete);
+
+    UStatus status;
+    if (false == enqueue(work)) {
+        message = std::move(work.message);
+        onComplete = std::move(work.completion);
+        status.set_code(UCode::RESOURCE_EXHAUSTED);
+        return status;
+    }
+
+    status.set_code(UCode::OK);
+    return status;
+}
+
+void CompletionExecutor::complete(SendCompletion &&onComplete,
+                                  UStatus status) {
+    if (!onComplete) {
+        return;
+    }
+
+    Work work;
+    work.completion = std::move(onComplete);
+    work.status = std::move(status);
+
+    if (false == enqueue(work)) {
+        UP_LOG_WARN("completion executor is saturated, completing inline");
+        work.completion(work.status);
+    }
+}
+
+bool CompletionExecutor::enqueue(Work &work) {
+    const auto before = pending_.fetch_add(1, std::memory_order_relaxed);
+    bool queued;
+    if (nullptr != scheduler_) {
+        const auto level = (nullptr != work.transport) ? priorityLevel(work.message.attributes()) :
+                                                         PriorityLevels - 1;
+        queued = (before < maxPending_) && scheduler_->push(level, work);
+    } else {
+        queued = queue_.tryPush(work);
+    }
+    if (false == queued) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    tasks_.fetch_add(1, std::memory_order_relaxed);
+    auto posted = pool_.post([this]() {
+        runOne();
+        tasks_.fetch_sub(1, std::memory_order_release);
+    });
+    if (false == posted) {
+        /* the pool is full or stopping, run one item here so nothing is left behind */
+        tasks_.fetch_sub(1, std::memory_order_relaxed);
+        runOne();
+    }
+
+    return true;
+}
+
+bool CompletionExecutor::runOne() {
+    Work work;
+    const bool taken = (nullptr != scheduler_) ? scheduler_->tryPop(work) : queue_.tryPop(work);
+    if (false == taken) {
+        /* another caller of runOne() took the item this task was posted for */
+        return false;
+    }
+
+    if (nullptr != work.transport) {
+        work.status = work.transport->send(work.message);
+    }
+    if (work.completion) {
+        work.completion(work.status);
+    }
+
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+
+    return true;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <up-cpp/transport/ConflatingMailbox.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::uri;
+using namespace uprotocol::v1;
+
+UStatus ConflatingMailbox::onReceive(UMessage &message) const {
+    return push(message);
+}
+
+UStatus ConflatingMailbox::push(const UMessage &message) const {
+    return store(message);
+}
+
+UStatus ConflatingMailbox::push(UMessage &&message) const {
+    return store(std::move(message));
+}
+
+template<typename M>
+UStatus ConflatingMailbox::store(M &&message) const {
+    UStatus status;
+
+    auto *slot = slotOf(message);
+    if (nullptr == slot) {
+        status.set_code(UCode::INVALID_ARGUMENT);
+        return status;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        if (true == slot->fresh) {
+            conflated_.fetch_add(1, std::memory_order_relaxed);
+        }
+        /* assigning into the held message reuses its attribute storage */
+        slot->message = std::forward<M>(message);
+        /* the consumer takes the sample after the producer's buffer may be gone */
+        slot->message.mutablePayload().retain();
+        slot->fresh = true;
+    }
+
+    /* queued after the write, so a consumer that takes the slot sees this
+     * sample or has already taken it */
+    ready(*slot);
+
+    status.set_code(UCode::OK);
+    return status;
+}
+
+bool ConflatingMailbox::tryPop(UMessage &message) {
+    while (true) {
+        Slot *slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ready_.empty()) {
+                return false;
+            }
+            slot = ready_.front();
+            ready_.pop_front();
+            slot->queued = false;
+        }
+
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        /* a slot queued again after its sample was taken holds nothing new */
+        if (true == slot->fresh) {
+            slot->fresh = false;
+            std::swap(message, slot->message);
+            return true;
+        }
+    }
+}
+
+bool ConflatingMailbox::waitPop(UMessage &message) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout_;
+
+    while (true) {
+        auto ticket = available_.value();
+        if (true == tryPop(message)) {
+            return true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        available_.wait(ticket, deadline - now);
+    }
+}
+
+size_t ConflatingMailbox::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_.size();
+}
+
+size_t ConflatingMailbox::topics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slots_.size();
+}
+
+void ConflatingMailbox::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto *slot : ready_) {
+        std::lock_guard<std::mutex> slotLock(slot->mutex);
+        slot->fresh = false;
+        slot->queued = false;
+        slot->message = UMessage();
+    }
+    ready_.clear();
+}
+
+ConflatingMailbox::Slot *ConflatingMailbox::slotOf(const UMessage &message) const {
+    uint8_t micro[MicroUriSerializer::MaxMicroUriLength];
+    auto size = MicroUriSerializer::serialize(message.attributes().source(), micro, sizeof(micro));
+    if (0 == size) {
+        return nullptr;
+    }
+    /* a local micro URI fits the small string buffer, the key is not allocated */
+    std::string key(reinterpret_cast<const char *>(micro), size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &slot = slots_[key];
+    if (nullptr == slot) {
+        slot = std::make_unique<Slot>();
+    }
+
+    return slot.get();
+}
+
+void ConflatingMailbox::ready(Slot &slot) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (true == slot.queued) {
+            return;
+        }
+        slot.queued = true;
+        ready_.push_back(&slot);
+    }
+
+    available_.post();
+}
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <thread>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/transport/ListenerDispatcher.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+static UStatus status(UCode code) {
+    UStatus result;
+    result.set_code(code);
+    return result;
+}
+
+ListenerQueue::ListenerQueue(ListenerDispatcher &dispatcher,
+                             std::vector<const UListener *> listeners,
+                             const DispatchOptions &options)
+    : dispatcher_(dispatcher),
+      listeners_(std::move(listeners)),
+      options_(options),
+      highWatermark_((0 != options.highWatermark) ?
+                     options.highWatermark :
+                     std::max<size_t>(1, options.capacity * 3 / 4)),
+      lowWatermark_(std::min((0 != options.lowWatermark) ? options.lowWatermark : options.capacity / 4,
+                             highWatermark_ - 1)),
+      scheduler_(makeScheduler(options)) {
+}
+
+std::unique_ptr<ListenerQueue::Scheduler> ListenerQueue::makeScheduler(const DispatchOptions &options) {
+    if ((false == options.prioritize) || (OverflowPolicy::COALESCE_LATEST == options.policy)) {
+        return nullptr;
+    }
+
+    /* the queue as a whole never holds more than capacity, so no class ever overflows */
+    auto classes = Scheduler::defaultOptions(std::max<size_t>(1, options.capacity));
+    for (auto &config : classes.classes) {
+        config.policy = Scheduler::DropPolicy::RejectNewest;
+    }
+
+    return std::make_unique<Scheduler>(classes, std::chrono::milliseconds(0));
+}
+
+UStatus ListenerQueue::onReceive(UMessage &message) const {
+    const bool coalesce = (OverflowPolicy::COALESCE_LATEST == options_.policy);
+
+    std::string topic;
+    if (true == coalesce) {
+        topic = message.attributes().source().SerializeAsString();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    const auto deadline = now + options_.blockTimeout;
+
+    bool post = false;
+    bool changed;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            if (true == closed_) {
+                return status(UCode::UNAVAILABLE);
+            }
+
+            if (queued() < options_.capacity) {
+                break;
+            }
+
+            /* only a message that does not fit replaces the newest queued one of its topic */
+            if (true == coalesce) {
+                auto latest = latest_.find(topic);
+                if (latest_.end() != latest) {
+                    auto &entry = entries_[static_cast<size_t>(latest->second - head_)];
+                    entry.message = message;
+                    entry.message.mutablePayload().retain();
+                    coalesced_.fetch_add(1, std::memory_order_relaxed);
+                    return status(UCode::OK);
+                }
+            }
+
+            if (OverflowPolicy::BLOCK != options_.policy) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return status(UCode::RESOURCE_EXHAUSTED);
+            }
+
+            /* read under the lock, so a pop that happens once it is released wakes us */
+            auto ticket = space_.value();
+            now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return status(UCode::RESOURCE_EXHAUSTED);
+            }
+            lock.unlock();
+            space_.wait(ticket, deadline - now);
+            lock.lock();
+        }
+
+        if (nullptr != scheduler_) {
+            Entry entry{message, now, {}};
+            entry.message.mutablePayload().retain();
+            scheduler_->push(priorityLevel(message.attributes()), entry);
+        } else {
+            if (true == coalesce) {
+                latest_[topic] = head_ + entries_.size();
+            }
+            entries_.push_back(Entry{message, now, std::move(topic)});
+            entries_.back().message.mutablePayload().retain();
+        }
+        depth_.store(queued(), std::memory_order_relaxed);
+
+        changed = updatePressure(now);
+
+        if (false == scheduled_) {
+            scheduled_ = true;
+            post = true;
+        }
+    }
+
+    if (true == changed) {
+        signal();
+    }
+
+    if ((true == post) && (false == schedule())) {
+        UP_LOG_WARN("listener pool is saturated, delivering on the receive thread");
+        drain();
+    }
+
+    return status(UCode::OK);
+}
+
+std::chrono::nanoseconds ListenerQueue::lag() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::chrono::steady_clock::time_point since;
+    if (false == oldest(since)) {
+        return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::steady_clock::now() - since;
+}
+
+size_t ListenerQueue::queued() const {
+    return (nullptr != scheduler_) ? scheduler_->size() : entries_.size();
+}
+
+bool ListenerQueue::oldest(std::chrono::steady_clock::time_point &since) const {
+    if (nullptr == scheduler_) {
+        if (entries_.empty()) {
+            return false;
+        }
+        since = entries_.front().queued;
+        return true;
+    }
+
+    /* every class is in arrival order, the oldest entry is at the front of one of them */
+    bool found = false;
+    for (size_t level = 0; level < PriorityLevels; ++level) {
+        const auto *entry = scheduler_->front(level);
+        if ((nullptr != entry) && ((false == found) || (entry->queued < since))) {
+            since = entry->queued;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void ListenerQueue::drain() const {
+    while (true) {
+        for (size_t n = 0; n < BatchSize; ++n) {
+            Entry entry;
+            bool changed;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (nullptr != scheduler_) {
+                    if (false == scheduler_->tryPop(entry)) {
+                        /* the next onReceive() schedules the queue again */
+                        scheduled_ = false;
+                        return;
+                    }
+                } else {
+                    if (entries_.empty()) {
+                        scheduled_ = false;
+                        return;
+                    }
+                    entry = std::move(entries_.front());
+                    entries_.pop_front();
+                    if (OverflowPolicy::COALESCE_LATEST == options_.policy) {
+                        auto latest = latest_.find(entry.topic);
+                        if ((latest_.end() != latest) && (head_ == latest->second)) {
+                            latest_.erase(latest);
+                        }
+                    }
+                    ++head_;
+                }
+                depth_.store(queued(), std::memory_order_relaxed);
+
+                changed = updatePressure(std::chrono::steady_clock::now());
+            }
+
+            space_.post();
+            if (true == changed) {
+                signal();
+            }
+
+            for (const auto *listener : listeners_) {
+                listener->onReceive(entry.message);
+            }
+        }
+
+        /* give the other queues a turn, keep going here if the pool is full */
+        if (true == schedule()) {
+            return;
+        }
+    }
+}
+
+bool ListenerQueue::schedule() const {
+    auto *dispatcher = &dispatcher_;
+
+    dispatcher->tasks_.fetch_add(1, std::memory_order_relaxed);
+    /* the queue may be destroyed once drain() returns, only the dispatcher is touched after it */
+    auto posted = dispatcher->pool_.post([this, dispatcher]() {
+        drain();
+        dispatcher->tasks_.fetch_sub(1, std::memory_order_release);
+    });
+    if (false == posted) {
+        dispatcher->tasks_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    return posted;
+}
+
+bool ListenerQueue::updatePressure(std::chrono::steady_clock::time_point now) const {
+    const auto depth = queued();
+    std::chrono::steady_clock::time_point since;
+    const bool lagging = (0 != options_.maxLag.count()) &&
+                         (true == oldest(since)) &&
+                         ((now - since) > options_.maxLag);
+
+    const bool throttled = throttled_.load(std::memory_order_relaxed);
+    bool throttle = throttled;
+    if ((false == throttled) && ((depth >= highWatermark_) || (true == lagging))) {
+        throttle = true;
+    } else if ((true == throttled) && (depth <= lowWatermark_) && (false == lagging)) {
+        throttle = false;
+    }
+
+    if (throttle == throttled) {
+        return false;
+    }
+
+    throttled_.store(throttle, std::memory_order_release);
+    if (true == throttle) {
+        dispatcher_.throttled_.fetch_add(1, std::memory_order_acq_rel);
+    } else {
+        dispatcher_.throttled_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    return true;
+}
+
+void ListenerQueue::signal() const {
+    if (!options_.onPressure) {
+        return;
+    }
+
+    /* signals raised concurrently are handed over one at a time and always end
+     * on the current state, so the handler never sees a stale one last */
+    std::lock_guard<std::mutex> lock(signalMutex_);
+    const bool throttle = throttled_.load(std::memory_order_acquire);
+    if (throttle != signalled_) {
+        signalled_ = throttle;
+        options_.onPressure(throttle);
+    }
+}
+
+void ListenerQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    /* release the producers blocked on a full queue */
+    space_.postAll();
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if ((false == scheduled_) && (0 == queued())) {
+                break;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+ListenerDispatcher::ListenerDispatcher(uprotocol::utils::ThreadPool &pool)
+    : pool_(pool) {
+}
+
+ListenerDispatcher::~ListenerDispatcher() {
+    for (auto &queue : queues_) {
+        queue->close();
+    }
+
+    /* drain tasks that returned still hold a pointer to the dispatcher */
+    while (0 != tasks_.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+ListenerQueue & ListenerDispatcher::attach(const UListener &listener,
+                                           const DispatchOptions &options) {
+    return attach(std::vector<const UListener *>{&listener}, options);
+}
+
+ListenerQueue & ListenerDispatcher::attach(std::vector<const UListener *> listeners,
+                                           const DispatchOptions &options) {
+    std::unique_ptr<ListenerQueue> queue(new ListenerQueue(*this, std::move(listeners), options));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_.push_back(std::move(queue));
+
+    return *queues_.back();
+}
+
+UStatus ListenerDispatcher::detach(const ListenerQueue &queue) {
+    std::unique_ptr<ListenerQueue> detached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = std::find_if(queues_.begin(), queues_.end(),
+                                  [&queue](const auto &q) { return q.get() == &queue; });
+        if (queues_.end() == found) {
+            return status(UCode::NOT_FOUND);
+        }
+        detached = std::move(*found);
+        queues_.erase(found);
+    }
+
+    detached->close();
+
+    return status(UCode::OK);
+}
+
+size_t ListenerDispatcher::depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t total = 0;
+    for (const auto &queue : queues_) {
+        total += queue->depth();
+    }
+
+    return total;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <optional>
+#include <up-cpp/transport/LoopbackTransport.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+static UStatus status(UCode code) {
+    UStatus result;
+    result.set_code(code);
+    return result;
+}
+
+LoopbackTransport::LoopbackTransport(uprotocol::utils::ThreadPool &pool, const DispatchOptions &options)
+    : options_(options), dispatcher_(std::make_unique<ListenerDispatcher>(pool)) {
+}
+
+LoopbackTransport::~LoopbackTransport() {
+    /* the dispatcher delivers and destroys the queues, nothing can reach them anymore */
+    dispatcher_.reset();
+}
+
+UStatus LoopbackTransport::send(const UMessage &message) {
+    std::optional<UMessage> copy;
+    std::optional<UStatus> failure;
+    registry_.forEachListener(message.attributes().source(), [&](const UListener &listener) {
+        if (!copy) {
+            copy.emplace(message);
+        }
+        auto result = listener.onReceive(*copy);
+        if ((UCode::OK != result.code()) && !failure) {
+            failure = std::move(result);
+        }
+    });
+
+    return failure ? *failure : status(UCode::OK);
+}
+
+UStatus LoopbackTransport::registerListener(const UUri &uri, const UListener &listener) {
+    if (nullptr == dispatcher_) {
+        return registry_.registerListener(uri, listener);
+    }
+
+    std::lock_guard<std::mutex> lock(queuesMutex_);
+
+    auto found = queues_.find(&listener);
+    auto *queue = (queues_.end() == found) ? &dispatcher_->attach(listener, options_) : found->second.queue;
+    auto result = registry_.registerListener(uri, *queue);
+    if (UCode::OK == result.code()) {
+        if (queues_.end() == found) {
+            queues_.emplace(&listener, Queued{queue, 1});
+        } else {
+            ++found->second.registrations;
+        }
+    } else if (queues_.end() == found) {
+        dispatcher_->detach(*queue);
+    }
+
+    return result;
+}
+
+UStatus LoopbackTransport::unregisterListener(const UUri &uri, const UListener &listener) {
+    if (nullptr == dispatcher_) {
+        return registry_.unregisterListener(uri, listener);
+    }
+
+    std::lock_guard<std::mutex> lock(queuesMutex_);
+
+    auto found = queues_.find(&listener);
+    if (queues_.end() == found) {
+        return status(UCode::NOT_FOUND);
+    }
+    auto result = registry_.unregisterListener(uri, *found->second.queue);
+    if ((UCode::OK == result.code()) && (0 == --found->second.registrations)) {
+        auto *queue = found->second.queue;
+        queues_.erase(found);
+        /* the registry waited for the send() calls that could still reach the queue */
+        dispatcher_->detach(*queue);
+    }
+
+    return result;
+}
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <up-cpp/transport/datamodel/PayloadBufferPool.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <up-cpp/utils/Metrics.h>
+
+namespace uprotocol::utransport {
+
+namespace {
+
+/* the control block of a pooled shared_ptr fits into a recycled block of this size */
+constexpr size_t BlockSize = 64U;
+
+/* free control blocks a thread keeps */
+constexpr size_t CachedBlocks = 256U;
+
+constexpr size_t threadLimit(size_t index) {
+    return std::max<size_t>(2U, PayloadBufferPool::ThreadCacheBytes / PayloadBufferPool::classSize(index));
+}
+
+constexpr size_t sharedLimit(size_t index) {
+    return std::max<size_t>(4U, PayloadBufferPool::SharedBytes / PayloadBufferPool::classSize(index));
+}
+
+uint8_t *allocateBuffer(size_t index) {
+    return static_cast<uint8_t *>(::operator new(PayloadBufferPool::classSize(index)));
+}
+
+void freeBuffer(uint8_t *buffer) {
+    ::operator delete(buffer);
+}
+
+struct PoolMetrics {
+    utils::metrics::Counter &allocated;
+    utils::metrics::Counter &reused;
+};
+
+const PoolMetrics &poolMetrics() {
+    auto &registry = utils::metrics::Registry::instance();
+    static const PoolMetrics metrics {
+        registry.counter("up_payload_buffers_allocated_total", "Payload buffers allocated from the heap"),
+        registry.counter("up_payload_buffers_reused_total", "Payload buffers taken from the pool") };
+    return metrics;
+}
+
+} // namespace
+
+/* free buffers and control blocks of one thread */
+struct PayloadBufferCache {
+    std::array<std::vector<uint8_t *>, PayloadBufferPool::NumOfClasses> buffers;
+    std::vector<void *> blocks;
+
+    PayloadBufferCache() {
+        for (size_t index = 0; index < buffers.size(); ++index) {
+            buffers[index].reserve(threadLimit(index));
+        }
+        blocks.reserve(CachedBlocks);
+    }
+
+    ~PayloadBufferCache() {
+        // hand the buffers over to the threads still running
+        auto &pool = PayloadBufferPool::instance();
+        for (size_t index = 0; index < buffers.size(); ++index) {
+            for (auto *buffer : buffers[index]) {
+                if (false == pool.give(index, buffer)) {
+                    freeBuffer(buffer);
+                }
+            }
+        }
+        for (auto *block : blocks) {
+            ::operator delete(block);
+        }
+    }
+
+    /* keep a buffer whose last reference dropped on this thread */
+    static void release(size_t index, uint8_t *buffer) noexcept;
+
+    void clear() {
+        for (auto &list : buffers) {
+            for (auto *buffer : list) {
+                freeBuffer(buffer);
+            }
+            list.clear();
+        }
+    }
+};
+
+namespace {
+
+/* trivially destructible, so still readable while the thread's destructors run */
+thread_local PayloadBufferCache *cache_ = nullptr;
+thread_local bool cacheGone_ = false;
+
+struct CacheGuard {
+    ~CacheGuard() {
+        delete cache_;
+        cache_ = nullptr;
+        cacheGone_ = true;
+    }
+};
+
+thread_local CacheGuard guard_;
+
+/* nullptr once the calling thread is exiting */
+PayloadBufferCache *threadCache() {
+    if ((nullptr == cache_) && (false == cacheGone_)) {
+        // odr-use the guard so its destructor runs at thread exit
+        static_cast<void>(&guard_);
+        cache_ = new PayloadBufferCache();
+    }
+    return cache_;
+}
+
+/* recycles the control blocks of the shared_ptrs handed out by the pool */
+template<typename T>
+struct BlockAllocator {
+    using value_type = T;
+
+    BlockAllocator() = default;
+
+    template<typename U>
+    BlockAllocator(const BlockAllocator<U> &) noexcept {}
+
+    static constexpr bool fits(size_t n) {
+        return (n * sizeof(T) <= BlockSize) && (alignof(T) <= alignof(std::max_align_t));
+    }
+
+    T *allocate(size_t n) {
+        if (false == fits(n)) {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        auto *cache = threadCache();
+        if ((nullptr != cache) && (false == cache->blocks.empty())) {
+            auto *block = cache->blocks.back();
+            cache->blocks.pop_back();
+            return static_cast<T *>(block);
+        }
+        return static_cast<T *>(::operator new(BlockSize));
+    }
+
+    void deallocate(T *block, size_t n) noexcept {
+        if (fits(n)) {
+            auto *cache = threadCache();
+            if ((nullptr != cache) && (cache->blocks.size() < CachedBlocks)) {
+                cache->blocks.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+
+    template<typename U>
+    bool operator==(const BlockAllocator<U> &) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const BlockAllocator<U> &) const noexcept {
+        return false;
+    }
+};
+
+struct Recycle {
+    size_t index;
+
+    void operator()(uint8_t *buffer) const noexcept {
+        PayloadBufferCache::release(index, buffer);
+    }
+};
+
+} // namespace
+
+void PayloadBufferCache::release(size_t index, uint8_t *buffer) noexcept {
+    auto *cache = threadCache();
+    if ((nullptr != cache) && (cache->buffers[index].size() < threadLimit(index))) {
+        cache->buffers[index].push_back(buffer);
+        return;
+    }
+    if (false == PayloadBufferPool::instance().give(index, buffer)) {
+        freeBuffer(buffer);
+    }
+}
+
+PayloadBufferPool &PayloadBufferPool::instance() {
+    // never destroyed, buffers may be released by static destructors
+    static auto *pool = new PayloadBufferPool();
+    return *pool;
+}
+
+std::shared_ptr<uint8_t[]> PayloadBufferPool::acquire(size_t size) {
+    const auto index = classOf(size);
+    if (index >= NumOfClasses) {
+        return std::shared_ptr<uint8_t[]>(new uint8_t[size]);
+    }
+
+    uint8_t *buffer = nullptr;
+    auto *cache = threadCache();
+    if ((nullptr != cache) && (false == cache->buffers[index].empty())) {
+        buffer = cache->buffers[index].back();
+        cache->buffers[index].pop_back();
+    } else {
+        buffer = take(index);
+    }
+
+    if (nullptr == buffer) {
+        buffer = allocateBuffer(index);
+        if constexpr (utils::metrics::Enabled) {
+            poolMetrics().allocated.add();
+        }
+    } else if constexpr (utils::metrics::Enabled) {
+        poolMetrics().reused.add();
+    }
+
+    return std::shared_ptr<uint8_t[]>(buffer, Recycle{index}, BlockAllocator<uint8_t>());
+}
+
+uint8_t *PayloadBufferPool::take(size_t index) {
+    auto &shared = shared_[index];
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (shared.buffers.empty()) {
+        return nullptr;
+    }
+
+    auto *buffer = shared.buffers.back();
+    shared.buffers.pop_back();
+
+    // refill the thread cache with half of its capacity while we hold the lock
+    auto *cache = threadCache();
+    if (nullptr != cache) {
+        auto &local = cache->buffers[index];
+        while ((false == shared.buffers.empty()) && (local.size() < threadLimit(index) / 2)) {
+            local.push_back(shared.buffers.back());
+            shared.buffers.pop_back();
+        }
+    }
+
+    return buffer;
+}
+
+bool PayloadBufferPool::give(size_t index, uint8_t *buffer) {
+    auto &shared = shared_[index];
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (shared.buffers.size() >= sharedLimit(index)) {
+        return false;
+    }
+
+    shared.buffers.push_back(buffer);
+    return true;
+}
+
+void PayloadBufferPool::trim() {
+    if (auto *cache = threadCache()) {
+        cache->clear();
+    }
+
+    for (auto &shared : shared_) {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (auto *buffer : shared.buffers) {
+            freeBuffer(buffer);
+        }
+        shared.buffers.clear();
+    }
+}
+
+size_t PayloadBufferPool::sharedBytes() const {
+    size_t bytes = 0;
+    for (size_t index = 0; index < NumOfClasses; ++index) {
+        std::lock_guard<std::mutex> lock(shared_[index].mutex);
+        bytes += shared_[index].buffers.size() * classSize(index);
+    }
+    return bytes;
+}
+
+} // namespace uprotocol::utransport
@@ -0,0 +1,537 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <up-cpp/transport/SharedMemoryTransport.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include <up-cpp/utils/Log.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory atomics must not rely on a process local lock");
+
+namespace {
+
+constexpr uint64_t SegmentMagic = 0x75502d73686d3031ULL; /* "uP-shm01" */
+constexpr size_t Alignment = 64U;
+constexpr size_t NoRing = SIZE_MAX;
+
+constexpr uint32_t RingFree = 0U;
+constexpr uint32_t RingAttached = 1U;
+constexpr uint32_t RingDetaching = 2U;
+
+/* spin on an empty ring this often before sleeping on its futex */
+constexpr int SpinsBeforeSleep = 64;
+/* longest sleep of the receive thread, bounds how late it notices termination */
+constexpr std::chrono::milliseconds ReceiveTimeout { 100 };
+
+constexpr size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+constexpr size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1U;
+    while (result < value) {
+        result <<= 1U;
+    }
+    return result;
+}
+
+UStatus status(UCode code) {
+    UStatus result;
+    result.set_code(code);
+    return result;
+}
+
+/* the futex word lives in a mapping shared between processes, so no _PRIVATE operations */
+void futexWait(std::atomic<uint32_t> &word, uint32_t expected, std::chrono::nanoseconds timeout) {
+#if defined(__linux__)
+    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(secs.count());
+    ts.tv_nsec = static_cast<long>((timeout - secs).count());
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::milliseconds(1)));
+#endif
+}
+
+void futexWake(std::atomic<uint32_t> &word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+}  // namespace
+
+/**
+ * Start of the segment, written once by the creator before the magic is published.
+ */
+struct SegmentHeader {
+    std::atomic<uint64_t> magic;
+    uint64_t size;
+    uint64_t ringsOffset;
+    uint64_t slotsOffset;
+    uint64_t ringStride;
+    uint64_t slotStride;
+    uint32_t rings;
+    uint32_t ringCapacity;
+    uint32_t slots;
+    uint32_t attributesCapacity;
+    uint32_t payloadCapacity;
+};
+
+/**
+ * Single producer / single consumer ring of slot indices, followed in the
+ * segment by ringCapacity entries.
+ */
+struct SharedMemoryTransport::Ring {
+    alignas(Alignment) std::atomic<uint32_t> state;
+    /* set by the publisher while it pushes, so a detaching subscriber can wait it out */
+    alignas(Alignment) std::atomic<uint32_t> producerBusy;
+    alignas(Alignment) std::atomic<uint64_t> head;
+    alignas(Alignment) std::atomic<uint64_t> tail;
+    alignas(Alignment) std::atomic<uint32_t> word;
+    std::atomic<uint32_t> waiters;
+
+    uint32_t *entries() {
+        return reinterpret_cast<uint32_t *>(this + 1);
+    }
+
+    /* bump the event counter, the syscall is skipped when the subscriber is busy */
+    void post() {
+        word.fetch_add(1, std::memory_order_seq_cst);
+        if (0U != waiters.load(std::memory_order_seq_cst)) {
+            futexWake(word);
+        }
+    }
+};
+
+/**
+ * Message slot, followed in the segment by the attributes and the payload areas.
+ */
+struct SharedMemoryTransport::Slot {
+    /* payload copies, queued ring entries and the publisher while it sends */
+    alignas(Alignment) std::atomic<uint32_t> refs;
+    /* 0 while loaned and not sent yet, only changed by the publisher */
+    std::atomic<uint32_t> published;
+    uint32_t attributesSize;
+    uint32_t payloadSize;
+    uint32_t format;
+
+    uint8_t *attributes() {
+        return reinterpret_cast<uint8_t *>(this + 1);
+    }
+
+    void release() {
+        refs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+};
+
+/**
+ * Process local mapping of a segment, kept alive by every payload into it.
+ */
+struct SharedMemoryTransport::Segment {
+    std::string name;
+    uint8_t *base = nullptr;
+    size_t size = 0;
+
+    ~Segment() {
+        if (nullptr != base) {
+            munmap(base, size);
+        }
+    }
+
+    SegmentHeader &header() const {
+        return *reinterpret_cast<SegmentHeader *>(base);
+    }
+
+    Ring &ring(size_t index) const {
+        return *reinterpret_cast<Ring *>(base + header().ringsOffset + index * header().ringStride);
+    }
+
+    Slot &slot(size_t index) const {
+        return *reinterpret_cast<Slot *>(base + header().slotsOffset + index * header().slotStride);
+    }
+
+    uint8_t *payload(Slot &slot) const {
+        return slot.attributes() + header().attributesCapacity;
+    }
+};
+
+std::unique_ptr<SharedMemoryTransport> SharedMemoryTransport::create(const std::string &name,
+                                                                     const SharedMemoryOptions &options) {
+    const auto rings = (0U == options.subscribers) ? 1U : options.subscribers;
+    const auto slots = (0U == options.slots) ? 1U : options.slots;
+    const auto ringCapacity = roundUpToPowerOfTwo((0U == options.ringCapacity) ? 1U : options.ringCapacity);
+    const auto attributesCapacity = alignUp(options.attributesCapacity, Alignment);
+    if ((slots > UINT32_MAX) || (ringCapacity > UINT32_MAX) || (attributesCapacity > UINT32_MAX) ||
+        (options.payloadCapacity > UINT32_MAX)) {
+        UP_LOG_ERROR("shared memory segment {} is too large", name);
+        return nullptr;
+    }
+
+    const auto ringStride = alignUp(sizeof(Ring) + ringCapacity * sizeof(uint32_t), Alignment);
+    const auto slotStride = alignUp(sizeof(Slot) + attributesCapacity + options.payloadCapacity, Alignment);
+    const auto ringsOffset = alignUp(sizeof(SegmentHeader), Alignment);
+    const auto slotsOffset = ringsOffset + rings * ringStride;
+    const auto size = slotsOffset + slots * slotStride;
+
+    /* replace a segment left behind by a previous publisher */
+    shm_unlink(name.c_str());
+    auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (-1 == fd) {
+        UP_LOG_ERROR("shm_open of {} failed: {}", name, std::strerror(errno));
+        return nullptr;
+    }
+    if (0 != ftruncate(fd, static_cast<off_t>(size))) {
+        UP_LOG_ERROR("ftruncate of {} to {} bytes failed: {}", name, size, std::strerror(errno));
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    auto *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == base) {
+        UP_LOG_ERROR("mmap of {} failed: {}", name, std::strerror(errno));
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    auto segment = std::make_shared<Segment>();
+    segment->name = name;
+    segment->base = static_cast<uint8_t *>(base);
+    segment->size = size;
+
+    auto *header = new (base) SegmentHeader();
+    header->size = size;
+    header->ringsOffset = ringsOffset;
+    header->slotsOffset = slotsOffset;
+    header->ringStride = ringStride;
+    header->slotStride = slotStride;
+    header->rings = static_cast<uint32_t>(rings);
+    header->ringCapacity = static_cast<uint32_t>(ringCapacity);
+    header->slots = static_cast<uint32_t>(slots);
+    header->attributesCapacity = static_cast<uint32_t>(attributesCapacity);
+    header->payloadCapacity = static_cast<uint32_t>(options.payloadCapacity);
+    for (size_t i = 0; i < rings; ++i) {
+        new (&segment->ring(i)) Ring();
+    }
+    for (size_t i = 0; i < slots; ++i) {
+        new (&segment->slot(i)) Slot();
+    }
+    header->magic.store(SegmentMagic, std::memory_order_release);
+
+    return std::unique_ptr<SharedMemoryTransport>(new SharedMemoryTransport(std::move(segment), true, NoRing));
+}
+
+std::unique_ptr<SharedMemoryTransport> SharedMemoryTransport::open(const std::string &name) {
+    auto fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (-1 == fd) {
+        UP_LOG_ERROR("shm_open of {} failed: {}", name, std::strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    if ((0 != fstat(fd, &st)) || (static_cast<size_t>(st.st_size) < sizeof(SegmentHeader))) {
+        UP_LOG_ERROR("{} is not a shared memory transport segment", name);
+        close(fd);
+        return nullptr;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    auto *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == base) {
+        UP_LOG_ERROR("mmap of {} failed: {}", name, std::strerror(errno));
+        return nullptr;
+    }
+
+    auto segment = std::make_shared<Segment>();
+    segment->name = name;
+    segment->base = static_cast<uint8_t *>(base);
+    segment->size = size;
+
+    const auto &header = segment->header();
+    if ((SegmentMagic != header.magic.load(std::memory_order_acquire)) || (size != header.size)) {
+        UP_LOG_ERROR("{} is not a shared memory transport segment", name);
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < header.rings; ++i) {
+        auto expected = RingFree;
+        if (segment->ring(i).state.compare_exchange_strong(expected, RingAttached, std::memory_order_acq_rel)) {
+            return std::unique_ptr<SharedMemoryTransport>(new SharedMemoryTransport(std::move(segment), false, i));
+        }
+    }
+    UP_LOG_ERROR("no free subscriber ring in {}", name);
+    return nullptr;
+}
+
+SharedMemoryTransport::SharedMemoryTransport(std::shared_ptr<Segment> segment, bool publisher, size_t ring)
+    : segment_(std::move(segment)), publisher_(publisher), ring_(ring) {
+    if (false == publisher_) {
+        receiveThread_ = std::thread(&SharedMemoryTransport::receiveLoop, this);
+    }
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    if (true == publisher_) {
+        shm_unlink(segment_->name.c_str());
+        return;
+    }
+
+    auto &ring = segment_->ring(ring_);
+    terminate_.store(true, std::memory_order_release);
+    ring.post();
+    if (receiveThread_.joinable()) {
+        receiveThread_.join();
+    }
+
+    /* once the publisher is out of the ring nothing is pushed to it anymore */
+    ring.state.store(RingDetaching, std::memory_order_seq_cst);
+    while (0U != ring.producerBusy.load(std::memory_order_seq_cst)) {
+        std::this_thread::yield();
+    }
+    const auto mask = segment_->header().ringCapacity - 1U;
+    const auto tail = ring.tail.load(std::memory_order_acquire);
+    for (auto pos = ring.head.load(std::memory_order_relaxed); pos != tail; ++pos) {
+        segment_->slot(ring.entries()[pos & mask]).release();
+    }
+    ring.head.store(tail, std::memory_order_release);
+    ring.state.store(RingFree, std::memory_order_release);
+}
+
+UStatus SharedMemoryTransport::send(const UMessage &message) {
+    if (false == publisher_) {
+        UP_LOG_ERROR("only the creator of {} can send", segment_->name);
+        return status(UCode::FAILED_PRECONDITION);
+    }
+
+    const auto &header = segment_->header();
+    const auto &payload = message.payload();
+    const auto attributesSize = message.attributes().ByteSizeLong();
+    if ((attributesSize > header.attributesCapacity) || (payload.size() > header.payloadCapacity)) {
+        UP_LOG_ERROR("message of {} attribute and {} payload bytes does not fit a slot of {}",
+                     attributesSize, payload.size(), segment_->name);
+        return status(UCode::INVALID_ARGUMENT);
+    }
+
+    bool full = false;
+    Slot *slot = nullptr;
+    {
+        /* the lock only covers publishing the slot, a local listener may send again */
+        std::lock_guard<std::mutex> lock(sendMutex_);
+
+        slot = loanedSlot(payload);
+        if ((nullptr != slot) && (0U == slot->published.exchange(1U, std::memory_order_relaxed))) {
+            /* the payload was written in place, only hold the slot while sending */
+            slot->refs.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            slot = allocate();
+            if (nullptr == slot) {
+                UP_LOG_ERROR("no free slot in {}", segment_->name);
+                return status(UCode::RESOURCE_EXHAUSTED);
+            }
+            slot->published.store(1U, std::memory_order_relaxed);
+            /* gathered segments are copied one by one, without flattening them first */
+            payload.copyTo(segment_->payload(*slot));
+        }
+        message.attributes().SerializeWithCachedSizesToArray(slot->attributes());
+        slot->attributesSize = static_cast<uint32_t>(attributesSize);
+        slot->payloadSize = static_cast<uint32_t>(payload.size());
+        slot->format = static_cast<uint32_t>(payload.format());
+
+        const auto index = static_cast<uint32_t>(
+            (reinterpret_cast<uint8_t *>(slot) - segment_->base - header.slotsOffset) / header.slotStride);
+        const auto mask = header.ringCapacity - 1U;
+        for (size_t i = 0; i < header.rings; ++i) {
+            auto &ring = segment_->ring(i);
+            ring.producerBusy.store(1U, std::memory_order_seq_cst);
+            if (RingAttached == ring.state.load(std::memory_order_seq_cst)) {
+                const auto tail = ring.tail.load(std::memory_order_relaxed);
+                if ((tail - ring.head.load(std::memory_order_acquire)) >= header.ringCapacity) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    full = true;
+                } else {
+                    slot->refs.fetch_add(1, std::memory_order_relaxed);
+                    ring.entries()[tail & mask] = index;
+                    ring.tail.store(tail + 1, std::memory_order_release);
+                    ring.post();
+                }
+            }
+            ring.producerBusy.store(0U, std::memory_order_release);
+        }
+    }
+
+    /* local listeners read the published slot like a subscriber, a write copies it */
+    std::optional<UMessage> local;
+    listeners_.forEachListener(message.attributes().source(), [this, &message, &local, slot](const UListener &listener) {
+        if (!local) {
+            local.emplace(message);
+            slot->refs.fetch_add(1, std::memory_order_relaxed);
+            local->setPayload(payloadOf(slot, slot->payloadSize, false));
+        }
+        listener.onReceive(*local);
+    });
+    slot->release();
+
+    return status(full ? UCode::RESOURCE_EXHAUSTED : UCode::OK);
+}
+
+UStatus SharedMemoryTransport::registerListener(const UUri &uri, const UListener &listener) {
+    return listeners_.registerListener(uri, listener);
+}
+
+UStatus SharedMemoryTransport::unregisterListener(const UUri &uri, const UListener &listener) {
+    return listeners_.unregisterListener(uri, listener);
+}
+
+UPayload SharedMemoryTransport::loan(size_t size) {
+    if ((false == publisher_) || (size > segment_->header().payloadCapacity)) {
+        return UPayload();
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+
+    auto *slot = allocate();
+    if (nullptr == slot) {
+        return UPayload();
+    }
+    slot->published.store(0U, std::memory_order_relaxed);
+    /* the allocation reference becomes the payload's */
+    return payloadOf(slot, size, true);
+}
+
+size_t SharedMemoryTransport::slotsInUse() const {
+    size_t count = 0;
+    for (size_t i = 0; i < segment_->header().slots; ++i) {
+        if (0U != segment_->slot(i).refs.load(std::memory_order_acquire)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+SharedMemoryTransport::Slot *SharedMemoryTransport::allocate() {
+    const auto slots = segment_->header().slots;
+    for (size_t n = 0; n < slots; ++n) {
+        auto &slot = segment_->slot(cursor_);
+        cursor_ = (cursor_ + 1 == slots) ? 0 : cursor_ + 1;
+        auto expected = 0U;
+        if (slot.refs.compare_exchange_strong(expected, 1U, std::memory_order_acquire)) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+SharedMemoryTransport::Slot *SharedMemoryTransport::loanedSlot(const UPayload &payload) const {
+    if (false == payload.isContiguous()) {
+        return nullptr;
+    }
+    const auto &header = segment_->header();
+    const auto *data = payload.data();
+    if ((UPayloadType::SHARED != payload.type()) || (data < segment_->base + header.slotsOffset) ||
+        (data >= segment_->base + header.size)) {
+        return nullptr;
+    }
+    const auto offset = static_cast<size_t>(data - segment_->base) - header.slotsOffset;
+    auto &slot = segment_->slot(offset / header.slotStride);
+    return (segment_->payload(slot) == data) ? &slot : nullptr;
+}
+
+UPayload SharedMemoryTransport::payloadOf(Slot *slot, size_t size, bool loaned) const {
+    auto segment = segment_;
+    std::shared_ptr<uint8_t[]> data(segment_->payload(*slot),
+                                    [segment, slot](const uint8_t *) { slot->release(); });
+    /* only a loan is written in place, received payloads are copied before any write */
+    UPayload payload = loaned ? UPayload::lend(std::move(data), size) :
+                                UPayload(std::shared_ptr<const uint8_t[]>(std::move(data)), size);
+    payload.setFormat(static_cast<UPayloadFormat>(slot->format));
+    return payload;
+}
+
+void SharedMemoryTransport::receiveLoop() {
+    auto &ring = segment_->ring(ring_);
+    int spins = 0;
+
+    while (false == terminate_.load(std::memory_order_acquire)) {
+        const auto head = ring.head.load(std::memory_order_relaxed);
+        if (head != ring.tail.load(std::memory_order_acquire)) {
+            deliver(ring, head);
+            spins = 0;
+            continue;
+        }
+        if (++spins < SpinsBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto ticket = ring.word.load(std::memory_order_acquire);
+        ring.waiters.fetch_add(1, std::memory_order_seq_cst);
+        if ((head == ring.tail.load(std::memory_order_seq_cst)) &&
+            (false == terminate_.load(std::memory_order_acquire))) {
+            futexWait(ring.word, ticket, ReceiveTimeout);
+        }
+        ring.waiters.fetch_sub(1, std::memory_order_relaxed);
+        spins = 0;
+    }
+}
+
+bool SharedMemoryTransport::deliver(Ring &ring, uint64_t pos) {
+    const auto mask = segment_->header().ringCapacity - 1U;
+    auto *slot = &segment_->slot(ring.entries()[pos & mask]);
+
+    UMessage message;
+    const auto parsed = message.mutableAttributes().ParseFromArray(slot->attributes(),
+                                                                   static_cast<int>(slot->attributesSize));
+    /* the ring entry's reference becomes the payload's */
+    message.setPayload(payloadOf(slot, slot->payloadSize, false));
+    ring.head.store(pos + 1, std::memory_order_release);
+
+    if (false == parsed) {
+        UP_LOG_ERROR("dropping a message with malformed attributes from {}", segment_->name);
+        return false;
+    }
+    listeners_.dispatch(message.attributes().source(), message);
+    return true;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <up-cpp/transport/datamodel/UPayload.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <up-cpp/utils/Log.h>
+
+namespace uprotocol::utransport {
+
+UPayload UPayload::mapFile(const std::string &path,
+                           size_t offset,
+                           size_t length) {
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        UP_LOG_ERROR("cannot open {}: {}", path, std::strerror(errno));
+        return UPayload();
+    }
+
+    struct stat info {};
+    if (0 != ::fstat(fd, &info)) {
+        UP_LOG_ERROR("cannot stat {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return UPayload();
+    }
+    const auto fileSize = static_cast<size_t>(info.st_size);
+    if (offset >= fileSize) {
+        ::close(fd);
+        return UPayload();
+    }
+    length = std::min(length, fileSize - offset);
+
+    /* the mapping starts at the page holding offset */
+    const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const auto start = offset - (offset % pageSize);
+    const auto mapLength = length + (offset - start);
+    auto *base = ::mmap(nullptr, mapLength, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(start));
+    /* the mapping keeps the file open */
+    ::close(fd);
+    if (MAP_FAILED == base) {
+        UP_LOG_ERROR("mmap of {} failed: {}", path, std::strerror(errno));
+        return UPayload();
+    }
+    /* large blobs are usually read front to back, let the kernel read ahead */
+    static_cast<void>(::madvise(base, mapLength, MADV_SEQUENTIAL));
+
+    std::shared_ptr<const uint8_t[]> data(static_cast<const uint8_t *>(base) + (offset - start),
+                                          [base, mapLength](const uint8_t *) { ::munmap(base, mapLength); });
+    /* a caller buffer, not writable: mutableData() copies instead of faulting on the read-only pages */
+    return UPayload(std::move(data), length);
+}
+
+} // namespace uprotocol::utransport
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <up-cpp/uri/serializer/BatchUriConverter.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+#include <up-cpp/utils/Futex.h>
+
+using namespace uprotocol::uri;
+
+namespace {
+
+/**
+ * Chunks of a batch, claimed by the calling thread and by helper tasks on the pool.
+ * Helpers may start after the batch is done, they only ever touch this state.
+ */
+template<typename Column>
+struct Batch {
+    std::function<void(std::size_t, std::size_t, Column&)> convert;
+    std::size_t count = 0;
+    std::size_t chunkSize = 0;
+    std::vector<Column> parts;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    uprotocol::utils::Futex finished;
+
+    /* convert chunks until none is left */
+    void work() {
+        std::size_t converted = 0;
+        for (auto chunk = next++; chunk < parts.size(); chunk = next++) {
+            const auto begin = chunk * chunkSize;
+            convert(begin, std::min(count, begin + chunkSize), parts[chunk]);
+            ++converted;
+        }
+        if ((0 != converted) && (parts.size() == done.fetch_add(converted) + converted)) {
+            finished.postAll();
+        }
+    }
+
+    /* wait for the chunks claimed by the helpers */
+    void wait() {
+        while (true) {
+            const auto ticket = finished.value();
+            if (parts.size() == done.load()) {
+                return;
+            }
+            finished.wait(ticket, std::chrono::milliseconds(100));
+        }
+    }
+};
+
+/* append part to column, shifting its offsets */
+template<typename Column>
+auto join(Column& column, const Column& part) -> void {
+    const auto base = column.offsets.back();
+    if constexpr (std::is_same_v<Column, MicroUriColumn>) {
+        column.bytes.insert(column.bytes.end(), part.bytes.begin(), part.bytes.end());
+    } else {
+        column.chars.append(part.chars);
+    }
+    for (std::size_t i = 1; i < part.offsets.size(); ++i) {
+        column.offsets.push_back(base + part.offsets[i]);
+    }
+    column.errors.insert(column.errors.end(), part.errors.begin(), part.errors.end());
+}
+
+template<typename Column>
+auto run(std::size_t count,
+         uprotocol::utils::ThreadPool* pool,
+         std::function<void(std::size_t, std::size_t, Column&)> convert) -> Column {
+    auto batch = std::make_shared<Batch<Column>>();
+    batch->convert = std::move(convert);
+    batch->count = count;
+
+    // enough chunks for every worker to get a few, so uneven chunks even out
+    const auto workers = (nullptr == pool) ? 1 : pool->numOfThreads() + 1;
+    batch->chunkSize = std::max<std::size_t>(1, std::min(BatchUriConverter::ChunkSize, (count + 4 * workers - 1) / (4 * workers)));
+    batch->parts.resize((count + batch->chunkSize - 1) / batch->chunkSize);
+
+    if ((nullptr != pool) && (batch->parts.size() > 1)) {
+        const auto helpers = std::min(pool->numOfThreads(), batch->parts.size() - 1);
+        for (std::size_t i = 0; i < helpers; ++i) {
+            if (false == pool->post([batch]() { batch->work(); })) {
+                break;
+            }
+        }
+    }
+    batch->work();
+    batch->wait();
+
+    Column column;
+    column.offsets.reserve(count + 1);
+    column.errors.reserve(count);
+    for (const auto& part : batch->parts) {
+        join(column, part);
+    }
+    return column;
+}
+
+}  // namespace
+
+/**
+ * Convert a column of long URIs to a column of micro URIs.
+ * @param arena characters of the long URIs.
+ * @param offsets count + 1 offsets into arena.
+ * @param count number of URIs.
+ * @param pool pool to convert on in parallel, nullptr to convert on the calling thread.
+ * @param resolve fills in the ids of the deserialized UUris, may be empty.
+ * @return Returns the micro URIs in input order.
+ */
+auto BatchUriConverter::longToMicro(std::string_view arena,
+                                    const std::size_t* offsets,
+                                    std::size_t count,
+                                    utils::ThreadPool* pool,
+                                    const Resolver& resolve) -> MicroUriColumn {
+    return run<MicroUriColumn>(count, pool, [arena, offsets, &resolve](std::size_t begin, std::size_t end, MicroUriColumn& out) {
+        std::array<uint8_t, MicroUriSerializer::MaxMicroUriLength> buffer{};
+        out.bytes.reserve((end - begin) * MicroUriSerializer::LocalMicroUriLength);
+        out.offsets.reserve(end - begin + 1);
+        out.errors.reserve(end - begin);
+        for (auto i = begin; i < end; ++i) {
+            uint8_t error = 0;
+            auto uri = LongUriSerializer::tryDeserialize(arena.substr(offsets[i], offsets[i + 1] - offsets[i]));
+            if (!uri) {
+                error = static_cast<uint8_t>(uri.error());
+            } else if (resolve && (false == resolve(*uri))) {
+                error = static_cast<uint8_t>(UriError::Unresolved);
+            } else if (auto size = MicroUriSerializer::trySerialize(*uri, buffer.data(), buffer.size())) {
+                out.bytes.insert(out.bytes.end(), buffer.begin(), buffer.begin() + *size);
+            } else {
+                error = static_cast<uint8_t>(size.error());
+            }
+            out.offsets.push_back(out.bytes.size());
+            out.errors.push_back(error);
+        }
+    });
+}
+
+/**
+ * Convert a column of micro URIs to a column of long URIs.
+ * @param arena bytes of the micro URIs.
+ * @param offsets count + 1 offsets into arena.
+ * @param count number of URIs.
+ * @param pool pool to convert on in parallel, nullptr to convert on the calling thread.
+ * @param resolve fills in the names of the deserialized UUris, may be empty.
+ * @return Returns the long URIs in input order.
+ */
+auto BatchUriConverter::microToLong(const uint8_t* arena,
+                                    const std::size_t* offsets,
+                                    std::size_t count,
+                                    utils::ThreadPool* pool,
+                                    const Resolver& resolve) -> LongUriColumn {
+    return run<LongUriColumn>(count, pool, [arena, offsets, &resolve](std::size_t begin, std::size_t end, LongUriColumn& out) {
+        std::string long_uri;
+        out.offsets.reserve(end - begin + 1);
+        out.errors.reserve(end - begin);
+        for (auto i = begin; i < end; ++i) {
+            uint8_t error = 0;
+            auto uri = MicroUriSerializer::tryDeserialize(arena + offsets[i], offsets[i + 1] - offsets[i]);
+            if (!uri) {
+                error = static_cast<uint8_t>(uri.error());
+            } else if (resolve && (false == resolve(*uri))) {
+                error = static_cast<uint8_t>(UriError::Unresolved);
+            } else if (0 == LongUriSerializer::serialize(*uri, long_uri)) {
+                error = static_cast<uint8_t>(UriError::Empty);
+            } else {
+                out.chars.append(long_uri);
+            }
+            out.offsets.push_back(out.chars.size());
+            out.errors.push_back(error);
+        }
+    });
+}
@@ -23,9 +23,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include <array>
-#include <arpa/inet.h>
-#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstring>
+#include <up-cpp/utils/Log.h>
 #include <up-cpp/uri/tools/IpAddress.h>
 #include "up-core-api/uri.pb.h"
 
@@ -36,23 +36,6 @@ namespace {
 
     using UAuthority = uprotocol::v1::UAuthority;
 
-    /// Controls whether buffers created when converting address formats have
-    /// `shrink_to_fit()` called on them. This should be set to true only if
-    /// it seems reasonably likely that large numbers of IpAddress instances
-    /// will be kept around for long times.
-    constexpr bool OPTION_SHRINK_BUFFERS = false;
-
-    std::vector<uint8_t> bytesFromAuthority(UAuthority const& authority) {
-        std::vector<uint8_t> addressBytes;
-        if (authority.has_ip() && authority.ip().size() > 0) {
-            auto const& addrByteStr = authority.ip();
-            std::transform(addrByteStr.begin(), addrByteStr.end(),
-                    std::back_inserter(addressBytes),
-                    [](char c){ return *reinterpret_cast<uint8_t*>(&c); });
-        }
-        return addressBytes;
-    }
-
     uri::IpAddress::Type typeFromAuthority(UAuthority const& authority) {
         if (authority.has_ip()) {
             if (authority.ip().size() == uri::IpAddress::IpV4AddressBytes) {
@@ -60,104 +43,341 @@ namespace {
             } else if (authority.ip().size() == uri::IpAddress::IpV6AddressBytes) {
                 return uri::IpAddress::Type::IpV6;
             }
-            spdlog::error("UAuthority has IP address, but size ({}) does not "
+            UP_LOG_ERROR("UAuthority has IP address, but size ({}) does not "
                     "match expected for IPv4 or IPv6", authority.ip().size());
         } else {
-            spdlog::error("UAuthority does not have IP address");
+            UP_LOG_ERROR("UAuthority does not have IP address");
         }
         return uri::IpAddress::Type::Invalid;
     }
+
+    const uint8_t* bytesFromAuthority(UAuthority const& authority) {
+        return reinterpret_cast<const uint8_t*>(authority.ip().data());
+    }
+
+    std::size_t sizeFromAuthority(UAuthority const& authority) {
+        return authority.has_ip() ? authority.ip().size() : 0;
+    }
+
+    int hexValue(char c) {
+        if ((c >= '0') && (c <= '9')) {
+            return c - '0';
+        }
+        if ((c >= 'a') && (c <= 'f')) {
+            return c - 'a' + 10;
+        }
+        if ((c >= 'A') && (c <= 'F')) {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    /// Dotted decimal IPv4 address, the rules of inet_pton(AF_INET): four
+    /// octets of at most 255 and no leading zeros.
+    bool parseIpV4(const char* src, const char* end, uint8_t* dst) {
+        uint8_t octets[uri::IpAddress::IpV4AddressBytes] = {};
+        std::size_t count = 0;
+        bool sawDigit = false;
+
+        while (src < end) {
+            auto ch = *src++;
+            if ((ch >= '0') && (ch <= '9')) {
+                if (sawDigit && (0 == octets[count - 1])) {
+                    return false;
+                }
+                unsigned value = (sawDigit ? octets[count - 1] * 10U : 0U) + static_cast<unsigned>(ch - '0');
+                if (value > 255) {
+                    return false;
+                }
+                if (false == sawDigit) {
+                    if (++count > uri::IpAddress::IpV4AddressBytes) {
+                        return false;
+                    }
+                    sawDigit = true;
+                }
+                octets[count - 1] = static_cast<uint8_t>(value);
+            } else if ((ch == '.') && sawDigit) {
+                if (count == uri::IpAddress::IpV4AddressBytes) {
+                    return false;
+                }
+                sawDigit = false;
+            } else {
+                return false;
+            }
+        }
+        if (count < uri::IpAddress::IpV4AddressBytes) {
+            return false;
+        }
+
+        std::memcpy(dst, octets, sizeof(octets));
+        return true;
+    }
+
+    /// Colon separated IPv6 address, the rules of inet_pton(AF_INET6): up to
+    /// eight groups of one to four hex digits, at most one "::" standing for at
+    /// least one zero group, and optionally an IPv4 address in the last 32 bits.
+    bool parseIpV6(const char* src, const char* end, uint8_t* dst) {
+        uint8_t tmp[uri::IpAddress::IpV6AddressBytes] = {};
+        uint8_t* tp = tmp;
+        uint8_t* const tend = tmp + sizeof(tmp);
+        uint8_t* colon = nullptr;
+
+        if (src == end) {
+            return false;
+        }
+        // Leading :: requires some special handling
+        if (*src == ':') {
+            if ((++src == end) || (*src != ':')) {
+                return false;
+            }
+        }
+
+        const char* token = src;
+        std::size_t digits = 0;
+        unsigned value = 0;
+        while (src < end) {
+            auto ch = *src++;
+            if (auto digit = hexValue(ch); digit >= 0) {
+                if (4 == digits) {
+                    return false;
+                }
+                value = (value << 4) | static_cast<unsigned>(digit);
+                ++digits;
+                continue;
+            }
+            if (ch == ':') {
+                token = src;
+                if (0 == digits) {
+                    if (nullptr != colon) {
+                        return false;
+                    }
+                    colon = tp;
+                    continue;
+                } else if (src == end) {
+                    return false;
+                }
+                if (tp + 2 > tend) {
+                    return false;
+                }
+                *tp++ = static_cast<uint8_t>(value >> 8);
+                *tp++ = static_cast<uint8_t>(value);
+                digits = 0;
+                value = 0;
+                continue;
+            }
+            if ((ch == '.') && (tp + uri::IpAddress::IpV4AddressBytes <= tend) &&
+                    parseIpV4(token, end, tp)) {
+                tp += uri::IpAddress::IpV4AddressBytes;
+                digits = 0;
+                break;
+            }
+            return false;
+        }
+        if (digits > 0) {
+            if (tp + 2 > tend) {
+                return false;
+            }
+            *tp++ = static_cast<uint8_t>(value >> 8);
+            *tp++ = static_cast<uint8_t>(value);
+        }
+        if (nullptr != colon) {
+            // :: would expand to a zero-width field
+            if (tp == tend) {
+                return false;
+            }
+            auto n = static_cast<std::size_t>(tp - colon);
+            std::memmove(tend - n, colon, n);
+            std::memset(colon, 0, static_cast<std::size_t>(tend - n - colon));
+            tp = tend;
+        }
+        if (tp != tend) {
+            return false;
+        }
+
+        std::memcpy(dst, tmp, sizeof(tmp));
+        return true;
+    }
+
+    char* formatDecimal(char* out, uint8_t value) {
+        if (value >= 100) {
+            *out++ = static_cast<char>('0' + value / 100);
+        }
+        if (value >= 10) {
+            *out++ = static_cast<char>('0' + (value / 10) % 10);
+        }
+        *out++ = static_cast<char>('0' + value % 10);
+        return out;
+    }
+
+    char* formatIpV4(char* out, const uint8_t* bytes) {
+        for (std::size_t i = 0; i < uri::IpAddress::IpV4AddressBytes; ++i) {
+            if (0 != i) {
+                *out++ = '.';
+            }
+            out = formatDecimal(out, bytes[i]);
+        }
+        return out;
+    }
+
+    /// Same output as inet_ntop(AF_INET6): lower case hex, the longest run of
+    /// two or more zero groups (the first one on a tie) shortened to "::" and
+    /// IPv4 compatible / mapped addresses ending in dotted decimal.
+    char* formatIpV6(char* out, const uint8_t* bytes) {
+        static constexpr char Hex[] = "0123456789abcdef";
+        constexpr int Groups = uri::IpAddress::IpV6AddressBytes / 2;
+
+        uint16_t words[Groups];
+        for (int i = 0; i < Groups; ++i) {
+            words[i] = static_cast<uint16_t>((bytes[2 * i] << 8) | bytes[2 * i + 1]);
+        }
+
+        int bestBase = -1;
+        int bestLen = 0;
+        for (int i = 0, curBase = -1; i <= Groups; ++i) {
+            if ((i < Groups) && (0 == words[i])) {
+                if (-1 == curBase) {
+                    curBase = i;
+                }
+                continue;
+            }
+            if ((-1 != curBase) && (i - curBase > bestLen)) {
+                bestBase = curBase;
+                bestLen = i - curBase;
+            }
+            curBase = -1;
+        }
+        if (bestLen < 2) {
+            bestBase = -1;
+        }
+
+        for (int i = 0; i < Groups; ++i) {
+            if ((-1 != bestBase) && (i >= bestBase) && (i < bestBase + bestLen)) {
+                if (i == bestBase) {
+                    *out++ = ':';
+                }
+                continue;
+            }
+            if (0 != i) {
+                *out++ = ':';
+            }
+            if ((6 == i) && (0 == bestBase) &&
+                    ((6 == bestLen) || ((5 == bestLen) && (0xffff == words[5])))) {
+                return formatIpV4(out, bytes + 12);
+            }
+            bool leading = true;
+            for (int shift = 12; shift >= 0; shift -= 4) {
+                auto nibble = (words[i] >> shift) & 0xf;
+                if (leading && (0 == nibble) && (0 != shift)) {
+                    continue;
+                }
+                leading = false;
+                *out++ = Hex[nibble];
+            }
+        }
+        if ((-1 != bestBase) && (bestBase + bestLen == Groups)) {
+            *out++ = ':';
+        }
+        return out;
+    }
 }
 
 uri::IpAddress::IpAddress(uprotocol::v1::UAuthority const& authority)
-    : IpAddress(bytesFromAuthority(authority), typeFromAuthority(authority))
+    : IpAddress(bytesFromAuthority(authority), sizeFromAuthority(authority), typeFromAuthority(authority))
 { }
 
+auto uri::IpAddress::getString() const -> std::string {
+    if (0 != stringLength_) {
+        return std::string(ipString_.data(), stringLength_);
+    }
+
+    char buffer[MaxStringLength];
+    return std::string(buffer, format(buffer, sizeof(buffer)));
+}
+
+auto uri::IpAddress::format(char* buffer, std::size_t size) const -> std::size_t {
+    if (0 != stringLength_) {
+        if (size < stringLength_) {
+            return 0;
+        }
+        std::memcpy(buffer, ipString_.data(), stringLength_);
+        return stringLength_;
+    }
+
+    char formatted[MaxStringLength];
+    char* end = formatted;
+    if (type_ == Type::IpV4) {
+        end = formatIpV4(formatted, ipBytes_.data());
+    } else if (type_ == Type::IpV6) {
+        end = formatIpV6(formatted, ipBytes_.data());
+    }
+
+    auto length = static_cast<std::size_t>(end - formatted);
+    if (size < length) {
+        return 0;
+    }
+    std::memcpy(buffer, formatted, length);
+    return length;
+}
+
 /**
- * Updates the state of the IP object from the value of the ipString_ field
+ * Updates the state of the IP object from an address string
  */
-void uri::IpAddress::fromString() {
-    if (std::vector<uint8_t> bytes(IpV6AddressBytes, 0);
-            1 == inet_pton(AF_INET6, ipString_.c_str(), bytes.data())) {
-        type_ = Type::IpV6;
-        ipBytes_ = std::move(bytes);
-        return;
+void uri::IpAddress::fromString(std::string_view ipString) {
+    const auto* begin = ipString.data();
+    const auto* end = begin + ipString.size();
 
-    } else if (bytes.resize(IpV4AddressBytes);
-            1 == inet_pton(AF_INET, ipString_.c_str(), bytes.data())) {
-        if constexpr (OPTION_SHRINK_BUFFERS) {
-            bytes.shrink_to_fit();
+    // an address without a colon can only be IPv4 and one with a colon only IPv6
+    if (ipString.size() <= MaxStringLength) {
+        if (ipString.npos != ipString.find(':')) {
+            if (parseIpV6(begin, end, ipBytes_.data())) {
+                type_ = Type::IpV6;
+                ipLength_ = IpV6AddressBytes;
+            }
+        } else if (parseIpV4(begin, end, ipBytes_.data())) {
+            type_ = Type::IpV4;
+            ipLength_ = IpV4AddressBytes;
         }
-        type_ = Type::IpV4;
-        ipBytes_ = std::move(bytes);
+    }
+
+    if (0 == ipLength_) {
+        UP_LOG_ERROR("ipString does not contain a valid IPv4 / IPv6 address");
+        type_ = Type::Invalid;
+        ipBytes_.fill(0);
         return;
     }
 
-    spdlog::error("ipString does not contain a valid IPv4 / IPv6 address");
-    type_ = Type::Invalid;
-    ipString_.clear();
+    std::copy(ipString.begin(), ipString.end(), ipString_.begin());
+    stringLength_ = static_cast<uint8_t>(ipString.size());
 }
 
 /**
- * Updates state of the IP object from the value of the ipBytes_ field
+ * Updates state of the IP object from address bytes
  */
-void uri::IpAddress::fromBytes() {
-    if (ipBytes_.empty()) {
-        spdlog::error("ipBytes is empty");
+void uri::IpAddress::fromBytes(const uint8_t* ipBytes, std::size_t size) {
+    if (0 == size) {
+        UP_LOG_ERROR("ipBytes is empty");
         type_ = Type::Invalid;
         return;
     }
 
     if (type_ == Type::IpV6) {
-        if (ipBytes_.size() == IpV6AddressBytes) {
-            ipString_.resize(INET6_ADDRSTRLEN);
-        } else {
-            spdlog::error("ipBytes is the wrong size for an IPv6 address");
+        if (size != IpV6AddressBytes) {
+            UP_LOG_ERROR("ipBytes is the wrong size for an IPv6 address");
             type_ = Type::Invalid;
-            ipBytes_.clear();
             return;
         }
     } else if (type_ == Type::IpV4) {
-        if (ipBytes_.size() == IpV4AddressBytes) {
-            ipString_.resize(INET_ADDRSTRLEN);
-        } else {
-            spdlog::error("ipBytes is the wrong size for an IPv4 address");
+        if (size != IpV4AddressBytes) {
+            UP_LOG_ERROR("ipBytes is the wrong size for an IPv4 address");
             type_ = Type::Invalid;
-            ipBytes_.clear();
             return;
         }
     } else {
-        spdlog::error("type is not one of IPv4 or IPv6");
-        type_ = Type::Invalid;
-        ipBytes_.clear();
-        return;
-    }
-         
-    // Note: handling Type::Invalid and other non IP types by returning
-    // in the conditional block above allows this check to assume that type
-    // is *either* IpV4 OR IpV6 and not any of the other possible values.
-    auto inet_type = (type_ == Type::IpV4) ? AF_INET : AF_INET6;
-
-    if (inet_ntop(inet_type, ipBytes_.data(), ipString_.data(), ipString_.size()) == nullptr) {
-        spdlog::error("inet_ntop failed");
+        UP_LOG_ERROR("type is not one of IPv4 or IPv6");
         type_ = Type::Invalid;
-        ipBytes_.clear();
-        ipString_.clear();
         return;
     }
 
-    // std::string can happily hold null characters in the middle of its
-    // buffer. Since we expanded to the maximum length of a given address
-    // type, we need to find where the real end of the string provided
-    // by inet_ntop is and truncate to that.
-    auto term = ipString_.find_first_of('\0');
-    if (ipString_.npos != term) {
-        ipString_.resize(term);
-    // If these IpAddress objects are kept around in any quantity,
-    // we might want to purge the excess memory once the string
-    // is resized.
-        if constexpr (OPTION_SHRINK_BUFFERS) {
-            ipString_.shrink_to_fit();
-        }
-    }
+    std::memcpy(ipBytes_.data(), ipBytes, size);
+    ipLength_ = static_cast<uint8_t>(size);
 }
@@ -23,16 +23,34 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include <regex>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <string>
-#include <vector>
-#include <iostream>
 #include <up-cpp/uri/builder/BuildUUri.h>
 #include <up-cpp/uri/builder/BuildUAuthority.h>
 #include <up-cpp/uri/builder/BuildEntity.h>
 #include <up-cpp/uri/builder/BuildUResource.h>
 #include <up-cpp/uri/tools/Utils.h>
 #include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/Metrics.h>
+
+using uprotocol::utils::metrics::SerializerMetrics;
+
+static const SerializerMetrics& serializeMetrics() {
+    static const auto metrics = SerializerMetrics::of("long_uri", "serialize");
+    return metrics;
+}
+
+static const SerializerMetrics& deserializeMetrics() {
+    static const auto metrics = SerializerMetrics::of("long_uri", "deserialize");
+    return metrics;
+}
 
 /**
  * Support for serializing UUri objects into their String format.
@@ -41,22 +59,113 @@
  * in a uProtocol publish communication.
  */ 
 auto uprotocol::uri::LongUriSerializer::serialize(const v1::UUri& uri) -> std::string {
+    std::string uri_string;
+    serialize(uri, uri_string);
+
+    return uri_string;
+}
+
+/**
+ * Serialize a UUri into a caller supplied string, replacing its content.
+ * @param uri UUri object to be serialized to the String format.
+ * @param out Receives the String format of the supplied UUri.
+ * @return Returns the length of the serialized UUri.
+ */
+auto uprotocol::uri::LongUriSerializer::serialize(const v1::UUri& uri, std::string& out) -> std::size_t {
+    if constexpr (utils::metrics::Enabled) {
+        serializeMetrics().calls.add();
+    }
+    out.clear();
     if (isEmpty(uri)) {
-        return "";
+        return 0;
     }
 
-    std::string uri_string;
-    uri_string.append(buildAuthorityPartOfUri(uri.authority()));
-    if (uri_string.length() >= 2 || uri_string.empty()) {
-        uri_string.append("/");
+    // authority: "/" for local, "//name/" for remote, "/" if the authority only has an ip or id
+    const auto& u_authority = uri.authority();
+    std::string_view authority_name;
+    const bool local = isEmpty(u_authority);
+    if (!local && u_authority.has_name()) {
+        authority_name = u_authority.name();
     }
-    if (isEmpty(uri.entity())) {
-        return uri_string;
+    std::size_t length = local ? 1 : (authority_name.empty() ? 1 : 2 + authority_name.size() + 1);
+
+    // entity: "name/major[.minor]"
+    const auto& entity = uri.entity();
+    const bool has_entity = !isEmpty(entity);
+    std::string_view entity_name;
+    std::array<char, 2 * std::numeric_limits<uint32_t>::digits10 + 3> version{};
+    std::size_t version_length = 0;
+    if (has_entity) {
+        entity_name = entity.name();
+        auto isSpace = [](unsigned char ch) { return std::isspace(ch); };
+        while (!entity_name.empty() && isSpace(entity_name.front())) {
+            entity_name.remove_prefix(1);
+        }
+        while (!entity_name.empty() && isSpace(entity_name.back())) {
+            entity_name.remove_suffix(1);
+        }
+
+        char* end = version.data();
+        if (entity.has_version_major()) {
+            end = std::to_chars(end, version.data() + version.size(), entity.version_major()).ptr;
+            // the array fits both versions, the bound check only spares the compiler the proof
+            if (entity.has_version_minor() && (end != version.data() + version.size())) {
+                *end++ = '.';
+                end = std::to_chars(end, version.data() + version.size(), entity.version_minor()).ptr;
+            }
+        }
+        version_length = static_cast<std::size_t>(end - version.data());
+        length += entity_name.size() + 1 + version_length;
     }
-    uri_string.append(buildSoftwareEntityPartOfUri(uri.entity()));
-    uri_string.append(buildResourcePartOfUri(uri.resource()));
 
-    return uri_string;
+    // resource: "/name[.instance][#message]"
+    const auto& resource = uri.resource();
+    const bool has_resource = has_entity && !isEmpty(resource);
+    std::string_view instance;
+    std::string_view message;
+    if (has_resource) {
+        if (resource.has_instance()) {
+            instance = resource.instance();
+        }
+        if (resource.has_message()) {
+            message = resource.message();
+        }
+        length += 1 + resource.name().size() +
+                  (instance.empty() ? 0 : 1 + instance.size()) +
+                  (message.empty() ? 0 : 1 + message.size());
+    }
+
+    out.resize(length);
+    char* pos = out.data();
+    auto write = [&pos](std::string_view str) {
+        std::memcpy(pos, str.data(), str.size());
+        pos += str.size();
+    };
+
+    if (!local && !authority_name.empty()) {
+        write("//");
+        write(authority_name);
+    }
+    write("/");
+    if (has_entity) {
+        write(entity_name);
+        write("/");
+        write(std::string_view(version.data(), version_length));
+    }
+    if (has_resource) {
+        write("/");
+        write(resource.name());
+        if (!instance.empty()) {
+            write(".");
+            write(instance);
+        }
+        if (!message.empty()) {
+            write("#");
+            write(message);
+        }
+    }
+
+    return length;
 }
 
 /**
@@ -64,85 +173,192 @@ auto uprotocol::uri::LongUriSerializer::serialize(const v1::UUri& uri) -> std::s
  * @param protocol_uri A long format uProtocol URI.
  * @return Returns an UUri data object.
  */
-auto uprotocol::uri::LongUriSerializer::deserialize(std::string const& protocol_uri) -> v1::UUri {
-    if (protocol_uri.empty()) {
-        return BuildUUri().build();
-    }
-
-    auto uri = protocol_uri;
-    std::replace(uri.begin(), uri.end(), '\\', '/');
-    
-     const auto uri_parts = split(uri, "/");
-
-    constexpr auto MinimumParts = 2;
-    
-    if (auto j = getFirstNotEmpty(uri_parts); j > 3) {
-        return BuildUUri().build();
+auto uprotocol::uri::LongUriSerializer::deserialize(std::string_view protocol_uri) -> v1::UUri {
+    if constexpr (utils::metrics::Enabled) {
+        deserializeMetrics().calls.add();
     }
-    
-    //bool is_local = isLocality(uri);
-    if (uri_parts.size() < MinimumParts) {
+    LongUriParts parts;
+    if (!parse(protocol_uri, parts)) {
+        if constexpr (utils::metrics::Enabled) {
+            deserializeMetrics().failures.add();
+        }
         return BuildUUri().build();
-    } else if (isLocality(uri)) {
-        return parseLocalUUri(uri_parts);
-    } else {
-        return parseRemoteUUri(uri_parts);
     }
+
+    return build(parts);
 }
 
 /**
- * Check the number of empty strings in the Vector from the start to find the first non-empty string.
- * THis is used to determine if the URI is local or remote.
- * @param uri_parts 
- * @return 
+ * Deserialize a String into a UUri object, without throwing.
+ * @param protocol_uri A long format uProtocol URI.
+ * @return Returns the UUri or why the URI does not deserialize.
  */
-auto uprotocol::uri::LongUriSerializer::getFirstNotEmpty(const std::vector<std::string> &uri_parts) -> uint64_t {
-    decltype(uri_parts.size()) j = 0;
-    for (const auto & uri_part : uri_parts) {
-        if (uri_part.empty()) {
-            ++j;
-        } else {
-            break;
+auto uprotocol::uri::LongUriSerializer::tryDeserialize(std::string_view protocol_uri)
+        -> utils::Expected<v1::UUri, UriError> {
+    if constexpr (utils::metrics::Enabled) {
+        deserializeMetrics().calls.add();
+    }
+    const auto fail = [](UriError error) {
+        if constexpr (utils::metrics::Enabled) {
+            deserializeMetrics().failures.add();
         }
+        return utils::makeUnexpected(error);
+    };
+
+    LongUriParts parts;
+    try {
+        if (!parse(protocol_uri, parts)) {
+            return fail(protocol_uri.empty() ? UriError::Empty : UriError::Malformed);
+        }
+    } catch (const std::logic_error&) {
+        // std::invalid_argument or std::out_of_range from the version number
+        return fail(UriError::InvalidVersion);
     }
-    return j;
+
+    return build(parts);
 }
 
 /**
- * Find if the URI string is local or remote
- * @param uri 
- * @return 
+ * Build the UUri of a parsed long format URI.
+ * @param parts views into the long format URI.
+ * @return Returns the UUri.
  */
-auto inline uprotocol::uri::LongUriSerializer::isLocality(const std::string_view &uri) -> bool {
-    auto pos = uri.find("//");
-    auto is_local = pos != 0;  // local if does not start with "//"
-    if (!is_local) { // we find that is remote since "//" is found
-        is_local = uri.find("///", pos) == 0;  // local if starts with "///");
+auto uprotocol::uri::LongUriSerializer::build(const LongUriParts &parts) -> v1::UUri {
+    v1::UUri uri;
+
+    auto *authority = uri.mutable_authority();
+    if (!parts.isLocal) {
+        auto *name = authority->mutable_name();
+        name->resize(parts.authority.size());
+        std::transform(parts.authority.begin(), parts.authority.end(), name->begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+    }
+
+    auto *entity = uri.mutable_entity();
+    if (!parts.entityName.empty()) {
+        entity->set_name(parts.entityName.data(), parts.entityName.size());
+    }
+    if (parts.hasVersionMajor) {
+        entity->set_version_major(parts.versionMajor);
+    }
+    if (parts.hasVersionMinor) {
+        entity->set_version_minor(parts.versionMinor);
     }
-    return is_local;
+
+    auto *resource = uri.mutable_resource();
+    if (!parts.resourceName.empty()) {
+        resource->set_name(parts.resourceName.data(), parts.resourceName.size());
+    }
+    if (!parts.resourceInstance.empty()) {
+        resource->set_instance(parts.resourceInstance.data(), parts.resourceInstance.size());
+    }
+    if (!parts.resourceMessage.empty()) {
+        resource->set_message(parts.resourceMessage.data(), parts.resourceMessage.size());
+    }
+
+    return uri;
 }
 
 /**
- * Splits this string around matches of the given string delimiter.
- * Trailing empty strings are therefore not included in the resulting array.
- * @param str String to be split.
- * @param delimiter Delimiter to split the string.
- * @return Returns a vector of strings.
+ * Tokenize a long format URI in a single pass.
+ * Both '/' and '\\' separate tokens. Only the first tokens are kept, the total count
+ * still decides the shape of the URI exactly as the token vector used to.
+ * @param protocol_uri A long format uProtocol URI.
+ * @param parts Receives views into protocol_uri.
+ * @return false if the URI deserializes to an empty UUri.
  */
-auto uprotocol::uri::LongUriSerializer::split(std::string str,
-                              const std::string_view& delimiter) -> std::vector<std::string> {
-    std::vector<std::string> vec;
-    std::string token;
-    auto pos = str.find(delimiter);
-    while (std::string::npos != pos) {
-        token = str.substr(0, pos);
-        vec.push_back(token);
-        str.erase(0, pos + delimiter.length());
-        pos = str.find(delimiter);
-    }
-    vec.push_back(str);
-
-    return vec;
+auto uprotocol::uri::LongUriSerializer::parse(std::string_view protocol_uri, LongUriParts &parts) -> bool {
+    parts = LongUriParts();
+    if (protocol_uri.empty()) {
+        return false;
+    }
+
+    constexpr size_t MaxTokens = 6;
+    std::array<std::string_view, MaxTokens> tokens;
+    size_t count = 0;
+    size_t first_not_empty = SIZE_MAX;
+
+    size_t start = 0;
+    for (size_t pos = 0; pos <= protocol_uri.size(); ++pos) {
+        if (pos == protocol_uri.size() || '/' == protocol_uri[pos] || '\\' == protocol_uri[pos]) {
+            if (count < MaxTokens) {
+                tokens[count] = protocol_uri.substr(start, pos - start);
+            }
+            if (SIZE_MAX == first_not_empty && pos != start) {
+                first_not_empty = count;
+            }
+            ++count;
+            start = pos + 1;
+        }
+    }
+    if (SIZE_MAX == first_not_empty) {
+        first_not_empty = count;
+    }
+
+    constexpr auto MinimumParts = 2;
+
+    if (first_not_empty > 3 || count < MinimumParts) {
+        return false;
+    }
+
+    // remote if it starts with "//" but not with "///"
+    auto isSeparator = [&protocol_uri](size_t pos) {
+        return pos < protocol_uri.size() && ('/' == protocol_uri[pos] || '\\' == protocol_uri[pos]);
+    };
+    parts.isLocal = !(isSeparator(0) && isSeparator(1)) || isSeparator(2);
+
+    auto i = first_not_empty;
+    if (count <= i) {
+        return false;
+    }
+
+    if (parts.isLocal) {
+        auto const entity_name = tokens[i];
+        std::string_view version;
+        if (count > i + 1) {
+            version = tokens[i + 1];
+            if (count > i + 2) {
+                parseUResource(tokens[i + 2], parts);
+            }
+        }
+        if (!isBlank(entity_name)) {
+            parts.entityName = entity_name;
+        }
+        parts.entityVersion = version;
+        parseVersion(version, parts);
+
+        return !(parts.entityName.empty() && !parts.hasVersionMajor);
+    }
+
+    if (count < 3) {
+        return false;
+    }
+    if (isBlank(tokens[i])) {
+        UP_LOG_ERROR("UAuthority name is blank. Ignoring setName()");
+        return false;
+    }
+    parts.authority = tokens[i];
+
+    if (count > 3) {
+        // the remote entity name always follows the authority
+        auto const entity_name = tokens[i + 1];
+        if (!entity_name.empty()) {
+            std::string_view version;
+            if (count > 4) {
+                version = tokens[4];
+            }
+            if (!isBlank(entity_name)) {
+                parts.entityName = entity_name;
+            }
+            parts.entityVersion = version;
+            parseVersion(version, parts);
+        }
+        if (count > 5) {
+            parseUResource(tokens[5], parts);
+        }
+    }
+
+    return true;
 }
 
 /**
@@ -208,128 +424,109 @@ auto uprotocol::uri::LongUriSerializer::buildAuthorityPartOfUri(const v1::UAutho
 }
 
 /**
- * Static method for creating a UResource using a string that contains
- * name + instance + message.
- * @param resourceString String that contains the UResource information.
- * @return Returns a UResource object.
+ * Split the resource token into name + instance + message.
+ * The name and instance are separated by the first '.', the message follows the first '#'
+ * up to an optional second '#'.
+ * @param resource_string String that contains the UResource information.
+ * @param parts Receives the resource views.
  */
-auto uprotocol::uri::LongUriSerializer::parseUResource(const std::string& resource_string) -> v1::UResource {
+auto uprotocol::uri::LongUriSerializer::parseUResource(std::string_view resource_string, LongUriParts &parts) -> void {
     if (resource_string.empty()) {
-        return BuildUResource().build();
+        return;
     }
-    auto parts = split(resource_string, "#");
 
-    auto builder = BuildUResource();
-    
-    auto pos = parts[0].find('.');
-    if (std::string::npos == pos) {
-        builder.setName(parts[0]);
-    } else {
-        if (parts[0].substr(pos + 1).empty()) {
-            spdlog::error("Invalid resource instance: {}", parts[0]);
-            return BuildUResource().build();
+    auto const hash = resource_string.find('#');
+    auto const name_instance = resource_string.substr(0, hash);
+
+    std::string_view name = name_instance;
+    std::string_view instance;
+    if (auto pos = name_instance.find('.'); std::string_view::npos != pos) {
+        instance = name_instance.substr(pos + 1);
+        if (instance.empty()) {
+            UP_LOG_ERROR("Invalid resource instance: {}", name_instance);
+            return;
         }
-        builder.setName(parts[0].substr(0, pos)).setInstance(parts[0].substr(pos + 1));
+        name = name_instance.substr(0, pos);
+    }
+
+    if (!isBlank(name)) {
+        parts.resourceName = name;
     }
-    if (parts.size() > 1) {
-        builder.setMessage(parts[1]);
+    if (!isBlank(instance)) {
+        parts.resourceInstance = instance;
+    }
+    if (std::string_view::npos != hash) {
+        auto message = resource_string.substr(hash + 1);
+        message = message.substr(0, message.find('#'));
+        if (!isBlank(message)) {
+            parts.resourceMessage = message;
+        }
     }
-    return builder.build();
 }
 
 /**
- * Static method for creating a UEntity using a string that contains
- * name and version.
- * @param entity String that contains the UEntity name.
+ * Parse the version token; "2" sets the major version, "2.7" major and minor.
+ * A negative version without minor part is ignored, as in BuildUEntity::setVersion().
  * @param version String that contains the UEntity version.
- * @return Returns a UEntity object.
+ * @param parts Receives the version numbers.
  */
-auto uprotocol::uri::LongUriSerializer::parseUEntity(const std::string &entity, const std::string &version) -> v1::UEntity {
-    if (0 == entity.length()) {
-        return BuildUEntity().build();
+auto uprotocol::uri::LongUriSerializer::parseVersion(std::string_view version, LongUriParts &parts) -> void {
+    if (version.empty()) {
+        return;
+    }
+    if (auto pos = version.find('.'); std::string_view::npos == pos) {
+        auto ver = toInt(version);
+        if (ver < 0) {
+            return;
+        }
+        parts.hasVersionMajor = true;
+        parts.versionMajor = static_cast<uint32_t>(ver);
+    } else {
+        auto major = toInt(version.substr(0, pos));
+        auto minor = toInt(version.substr(pos + 1));
+        parts.hasVersionMajor = true;
+        parts.versionMajor = static_cast<uint32_t>(major);
+        parts.hasVersionMinor = true;
+        parts.versionMinor = static_cast<uint32_t>(minor);
     }
-    
-    return BuildUEntity().setName(entity).setVersion(version).build();
 }
 
 /**
- * Static method for creating a UUri using a vector of strings that contains
- * the Local UUri information.
- * @param uriParts Vector of strings that contains the Local UUri information.
- * @return Returns a UUri object.
+ * std::stoi on a string_view: skips leading white spaces, accepts a sign and parses
+ * the leading decimal digits.
+ * @param str String holding the number.
+ * @return Returns the parsed number.
  */
-auto uprotocol::uri::LongUriSerializer::parseLocalUUri(const std::vector<std::string>& uri_parts) -> v1::UUri {
-    std::string entity_name;
-    std::string version;
-    auto u_resource = BuildUResource().build() ;
-    auto number_of_parts_in_uri = uri_parts.size();
-
-    if (number_of_parts_in_uri < 2) {
-        return BuildUUri().build();
+auto uprotocol::uri::LongUriSerializer::toInt(std::string_view str) -> int {
+    size_t pos = 0;
+    while (pos < str.size() && std::isspace(static_cast<unsigned char>(str[pos]))) {
+        ++pos;
     }
-    uint64_t i = 0;
-    for (; i < number_of_parts_in_uri; i++) {
-        if (!uri_parts[i].empty()) {
-            break;
-        }
-    }
-    if (number_of_parts_in_uri <= i) {
-        return BuildUUri().build();
-    }
-    
-    entity_name = uri_parts[i];
-    if (number_of_parts_in_uri > i + 1) {
-        version = uri_parts[i + 1];
-        if (number_of_parts_in_uri > i + 2) {
-            u_resource = parseUResource(uri_parts[i + 2]);
-        }
-    }
-    auto entity = parseUEntity(entity_name, version);
-    if (isEmpty(entity)) {
-        return BuildUUri().build();
-    }
-    return BuildUUri().setAutority(BuildUAuthority().build()).setEntity(entity).setResource(u_resource).build();
-}
 
-/**
- * Static method for creating a UUri using a vector of strings that contains
- * the Remote UUri information.
- * @param uriParts Vector of strings that contains the Remote UUri information.
- * @return Returns a UUri object.
-*/
-auto uprotocol::uri::LongUriSerializer::parseRemoteUUri(const std::vector<std::string>& uri_parts) -> v1::UUri {
-    std::string entity_name;
-    auto number_of_parts_in_uri = uri_parts.size();
-
-    if (number_of_parts_in_uri < 3) {
-        return BuildUUri().build();
+    bool negative = false;
+    if (pos < str.size() && ('+' == str[pos] || '-' == str[pos])) {
+        negative = ('-' == str[pos]);
+        ++pos;
     }
-    uint64_t i = 0;
-    for (; i < number_of_parts_in_uri; i++) {
-        if (!uri_parts[i].empty()) {
-            break;
+
+    // std::stoi stops at an embedded null character, as strtol does
+    const long long limit = negative ? -static_cast<long long>(INT_MIN) : INT_MAX;
+    long long value = 0;
+    size_t digits = 0;
+    bool overflow = false;
+    for (; pos < str.size() && std::isdigit(static_cast<unsigned char>(str[pos])); ++pos, ++digits) {
+        if (!overflow) {
+            value = value * 10 + (str[pos] - '0');
+            overflow = value > limit;
         }
     }
-    if (number_of_parts_in_uri <= i) {
-        return BuildUUri().build();
-    }
-    auto authority = BuildUAuthority().setName(uri_parts[i]).build();
-    if (isEmpty(authority)) {
-        return BuildUUri().build();
+
+    if (0 == digits) {
+        throw std::invalid_argument("stoi");
     }
-    
-    if (uri_parts.size() > 3) {
-        std::string version;
-        ++i;
-        entity_name = uri_parts[i];
-        if (number_of_parts_in_uri > 4) {
-            version = uri_parts[4];
-        }
-        auto entity = parseUEntity(entity_name, version);
-        auto resource = number_of_parts_in_uri > 5 ? parseUResource(uri_parts[5]) : BuildUResource().build();
-    
-        return BuildUUri().setAutority(authority).setEntity(entity).setResource(resource).build();
-    } else {
-        return BuildUUri().setAutority(authority).setEntity(BuildUEntity().build()).setResource(BuildUResource().build()).build();
+    if (overflow) {
+        throw std::out_of_range("stoi");
     }
+
+    return static_cast<int>(negative ? -value : value);
 }
@@ -23,28 +23,44 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#include <optional>
-#include <variant>
+#include <array>
+#include <cstring>
 #include <up-cpp/uri/serializer/MicroUriSerializer.h>
 #include <up-cpp/uri/tools/IpAddress.h>
+#include <up-cpp/uri/tools/UriKey.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/Metrics.h>
 
 using uprotocol::uri::IpAddress;
 using namespace uprotocol::uri;
+using uprotocol::utils::metrics::SerializerMetrics;
+
+static const SerializerMetrics& serializeMetrics() {
+    static const auto metrics = SerializerMetrics::of("micro_uri", "serialize");
+    return metrics;
+}
+
+static const SerializerMetrics& deserializeMetrics() {
+    static const auto metrics = SerializerMetrics::of("micro_uri", "deserialize");
+    return metrics;
+}
 
 /**
  * Static method for creating a remote authority supporting the micro serialization information representation of a UUri.<br>
  * using ID
- * @param id_vec
+ * @param id_bytes ID_LEN field followed by the ID
+ * @param size
  * @return
  */
-[[nodiscard]] static auto createMicroRemoteWithId(const std::vector<uint8_t> &id_vec) -> uprotocol::v1::UAuthority {
-    auto id = std::string(id_vec.begin() + 1, id_vec.end());
+[[nodiscard]] static auto createMicroRemoteWithId(const uint8_t* id_bytes, std::size_t size) -> uprotocol::v1::UAuthority {
+    auto id = std::string_view(reinterpret_cast<const char*>(id_bytes) + 1, size - 1);
     if (isBlank(id)) {
-        spdlog::error("Id is blank");
+        UP_LOG_ERROR("Id is blank");
         return uprotocol::uri::BuildUAuthority().build();
     }
 
-    auto authority = uprotocol::uri::BuildUAuthority().setId(id).build();
+    uprotocol::v1::UAuthority authority;
+    authority.set_id(id.data(), id.size());
     return authority;
 }
 
@@ -54,109 +70,132 @@ using namespace uprotocol::uri;
  * @return Returns a vector<uint8_t> representing the serialized UUri.
  */
 auto MicroUriSerializer::serialize(const uprotocol::v1::UUri& u_uri) -> std::vector<uint8_t> {
-    if (isEmpty(u_uri) || !isMicroForm(u_uri)) {
-        spdlog::error("micro uri cannot be serialized : isEmpty=={} isMicroForm=={}",
-                isEmpty(u_uri), isMicroForm(u_uri));
-        return std::vector<uint8_t>();
+    std::array<uint8_t, MaxMicroUriLength> buffer;
+    auto size = serialize(u_uri, buffer.data(), buffer.size());
+
+    return std::vector<uint8_t>(buffer.begin(), buffer.begin() + size);
+}
+
+/**
+ * Serialize a UUri into a caller provided buffer following the Micro-URI specifications.
+ * @param u_uri The UUri data object.
+ * @param buffer destination of the serialized UUri.
+ * @param size size of buffer in bytes.
+ * @return Returns the number of bytes written, 0 on error.
+ */
+auto MicroUriSerializer::serialize(const uprotocol::v1::UUri& u_uri,
+                                   uint8_t* buffer,
+                                   std::size_t size) -> std::size_t {
+    const auto result = trySerialize(u_uri, buffer, size);
+    if (!result) {
+        UP_LOG_ERROR("micro uri cannot be serialized : {}", toString(result.error()));
+        return 0;
     }
 
-    std::vector<uint8_t> uri;
+    return *result;
+}
 
-    // UP_VERSION
-    uri.push_back(UpVersion);
+/**
+ * Serialize a UUri into a caller provided buffer, without logging.
+ * @param u_uri The UUri data object.
+ * @param buffer destination of the serialized UUri.
+ * @param size size of buffer in bytes.
+ * @return Returns the number of bytes written or why the UUri cannot be serialized.
+ */
+auto MicroUriSerializer::trySerialize(const uprotocol::v1::UUri& u_uri,
+                                      uint8_t* buffer,
+                                      std::size_t size) -> uprotocol::utils::Expected<std::size_t, UriError> {
+    if constexpr (uprotocol::utils::metrics::Enabled) {
+        serializeMetrics().calls.add();
+    }
+    const auto fail = [](UriError error) {
+        if constexpr (uprotocol::utils::metrics::Enabled) {
+            serializeMetrics().failures.add();
+        }
+        return uprotocol::utils::makeUnexpected(error);
+    };
 
-    // Gets {AuthorityType, Bytes} for the given authority
-    const auto authority = serialize(u_uri.authority());
-    auto& authority_type = authority.first;
-    auto& authority_bytes = authority.second;
+    // classify the URI once
+    const auto key = UriKey::of(u_uri);
+    if (key.isEmpty()) {
+        return fail(UriError::Empty);
+    }
+    if (!key.isMicroForm()) {
+        return fail(UriError::NotMicroForm);
+    }
 
-    if (AuthorityType::Invalid == authority_type) {
-        return {};
+    const auto& u_auth = u_uri.authority();
+    const auto authority_type = getAuthorityType(u_auth);
+
+    std::size_t length;
+    switch (authority_type) {
+        case AuthorityType::Local:
+            length = LocalMicroUriLength;
+            break;
+        case AuthorityType::IpV4:
+        case AuthorityType::IpV6:
+            length = MicroUriHeaderLength + u_auth.ip().size();
+            break;
+        case AuthorityType::Id:
+            length = MicroUriHeaderLength + UAuthorityIdLenSize + u_auth.id().size();
+            break;
+        case AuthorityType::Invalid:
+        default:
+            return fail(UriError::InvalidAuthorityType);
+    }
+
+    if ((nullptr == buffer) || (size < length)) {
+        return fail(UriError::BufferTooSmall);
     }
 
-    uri.push_back(static_cast<uint8_t>(authority_type));
+    // UP_VERSION
+    buffer[0] = UpVersion;
+
+    // AUTHORITY_TYPE
+    buffer[1] = static_cast<uint8_t>(authority_type);
 
     // URESOURCE_ID
     auto resource_id = u_uri.resource().id();
-    uri.push_back(static_cast<uint8_t>(resource_id >> 8)); // 8 msb bits
-    uri.push_back(static_cast<uint8_t>(resource_id & 0xFF)); // 8 lsb bits
+    buffer[ResourceIdPosition] = static_cast<uint8_t>(resource_id >> 8); // 8 msb bits
+    buffer[ResourceIdPosition + 1] = static_cast<uint8_t>(resource_id & 0xFF); // 8 lsb bits
 
     // UENTITY_ID
     auto entity_id = u_uri.entity().id();
-    uri.push_back(static_cast<uint8_t>(entity_id >> 8)); // 8 msb bits
-    uri.push_back(static_cast<uint8_t>(entity_id & 0xFF)); // 8 lsb bits
+    buffer[EntityIdStartPosition] = static_cast<uint8_t>(entity_id >> 8); // 8 msb bits
+    buffer[EntityIdStartPosition + 1] = static_cast<uint8_t>(entity_id & 0xFF); // 8 lsb bits
 
-    // UENTITY_VERSION
-    decltype(u_uri.entity().version_major()) version = 0;
-    if (u_uri.entity().has_version_major()) {
-        version = u_uri.entity().version_major();
-    }
-    // TODO - I cannot for the life of me figure out what this is intended to
-    //        do here. I *think* the goal is to put a 0 if the version is
-    //        outside the range representable by uint8_t, but I can't see how
-    //        that actually works.
-    auto version_string = std::to_string(version);
-    uri.push_back(version_string.empty() ? 0 : static_cast<unsigned char>(std::stoi(version_string)));
+    // UENTITY_VERSION - only the low 8 bits of the major version are carried
+    buffer[UeVersionPosition] = u_uri.entity().has_version_major()
+        ? static_cast<uint8_t>(u_uri.entity().version_major())
+        : 0;
 
     // UNUSED
-    uri.push_back(0);
+    buffer[UeVersionPosition + 1] = 0;
 
     // UAUTHORITY_ADDRESS
-    // Skip address if local authority
-    if (AuthorityType::Local == authority_type) {
-        return uri;
+    if (AuthorityType::IpV4 == authority_type || AuthorityType::IpV6 == authority_type) {
+        std::memcpy(buffer + AuthorityStartPosition, u_auth.ip().data(), u_auth.ip().size());
+    } else if (AuthorityType::Id == authority_type) {
+        buffer[IdLengthPosition] = static_cast<uint8_t>(u_auth.id().size());
+        std::memcpy(buffer + IdLengthPosition + UAuthorityIdLenSize, u_auth.id().data(), u_auth.id().size());
     }
 
-    // not local, then append the serialized address
-    uri.insert(uri.end(), authority_bytes.begin(), authority_bytes.end());
-
-    return uri;
+    return length;
 }
 
 auto MicroUriSerializer::serialize(const uprotocol::v1::UAuthority& u_auth) -> std::pair<AuthorityType, std::vector<uint8_t>> {
-    // TYPE (and address for later)
-    // Address either
-    //     a) contains no value, representing a local URI
-    //     b) contains an IpAddress, representing IPv4 or IPv6 remote URI
-    //     c) contains a string, representing an ID remote URI
-    std::optional<std::variant<IpAddress, std::string>> address;
-    if (u_auth.has_ip()) {
-        address = IpAddress(u_auth);
-    } else if (u_auth.has_id()) {
-        address = u_auth.id();
-    }
-
-    AuthorityType authority_type = AuthorityType::Invalid;
-    if (address && std::holds_alternative<IpAddress>(*address)) {
-        auto& ip_address = std::get<IpAddress>(*address);
-        if (auto type = ip_address.getType(); type == IpAddress::Type::IpV4) {
-            authority_type = AuthorityType::IpV4;
-        } else if (type == IpAddress::Type::IpV6) {
-            authority_type = AuthorityType::IpV6;
-        }
-    } else if (address && std::holds_alternative<std::string>(*address)) {
-        if (auto& id = std::get<std::string>(*address);
-                id.size() >= UAuthorityIdMinLength && id.size() <= UAuthorityIdMaxLength) {
-            authority_type = AuthorityType::Id;
-        }
-    } else if (!address) {
-        authority_type = AuthorityType::Local;
-    }
+    const auto authority_type = getAuthorityType(u_auth);
 
     std::vector<uint8_t> authority;
 
     if (authority_type == AuthorityType::Invalid) {
-        spdlog::error("micro uri authority type is Invalid : {}", static_cast<int>(authority_type));
+        UP_LOG_ERROR("micro uri authority type is Invalid : {}", static_cast<int>(authority_type));
+    } else if (AuthorityType::Id == authority_type) {
+        authority.reserve(UAuthorityIdLenSize + u_auth.id().size());
+        authority.push_back(static_cast<uint8_t>(u_auth.id().size()));
+        authority.insert(authority.end(), u_auth.id().begin(), u_auth.id().end());
     } else if (AuthorityType::Local != authority_type) {
-        // not local, then it is a remote address with either IP or ID
-        if (std::holds_alternative<IpAddress>(*address)) {
-            auto ipBytes = std::get<IpAddress>(*address).getBytes();
-            authority.insert(authority.end(), ipBytes.begin(), ipBytes.end());
-        } else if (std::holds_alternative<std::string>(*address)) {
-            auto& idString = std::get<std::string>(*address);
-            authority.push_back(static_cast<uint8_t>(idString.size()));
-            authority.insert(authority.end(), idString.begin(), idString.end());
-        }
+        authority.assign(u_auth.ip().begin(), u_auth.ip().end());
     }
 
     return {authority_type, authority};
@@ -168,34 +207,79 @@ auto MicroUriSerializer::serialize(const uprotocol::v1::UAuthority& u_auth) -> s
  * @return Returns an UUri data object from the serialized format of a microUri.
  */
 auto MicroUriSerializer::deserialize(std::vector<uint8_t> const& micro_uri) -> uprotocol::v1::UUri {
-    if (micro_uri.empty() || micro_uri.size() < LocalMicroUriLength) {
+    return deserialize(micro_uri.data(), micro_uri.size());
+}
+
+/**
+ * Deserialize a micro URI held in a caller provided buffer into a UUri object.
+ * @param micro_uri pointer to the uProtocol micro URI bytes.
+ * @param size number of bytes in micro_uri.
+ * @return Returns an UUri data object from the serialized format of a microUri.
+ */
+auto MicroUriSerializer::deserialize(const uint8_t* micro_uri, std::size_t size) -> uprotocol::v1::UUri {
+    auto result = tryDeserialize(micro_uri, size);
+    if (!result) {
+        if (UriError::Empty != result.error()) {
+            UP_LOG_ERROR("micro uri of {} bytes cannot be deserialized : {}", size, toString(result.error()));
+        }
         return BuildUUri().build();
     }
+
+    return std::move(result).value();
+}
+
+/**
+ * Deserialize a vector<uint8_t> into a UUri object, without logging.
+ * @param micro_uri A vector<uint8_t> uProtocol micro URI.
+ * @return Returns the UUri or why the micro URI does not deserialize.
+ */
+auto MicroUriSerializer::tryDeserialize(std::vector<uint8_t> const& micro_uri)
+        -> uprotocol::utils::Expected<uprotocol::v1::UUri, UriError> {
+    return tryDeserialize(micro_uri.data(), micro_uri.size());
+}
+
+/**
+ * Deserialize a micro URI held in a caller provided buffer into a UUri object, without logging.
+ * @param micro_uri pointer to the uProtocol micro URI bytes.
+ * @param size number of bytes in micro_uri.
+ * @return Returns the UUri or why the micro URI does not deserialize.
+ */
+auto MicroUriSerializer::tryDeserialize(const uint8_t* micro_uri, std::size_t size)
+        -> uprotocol::utils::Expected<uprotocol::v1::UUri, UriError> {
+    if constexpr (uprotocol::utils::metrics::Enabled) {
+        deserializeMetrics().calls.add();
+    }
+    const auto fail = [](UriError error) {
+        if constexpr (uprotocol::utils::metrics::Enabled) {
+            deserializeMetrics().failures.add();
+        }
+        return uprotocol::utils::makeUnexpected(error);
+    };
+
+    if (nullptr == micro_uri || 0 == size) {
+        return fail(UriError::Empty);
+    }
+    if (size < LocalMicroUriLength) {
+        return fail(UriError::InvalidLength);
+    }
     if (micro_uri[0] != UpVersion) {
-        spdlog::error("micro uri version is not Valid : {}", micro_uri[0]);
-        return BuildUUri().build();
+        return fail(UriError::InvalidVersion);
     }
 
     // AUTHORITY_TYPE
     auto authority_type = getAuthorityType(micro_uri[1]);
     if (AuthorityType::Invalid == authority_type) {
-        return BuildUUri().build();
-    } else if (!checkMicroUriSize(micro_uri.size(), authority_type)) {
-        return BuildUUri().build();
+        return fail(UriError::InvalidAuthorityType);
+    } else if (!checkMicroUriSize(size, authority_type)) {
+        return fail(UriError::InvalidLength);
     } else if (AuthorityType::Id == authority_type) {
         auto const expected_id_size = micro_uri[IdLengthPosition];
-        auto const actual_id_size = micro_uri.size() - MicroUriHeaderLength - UAuthorityIdLenSize;
+        auto const actual_id_size = size - MicroUriHeaderLength - UAuthorityIdLenSize;
         if (expected_id_size != actual_id_size) {
-            spdlog::error("micro uri ID_LEN field ({}) does not match received ID length ({})",
-                    expected_id_size, actual_id_size);
-            return BuildUUri().build();
+            return fail(UriError::IdLengthMismatch);
         }
     }
 
-    // UAUTORITY_ADDRESS
-    std::vector<uint8_t> authority_bytes(micro_uri.begin() + AuthorityStartPosition, micro_uri.end());
-    auto u_authority = getUauthority(authority_bytes, authority_type);
-
     // UENTITY_ID
     auto entity_id = (static_cast<uint16_t>(micro_uri[EntityIdStartPosition]) << 8) | micro_uri[EntityIdStartPosition + 1];
 
@@ -205,15 +289,28 @@ auto MicroUriSerializer::deserialize(std::vector<uint8_t> const& micro_uri) -> u
     // URESOURCE_ID
     auto resource_id = (static_cast<uint16_t>(micro_uri[ResourceIdPosition]) << 8) | (micro_uri[ResourceIdPosition + 1]);
 
-    return BuildUUri().setAutority(u_authority).
-                       setEntity(BuildUEntity().
-                                 setId(entity_id).
-                                 setMajorVersion(major_version).
-                                 build()).
-                       setResource(BuildUResource().
-                                   setID(resource_id).
-                                   build()).
-                       build();
+    // fill the UUri in place, with the same presence rules as the builders
+    uprotocol::v1::UUri u_uri;
+
+    // UAUTORITY_ADDRESS
+    *u_uri.mutable_authority() = getUauthority(micro_uri + AuthorityStartPosition,
+                                               size - AuthorityStartPosition,
+                                               authority_type);
+
+    auto* entity = u_uri.mutable_entity();
+    if (0 != entity_id) {
+        entity->set_id(entity_id);
+    }
+    entity->set_version_major(major_version);
+
+    auto* resource = u_uri.mutable_resource();
+    if (0 != resource_id) {
+        resource->set_id(resource_id);
+    } else {
+        UP_LOG_ERROR("UResource id cannot be 0");
+    }
+
+    return u_uri;
 }
 
 /**
@@ -224,13 +321,13 @@ auto MicroUriSerializer::deserialize(std::vector<uint8_t> const& micro_uri) -> u
 [[maybe_unused]] auto MicroUriSerializer::printIp(std::vector<uint8_t> ip) {
     std::string s;
     if (ip.empty()) {
-        spdlog::info("Serialized IP is empty");
+        UP_LOG_INFO("Serialized IP is empty");
         return;
     }
     for (unsigned char i : ip) {
         s += std::to_string(i) + " ";
     }
-    spdlog::info("Serialized IP: {}", s);
+    UP_LOG_INFO("Serialized IP: {}", s);
 }
 
 /**
@@ -249,7 +346,6 @@ auto MicroUriSerializer::getAuthorityType(uint8_t type) -> AuthorityType {
         // Per spec, any value above AuthorityType::Id is equally invalid
         case AuthorityType::Invalid:
         default:
-            spdlog::error("micro uri authority type {} is not supported", type);
             return AuthorityType::Invalid;
     }
 }
@@ -280,38 +376,58 @@ auto MicroUriSerializer::checkMicroUriSize(std::size_t const size, AuthorityType
         case AuthorityType::Id:
             if (size >= IdMicroUriMinLength && size <= IdMicroUriMaxLength) {
                 return true;
-            } else {
-                spdlog::error("ID micro uri length {} outside supported range [{}, {}]",
-                        size, IdMicroUriMinLength, IdMicroUriMaxLength);
-                return false;
             }
             break;
         case AuthorityType::Invalid:
             break;
     }
-    spdlog::error("micro uri length {} for type {} is not supported", size,
-            static_cast<size_t>(type));
     return false;
 }
 
+/**
+ * get AuthorityType a UAuthority serializes to
+ * @param u_auth
+ * @return AuthorityType
+ */
+auto MicroUriSerializer::getAuthorityType(const uprotocol::v1::UAuthority& u_auth) -> AuthorityType {
+    // Address either
+    //     a) contains no value, representing a local URI
+    //     b) contains IP bytes, representing IPv4 or IPv6 remote URI
+    //     c) contains a string, representing an ID remote URI
+    if (u_auth.has_ip()) {
+        if (IpAddress::IpV4AddressBytes == u_auth.ip().size()) {
+            return AuthorityType::IpV4;
+        } else if (IpAddress::IpV6AddressBytes == u_auth.ip().size()) {
+            return AuthorityType::IpV6;
+        }
+        return AuthorityType::Invalid;
+    } else if (u_auth.has_id()) {
+        if (u_auth.id().size() >= UAuthorityIdMinLength && u_auth.id().size() <= UAuthorityIdMaxLength) {
+            return AuthorityType::Id;
+        }
+        return AuthorityType::Invalid;
+    }
+
+    return AuthorityType::Local;
+}
+
 /**
  * get UAuthority from IP address or ID
- * @param addr vector that containes either IP address or ID
- * @param type AuthorityType type of the passed authority vector
+ * @param addr buffer that containes either IP address or ID
+ * @param size number of bytes in addr
+ * @param type AuthorityType type of the passed authority buffer
  * @return uprotocol::v1::UAuthority. If the address is empty or illegal, then it returns an empty UAuthority.
  */
-auto MicroUriSerializer::getUauthority(const std::vector<uint8_t> &addr, AuthorityType type) -> uprotocol::v1::UAuthority {
+auto MicroUriSerializer::getUauthority(const uint8_t* addr, std::size_t size, AuthorityType type) -> uprotocol::v1::UAuthority {
     switch (type) {
-        case AuthorityType::IpV4: {
-            IpAddress ip_address(addr, IpAddress::Type::IpV4);
-            return uprotocol::uri::BuildUAuthority().setIp(ip_address).build();
-        }
+        case AuthorityType::IpV4:
         case AuthorityType::IpV6: {
-            IpAddress ip_address(addr, IpAddress::Type::IpV6);
-            return uprotocol::uri::BuildUAuthority().setIp(ip_address).build();
+            uprotocol::v1::UAuthority authority;
+            authority.set_ip(reinterpret_cast<const char*>(addr), size);
+            return authority;
         }
         case AuthorityType::Id: {
-            return createMicroRemoteWithId(addr);
+            return createMicroRemoteWithId(addr, size);
         }
         default:
             return BuildUAuthority().build();
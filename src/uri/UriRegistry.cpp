@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <type_traits>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+#include <up-cpp/uri/serializer/UriRegistry.h>
+#include <up-cpp/uri/tools/UriHash.h>
+#include <up-cpp/uri/tools/Utils.h>
+
+using namespace uprotocol::uri;
+
+UriRegistry::UriRegistry(std::size_t capacity)
+    : shardCapacity_((capacity + Shards - 1) / Shards == 0 ? 1 : (capacity + Shards - 1) / Shards) {
+}
+
+/**
+ * Look up (or parse and intern) a long format URI.
+ * @param long_uri A long format uProtocol URI.
+ * @return Returns the entry, nullptr if the URI deserializes to an empty UUri.
+ */
+auto UriRegistry::fromLong(std::string_view long_uri) -> EntryPtr {
+    if (auto entry = find(longIndex_, long_uri)) {
+        return entry;
+    }
+
+    auto uri = LongUriSerializer::deserialize(long_uri);
+    if (isEmpty(uri)) {
+        return nullptr;
+    }
+
+    auto entry = makeEntry(std::move(uri));
+    insertAll(entry);
+    // also remember the spelling we were asked for if it is not the canonical one
+    if (long_uri != entry->longUri) {
+        insert(longIndex_, long_uri, entry);
+    }
+
+    return entry;
+}
+
+/**
+ * Look up (or parse and intern) a micro format URI.
+ * @param micro_uri pointer to the micro URI bytes.
+ * @param size number of bytes in micro_uri.
+ * @return Returns the entry, nullptr if the URI deserializes to an empty UUri.
+ */
+auto UriRegistry::fromMicro(const uint8_t* micro_uri, std::size_t size) -> EntryPtr {
+    const std::string_view micro_key(reinterpret_cast<const char*>(micro_uri), (nullptr == micro_uri) ? 0 : size);
+    if (auto entry = find(microIndex_, micro_key)) {
+        return entry;
+    }
+
+    auto uri = MicroUriSerializer::deserialize(micro_uri, size);
+    if (isEmpty(uri)) {
+        return nullptr;
+    }
+
+    auto entry = makeEntry(std::move(uri));
+    insertAll(entry);
+
+    return entry;
+}
+
+/**
+ * Look up (or rebuild and intern) a UUri from its packed key.
+ * @param key packed key as returned by packKey().
+ * @return Returns the entry, nullptr if key is 0.
+ */
+auto UriRegistry::fromKey(uint64_t key) -> EntryPtr {
+    if (0 == key) {
+        return nullptr;
+    }
+    if (auto entry = find(keyIndex_, key)) {
+        return entry;
+    }
+
+    auto entry = makeEntry(unpackKey(key));
+    insertAll(entry);
+
+    return entry;
+}
+
+/**
+ * Intern a UUri, indexed by every form it can be serialized to.
+ * @param uri the UUri to intern.
+ * @return Returns the entry, nullptr if uri is empty.
+ */
+auto UriRegistry::intern(const v1::UUri& uri) -> EntryPtr {
+    if (isEmpty(uri)) {
+        return nullptr;
+    }
+
+    if (auto key = packKey(uri); 0 != key) {
+        if (auto entry = find(keyIndex_, key)) {
+            return entry;
+        }
+    } else if (auto entry = find(longIndex_, std::string_view(LongUriSerializer::serialize(uri)))) {
+        return entry;
+    }
+
+    auto entry = makeEntry(v1::UUri(uri));
+    insertAll(entry);
+
+    return entry;
+}
+
+/**
+ * Pack a local micro form UUri into a 64 bit key.
+ * @param uri the UUri to pack.
+ * @return Returns the key, 0 if the UUri is not a local micro form UUri.
+ */
+auto UriRegistry::packKey(const v1::UUri& uri) -> uint64_t {
+    if (!isEmpty(uri.authority()) || !isMicroForm(uri.entity()) || !isMicroForm(uri.resource()) ||
+            uri.entity().id() > UINT16_MAX || uri.resource().id() > UINT16_MAX) {
+        return 0;
+    }
+
+    const uint64_t version = uri.entity().has_version_major() ? (uri.entity().version_major() & 0xFF) : 0;
+
+    return static_cast<uint64_t>(uri.resource().id()) |
+           (static_cast<uint64_t>(uri.entity().id()) << 16) |
+           (version << 32) |
+           (static_cast<uint64_t>(AuthorityType::Local) << 40);
+}
+
+/**
+ * Rebuild the UUri described by a packed key, the same way a local micro URI is deserialized.
+ * @param key packed key as returned by packKey().
+ * @return Returns the UUri, empty if key is 0.
+ */
+auto UriRegistry::unpackKey(uint64_t key) -> v1::UUri {
+    v1::UUri uri;
+    if (0 == key) {
+        return uri;
+    }
+
+    uri.mutable_authority();
+    const auto entity_id = static_cast<uint32_t>((key >> 16) & 0xFFFF);
+    const auto resource_id = static_cast<uint32_t>(key & 0xFFFF);
+    if (0 != entity_id) {
+        uri.mutable_entity()->set_id(entity_id);
+    }
+    uri.mutable_entity()->set_version_major(static_cast<uint32_t>((key >> 32) & 0xFF));
+    if (0 != resource_id) {
+        uri.mutable_resource()->set_id(resource_id);
+    } else {
+        uri.mutable_resource();
+    }
+
+    return uri;
+}
+
+auto UriRegistry::size() const -> std::size_t {
+    std::size_t total = 0;
+    auto count = [&total](const auto& index) {
+        for (const auto& shard : index) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.lru.size();
+        }
+    };
+    count(longIndex_);
+    count(microIndex_);
+    count(keyIndex_);
+
+    return total;
+}
+
+void UriRegistry::clear() {
+    auto reset = [](auto& index) {
+        for (auto& shard : index) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.clear();
+            shard.lru.clear();
+        }
+    };
+    reset(longIndex_);
+    reset(microIndex_);
+    reset(keyIndex_);
+}
+
+template<typename Key>
+auto UriRegistry::shardOf(Index<Key>& index, const Key& key) -> Shard<Key>& {
+    // fibonacci hashing spreads keys whose low bits are similar (e.g. resource ids)
+    const uint64_t hash = static_cast<uint64_t>(std::hash<Key>{}(key)) * 0x9E3779B97F4A7C15ULL;
+    return index[hash >> 60];
+}
+
+template<typename Key>
+auto UriRegistry::find(Index<Key>& index, const Key& key) -> EntryPtr {
+    auto& shard = shardOf(index, key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (shard.index.end() == it) {
+        return nullptr;
+    }
+    // most recently used entries live at the front
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+
+    return it->second->entry;
+}
+
+template<typename Key>
+void UriRegistry::insert(Index<Key>& index, const Key& key, const EntryPtr& entry) {
+    auto& shard = shardOf(index, key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (auto it = shard.index.find(key); shard.index.end() != it) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+
+    shard.lru.emplace_front();
+    auto& node = shard.lru.front();
+    if constexpr (std::is_same_v<Key, std::string_view>) {
+        node.storage.assign(key.data(), key.size());
+        node.key = node.storage;
+    } else {
+        node.key = key;
+    }
+    node.entry = entry;
+    shard.index.emplace(node.key, shard.lru.begin());
+
+    if (shard.lru.size() > shardCapacity_) {
+        shard.index.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+    }
+}
+
+auto UriRegistry::makeEntry(v1::UUri&& uri) -> EntryPtr {
+    auto entry = std::make_shared<Entry>();
+    entry->uri = std::move(uri);
+    LongUriSerializer::serialize(entry->uri, entry->longUri);
+    if (isMicroForm(entry->uri)) {
+        entry->microUri = MicroUriSerializer::serialize(entry->uri);
+    }
+    entry->key = packKey(entry->uri);
+    entry->hash = UriHash{}(entry->uri);
+
+    return entry;
+}
+
+void UriRegistry::insertAll(const EntryPtr& entry) {
+    if (!entry->longUri.empty()) {
+        insert(longIndex_, std::string_view(entry->longUri), entry);
+    }
+    if (!entry->microUri.empty()) {
+        insert(microIndex_,
+               std::string_view(reinterpret_cast<const char*>(entry->microUri.data()), entry->microUri.size()),
+               entry);
+    }
+    if (0 != entry->key) {
+        insert(keyIndex_, entry->key, entry);
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+#include <spdlog/details/registry.h>
+#include <up-cpp/utils/Log.h>
+
+namespace uprotocol::utils::log {
+
+void enableAsync(size_t queueSize) {
+    auto current = spdlog::default_logger();
+    if (nullptr != std::dynamic_pointer_cast<spdlog::async_logger>(current)) {
+        return;
+    }
+
+    spdlog::init_thread_pool((0 == queueSize) ? 1 : queueSize, 1);
+    auto async = std::make_shared<spdlog::async_logger>(current->name(),
+                                                        current->sinks().begin(),
+                                                        current->sinks().end(),
+                                                        spdlog::thread_pool(),
+                                                        spdlog::async_overflow_policy::overrun_oldest);
+    async->set_level(current->level());
+    async->flush_on(current->flush_level());
+    spdlog::set_default_logger(std::move(async));
+}
+
+void disableAsync() {
+    auto current = spdlog::default_logger();
+    if (nullptr == std::dynamic_pointer_cast<spdlog::async_logger>(current)) {
+        return;
+    }
+
+    auto sync = std::make_shared<spdlog::logger>(current->name(), current->sinks().begin(), current->sinks().end());
+    sync->set_level(current->level());
+    sync->flush_on(current->flush_level());
+    current->flush();
+    spdlog::set_default_logger(std::move(sync));
+
+    /* the thread pool writes out its queue before its thread is joined */
+    spdlog::details::registry::instance().set_tp(nullptr);
+}
+
+} // namespace uprotocol::utils::log
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstdio>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/Metrics.h>
+
+namespace uprotocol::utils::metrics {
+
+namespace {
+
+/* power of two exposition buckets for histograms, 2^8ns (256ns) to 2^36ns (~69s) */
+constexpr unsigned FirstBucketShift = 8U;
+constexpr unsigned LastBucketShift = 36U;
+
+std::string withLabels(std::string_view name, std::string_view suffix, std::string_view labels,
+                       std::string_view extra = {}) {
+    std::string line(name);
+    line.append(suffix);
+    if (!labels.empty() || !extra.empty()) {
+        line.push_back('{');
+        line.append(labels);
+        if (!labels.empty() && !extra.empty()) {
+            line.push_back(',');
+        }
+        line.append(extra);
+        line.push_back('}');
+    }
+    return line;
+}
+
+void appendSample(std::string &out, const std::string &series, const std::string &value) {
+    out.append(series);
+    out.push_back(' ');
+    out.append(value);
+    out.push_back('\n');
+}
+
+std::string seconds(uint64_t nanoseconds) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(nanoseconds) * 1e-9);
+    return buffer;
+}
+
+void appendHistogram(std::string &out, std::string_view name, std::string_view labels, const Histogram &histogram) {
+    for (auto shift = FirstBucketShift; shift <= LastBucketShift; ++shift) {
+        appendSample(out, withLabels(name, "_bucket", labels, "le=\"" + seconds(1ULL << shift) + "\""),
+                     std::to_string(histogram.countBelow(1ULL << shift)));
+    }
+    const auto count = histogram.count();
+    appendSample(out, withLabels(name, "_bucket", labels, "le=\"+Inf\""), std::to_string(count));
+    appendSample(out, withLabels(name, "_sum", labels), seconds(histogram.sum()));
+    appendSample(out, withLabels(name, "_count", labels), std::to_string(count));
+}
+
+template<typename T>
+T & lookup(std::map<std::string, std::unique_ptr<T>, std::less<>> &metrics, std::string_view labels) {
+    auto it = metrics.find(labels);
+    if (metrics.end() == it) {
+        it = metrics.emplace(std::string(labels), std::make_unique<T>()).first;
+    }
+    return *it->second;
+}
+
+template<typename T>
+const T * find(const std::map<std::string, std::unique_ptr<T>, std::less<>> &metrics, std::string_view labels) {
+    auto it = metrics.find(labels);
+    return (metrics.end() == it) ? nullptr : it->second.get();
+}
+
+} // namespace
+
+Registry & Registry::instance() {
+    /* never destroyed, components may still update their metrics during static destruction */
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+Registry::Family & Registry::family(std::string_view name, std::string_view help, Type type) {
+    auto it = families_.find(name);
+    if (families_.end() == it) {
+        it = families_.emplace(std::string(name), Family{type, std::string(help), {}, {}, {}}).first;
+    } else if (type != it->second.type) {
+        UP_LOG_ERROR("metric {} is already registered with a different type", name);
+    }
+    return it->second;
+}
+
+const Registry::Family * Registry::findFamily(std::string_view name, Type type) const {
+    auto it = families_.find(name);
+    if ((families_.end() == it) || (type != it->second.type)) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+Counter & Registry::counter(std::string_view name, std::string_view help, std::string_view labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lookup(family(name, help, Type::COUNTER).counters, labels);
+}
+
+Gauge & Registry::gauge(std::string_view name, std::string_view help, std::string_view labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lookup(family(name, help, Type::GAUGE).gauges, labels);
+}
+
+Histogram & Registry::histogram(std::string_view name, std::string_view help, std::string_view labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lookup(family(name, help, Type::HISTOGRAM).histograms, labels);
+}
+
+const Counter * Registry::findCounter(std::string_view name, std::string_view labels) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto *family = findFamily(name, Type::COUNTER);
+    return (nullptr == family) ? nullptr : find(family->counters, labels);
+}
+
+const Gauge * Registry::findGauge(std::string_view name, std::string_view labels) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto *family = findFamily(name, Type::GAUGE);
+    return (nullptr == family) ? nullptr : find(family->gauges, labels);
+}
+
+const Histogram * Registry::findHistogram(std::string_view name, std::string_view labels) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto *family = findFamily(name, Type::HISTOGRAM);
+    return (nullptr == family) ? nullptr : find(family->histograms, labels);
+}
+
+std::string Registry::scrape() const {
+    std::string out;
+    if constexpr (false == Enabled) {
+        return out;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &[name, family] : families_) {
+        out.append("# HELP ").append(name).append(" ").append(family.help).append("\n");
+        switch (family.type) {
+            case Type::COUNTER:
+                out.append("# TYPE ").append(name).append(" counter\n");
+                for (const auto &[labels, counter] : family.counters) {
+                    appendSample(out, withLabels(name, "", labels), std::to_string(counter->value()));
+                }
+                break;
+            case Type::GAUGE:
+                out.append("# TYPE ").append(name).append(" gauge\n");
+                for (const auto &[labels, gauge] : family.gauges) {
+                    appendSample(out, withLabels(name, "", labels), std::to_string(gauge->value()));
+                }
+                break;
+            case Type::HISTOGRAM:
+                out.append("# TYPE ").append(name).append(" histogram\n");
+                for (const auto &[labels, histogram] : family.histograms) {
+                    appendHistogram(out, name, labels, *histogram);
+                }
+                break;
+        }
+    }
+
+    return out;
+}
+
+} // namespace uprotocol::utils::metrics
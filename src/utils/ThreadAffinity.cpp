@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <up-cpp/utils/ThreadAffinity.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace uprotocol::utils::affinity {
+
+namespace {
+
+/* parses a sysfs CPU list such as "0-3,8,10-11" */
+std::vector<unsigned> parseCpuList(const std::string &list) {
+    std::vector<unsigned> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        auto end = list.find(',', pos);
+        if (std::string::npos == end) {
+            end = list.size();
+        }
+        unsigned first = 0;
+        unsigned last = 0;
+        const auto range = list.substr(pos, end - pos);
+        const auto fields = std::sscanf(range.c_str(), "%u-%u", &first, &last);
+        if (1 == fields) {
+            last = first;
+        }
+        if (fields >= 1) {
+            for (auto cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        pos = end + 1;
+    }
+
+    return cpus;
+}
+
+std::string readLine(const std::string &path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+unsigned numOfCpus() {
+#if defined(__linux__)
+    const auto online = parseCpuList(readLine("/sys/devices/system/cpu/online"));
+    if (false == online.empty()) {
+        return online.back() + 1;
+    }
+#endif
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+std::vector<int> cpuNodes() {
+    std::vector<int> nodes(numOfCpus(), 0);
+#if defined(__linux__)
+    const auto online = parseCpuList(readLine("/sys/devices/system/node/online"));
+    for (auto node : online) {
+        for (auto cpu : cpusOfNode(static_cast<int>(node))) {
+            if (cpu < nodes.size()) {
+                nodes[cpu] = static_cast<int>(node);
+            }
+        }
+    }
+#endif
+    return nodes;
+}
+
+std::vector<unsigned> cpusOfNode(int node) {
+#if defined(__linux__)
+    if (node >= 0) {
+        auto cpus = parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+        if ((false == cpus.empty()) || (0 != node)) {
+            return cpus;
+        }
+    }
+#endif
+    if (0 != node) {
+        return {};
+    }
+
+    /* no topology, every CPU is on node 0 */
+    std::vector<unsigned> cpus(numOfCpus());
+    for (unsigned cpu = 0; cpu < cpus.size(); ++cpu) {
+        cpus[cpu] = cpu;
+    }
+    return cpus;
+}
+
+int currentCpu() noexcept {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+bool pinCurrentThread(const std::vector<unsigned> &cpus) {
+#if defined(__linux__)
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return 0 == pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+bool nameCurrentThread(std::string_view name) {
+#if defined(__linux__)
+    /* the kernel keeps 15 characters and the terminating null */
+    const std::string truncated(name.substr(0, 15));
+    return 0 == pthread_setname_np(pthread_self(), truncated.c_str());
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+bool scheduleCurrentThread(int policy,
+                           int priority) {
+#if defined(__linux__)
+    sched_param param {};
+    param.sched_priority = priority;
+    return 0 == pthread_setschedparam(pthread_self(), policy, &param);
+#else
+    (void)policy;
+    (void)priority;
+    return false;
+#endif
+}
+
+} // namespace uprotocol::utils::affinity
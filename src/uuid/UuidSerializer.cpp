@@ -24,56 +24,236 @@
  */
 
 #include <array>
+#include <cstring>
 #include <up-cpp/uuid/serializer/UuidSerializer.h>
+#include <up-cpp/utils/Log.h>
+#include <up-cpp/utils/Metrics.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace uprotocol::uuid {
 
-std::string UuidSerializer::serializeToString(UUID uuid) {
-    std::array<uint8_t, uuidSize_> buff{};
-    std::string buff_str{};
-    uint64_t msb = uuid.msb();
-    uint64_t lsb = uuid.lsb();
-    for (int i = 0; i < 8; i++) {
-        buff[i] = ((msb >> (8 * i)) & 0XFF);
-        buff[i + 8] = ((lsb >> (8 * i)) & 0XFF);
-    }
+namespace {
+
+/* writes the 32 lower case hex digits of 16 bytes */
+void encodeHex(const uint8_t *bytes, char *hex) {
+#if defined(__SSE2__)
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+    const __m128i lo = _mm_and_si128(v, nibble);
 
+    auto toAscii = [](__m128i x) {
+        /* '0' + x, plus the distance from '9' + 1 to 'a' for the letters */
+        const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(9)),
+                                              _mm_set1_epi8('a' - '0' - 10));
+        return _mm_add_epi8(_mm_add_epi8(x, _mm_set1_epi8('0')), letters);
+    };
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hex), toAscii(_mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hex + 16), toAscii(_mm_unpackhi_epi8(hi, lo)));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const uint8_t DIGITS[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+    const uint8x16_t lut = vld1q_u8(DIGITS);
+    const uint8x16_t v = vld1q_u8(bytes);
+    const uint8x16_t hi = vshrq_n_u8(v, 4);
+    const uint8x16_t lo = vandq_u8(v, vdupq_n_u8(0x0f));
+
+    vst1q_u8(reinterpret_cast<uint8_t *>(hex), vqtbl1q_u8(lut, vzip1q_u8(hi, lo)));
+    vst1q_u8(reinterpret_cast<uint8_t *>(hex + 16), vqtbl1q_u8(lut, vzip2q_u8(hi, lo)));
+#else
     static const char DIGITS[] = "0123456789abcdef";
-    std::string str{};
-    for (int i = 0; i < uuidSize_; i++) {
-        auto e = (std::byte)buff[i];
-        auto shifted_e = (std::byte)buff[i];
-        shifted_e >>= 4;
-        str += DIGITS[(std::uint8_t)(shifted_e)];
-        str += DIGITS[(std::uint8_t)(e & (std::byte)0xf)];
-        if (i == 3 || i == 5 || i == 7 || i == 9) {
-            str += '-';
+    for (int i = 0; i < 16; i++) {
+        hex[2 * i] = DIGITS[bytes[i] >> 4];
+        hex[2 * i + 1] = DIGITS[bytes[i] & 0xf];
+    }
+#endif
+}
+
+/* parses 32 hex digits (either case) into 16 bytes, false on any other character */
+bool decodeHex(const char *hex, uint8_t *bytes) {
+#if defined(__SSE2__)
+    __m128i pairs[2];
+    for (int chunk = 0; chunk < 2; chunk++) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hex + 16 * chunk));
+        /* signed compares, so bytes >= 0x80 fail both ranges */
+        const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                              _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+        const __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                              _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        if (0xFFFF != _mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha))) {
+            return false;
+        }
+
+        const __m128i value = _mm_or_si128(
+            _mm_and_si128(isDigit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+            _mm_and_si128(isAlpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+        /* even characters are the high nibbles, they sit in the low byte of each 16 bit lane */
+        const __m128i high = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(0x00ff)), 4);
+        pairs[chunk] = _mm_or_si128(high, _mm_srli_epi16(value, 8));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes), _mm_packus_epi16(pairs[0], pairs[1]));
+    return true;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    uint8x16_t values[2];
+    for (int chunk = 0; chunk < 2; chunk++) {
+        const uint8x16_t c = vld1q_u8(reinterpret_cast<const uint8_t *>(hex + 16 * chunk));
+        /* unsigned wrap around turns both range checks into a single compare */
+        const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+        const uint8x16_t alpha = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+        const uint8x16_t isDigit = vcltq_u8(digit, vdupq_n_u8(10));
+        const uint8x16_t isAlpha = vcltq_u8(alpha, vdupq_n_u8(6));
+        if (0xFF != vminvq_u8(vorrq_u8(isDigit, isAlpha))) {
+            return false;
+        }
+        values[chunk] = vbslq_u8(isDigit, digit, vaddq_u8(alpha, vdupq_n_u8(10)));
+    }
+    const uint8x16_t high = vuzp1q_u8(values[0], values[1]);
+    const uint8x16_t low = vuzp2q_u8(values[0], values[1]);
+    vst1q_u8(bytes, vorrq_u8(vshlq_n_u8(high, 4), low));
+    return true;
+#else
+    for (int i = 0; i < 32; i++) {
+        const auto c = static_cast<uint8_t>(hex[i]);
+        /* unsigned wrap around turns both range checks into a single compare */
+        const uint8_t digit = c - '0';
+        const uint8_t alpha = (c | 0x20) - 'a';
+        uint8_t n;
+        if (digit < 10) {
+            n = digit;
+        } else if (alpha < 6) {
+            n = alpha + 10;
+        } else {
+            return false;
+        }
+        if ((i & 1) == 0) {
+            bytes[i >> 1] = n << 4;
+        } else {
+            bytes[i >> 1] |= n;
         }
     }
+    return true;
+#endif
+}
+
+using utils::metrics::SerializerMetrics;
+
+struct UuidMetrics {
+    SerializerMetrics serializeString = SerializerMetrics::of("uuid", "serialize_string");
+    SerializerMetrics deserializeString = SerializerMetrics::of("uuid", "deserialize_string");
+    SerializerMetrics serializeBytes = SerializerMetrics::of("uuid", "serialize_bytes");
+    SerializerMetrics deserializeBytes = SerializerMetrics::of("uuid", "deserialize_bytes");
+};
+
+const UuidMetrics &uuidMetrics() {
+    static const UuidMetrics metrics;
+    return metrics;
+}
+
+} // namespace
+
+std::string UuidSerializer::serializeToString(const UUID &uuid) {
+    std::string str(StringLength, '-');
+    serializeToChars(uuid, str.data());
     return str;
 }
 
-std::vector<uint8_t> UuidSerializer::serializeToBytes(UUID uuid) {
-    std::vector<std::uint8_t> byteArray(uuidSize_);
-    uint64_t msb = uuid.msb();
-    uint64_t lsb = uuid.lsb();
+void UuidSerializer::serializeToChars(const UUID &uuid,
+                                      char *out) {
+    if constexpr (utils::metrics::Enabled) {
+        uuidMetrics().serializeString.calls.add();
+    }
+    alignas(16) uint8_t bytes[uuidSize_];
+    alignas(16) char hex[2 * uuidSize_];
+    pack(uuid.msb(), uuid.lsb(), bytes);
+    encodeHex(bytes, hex);
+
+    /* dashes after bytes 3, 5, 7 and 9 */
+    std::memcpy(out, hex, 8);
+    out[8] = '-';
+    std::memcpy(out + 9, hex + 8, 4);
+    out[13] = '-';
+    std::memcpy(out + 14, hex + 12, 4);
+    out[18] = '-';
+    std::memcpy(out + 19, hex + 16, 4);
+    out[23] = '-';
+    std::memcpy(out + 24, hex + 20, 12);
+}
+
+bool UuidSerializer::deserializeFromChars(const char *str,
+                                          size_t length,
+                                          UUID &uuid) {
+    if ((StringLength != length) ||
+        ('-' != str[8]) || ('-' != str[13]) || ('-' != str[18]) || ('-' != str[23])) {
+        return false;
+    }
+
+    alignas(16) char hex[2 * uuidSize_];
+    std::memcpy(hex, str, 8);
+    std::memcpy(hex + 8, str + 9, 4);
+    std::memcpy(hex + 12, str + 14, 4);
+    std::memcpy(hex + 16, str + 19, 4);
+    std::memcpy(hex + 20, str + 24, 12);
 
-    for (int i = 0; i < 8; i++) {
-        byteArray[i] = ((msb >> (8 * i)) & 0XFF);
-        byteArray[i + 8] = ((lsb >> (8 * i)) & 0XFF);
+    alignas(16) uint8_t bytes[uuidSize_];
+    if (false == decodeHex(hex, bytes)) {
+        return false;
     }
 
+    uint64_t msbNum = 0;
+    uint64_t lsbNum = 0;
+    unpack(bytes, msbNum, lsbNum);
+    uuid.set_msb(msbNum);
+    uuid.set_lsb(lsbNum);
+    return true;
+}
+
+std::vector<uint8_t> UuidSerializer::serializeToBytes(const UUID &uuid) {
+    if constexpr (utils::metrics::Enabled) {
+        uuidMetrics().serializeBytes.calls.add();
+    }
+    std::vector<std::uint8_t> byteArray(uuidSize_);
+    pack(uuid.msb(), uuid.lsb(), byteArray.data());
+
     return byteArray;
 }
 
-UUID UuidSerializer::deserializeFromString(std::string uuidStr) {
+UUID UuidSerializer::deserializeFromString(std::string_view uuidStr) {
+    auto uuid = tryDeserializeFromString(uuidStr);
+    if (!uuid) {
+        UP_LOG_ERROR("UUID string contains invalid data ({}). This can result"
+                     " in Invalid UUID number, so returning an instant UUID number.",
+                     toString(uuid.error()));
+        return createUUID(0,0);
+    }
+
+    return std::move(uuid).value();
+}
+
+utils::Expected<UUID, UuidError> UuidSerializer::tryDeserializeFromString(std::string_view uuidStr) {
+    if constexpr (utils::metrics::Enabled) {
+        uuidMetrics().deserializeString.calls.add();
+    }
+    UUID uuid;
+    if (deserializeFromChars(uuidStr.data(), uuidStr.size(), uuid)) {
+        return uuid;
+    }
+
+    // not in the canonical format, fall back to the lenient parser
     std::vector<uint8_t>  buffVect(uuidSize_);
 
-    if (-1 == UuidSerializer::uuidFromString(uuidStr,
-                                             buffVect)) {
-        spdlog::error("UUID string contains invalid data. This can result"
-                      "in Invalid UUID number, so returning an instant UUID number.");
-        return createUUID(0,0);
+    auto status = UuidSerializer::uuidFromString(uuidStr,
+                                                 buffVect);
+    if (0 != status) {
+        if constexpr (utils::metrics::Enabled) {
+            uuidMetrics().deserializeString.failures.add();
+        }
+        return utils::makeUnexpected((-2 == status) ? UuidError::InvalidLength : UuidError::InvalidCharacter);
     }
 
     uint64_t msbNum = 0;
@@ -87,34 +267,49 @@ UUID UuidSerializer::deserializeFromString(std::string uuidStr) {
     return createUUID(msbNum, lsbNum);
 }
 
-UUID UuidSerializer::deserializeFromBytes(std::vector<uint8_t> bytes) {
-    uint64_t msbNum = 0;
-    uint64_t lsbNum = 0;
-    const int size = bytes.size();
-    if( size != uuidSize_ ) {
-        spdlog::error("UUID byte array with invalid size: {}", size);
+UUID UuidSerializer::deserializeFromBytes(const std::vector<uint8_t> &bytes) {
+    return deserializeFromBytes(bytes.data(), bytes.size());
+}
+
+UUID UuidSerializer::deserializeFromBytes(const uint8_t *bytes,
+                                          size_t size) {
+    auto uuid = tryDeserializeFromBytes(bytes, size);
+    if (!uuid) {
+        UP_LOG_ERROR("UUID byte array with invalid size: {}", size);
         return createUUID(0,0);
     }
 
-    for (auto i = 7; i >= 0; i--) {
-        msbNum <<= 8;
-        lsbNum <<= 8;
-        msbNum |= (uint64_t)bytes[i];
-        lsbNum |= (uint64_t)bytes[i + 8];
+    return std::move(uuid).value();
+}
+
+utils::Expected<UUID, UuidError> UuidSerializer::tryDeserializeFromBytes(const uint8_t *bytes,
+                                                                         size_t size) {
+    if constexpr (utils::metrics::Enabled) {
+        uuidMetrics().deserializeBytes.calls.add();
+    }
+    if( size != ByteLength ) {
+        if constexpr (utils::metrics::Enabled) {
+            uuidMetrics().deserializeBytes.failures.add();
+        }
+        return utils::makeUnexpected(UuidError::InvalidLength);
     }
+
+    uint64_t msbNum = 0;
+    uint64_t lsbNum = 0;
+    unpack(bytes, msbNum, lsbNum);
     return createUUID(msbNum, lsbNum);
 }
 
-int UuidSerializer::uuidFromString(std::string str,
+int UuidSerializer::uuidFromString(std::string_view str,
                                    std::vector<uint8_t> &uuidOut) {
-    str.erase(remove(str.begin(),
-                    str.end(),
-                    '-'),
-                        str.end());
     auto i = 0;
     for (auto c : str) {
         uint8_t n;
 
+        if ('-' == c) {
+            continue;
+        }
+
         if (std::isdigit(c)) {
             n = c - '0';
         } else if (std::isxdigit(c)) {
@@ -126,7 +321,7 @@ int UuidSerializer::uuidFromString(std::string str,
         //uuidOut of size 16, index should not go beyond 15.
         int index = i >> 1;
         if(index > 15) {
-            return -1;
+            return -2;
         }
 
         if ((i & 1) == 0) {
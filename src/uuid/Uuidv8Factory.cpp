@@ -24,35 +24,91 @@
  */
 
 #include <up-cpp/uuid/factory/Uuidv8Factory.h>
+#include <up-cpp/utils/Metrics.h>
 
 namespace uprotocol::uuid {
 
+namespace {
+
+utils::metrics::Counter &saturatedMetric() {
+    static auto &saturated = utils::metrics::Registry::instance().counter(
+        "up_uuid_counter_saturated_total",
+        "UUID reservations that ran the 12 bit counter past the current millisecond");
+    return saturated;
+}
+
+} // namespace
+
 UUID Uuidv8Factory::create() {
+    UUID uuid;
+    uuid.set_msb(reserve(1));
+    uuid.set_lsb(lsb_);
+    return uuid;
+}
+
+void Uuidv8Factory::createBatch(UUID *uuids, size_t count) {
+    if (0 == count) {
+        return;
+    }
+
+    auto msb = reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uuids[i].set_msb(msb);
+        uuids[i].set_lsb(lsb_);
+        msb = advanceMsb(msb, 1);
+    }
+}
+
+void Uuidv8Factory::createBatch(RawUuid *uuids, size_t count) {
+    if (0 == count) {
+        return;
+    }
+
+    auto msb = reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uuids[i].msb = msb;
+        uuids[i].lsb = lsb_;
+        msb = advanceMsb(msb, 1);
+    }
+}
+
+uint64_t Uuidv8Factory::reserve(size_t count) {
     // Get the current time from the monotonic clock
     std::chrono::time_point<std::chrono::steady_clock> currentTime = std::chrono::steady_clock::now();
     // Convert the time point to a duration in milliseconds
     std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime.time_since_epoch());
     uint64_t now = ms.count();
 
-    msb_ = (now << 16) | version_;  // 48 bit clock 4 bits version_ custom_b
+    // one compare-exchange on the packed time and counter, retried only if another thread won
     auto prevMsb = getLastMsb();
+    auto first = nextMsb(prevMsb, now);
+    while (false == lastMsb_.compare_exchange_weak(prevMsb, advanceMsb(first, count - 1),
+                                                   std::memory_order_relaxed,
+                                                   std::memory_order_relaxed)) {
+        first = nextMsb(prevMsb, now);
+    }
+
+    if constexpr (utils::metrics::Enabled) {
+        if ((advanceMsb(first, count - 1) >> 16) > now) {
+            saturatedMetric().add();
+        }
+    }
+
+    return first;
+}
 
+uint64_t Uuidv8Factory::nextMsb(uint64_t prevMsb, uint64_t now) {
     auto time = prevMsb >> 16;
-    auto count = prevMsb & 0xFFFL;
 
     if ((now <= time) &&
-        (now > (time - clockDriftTolerance_))) {
+        ((time - now) < clockDriftTolerance_)) {
         // add to count up to MAX_COUNT (12 bits) no need to change
-        // since we maintain the variant and random
-        msb_ =  (count < maxCount_)
-                ? prevMsb + 1
-                : prevMsb;
+        // since we maintain the variant and random; a full counter
+        // continues in the next millisecond
+        return advanceMsb(prevMsb, 1);
     }
-    lastMsb_ = msb_;
-    UUID uuid;
-    uuid.set_msb(msb_);
-    uuid.set_lsb(lsb_);
-    return uuid;
+
+    return (now << 16) | version_;  // 48 bit clock 4 bits version_ custom_b
 }
 
-} //uprotocol::uuid
\ No newline at end of file
+} //uprotocol::uuid
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/message_differencer.h>
+#include <up-cpp/cloudevent/serialize/binary_serializer.h>
+
+using namespace cloudevents::format;
+using io::cloudevents::v1::CloudEvent;
+
+namespace {
+
+CloudEvent publishEvent() {
+    CloudEvent ce;
+    ce.set_id("testme");
+    ce.set_source("/body.access/1/door.front_left#Door");
+    ce.set_spec_version("v1");
+    ce.set_type("pub.v1");
+    (*ce.mutable_attributes())[Serializer::PRIORITY_KEY].set_ce_string("CS1");
+    (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer(100);
+    ce.mutable_proto_data()->set_type_url("type.googleapis.com/test.Door");
+    ce.mutable_proto_data()->set_value(std::string("\x08\x00\x01\xff", 4));
+    return ce;
+}
+
+bool equal(const CloudEvent &a, const CloudEvent &b) {
+    return google::protobuf::util::MessageDifferencer::Equals(a, b);
+}
+
+}
+
+TEST(RawBinarySerializer, RoundTrip) {
+    raw_binary_serializer serializer;
+    const auto ce = publishEvent();
+
+    auto formatted = serializer.serialize(ce);
+    ASSERT_TRUE(formatted.has_value());
+    EXPECT_EQ(DATA_TYPE_E::RAW, (*formatted)->type);
+
+    auto parsed = serializer.deserialized(**formatted);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_TRUE(equal(ce, **parsed));
+}
+
+TEST(RawBinarySerializer, RejectsOtherFormat) {
+    raw_binary_serializer serializer;
+    auto formatted = serializer.serialize(publishEvent());
+    ASSERT_TRUE(formatted.has_value());
+
+    (*formatted)->type = DATA_TYPE_E::BINARY;
+    EXPECT_FALSE(serializer.deserialized(**formatted).has_value());
+}
+
+TEST(RawBinarySerializer, Buffer) {
+    raw_binary_serializer serializer;
+    const auto ce = publishEvent();
+    const auto size = raw_binary_serializer::serialized_size(ce);
+
+    std::vector<uint8_t> buffer(size);
+    auto written = serializer.serialize_to(ce, buffer.data(), buffer.size());
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(size, *written);
+
+    auto parsed = serializer.deserialize_from(buffer.data(), *written);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_TRUE(equal(ce, **parsed));
+}
+
+TEST(RawBinarySerializer, BufferTooSmall) {
+    raw_binary_serializer serializer;
+    const auto ce = publishEvent();
+
+    std::vector<uint8_t> buffer(raw_binary_serializer::serialized_size(ce) - 1);
+    EXPECT_FALSE(serializer.serialize_to(ce, buffer.data(), buffer.size()).has_value());
+}
+
+TEST(RawBinarySerializer, Stream) {
+    raw_binary_serializer serializer;
+    const auto ce = publishEvent();
+
+    std::string bytes;
+    {
+        google::protobuf::io::StringOutputStream out(&bytes);
+        ASSERT_TRUE(serializer.serialize_to(ce, &out));
+    }
+
+    google::protobuf::io::ArrayInputStream in(bytes.data(), static_cast<int>(bytes.size()));
+    auto parsed = serializer.deserialize_from(&in);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_TRUE(equal(ce, **parsed));
+}
+
+TEST(RawBinarySerializer, InvalidEvent) {
+    raw_binary_serializer serializer;
+    auto ce = publishEvent();
+    ce.set_spec_version("v0");
+
+    uint8_t buffer[256];
+    EXPECT_FALSE(serializer.serialize(ce).has_value());
+    EXPECT_FALSE(serializer.serialize_to(ce, buffer, sizeof(buffer)).has_value());
+
+    /* a request without its sink is rejected after parsing */
+    ce.set_spec_version("v1");
+    ce.set_type("req.v1");
+    const auto bytes = ce.SerializeAsString();
+    EXPECT_FALSE(serializer.deserialize_from(reinterpret_cast<const uint8_t *>(bytes.data()),
+                         bytes.size()).has_value());
+}
+
+TEST(RawBinarySerializer, TruncatedBytes) {
+    raw_binary_serializer serializer;
+    const auto bytes = publishEvent().SerializeAsString();
+
+    EXPECT_FALSE(serializer.deserialize_from(nullptr, 0).has_value());
+    EXPECT_FALSE(serializer.deserialize_from(reinterpret_cast<const uint8_t *>(bytes.data()),
+                         bytes.size() - 1).has_value());
+}
+
+TEST(RawBinarySerializer, Lazy) {
+    raw_binary_serializer serializer;
+    const auto ce = publishEvent();
+    const auto bytes = ce.SerializeAsString();
+
+    LazyCloudEvent event;
+    ASSERT_TRUE(serializer.deserialize_lazy(reinterpret_cast<const uint8_t *>(bytes.data()),
+                        bytes.size(), event));
+    EXPECT_EQ(ce.id(), event.envelope().id());
+    EXPECT_FALSE(event.envelope().has_proto_data());
+    ASSERT_TRUE(event.has_proto_data());
+    EXPECT_EQ(ce.proto_data().type_url(), event.type_url());
+    EXPECT_EQ(ce.proto_data().value(), event.payload_bytes());
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <up-cpp/cloudevent/factory/cloud_event_factory.h>
+#include <up-cpp/cloudevent/serialize/binary_serializer.h>
+
+using namespace cloudevents::factory;
+using namespace cloudevents::format;
+using io::cloudevents::v1::CloudEvent;
+
+namespace {
+
+const std::string rpcUri = "/body.access/1/door.front_left#Door";
+const std::string sinkUri = "/body.access/1/rpc.response";
+
+google::protobuf::Timestamp body() {
+    google::protobuf::Timestamp ts;
+    ts.set_seconds(1700000000);
+    ts.set_nanos(42);
+    return ts;
+}
+
+/* every part of the event that owns memory must be on the arena */
+void expectOnArena(const CloudEvent &ce, google::protobuf::Arena &arena) {
+    EXPECT_EQ(&arena, ce.GetArena());
+    EXPECT_EQ(&arena, ce.proto_data().GetArena());
+    for (const auto &[name, value] : ce.attributes()) {
+        EXPECT_EQ(&arena, value.GetArena()) << name;
+    }
+}
+
+}
+
+TEST(CloudEventFactory, PublishOnArena) {
+    google::protobuf::Arena arena;
+    auto msg = body();
+    UAttributes attributes("h", Priority::Priority_E::STANDARD_PRIORITY, 100);
+
+    auto *ce = factory::publish_factory(msg, rpcUri, attributes, arena);
+    ASSERT_NE(nullptr, ce);
+    expectOnArena(*ce, arena);
+
+    EXPECT_EQ(rpcUri, ce->source());
+    EXPECT_EQ("pub.v1", ce->type());
+    EXPECT_EQ("v1", ce->spec_version());
+    EXPECT_EQ(100, ce->attributes().at(Serializer::TTL_KEY).ce_integer());
+    EXPECT_EQ("h", ce->attributes().at(Serializer::HASH_KEY).ce_string());
+    EXPECT_EQ("CS1", ce->attributes().at(Serializer::PRIORITY_KEY).ce_string());
+    EXPECT_EQ(ce->proto_data().type_url(),
+              ce->attributes().at(Serializer::DATA_SCHEMA_KEY).ce_string());
+
+    google::protobuf::Timestamp unpacked;
+    ASSERT_TRUE(ce->proto_data().UnpackTo(&unpacked));
+    EXPECT_EQ(msg.SerializeAsString(), unpacked.SerializeAsString());
+}
+
+TEST(CloudEventFactory, RequestAndResponseOnArena) {
+    google::protobuf::Arena arena;
+    auto msg = body();
+    UAttributes attributes("", Priority::Priority_E::NOT_DEFINED, 100);
+
+    auto *request = factory::request_factory(msg, rpcUri, sinkUri, attributes, arena);
+    ASSERT_NE(nullptr, request);
+    expectOnArena(*request, arena);
+    EXPECT_EQ(sinkUri, request->attributes().at(Serializer::SINK_KEY).ce_string());
+
+    auto *response = factory::response_factory(msg, rpcUri, sinkUri, request->id(),
+                                               attributes, arena);
+    ASSERT_NE(nullptr, response);
+    expectOnArena(*response, arena);
+    EXPECT_EQ(request->id(), response->attributes().at(Serializer::REQ_ID_KEY).ce_string());
+
+    auto *notify = factory::notify_factory(msg, rpcUri, sinkUri, attributes, arena);
+    ASSERT_NE(nullptr, notify);
+    expectOnArena(*notify, arena);
+
+    auto *file = factory::file_factory(msg, rpcUri, sinkUri, attributes, arena);
+    ASSERT_NE(nullptr, file);
+    expectOnArena(*file, arena);
+}
+
+TEST(CloudEventFactory, ArenaEventSerializes) {
+    google::protobuf::Arena arena;
+    auto msg = body();
+    UAttributes attributes("", Priority::Priority_E::NOT_DEFINED, 100);
+
+    auto *ce = factory::request_factory(msg, rpcUri, sinkUri, attributes, arena);
+    ASSERT_NE(nullptr, ce);
+
+    raw_binary_serializer serializer;
+    auto formatted = serializer.serialize(*ce);
+    ASSERT_TRUE(formatted.has_value());
+    auto parsed = serializer.deserialized(**formatted);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(ce->id(), (*parsed)->id());
+}
+
+TEST(CloudEventFactory, InvalidUri) {
+    google::protobuf::Arena arena;
+    auto msg = body();
+    UAttributes attributes("", Priority::Priority_E::NOT_DEFINED, 100);
+
+    EXPECT_EQ(nullptr, factory::publish_factory(msg, "", attributes, arena));
+    EXPECT_EQ(nullptr, factory::request_factory(msg, "", sinkUri, attributes, arena));
+    EXPECT_EQ(nullptr, factory::request_factory(msg, rpcUri, "", attributes, arena));
+    EXPECT_EQ(nullptr, factory::response_factory(msg, "", sinkUri, "id", attributes, arena));
+
+    CloudEvent ce;
+    EXPECT_FALSE(factory::publish_factory(msg, "", attributes, ce));
+}
+
+TEST(CloudEventFactory, MissingTtl) {
+    google::protobuf::Arena arena;
+    auto msg = body();
+    UAttributes attributes;
+
+    EXPECT_EQ(nullptr, factory::request_factory(msg, rpcUri, sinkUri, attributes, arena));
+    EXPECT_EQ(nullptr, factory::response_factory(msg, rpcUri, sinkUri, "id", attributes, arena));
+
+    /* the ttl is optional when publishing */
+    auto *ce = factory::publish_factory(msg, rpcUri, attributes, arena);
+    ASSERT_NE(nullptr, ce);
+    EXPECT_EQ(0U, ce->attributes().count(Serializer::TTL_KEY));
+}
+
+TEST(CloudEventFactory, MissingRequestId) {
+    google::protobuf::Arena arena;
+    auto msg = body();
+    UAttributes attributes("", Priority::Priority_E::NOT_DEFINED, 100);
+
+    EXPECT_EQ(nullptr, factory::response_factory(msg, rpcUri, sinkUri, "", attributes, arena));
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/util/message_differencer.h>
+#include <up-cpp/cloudevent/serialize/json_serializer.h>
+
+using namespace cloudevents::format;
+using io::cloudevents::v1::CloudEvent;
+
+namespace {
+
+CloudEvent publishEvent() {
+    CloudEvent ce;
+    ce.set_id("testme");
+    ce.set_source("/body.access/1/door.front_left#Door");
+    ce.set_spec_version("v1");
+    ce.set_type("pub.v1");
+    (*ce.mutable_attributes())[Serializer::PRIORITY_KEY].set_ce_string("CS1");
+    (*ce.mutable_attributes())[Serializer::TTL_KEY].set_ce_integer(-100);
+    (*ce.mutable_attributes())["retained"].set_ce_boolean(true);
+    return ce;
+}
+
+bool equal(const CloudEvent &a, const CloudEvent &b) {
+    return google::protobuf::util::MessageDifferencer::Equals(a, b);
+}
+
+std::string jsonEvent(const std::string &members) {
+    return "{\"id\":\"testme\",\"source\":\"/body.access/1/door.front_left#Door\","
+           "\"specversion\":\"v1\",\"type\":\"pub.v1\"" + members + "}";
+}
+
+}
+
+TEST(JsonStreamSerializer, RoundTripTextData) {
+    Json_stream_serializer serializer;
+    auto ce = publishEvent();
+    ce.set_text_data("open \"the\" door\n");
+
+    auto formatted = serializer.serialize(ce);
+    ASSERT_TRUE(formatted.has_value());
+    EXPECT_EQ(DATA_TYPE_E::JSON, (*formatted)->type);
+
+    auto parsed = serializer.deserialized(**formatted);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_TRUE(equal(ce, **parsed));
+}
+
+TEST(JsonStreamSerializer, RoundTripBinaryData) {
+    Json_stream_serializer serializer;
+    for (const std::string data : {std::string(), std::string("\x00", 1),
+                                   std::string("\x00\xff", 2), std::string("\x00\xff\x7f", 3)}) {
+        auto ce = publishEvent();
+        ce.set_binary_data(data);
+
+        std::string json;
+        ASSERT_TRUE(serializer.serialize_to(ce, json));
+
+        CloudEvent parsed;
+        ASSERT_TRUE(serializer.deserialize_into(json.data(), json.size(), parsed));
+        EXPECT_TRUE(equal(ce, parsed)) << json;
+    }
+}
+
+TEST(JsonStreamSerializer, ProtoDataIsNotSupported) {
+    Json_stream_serializer serializer;
+    auto ce = publishEvent();
+    ce.mutable_proto_data()->set_type_url("type.googleapis.com/test.Door");
+
+    std::string json;
+    EXPECT_FALSE(serializer.serialize_to(ce, json));
+}
+
+TEST(JsonStreamSerializer, DeserializeClearsTarget) {
+    Json_stream_serializer serializer;
+    CloudEvent ce = publishEvent();
+    (*ce.mutable_attributes())["stale"].set_ce_string("left over");
+    ce.set_binary_data("left over");
+
+    const auto json = jsonEvent(",\"data\":\"fresh\"");
+    ASSERT_TRUE(serializer.deserialize_into(json.data(), json.size(), ce));
+    EXPECT_EQ(0, ce.attributes_size());
+    EXPECT_EQ("fresh", ce.text_data());
+}
+
+TEST(JsonStreamSerializer, UnsetAttributeIsOmitted) {
+    Json_stream_serializer serializer;
+    auto ce = publishEvent();
+    (*ce.mutable_attributes())["unset"];
+
+    std::string json;
+    ASSERT_TRUE(serializer.serialize_to(ce, json));
+    EXPECT_EQ(std::string::npos, json.find("unset"));
+    EXPECT_EQ(std::string::npos, json.find("null"));
+
+    CloudEvent parsed;
+    ASSERT_TRUE(serializer.deserialize_into(json.data(), json.size(), parsed));
+    ce.mutable_attributes()->erase("unset");
+    EXPECT_TRUE(equal(ce, parsed));
+}
+
+TEST(JsonStreamSerializer, NullIsAbsent) {
+    Json_stream_serializer serializer;
+    CloudEvent ce;
+
+    auto json = jsonEvent(",\"priority\":null,\"data\":null");
+    ASSERT_TRUE(serializer.deserialize_into(json.data(), json.size(), ce));
+    EXPECT_EQ(0, ce.attributes_size());
+    EXPECT_FALSE(ce.has_text_data());
+
+    json = "{\"id\":null,\"source\":\"/body.access/1/door.front_left#Door\","
+           "\"specversion\":\"v1\",\"type\":\"pub.v1\"}";
+    EXPECT_FALSE(serializer.deserialize_into(json.data(), json.size(), ce));
+}
+
+TEST(JsonStreamSerializer, InvalidBase64) {
+    Json_stream_serializer serializer;
+    CloudEvent ce;
+
+    auto json = jsonEvent(",\"data_base64\":\"QUJD\"");
+    ASSERT_TRUE(serializer.deserialize_into(json.data(), json.size(), ce));
+    EXPECT_EQ("ABC", ce.binary_data());
+
+    for (const char *data : {"QUJ", "QUJDR", "QU*D", "QQ==QUJD", "Q===", "===="}) {
+        json = jsonEvent(std::string(",\"data_base64\":\"") + data + "\"");
+        EXPECT_FALSE(serializer.deserialize_into(json.data(), json.size(), ce)) << data;
+    }
+}
+
+TEST(JsonStreamSerializer, UnsupportedJson) {
+    Json_stream_serializer serializer;
+    CloudEvent ce;
+
+    for (const char *members : {",\"nested\":{\"a\":1}", ",\"list\":[1]", ",\"ttl\":2147483648",
+                                ",\"ttl\":1.5", ",\"id\":1", ",\"data\":true", ",\"ttl\":"}) {
+        const auto json = jsonEvent(members);
+        EXPECT_FALSE(serializer.deserialize_into(json.data(), json.size(), ce)) << members;
+    }
+
+    /* missing mandatory member */
+    const std::string json = "{\"id\":\"testme\",\"specversion\":\"v1\",\"type\":\"pub.v1\"}";
+    EXPECT_FALSE(serializer.deserialize_into(json.data(), json.size(), ce));
+}
+
+TEST(JsonStreamSerializer, DeserializeOnArena) {
+    Json_stream_serializer serializer;
+    google::protobuf::Arena arena;
+    auto ce = google::protobuf::Arena::CreateMessage<CloudEvent>(&arena);
+
+    const auto json = jsonEvent(",\"ttl\":100,\"data\":\"open\"");
+    ASSERT_TRUE(serializer.deserialize_into(json.data(), json.size(), *ce));
+    EXPECT_EQ(&arena, ce->GetArena());
+    EXPECT_EQ(100, ce->attributes().at(Serializer::TTL_KEY).ce_integer());
+    EXPECT_EQ("open", ce->text_data());
+}
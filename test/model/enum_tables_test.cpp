@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <up-cpp/cloudevent/datamodel/attributes.h>
+#include <up-cpp/cloudevent/datamodel/priority.h>
+#include <up-cpp/cloudevent/datamodel/service_type.h>
+#include <up-cpp/cloudevent/datamodel/spec_version.h>
+
+using namespace cloudevents::format;
+
+/* the conversions of known values are evaluated at compile time */
+static_assert(Priority::ToString(Priority::Priority_E::REAL_TIME_PRIORITY) == "CS4");
+static_assert(Priority::getPriorityType("CS6") == Priority::Priority_E::NETWORK_PRIORITY);
+static_assert(ServiceType::ToString(ServiceType::MessageType_E::RESPONSE) == "res.v1");
+static_assert(ServiceType::getEnumType("req.v1") == ServiceType::MessageType_E::REQUEST);
+static_assert(SpecVersion::ToString(SpecVersion::SpecVersion_E::V1) == "v1");
+static_assert(SpecVersion::getSpecVersionE("v1") == SpecVersion::SpecVersion_E::V1);
+
+// Test that every priority converts to its name and back
+TEST(EnumTablesTest, Priority)
+{
+    const std::string names[] = {Priority::PRIORITY_CS0, Priority::PRIORITY_CS1, Priority::PRIORITY_CS2,
+                                 Priority::PRIORITY_CS3, Priority::PRIORITY_CS4, Priority::PRIORITY_CS5,
+                                 Priority::PRIORITY_CS6};
+    for (size_t i = 0; i < std::size(names); ++i) {
+        const auto priority = static_cast<Priority::Priority_E>(i);
+        EXPECT_EQ(Priority::ToString(priority), names[i]);
+        EXPECT_EQ(Priority::getPriorityType(names[i]), priority);
+    }
+
+    EXPECT_EQ(Priority::ToString(Priority::Priority_E::NOT_DEFINED), "");
+    for (const char *name : {"", "CS", "CS7", "CS/", "cs1", "XS1", "CS10", "CS1 "}) {
+        EXPECT_EQ(Priority::getPriorityType(name), Priority::Priority_E::NOT_DEFINED) << name;
+    }
+}
+
+// Test that every message type converts to its name and back
+TEST(EnumTablesTest, ServiceType)
+{
+    const std::pair<ServiceType::MessageType_E, std::string> types[] = {
+        {ServiceType::MessageType_E::PUBLISH, ServiceType::PUBLISH_MSG_TYPE_V1},
+        {ServiceType::MessageType_E::FILE, ServiceType::FILE_MSG_TYPE_V1},
+        {ServiceType::MessageType_E::REQUEST, ServiceType::REQUEST_MSG_TYPE_V1},
+        {ServiceType::MessageType_E::RESPONSE, ServiceType::RESPONSE_MSG_TYPE_V1}};
+    for (const auto &[type, name] : types) {
+        EXPECT_EQ(ServiceType::ToString(type), name);
+        EXPECT_EQ(ServiceType::getEnumType(name), type);
+    }
+
+    EXPECT_EQ(ServiceType::ToString(ServiceType::MessageType_E::NOT_DEFINED), "");
+    /* same first characters as a known type, but not its name */
+    for (const char *name : {"", "p", "re", "pub.v2", "pub.v1 ", "rex.v1", "fil.v1", "sub.v1", "req"}) {
+        EXPECT_EQ(ServiceType::getEnumType(name), ServiceType::MessageType_E::NOT_DEFINED) << name;
+    }
+}
+
+// Test that the spec version converts to its name and back
+TEST(EnumTablesTest, SpecVersion)
+{
+    EXPECT_EQ(SpecVersion::ToString(SpecVersion::SpecVersion_E::V1), SpecVersion::VERSION_SPEC_V1);
+    EXPECT_EQ(SpecVersion::getSpecVersionE(SpecVersion::VERSION_SPEC_V1), SpecVersion::SpecVersion_E::V1);
+
+    EXPECT_EQ(SpecVersion::ToString(SpecVersion::SpecVersion_E::NOT_DEFINED), "");
+    for (const char *name : {"", "v", "v2", "V1", "v1.0"}) {
+        EXPECT_EQ(SpecVersion::getSpecVersionE(name), SpecVersion::SpecVersion_E::NOT_DEFINED) << name;
+    }
+}
+
+// Test that the attributes keep the priority as the enum and hand out its name
+TEST(EnumTablesTest, AttributesPriority)
+{
+    UAttributes attributes("hash", Priority::Priority_E::SIGNALING_PRIORITY, 10);
+    EXPECT_EQ(attributes.get_priority(), Priority::Priority_E::SIGNALING_PRIORITY);
+    EXPECT_EQ(attributes.get_priority_view(), std::string_view("CS5"));
+    EXPECT_EQ(attributes.get_priority_string(), std::string("CS5"));
+    EXPECT_FALSE(attributes.isEmpty());
+
+    attributes.WithPriority(Priority::Priority_E::LOW_PRIORITY);
+    EXPECT_EQ(attributes.get_priority_view(), std::string_view("CS0"));
+
+    UAttributes empty;
+    EXPECT_TRUE(empty.isEmpty());
+    EXPECT_FALSE(empty.get_priority().has_value());
+    EXPECT_FALSE(empty.get_priority_view().has_value());
+    EXPECT_FALSE(empty.get_priority_string().has_value());
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <up-cpp/rpc/RequestTable.h>
+
+using namespace uprotocol::rpc;
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+using namespace std::chrono_literals;
+
+static UUID makeId(uint64_t n) {
+    UUID id;
+    id.set_msb(0x018e0000000000ULL + n);
+    id.set_lsb(0x8000000000000000ULL | (n * 7919));
+    return id;
+}
+
+// Test that a response is matched on its reqid
+TEST(RequestTableTest, CompleteByReqid)
+{
+    RequestTable table(64);
+    UCode code = UCode::UNKNOWN;
+    UPriority priority = UPriority::UPRIORITY_UNSPECIFIED;
+
+    EXPECT_EQ(table.add(makeId(1), 1000ms, [&](RpcResponse &&response) {
+        code = response.status.code();
+        priority = response.message.attributes().priority();
+    }).code(), UCode::OK);
+    EXPECT_EQ(table.add(makeId(1), 1000ms, [](RpcResponse &&) {}).code(), UCode::ALREADY_EXISTS);
+    EXPECT_EQ(table.size(), 1U);
+
+    UAttributes attributes;
+    *attributes.mutable_reqid() = makeId(1);
+    attributes.set_priority(UPriority::UPRIORITY_CS4);
+    UMessage response(UPayload(), attributes);
+
+    EXPECT_TRUE(table.complete(response));
+    EXPECT_EQ(code, UCode::OK);
+    EXPECT_EQ(priority, UPriority::UPRIORITY_CS4);
+    EXPECT_FALSE(table.complete(response));
+    EXPECT_EQ(table.size(), 0U);
+}
+
+// Test that a moved response reaches the continuation with the same payload buffer
+TEST(RequestTableTest, CompleteMovesPayload)
+{
+    RequestTable table(64);
+    const uint8_t *delivered = nullptr;
+
+    table.add(makeId(2), 1000ms, [&delivered](RpcResponse &&response) {
+        auto owned = std::move(response);
+        delivered = owned.message.payload().data();
+    });
+
+    std::vector<uint8_t> received(1 << 20, 0x5A);
+    const uint8_t *bytes = received.data();
+    UAttributes attributes;
+    *attributes.mutable_reqid() = makeId(2);
+    UMessage response(UPayload(std::move(received)), std::move(attributes));
+
+    EXPECT_TRUE(table.complete(std::move(response)));
+    EXPECT_EQ(delivered, bytes);
+}
+
+// Test that requests expire after their TTL and not before
+TEST(RequestTableTest, Expire)
+{
+    RequestTable table(64);
+    std::vector<int> expired;
+    const auto start = std::chrono::steady_clock::now();
+
+    CallOptions options;
+    options.set_ttl(50);
+    table.add(makeId(1), options, [&](RpcResponse &&response) {
+        EXPECT_EQ(response.status.code(), UCode::DEADLINE_EXCEEDED);
+        expired.push_back(1);
+    });
+    table.add(makeId(2), 400ms, [&](RpcResponse &&) { expired.push_back(2); });
+    /* past the first wheel level */
+    table.add(makeId(3), 70s, [&](RpcResponse &&) { expired.push_back(3); });
+    /* never expires */
+    table.add(makeId(4), 0ms, [&](RpcResponse &&) { expired.push_back(4); });
+
+    EXPECT_EQ(table.expire(start), 0U);
+    EXPECT_EQ(table.expire(start + 100ms), 1U);
+    EXPECT_EQ(expired, (std::vector<int>{1}));
+    EXPECT_EQ(table.expire(start + 300ms), 0U);
+    EXPECT_EQ(table.expire(start + 500ms), 1U);
+    EXPECT_EQ(table.expire(start + 60s), 0U);
+    EXPECT_EQ(table.expire(start + 80s), 1U);
+    EXPECT_EQ(expired, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(table.expire(start + 10h), 0U);
+    EXPECT_EQ(table.size(), 1U);
+
+    UStatus status;
+    status.set_code(UCode::UNAVAILABLE);
+    EXPECT_TRUE(table.cancel(makeId(4), status));
+    EXPECT_EQ(expired, (std::vector<int>{1, 2, 3, 4}));
+}
+
+// Test that a completed request does not expire and that the slots are reused
+TEST(RequestTableTest, CompleteBeforeExpiry)
+{
+    RequestTable table(16);
+    int timeouts = 0;
+    int completions = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t round = 0; round < 10; ++round) {
+        for (uint64_t i = 0; i < 16; ++i) {
+            ASSERT_EQ(table.add(makeId(round * 16 + i), 20ms, [&](RpcResponse &&response) {
+                if (UCode::OK == response.status.code()) {
+                    ++completions;
+                } else {
+                    ++timeouts;
+                }
+            }).code(), UCode::OK);
+        }
+        for (uint64_t i = 0; i < 16; i += 2) {
+            EXPECT_TRUE(table.complete(makeId(round * 16 + i), UMessage()));
+        }
+        table.expire(start + std::chrono::milliseconds(100 * (round + 1)));
+        EXPECT_EQ(table.size(), 0U);
+    }
+
+    EXPECT_EQ(completions, 80);
+    EXPECT_EQ(timeouts, 80);
+}
+
+// Test that a full table refuses new requests
+TEST(RequestTableTest, Exhausted)
+{
+    RequestTable table(16);
+    size_t added = 0;
+    UCode code = UCode::OK;
+    for (uint64_t i = 0; (i < 1000) && (UCode::OK == code); ++i) {
+        code = table.add(makeId(i), 1000ms, [](RpcResponse &&) {}).code();
+        added += (UCode::OK == code) ? 1 : 0;
+    }
+
+    EXPECT_EQ(code, UCode::RESOURCE_EXHAUSTED);
+    EXPECT_EQ(added, table.capacity());
+    EXPECT_EQ(table.size(), added);
+}
+
+// Test that a table holds exactly capacity requests however they spread over its stripes
+TEST(RequestTableTest, HoldsCapacity)
+{
+    for (const size_t capacity : {1U, 100U, 2000U, 10000U}) {
+        RequestTable table(capacity);
+        for (uint64_t i = 0; i < capacity; ++i) {
+            ASSERT_EQ(table.add(makeId(i * 7919U + capacity), 0ms, [](RpcResponse &&) {}).code(), UCode::OK);
+        }
+        EXPECT_EQ(table.add(makeId(UINT64_MAX), 0ms, [](RpcResponse &&) {}).code(), UCode::RESOURCE_EXHAUSTED);
+        EXPECT_EQ(table.size(), capacity);
+
+        /* the requests stay reachable and their room is reused */
+        for (uint64_t i = 0; i < capacity; ++i) {
+            ASSERT_TRUE(table.remove(makeId(i * 7919U + capacity)));
+        }
+        EXPECT_EQ(table.size(), 0U);
+        EXPECT_EQ(table.add(makeId(UINT64_MAX), 0ms, [](RpcResponse &&) {}).code(), UCode::OK);
+    }
+}
+
+// Test that a stripe holding more than its share of the requests grows
+TEST(RequestTableTest, GrowStripe)
+{
+    /* same mixer as the table, which picks the stripe from the top 4 bits */
+    auto stripeOf = [](const UUID &id) {
+        uint64_t h = id.msb() ^ (id.lsb() * 0x9E3779B97F4A7C15ULL);
+        h ^= h >> 31;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 29;
+        return h >> 60;
+    };
+    std::vector<UUID> ids;
+    for (uint64_t i = 0; ids.size() < 64; ++i) {
+        if (0 == stripeOf(makeId(i))) {
+            ids.push_back(makeId(i));
+        }
+    }
+
+    RequestTable table(ids.size());
+    int completed = 0;
+    int timeouts = 0;
+    for (const auto &id : ids) {
+        ASSERT_EQ(table.add(id, 1000ms, [&](RpcResponse &&response) {
+            completed += (UCode::OK == response.status.code()) ? 1 : 0;
+            timeouts += (UCode::DEADLINE_EXCEEDED == response.status.code()) ? 1 : 0;
+        }).code(), UCode::OK);
+    }
+    EXPECT_EQ(table.size(), ids.size());
+
+    /* the index and the timer wheel survived growing: half completes, the rest times out */
+    for (size_t i = 0; i < ids.size(); i += 2) {
+        EXPECT_TRUE(table.complete(ids[i], UMessage(UPayload(), UAttributes())));
+    }
+    EXPECT_EQ(table.expire(std::chrono::steady_clock::now() + 2000ms), ids.size() / 2);
+    EXPECT_EQ(completed, static_cast<int>(ids.size() / 2));
+    EXPECT_EQ(timeouts, static_cast<int>(ids.size() / 2));
+    EXPECT_EQ(table.size(), 0U);
+}
+
+// Test that a removed request is dropped without calling its continuation
+TEST(RequestTableTest, Remove)
+{
+    RequestTable table(16);
+    int called = 0;
+    ASSERT_EQ(table.add(makeId(1), 1000ms, [&](RpcResponse &&) { ++called; }).code(), UCode::OK);
+
+    EXPECT_TRUE(table.remove(makeId(1)));
+    EXPECT_FALSE(table.remove(makeId(1)));
+    EXPECT_EQ(table.size(), 0U);
+    EXPECT_EQ(table.expire(std::chrono::steady_clock::now() + 2000ms), 0U);
+    EXPECT_EQ(called, 0);
+}
+
+// Test that outstanding requests are cancelled when the table goes away
+TEST(RequestTableTest, CancelOnDestruction)
+{
+    int cancelled = 0;
+    {
+        RequestTable table(16);
+        table.add(makeId(1), 1000ms, [&](RpcResponse &&response) {
+            cancelled += (UCode::CANCELLED == response.status.code()) ? 1 : 0;
+        });
+    }
+    EXPECT_EQ(cancelled, 1);
+}
+
+// Test completions and expiry from several threads
+TEST(RequestTableTest, Concurrent)
+{
+    constexpr uint64_t numThreads = 4;
+    constexpr uint64_t numPerThread = 5000;
+    RequestTable table(numThreads * numPerThread);
+    std::atomic<uint64_t> done {0};
+    std::atomic<bool> stop {false};
+
+    std::thread timer([&]() {
+        while (false == stop.load()) {
+            table.expire();
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (uint64_t i = 0; i < numPerThread; ++i) {
+                const auto id = makeId(t * numPerThread + i);
+                ASSERT_EQ(table.add(id, std::chrono::milliseconds(i % 3), [&](RpcResponse &&) { ++done; }).code(),
+                          UCode::OK);
+                if (0 == i % 2) {
+                    table.complete(id, UMessage());
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    /* the requests with a TTL of 0 never expire */
+    for (uint64_t t = 0; t < numThreads; ++t) {
+        for (uint64_t i = 0; i < numPerThread; ++i) {
+            if (0 == i % 3) {
+                table.cancel(makeId(t * numPerThread + i), UStatus());
+            }
+        }
+    }
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while ((done.load() < numThreads * numPerThread) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(1ms);
+    }
+    stop = true;
+    timer.join();
+
+    EXPECT_EQ(done.load(), numThreads * numPerThread);
+    EXPECT_EQ(table.size(), 0U);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
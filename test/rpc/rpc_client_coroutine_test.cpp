@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <up-cpp/rpc/ContinuationRpcClient.h>
+#include <up-cpp/transport/LoopbackTransport.h>
+#include <up-cpp/transport/builder/UAttributesBuilder.h>
+
+using namespace uprotocol::rpc;
+using namespace uprotocol::utransport;
+using namespace uprotocol::utils;
+using namespace uprotocol::v1;
+
+static UUri uri(uint32_t resource) {
+    UUri uri;
+    uri.mutable_entity()->set_id(200);
+    uri.mutable_entity()->set_version_major(1);
+    uri.mutable_resource()->set_id(resource);
+    return uri;
+}
+
+static const UUri method = uri(1);
+static const UUri clientUri = uri(0);
+
+/* server of method that keeps the requests it was sent until respond() is called; the loopback
+   transport matches listeners on the message source, so it listens to the client's URI */
+class DeferredServer : public UListener
+{
+public:
+    explicit DeferredServer(UTransport &transport) : transport_(transport) {
+        transport_.registerListener(clientUri, *this);
+    }
+
+    ~DeferredServer() {
+        transport_.unregisterListener(clientUri, *this);
+    }
+
+    UStatus onReceive(UMessage &message) const override {
+        UStatus status;
+        if (UMessageType::UMESSAGE_TYPE_REQUEST != message.attributes().type()) {
+            status.set_code(UCode::OK);
+            return status;
+        }
+        if (0 == message.payload().size()) {
+            status.set_code(UCode::INVALID_ARGUMENT);
+            return status;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.push_back(message.attributes());
+        status.set_code(UCode::OK);
+        return status;
+    }
+
+    /* answer the requests received so far, keep them to answer them again */
+    size_t respond(bool keep = false) {
+        std::vector<UAttributes> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending.swap(requests_);
+            if (keep) {
+                requests_ = pending;
+            }
+        }
+        for (const auto &request : pending) {
+            auto builder = UAttributesBuilder::response(method, request.source(), UPriority::UPRIORITY_CS4,
+                                                        uprotocol::uuid::Uuidv8Factory::create());
+            builder.setReqid(request.id());
+            /* a payload referencing the receive buffer, only valid during the callback */
+            uint8_t receiveBuffer[] = {9, 8, 7};
+            UMessage message(UPayload(receiveBuffer, sizeof(receiveBuffer), UPayloadType::REFERENCE),
+                             builder.build());
+            transport_.send(message);
+            receiveBuffer[0] = 0;
+        }
+        return pending.size();
+    }
+
+private:
+    UTransport &transport_;
+    mutable std::mutex mutex_;
+    mutable std::vector<UAttributes> requests_;
+};
+
+static const uint8_t requestData[] = {1, 2, 3};
+
+/* fire and forget coroutine, enough to drive an awaitable */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+struct Outcome {
+    std::atomic<bool> done {false};
+    UCode code = UCode::UNKNOWN;
+    size_t size = 0;
+    std::thread::id thread;
+};
+
+static DetachedTask awaitResponse(ContinuationRpcClient &client,
+                                  const UPayload &payload,
+                                  const CallOptions &options,
+                                  ThreadPool *executor,
+                                  Outcome &outcome) {
+    auto response = co_await client.awaitMethod(method, payload, options, executor);
+    outcome.code = response.status.code();
+    outcome.size = response.message.payload().size();
+    outcome.thread = std::this_thread::get_id();
+    outcome.done = true;
+}
+
+static bool waitFor(const Outcome &outcome) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((false == outcome.done.load()) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return outcome.done.load();
+}
+
+// Test that a coroutine is resumed with the response, or right away when the request fails
+TEST(RpcClientCoroutineTest, AwaitResponse)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+
+    Outcome answered;
+    awaitResponse(client, payload, CallOptions(), nullptr, answered);
+    EXPECT_FALSE(answered.done.load());
+    EXPECT_EQ(server.respond(), 1U);
+    EXPECT_TRUE(answered.done.load());
+    EXPECT_EQ(answered.code, UCode::OK);
+    EXPECT_EQ(answered.size, 3U);
+
+    Outcome failed;
+    awaitResponse(client, UPayload(), CallOptions(), nullptr, failed);
+    EXPECT_TRUE(failed.done.load());
+    EXPECT_EQ(failed.code, UCode::INVALID_ARGUMENT);
+    EXPECT_EQ(client.pending(), 0U);
+}
+
+// Test that a coroutine is resumed on the executor
+TEST(RpcClientCoroutineTest, AwaitOnExecutor)
+{
+    ThreadPool pool(16, 1);
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+
+    Outcome outcome;
+    awaitResponse(client, payload, CallOptions(), &pool, outcome);
+    EXPECT_EQ(server.respond(), 1U);
+    ASSERT_TRUE(waitFor(outcome));
+    EXPECT_EQ(outcome.code, UCode::OK);
+    /* the referenced receive buffer was retained before the coroutine was resumed */
+    EXPECT_EQ(outcome.size, 3U);
+    EXPECT_NE(outcome.thread, std::this_thread::get_id());
+}
+
+// Test that a coroutine is resumed with DEADLINE_EXCEEDED once its TTL elapsed
+TEST(RpcClientCoroutineTest, AwaitTimeout)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    CallOptions options;
+    options.set_ttl(100);
+
+    Outcome outcome;
+    awaitResponse(client, payload, options, nullptr, outcome);
+    EXPECT_EQ(client.expire(), 0U);
+    EXPECT_FALSE(outcome.done.load());
+    EXPECT_EQ(client.expire(std::chrono::steady_clock::now() + std::chrono::seconds(1)), 1U);
+    EXPECT_TRUE(outcome.done.load());
+    EXPECT_EQ(outcome.code, UCode::DEADLINE_EXCEEDED);
+
+    /* the late response does not resume the coroutine a second time */
+    EXPECT_EQ(server.respond(), 1U);
+}
+
+// Test that a coroutine is resumed with CANCELLED when the client goes away
+TEST(RpcClientCoroutineTest, AwaitCancelled)
+{
+    ThreadPool pool(16, 1);
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    Outcome direct;
+    Outcome posted;
+
+    {
+        ContinuationRpcClient client(transport, clientUri);
+        awaitResponse(client, payload, CallOptions(), nullptr, direct);
+        awaitResponse(client, payload, CallOptions(), &pool, posted);
+        EXPECT_FALSE(direct.done.load());
+        EXPECT_FALSE(posted.done.load());
+    }
+
+    EXPECT_TRUE(direct.done.load());
+    EXPECT_EQ(direct.code, UCode::CANCELLED);
+    ASSERT_TRUE(waitFor(posted));
+    EXPECT_EQ(posted.code, UCode::CANCELLED);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
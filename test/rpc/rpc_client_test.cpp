@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <up-cpp/rpc/ContinuationRpcClient.h>
+#include <up-cpp/transport/LoopbackTransport.h>
+#include <up-cpp/transport/builder/UAttributesBuilder.h>
+
+using namespace uprotocol::rpc;
+using namespace uprotocol::utransport;
+using namespace uprotocol::utils;
+using namespace uprotocol::v1;
+
+static UUri uri(uint32_t resource) {
+    UUri uri;
+    uri.mutable_entity()->set_id(200);
+    uri.mutable_entity()->set_version_major(1);
+    uri.mutable_resource()->set_id(resource);
+    return uri;
+}
+
+static const UUri method = uri(1);
+static const UUri clientUri = uri(0);
+
+/* server of method that keeps the requests it was sent until respond() is called; the loopback
+   transport matches listeners on the message source, so it listens to the client's URI */
+class DeferredServer : public UListener
+{
+public:
+    explicit DeferredServer(UTransport &transport) : transport_(transport) {
+        transport_.registerListener(clientUri, *this);
+    }
+
+    ~DeferredServer() {
+        transport_.unregisterListener(clientUri, *this);
+    }
+
+    UStatus onReceive(UMessage &message) const override {
+        UStatus status;
+        if (UMessageType::UMESSAGE_TYPE_REQUEST != message.attributes().type()) {
+            status.set_code(UCode::OK);
+            return status;
+        }
+        if (0 == message.payload().size()) {
+            status.set_code(UCode::INVALID_ARGUMENT);
+            return status;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.push_back(message.attributes());
+        status.set_code(UCode::OK);
+        return status;
+    }
+
+    /* answer the requests received so far, keep them to answer them again */
+    size_t respond(bool keep = false) {
+        std::vector<UAttributes> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending.swap(requests_);
+            if (keep) {
+                requests_ = pending;
+            }
+        }
+        for (const auto &request : pending) {
+            auto builder = UAttributesBuilder::response(method, request.source(), UPriority::UPRIORITY_CS4,
+                                                        uprotocol::uuid::Uuidv8Factory::create());
+            builder.setReqid(request.id());
+            /* a payload referencing the receive buffer, only valid during the callback */
+            uint8_t receiveBuffer[] = {9, 8, 7};
+            UMessage message(UPayload(receiveBuffer, sizeof(receiveBuffer), UPayloadType::REFERENCE),
+                             builder.build());
+            transport_.send(message);
+            receiveBuffer[0] = 0;
+        }
+        return pending.size();
+    }
+
+private:
+    UTransport &transport_;
+    mutable std::mutex mutex_;
+    mutable std::vector<UAttributes> requests_;
+};
+
+class Collector : public UListener
+{
+public:
+    UStatus onReceive(UMessage &message) const override {
+        messages.push_back(message);
+        return UStatus();
+    }
+
+    mutable std::vector<UMessage> messages;
+};
+
+static const uint8_t requestData[] = {1, 2, 3};
+
+// Test that the continuation runs on the thread delivering the response without an executor
+TEST(RpcClientTest, ContinuationInline)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    bool called = false;
+
+    auto status = client.invokeMethod(method, payload, CallOptions(),
+        [&called](RpcResponse &&response) {
+            called = true;
+            EXPECT_EQ(response.status.code(), UCode::OK);
+            EXPECT_EQ(response.message.attributes().priority(), UPriority::UPRIORITY_CS4);
+            EXPECT_EQ(response.message.payload().data()[0], 9);
+        });
+
+    EXPECT_EQ(status.code(), UCode::OK);
+    EXPECT_FALSE(called);
+    EXPECT_EQ(client.pending(), 1U);
+    EXPECT_EQ(server.respond(), 1U);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(client.pending(), 0U);
+}
+
+// Test that a request the transport refused does not call the continuation
+TEST(RpcClientTest, ContinuationNotCalledOnFailure)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    bool called = false;
+
+    auto status = client.invokeMethod(method, UPayload(), CallOptions(),
+        [&called](RpcResponse &&) { called = true; });
+
+    EXPECT_EQ(status.code(), UCode::INVALID_ARGUMENT);
+    EXPECT_EQ(client.pending(), 0U);
+    EXPECT_EQ(server.respond(), 0U);
+    EXPECT_FALSE(called);
+}
+
+// Test the future and listener overloads of the RpcClient interface
+TEST(RpcClientTest, FutureAndListener)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    RpcClient &rpc = client;
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::VALUE);
+    CallOptions options;
+    options.set_ttl(100);
+
+    auto future = rpc.invokeMethod(method, payload, options);
+    Collector callback;
+    EXPECT_EQ(rpc.invokeMethod(method, payload, options, callback).code(), UCode::OK);
+    EXPECT_EQ(server.respond(), 2U);
+
+    auto response = future.get();
+    EXPECT_EQ(response.status.code(), UCode::OK);
+    EXPECT_EQ(response.message.attributes().type(), UMessageType::UMESSAGE_TYPE_RESPONSE);
+    ASSERT_EQ(callback.messages.size(), 1U);
+    EXPECT_EQ(callback.messages[0].payload().size(), 3U);
+
+    /* a failure reaches the future as its status, and the listener as the commstatus */
+    EXPECT_EQ(rpc.invokeMethod(method, UPayload(), options).get().status.code(), UCode::INVALID_ARGUMENT);
+    EXPECT_EQ(rpc.invokeMethod(method, payload, options, callback).code(), UCode::OK);
+    EXPECT_EQ(client.expire(std::chrono::steady_clock::now() + std::chrono::seconds(1)), 1U);
+    ASSERT_EQ(callback.messages.size(), 2U);
+    EXPECT_EQ(callback.messages[1].attributes().commstatus(), UCode::DEADLINE_EXCEEDED);
+}
+
+// Test that the requests are sent from the client's URI with the call options
+TEST(RpcClientTest, RequestAttributes)
+{
+    LoopbackTransport transport;
+    ContinuationRpcClient client(transport, clientUri);
+    Collector requests;
+    transport.registerListener(clientUri, requests);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    CallOptions options;
+    options.set_ttl(250);
+    options.set_priority(UPriority::UPRIORITY_CS5);
+    options.set_token("secret");
+
+    EXPECT_EQ(client.invokeMethod(method, payload, options, [](RpcResponse &&) {}).code(), UCode::OK);
+    ASSERT_EQ(requests.messages.size(), 1U);
+    const auto &attributes = requests.messages[0].attributes();
+    EXPECT_EQ(attributes.type(), UMessageType::UMESSAGE_TYPE_REQUEST);
+    EXPECT_EQ(attributes.source().resource().id(), clientUri.resource().id());
+    EXPECT_EQ(attributes.sink().resource().id(), method.resource().id());
+    EXPECT_EQ(attributes.ttl(), 250);
+    EXPECT_EQ(attributes.priority(), UPriority::UPRIORITY_CS5);
+    EXPECT_EQ(attributes.token(), "secret");
+    transport.unregisterListener(clientUri, requests);
+}
+
+// Test that a full client refuses new requests
+TEST(RpcClientTest, ContinuationExhausted)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri, 16);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    UCode code = UCode::OK;
+    for (int i = 0; (i < 1000) && (UCode::OK == code); ++i) {
+        code = client.invokeMethod(method, payload, CallOptions(), [](RpcResponse &&) {}).code();
+    }
+    EXPECT_EQ(code, UCode::RESOURCE_EXHAUSTED);
+}
+
+// Test that the default streaming invocation delivers a small response as one last chunk
+TEST(RpcClientTest, StreamingDefaultSingleChunk)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    std::vector<RpcChunk> chunks;
+
+    auto status = client.invokeStreamingMethod(method, payload, CallOptions(),
+        [&chunks](RpcChunk &&chunk) { chunks.push_back(std::move(chunk)); });
+    EXPECT_EQ(status.code(), UCode::OK);
+    EXPECT_EQ(server.respond(), 1U);
+
+    ASSERT_EQ(chunks.size(), 1U);
+    EXPECT_EQ(chunks[0].status.code(), UCode::OK);
+    EXPECT_TRUE(chunks[0].last);
+    EXPECT_EQ(chunks[0].offset, 0U);
+    EXPECT_EQ(chunks[0].message.payload().size(), 3U);
+
+    status = client.invokeStreamingMethod(method, UPayload(), CallOptions(),
+        [&chunks](RpcChunk &&chunk) { chunks.push_back(std::move(chunk)); });
+    EXPECT_EQ(status.code(), UCode::INVALID_ARGUMENT);
+    EXPECT_EQ(server.respond(), 0U);
+    EXPECT_EQ(chunks.size(), 1U);
+}
+
+// Test that the default streaming invocation cuts a larger response into ordered slices
+TEST(RpcClientTest, StreamingDefaultChunks)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    std::vector<size_t> offsets;
+    std::vector<uint8_t> bytes;
+    bool last = false;
+
+    auto status = client.invokeStreamingMethod(method, payload, CallOptions(),
+        [&](RpcChunk &&chunk) {
+            EXPECT_EQ(chunk.status.code(), UCode::OK);
+            EXPECT_FALSE(last);
+            EXPECT_EQ(chunk.message.attributes().priority(), UPriority::UPRIORITY_CS4);
+            offsets.push_back(chunk.offset);
+            const auto *data = chunk.message.payload().data();
+            bytes.insert(bytes.end(), data, data + chunk.message.payload().size());
+            last = chunk.last;
+        },
+        nullptr, 2);
+    EXPECT_EQ(status.code(), UCode::OK);
+    EXPECT_EQ(server.respond(), 1U);
+
+    EXPECT_EQ(offsets, (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(bytes, (std::vector<uint8_t>{9, 8, 7}));
+    EXPECT_TRUE(last);
+}
+
+// Test that many outstanding requests resume on the executor
+TEST(RpcClientTest, ContinuationOnExecutor)
+{
+    constexpr int numRequests = 2000;
+    ThreadPool pool(numRequests, 2);
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri, numRequests);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    std::atomic<int> completed {0};
+    std::atomic<int> onCaller {0};
+    const auto caller = std::this_thread::get_id();
+
+    for (int i = 0; i < numRequests; ++i) {
+        auto status = client.invokeMethod(method, payload, CallOptions(),
+            [&completed, &onCaller, caller](RpcResponse &&response) {
+                if (caller == std::this_thread::get_id()) {
+                    ++onCaller;
+                }
+                /* resumed after the receive buffer was reused, the bytes must have been retained */
+                if ((UCode::OK == response.status.code()) && (9 == response.message.payload().data()[0])) {
+                    ++completed;
+                }
+            },
+            &pool);
+        ASSERT_EQ(status.code(), UCode::OK);
+    }
+
+    EXPECT_EQ(server.respond(), static_cast<size_t>(numRequests));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((completed.load() < numRequests) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(completed.load(), numRequests);
+    EXPECT_EQ(onCaller.load(), 0);
+}
+
+// Test that a request without a response times out once and a late response is ignored
+TEST(RpcClientTest, ContinuationTimeout)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    CallOptions options;
+    options.set_ttl(100);
+    std::vector<UCode> codes;
+
+    auto status = client.invokeMethod(method, payload, options,
+        [&codes](RpcResponse &&response) { codes.push_back(response.status.code()); });
+    ASSERT_EQ(status.code(), UCode::OK);
+
+    EXPECT_EQ(client.expire(), 0U);
+    EXPECT_TRUE(codes.empty());
+
+    const auto later = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    EXPECT_EQ(client.expire(later), 1U);
+    ASSERT_EQ(codes.size(), 1U);
+    EXPECT_EQ(codes[0], UCode::DEADLINE_EXCEEDED);
+    EXPECT_EQ(client.pending(), 0U);
+
+    EXPECT_EQ(server.respond(), 1U);
+    EXPECT_EQ(codes.size(), 1U);
+}
+
+// Test that only the first of two responses reaches the continuation, with or without a TTL
+TEST(RpcClientTest, ContinuationSecondResponse)
+{
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    ContinuationRpcClient client(transport, clientUri);
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    CallOptions timed;
+    timed.set_ttl(100);
+    int called = 0;
+
+    for (const auto &options : {timed, CallOptions()}) {
+        auto status = client.invokeMethod(method, payload, options,
+            [&called](RpcResponse &&) { ++called; });
+        ASSERT_EQ(status.code(), UCode::OK);
+    }
+
+    EXPECT_EQ(server.respond(true), 2U);
+    EXPECT_EQ(called, 2);
+    EXPECT_EQ(client.pending(), 0U);
+    EXPECT_EQ(client.expire(std::chrono::steady_clock::now() + std::chrono::seconds(1)), 0U);
+
+    /* the duplicates only find no request to complete */
+    EXPECT_EQ(server.respond(), 2U);
+    EXPECT_EQ(called, 2);
+}
+
+// Test that a request never answered is cancelled when the client goes away
+TEST(RpcClientTest, ContinuationCancelled)
+{
+    UPayload payload(requestData, sizeof(requestData), UPayloadType::REFERENCE);
+    ThreadPool pool(16, 1);
+    LoopbackTransport transport;
+    DeferredServer server(transport);
+    std::atomic<int> cancelled {0};
+
+    {
+        ContinuationRpcClient client(transport, clientUri);
+        for (auto *executor : {static_cast<ThreadPool *>(nullptr), &pool}) {
+            auto status = client.invokeMethod(method, payload, CallOptions(),
+                [&cancelled](RpcResponse &&response) {
+                    if (UCode::CANCELLED == response.status.code()) {
+                        ++cancelled;
+                    }
+                },
+                executor);
+            ASSERT_EQ(status.code(), UCode::OK);
+        }
+        EXPECT_EQ(client.expire(), 0U);
+        EXPECT_EQ(client.pending(), 2U);
+    }
+
+    /* the client is gone, a response to its requests reaches nobody */
+    EXPECT_EQ(server.respond(), 2U);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((cancelled.load() < 2) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(cancelled.load(), 2);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -25,7 +25,10 @@
 
 #include <up-cpp/utils/base64.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <array>
+#include <random>
+#include <vector>
 
 using namespace uprotocol::utils;
 
@@ -188,3 +191,120 @@ TEST_F(encodeDecodeTests, base64_decode_unpaddedInput){
     std::string decodedStrNoPadding = Base64::decode(encodeStrNoPadding);
     ASSERT_EQ(decodedStrNoPadding, origStr);
 };
+
+/**
+* Test Case: inputs shorter than one group
+*/
+TEST_F(encodeDecodeTests, shortInput){
+
+    ASSERT_EQ(Base64::encode(emptyString), emptyString);
+    ASSERT_EQ(Base64::encode(std::string("a")), "YQ==");
+    ASSERT_EQ(Base64::encode("ab", 2), "YWI=");
+
+    ASSERT_EQ(Base64::decode(emptyString), emptyString);
+    ASSERT_EQ(Base64::decode(std::string("Y")), emptyString);
+    ASSERT_EQ(Base64::decode(std::string("YQ")), "a");
+};
+
+/**
+* Test Case: decoding stops after len characters
+*/
+TEST_F(encodeDecodeTests, decode_honorsLength){
+
+    ASSERT_EQ(Base64::decode("YWJjZGVm", 4), "abc");
+    ASSERT_EQ(Base64::decode("YWJjZGVm", 6), "abcd");
+};
+
+/**
+* Test Case: random data round trips through the buffer interface, with every
+* tail length and large enough inputs to use the vector paths
+*/
+TEST_F(encodeDecodeTests, bufferRoundTrip){
+
+    std::mt19937 random(42);
+    for (size_t len : {0U, 1U, 2U, 3U, 27U, 28U, 29U, 30U, 47U, 48U, 49U, 63U, 64U, 65U, 1000U, 4096U, 65537U}) {
+        std::vector<uint8_t> data(len);
+        for (auto &byte : data) {
+            byte = static_cast<uint8_t>(random());
+        }
+
+        std::vector<char> encodedData(Base64::encodedLen(len));
+        ASSERT_EQ(Base64::encode(data.data(), len, encodedData.data()), encodedData.size());
+        ASSERT_EQ(std::string(encodedData.begin(), encodedData.end()),
+                  Base64::encode(reinterpret_cast<const char*>(data.data()), len));
+
+        std::vector<uint8_t> decodedData(Base64::maxDecodedLen(encodedData.size()));
+        ASSERT_EQ(Base64::decode(encodedData.data(), encodedData.size(), decodedData.data()), len);
+        decodedData.resize(len);
+        ASSERT_EQ(decodedData, data);
+    }
+};
+
+/**
+* Test Case: decoding stops at the first character outside of the alphabet, also inside the vector paths
+*/
+TEST_F(encodeDecodeTests, decode_stopsAtInvalidCharacter){
+
+    std::string data(300, 'x');
+    auto encodedStr = Base64::encode(data);
+
+    for (size_t pos : {0U, 1U, 2U, 3U, 5U, 33U, 70U, 130U, 200U}) {
+        auto corrupted = encodedStr;
+        corrupted[pos] = '*';
+        ASSERT_EQ(Base64::decode(corrupted), Base64::decode(encodedStr.substr(0, pos))) << pos;
+    }
+};
+
+/**
+* Test Case: streaming in chunks of any size gives the same result as one call
+*/
+TEST_F(encodeDecodeTests, streaming){
+
+    std::mt19937 random(7);
+    std::string data(5000, '\0');
+    for (auto &c : data) {
+        c = static_cast<char>(random());
+    }
+    const auto expected = Base64::encode(data);
+
+    for (size_t chunk : {1U, 2U, 3U, 5U, 31U, 100U, 4999U}) {
+        Base64::Encoder encoder;
+        std::string encodedStr;
+        for (size_t pos = 0U; pos < data.size(); pos += chunk) {
+            const auto len = std::min(chunk, data.size() - pos);
+            std::vector<char> out(Base64::Encoder::maxOutput(len));
+            auto n = encoder.update(reinterpret_cast<const uint8_t*>(data.data()) + pos, len, out.data());
+            encodedStr.append(out.data(), n);
+        }
+        char tail[4];
+        encodedStr.append(tail, encoder.finish(tail));
+        ASSERT_EQ(encodedStr, expected) << chunk;
+
+        Base64::Decoder decoder;
+        std::string decodedStr;
+        for (size_t pos = 0U; pos < encodedStr.size(); pos += chunk) {
+            const auto len = std::min(chunk, encodedStr.size() - pos);
+            std::vector<uint8_t> out(Base64::Decoder::maxOutput(len));
+            auto n = decoder.update(encodedStr.data() + pos, len, out.data());
+            decodedStr.append(reinterpret_cast<const char*>(out.data()), n);
+        }
+        uint8_t rest[2];
+        decodedStr.append(reinterpret_cast<const char*>(rest), decoder.finish(rest));
+        ASSERT_EQ(decodedStr, data) << chunk;
+    }
+};
+
+/**
+* Test Case: the streaming decoder ignores input after the padding
+*/
+TEST_F(encodeDecodeTests, streaming_stopsAtPadding){
+
+    Base64::Decoder decoder;
+    uint8_t out[16];
+    auto n = decoder.update("YWJjZA=", 7, out);
+    ASSERT_TRUE(decoder.done());
+    ASSERT_EQ(decoder.update("=YWJj", 5, out + n), 0U);
+    n += decoder.finish(out + n);
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(out), n), "abcd");
+    ASSERT_FALSE(decoder.done());
+};
@@ -25,6 +25,7 @@
  
  
  */
+#include <memory>
 #include <string>
 #include <gtest/gtest.h>
 #include "up-cpp/uri/builder/BuildUUri.h"
@@ -348,6 +349,40 @@ TEST(UUri, testResolvedUri) {
     assertTrue(isMicroForm(uri18));
 }
 
+// Build a whole UUri tree in place on an arena, without intermediate copies.
+TEST(UUri, testArenaInPlaceUri) {
+    google::protobuf::Arena arena;
+    BuildUUri uriBuilder(&arena);
+    auto *uri = uriBuilder.buildInPlace();
+    assertEquals(&arena, uri->GetArena());
+
+    BuildUAuthority(uri->mutable_authority()).setName("VCU", "MY_VIN");
+    BuildUEntity(uri->mutable_entity()).setName("body.access").setMajorVersion(1);
+    BuildUResource(uri->mutable_resource()).setName("door").setInstance("front_left");
+    assertEquals(&arena, uri->mutable_entity()->GetArena());
+
+    auto expected = BuildUUri()
+        .setAutority(BuildUAuthority().setName("VCU", "MY_VIN").build())
+        .setEntity(BuildUEntity().setName("body.access").setMajorVersion(1).build())
+        .setResource(BuildUResource().setName("door").setInstance("front_left").build())
+        .build();
+    assertEquals(LongUriSerializer::serialize(expected), LongUriSerializer::serialize(*uri));
+}
+
+// Copies of a builder with an owned message must not point into the source builder.
+TEST(UUri, testBuilderCopyOwnsMessage) {
+    auto original = std::make_unique<BuildUEntity>();
+    original->setName("body.access");
+    BuildUEntity copy(*original);
+    original.reset();
+
+    copy.setMajorVersion(2);
+    auto entity = copy.build();
+    assertEquals("body.access", entity.name());
+    assertEquals(2, entity.version_major());
+    assertTrue(copy.buildInPlace() != nullptr);
+}
+
 auto main([[maybe_unused]] int argc, [[maybe_unused]] const char** argv) -> int {
     ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
     return RUN_ALL_TESTS();
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <up-cpp/uri/serializer/BatchUriConverter.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+
+using namespace uprotocol::uri;
+
+/* name <-> id table of the test's entities, the resource id is the instance number */
+static auto resolve(uprotocol::v1::UUri& uri) -> bool {
+    auto* entity = uri.mutable_entity();
+    auto* resource = uri.mutable_resource();
+    if (entity->name().empty()) {
+        if (100 != entity->id()) {
+            return false;
+        }
+        entity->set_name("body.access");
+        resource->set_name("door");
+        resource->set_instance(std::to_string(resource->id()));
+        return true;
+    }
+    if ("body.access" != entity->name()) {
+        return false;
+    }
+    entity->set_id(100);
+    resource->set_id(static_cast<uint32_t>(std::stoul(resource->instance())));
+    return true;
+}
+
+/* a column of long URIs for doors 1..count, every tenth from an unknown entity */
+static auto makeColumn(std::size_t count) -> LongUriColumn {
+    LongUriColumn column;
+    for (std::size_t i = 0; i < count; ++i) {
+        column.chars += (0 == i % 10) ? "/unknown/1/door." : "/body.access/1/door.";
+        column.chars += std::to_string(i + 1);
+        column.offsets.push_back(column.chars.size());
+        column.errors.push_back(0);
+    }
+    return column;
+}
+
+// Test converting a column to micro form and back, in input order
+TEST(BatchUriConverter, RoundTripInOrder) {
+    uprotocol::utils::ThreadPool pool(64, 3);
+    const auto input = makeColumn(10000);
+
+    const auto micro = BatchUriConverter::longToMicro(input, &pool, resolve);
+    ASSERT_EQ(micro.size(), input.size());
+    ASSERT_EQ(micro.offsets.size(), input.size() + 1);
+    for (std::size_t i = 0; i < micro.size(); ++i) {
+        if (0 == i % 10) {
+            EXPECT_EQ(static_cast<uint8_t>(UriError::Unresolved), micro.errors[i]);
+            EXPECT_TRUE(micro.at(i).empty());
+            continue;
+        }
+        ASSERT_EQ(0, micro.errors[i]);
+        auto uri = MicroUriSerializer::deserialize(micro.at(i));
+        EXPECT_EQ(100, uri.entity().id());
+        EXPECT_EQ(i + 1, uri.resource().id());
+    }
+
+    const auto output = BatchUriConverter::microToLong(micro, &pool, resolve);
+    ASSERT_EQ(output.size(), input.size());
+    for (std::size_t i = 0; i < output.size(); ++i) {
+        if (0 == i % 10) {
+            EXPECT_EQ(static_cast<uint8_t>(UriError::Empty), output.errors[i]);
+            continue;
+        }
+        EXPECT_EQ(0, output.errors[i]);
+        EXPECT_EQ(input.at(i), output.at(i));
+    }
+}
+
+// Test that converting on the calling thread gives the same result as on a pool
+TEST(BatchUriConverter, WithoutPool) {
+    uprotocol::utils::ThreadPool pool(64, 2);
+    const auto input = makeColumn(500);
+
+    const auto serial = BatchUriConverter::longToMicro(input, nullptr, resolve);
+    const auto parallel = BatchUriConverter::longToMicro(input, &pool, resolve);
+    EXPECT_EQ(serial.bytes, parallel.bytes);
+    EXPECT_EQ(serial.offsets, parallel.offsets);
+    EXPECT_EQ(serial.errors, parallel.errors);
+
+    // without a resolver the long form has no ids to serialize
+    const auto unresolved = BatchUriConverter::longToMicro(input);
+    EXPECT_EQ(static_cast<uint8_t>(UriError::NotMicroForm), unresolved.errors[1]);
+    EXPECT_TRUE(unresolved.bytes.empty());
+
+    const auto empty = BatchUriConverter::longToMicro(LongUriColumn(), &pool);
+    EXPECT_EQ(0, empty.size());
+    EXPECT_EQ(1, empty.offsets.size());
+}
+
+// Test that malformed entries fail on their own
+TEST(BatchUriConverter, ErrorsPerEntry) {
+    const std::string arena = "/body.access/1/door.1" "" "/body.access/x/door.2";
+    const std::vector<std::size_t> offsets{0, 21, 21, arena.size()};
+
+    const auto micro = BatchUriConverter::longToMicro(arena, offsets.data(), 3, nullptr, resolve);
+    EXPECT_EQ(0, micro.errors[0]);
+    EXPECT_EQ(static_cast<uint8_t>(UriError::Empty), micro.errors[1]);
+    EXPECT_EQ(static_cast<uint8_t>(UriError::InvalidVersion), micro.errors[2]);
+    EXPECT_EQ("unresolved", toString(UriError::Unresolved));
+}
+
+auto main(int argc, const char** argv) -> int {
+    ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
+    return RUN_ALL_TESTS();
+}
@@ -738,6 +738,88 @@ TEST(LongUriSerializer, testBuildProtocolUriFromUriPartsWhenUriHasRemoteAuthorit
 }
 
 
+// Test tokenizing a remote URI into views without building a UUri.
+TEST(LongUriSerializer, testParseRemoteIntoViews) {
+    const std::string uri = "//VCU.MY_CAR_VIN/body.access/1.2/door.front_left#Door";
+    LongUriParts parts;
+    assertTrue(LongUriSerializer::parse(uri, parts));
+    assertFalse(parts.isLocal);
+    EXPECT_EQ("VCU.MY_CAR_VIN", parts.authority);
+    EXPECT_EQ("body.access", parts.entityName);
+    EXPECT_EQ("1.2", parts.entityVersion);
+    EXPECT_EQ(1, parts.versionMajor);
+    EXPECT_EQ(2, parts.versionMinor);
+    EXPECT_EQ("door", parts.resourceName);
+    EXPECT_EQ("front_left", parts.resourceInstance);
+    EXPECT_EQ("Door", parts.resourceMessage);
+
+    // views point into the input string
+    assertTrue(parts.entityName.data() >= uri.data() && parts.entityName.data() < uri.data() + uri.size());
+
+    auto u_uri = LongUriSerializer::deserialize(uri);
+    EXPECT_EQ("vcu.my_car_vin", u_uri.authority().name());
+    EXPECT_EQ(uri.substr(0, 2) + "vcu.my_car_vin/body.access/1.2/door.front_left#Door",
+              LongUriSerializer::serialize(u_uri));
+}
+
+// Test tokenizing local URIs, with backslashes and invalid input.
+TEST(LongUriSerializer, testParseLocal) {
+    LongUriParts parts;
+    assertTrue(LongUriSerializer::parse("\\body.access\\1\\rpc.Raise", parts));
+    assertTrue(parts.isLocal);
+    EXPECT_EQ("body.access", parts.entityName);
+    assertTrue(parts.hasVersionMajor);
+    assertFalse(parts.hasVersionMinor);
+    EXPECT_EQ("rpc", parts.resourceName);
+    EXPECT_EQ("Raise", parts.resourceInstance);
+
+    assertFalse(LongUriSerializer::parse("", parts));
+    assertFalse(LongUriSerializer::parse("body.access", parts));
+    assertFalse(LongUriSerializer::parse("/////body.access", parts));
+    assertFalse(LongUriSerializer::parse("//   /body.access", parts));
+}
+
+// Test serializing into a reused string.
+TEST(LongUriSerializer, testSerializeIntoReusedString) {
+    auto remote = BuildUUri()
+        .setAutority(BuildUAuthority().setName("vcu.my_car_vin").build())
+        .setEntity(BuildUEntity().setName(" body.access ").setMajorVersion(1).setMinorVersion(20).build())
+        .setResource(BuildUResource().setName("door").setInstance("front_left").setMessage("Door").build())
+        .build();
+    auto local = BuildUUri()
+        .setAutority(BuildUAuthority().build())
+        .setEntity(BuildUEntity().setName("body.access").build())
+        .build();
+
+    std::string out;
+    EXPECT_EQ(54, LongUriSerializer::serialize(remote, out));
+    EXPECT_EQ("//vcu.my_car_vin/body.access/1.20/door.front_left#Door", out);
+    EXPECT_EQ(LongUriSerializer::serialize(remote), out);
+
+    auto capacity = out.capacity();
+    EXPECT_EQ(13, LongUriSerializer::serialize(local, out));
+    EXPECT_EQ("/body.access/", out);
+    EXPECT_EQ(capacity, out.capacity());
+
+    EXPECT_EQ(0, LongUriSerializer::serialize(BuildUUri().build(), out));
+    assertTrue(out.empty());
+}
+
+// Test the error codes of tryDeserialize.
+TEST(LONG_URI, testTryDeserialize) {
+    auto u_uri = LongUriSerializer::tryDeserialize("//vcu.my_car_vin/body.access/1/door.front_left#Door");
+    assertTrue(u_uri.has_value());
+    EXPECT_EQ("vcu.my_car_vin", u_uri->authority().name());
+    EXPECT_EQ("body.access", u_uri->entity().name());
+    EXPECT_EQ(1, u_uri->entity().version_major());
+    EXPECT_EQ("front_left", u_uri->resource().instance());
+
+    EXPECT_EQ(UriError::Empty, LongUriSerializer::tryDeserialize("").error());
+    EXPECT_EQ(UriError::Malformed, LongUriSerializer::tryDeserialize("up:").error());
+    EXPECT_EQ(UriError::InvalidVersion, LongUriSerializer::tryDeserialize("/body.access/x/door").error());
+    EXPECT_EQ("invalid version", toString(UriError::InvalidVersion));
+}
+
 auto main(int argc, const char** argv) -> int {
     ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
     return RUN_ALL_TESTS();
@@ -22,6 +22,8 @@
  * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
+#include <array>
 #include <string>
 #include <gtest/gtest.h>
 #include <up-cpp/uri/serializer/MicroUriSerializer.h>
@@ -1023,6 +1025,73 @@ TEST(UUri, testDeserializeWithWrongSizeForIpv6MicroUri) {
     }
 }
 
+// Test serialize into and deserialize from caller provided buffers.
+TEST(UUri, testSerializeIntoBuffer) {
+    auto u_uri = BuildUUri()
+        .setAutority(BuildUAuthority().setId("vcu.vin").build())
+        .setEntity(BuildUEntity().setId(29999).setMajorVersion(254).build())
+        .setResource(BuildUResource().setID(19999).build())
+        .build();
+
+    std::array<uint8_t, MicroUriSerializer::MaxMicroUriLength> buffer{};
+    auto size = MicroUriSerializer::serialize(u_uri, buffer.data(), buffer.size());
+    auto expected = MicroUriSerializer::serialize(u_uri);
+    assertEquals(expected.size(), size);
+    assertTrue(std::equal(expected.begin(), expected.end(), buffer.begin()));
+
+    auto u_uri2 = MicroUriSerializer::deserialize(buffer.data(), size);
+    assertEquals("vcu.vin", u_uri2.authority().id());
+    assertEquals(29999, u_uri2.entity().id());
+    assertEquals(254, u_uri2.entity().version_major());
+    assertEquals(19999, u_uri2.resource().id());
+
+    // buffer too small
+    assertEquals(0, MicroUriSerializer::serialize(u_uri, buffer.data(), size - 1));
+    // truncated input
+    assertTrue(isEmpty(MicroUriSerializer::deserialize(buffer.data(), size - 1)));
+    assertTrue(isEmpty(MicroUriSerializer::deserialize(nullptr, 0)));
+}
+
+// Test the error codes of trySerialize and tryDeserialize.
+TEST(UUri, testTrySerializeErrors) {
+    auto u_uri = BuildUUri()
+        .setAutority(BuildUAuthority().setId("vcu.vin").build())
+        .setEntity(BuildUEntity().setId(29999).setMajorVersion(254).build())
+        .setResource(BuildUResource().setID(19999).build())
+        .build();
+
+    std::array<uint8_t, MicroUriSerializer::MaxMicroUriLength> buffer{};
+    auto size = MicroUriSerializer::trySerialize(u_uri, buffer.data(), buffer.size());
+    assertTrue(size.has_value());
+    assertEquals(MicroUriSerializer::serialize(u_uri).size(), *size);
+
+    auto u_uri2 = MicroUriSerializer::tryDeserialize(buffer.data(), *size);
+    assertTrue(u_uri2.has_value());
+    assertEquals("vcu.vin", u_uri2->authority().id());
+    assertEquals(19999, u_uri2->resource().id());
+
+    assertTrue(UriError::BufferTooSmall == MicroUriSerializer::trySerialize(u_uri, buffer.data(), *size - 1).error());
+    assertTrue(UriError::Empty == MicroUriSerializer::trySerialize(BuildUUri().build(), buffer.data(), buffer.size()).error());
+    auto long_form = BuildUUri()
+        .setAutority(BuildUAuthority().build())
+        .setEntity(BuildUEntity().setName("body.access").build())
+        .setResource(BuildUResource().setName("door").build())
+        .build();
+    assertTrue(UriError::NotMicroForm == MicroUriSerializer::trySerialize(long_form, buffer.data(), buffer.size()).error());
+
+    assertTrue(UriError::Empty == MicroUriSerializer::tryDeserialize(nullptr, 0).error());
+    assertTrue(UriError::Empty == MicroUriSerializer::tryDeserialize(std::vector<uint8_t>{}).error());
+    assertTrue(UriError::InvalidLength == MicroUriSerializer::tryDeserialize(buffer.data(), 3).error());
+    assertTrue(UriError::IdLengthMismatch == MicroUriSerializer::tryDeserialize(buffer.data(), *size - 1).error());
+
+    auto bad_version = buffer;
+    bad_version[0] = 9;
+    assertTrue(UriError::InvalidVersion == MicroUriSerializer::tryDeserialize(bad_version.data(), *size).error());
+    auto bad_type = buffer;
+    bad_type[1] = 9;
+    assertTrue(UriError::InvalidAuthorityType == MicroUriSerializer::tryDeserialize(bad_type.data(), *size).error());
+}
+
 auto main([[maybe_unused]] int argc, [[maybe_unused]] const char** argv) -> int {
     ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
     return RUN_ALL_TESTS();
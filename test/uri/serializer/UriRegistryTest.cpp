@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <up-cpp/uri/serializer/UriRegistry.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+
+using namespace uprotocol::uri;
+
+static auto localMicroUri(uint32_t entity_id, uint32_t version, uint32_t resource_id) -> uprotocol::v1::UUri {
+    return BuildUUri()
+        .setAutority(BuildUAuthority().build())
+        .setEntity(BuildUEntity().setName("body.access").setId(entity_id).setMajorVersion(version).build())
+        .setResource(BuildUResource().setName("door").setID(resource_id).build())
+        .build();
+}
+
+// Test that looking up the same long URI twice returns the same interned entry.
+TEST(UriRegistry, testLongLookupIsInterned) {
+    UriRegistry registry;
+    auto first = registry.fromLong("/body.access/1/door.front_left");
+    ASSERT_NE(nullptr, first);
+    auto second = registry.fromLong("/body.access/1/door.front_left");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ("body.access", first->uri.entity().name());
+    EXPECT_EQ("/body.access/1/door.front_left", first->longUri);
+    EXPECT_TRUE(first->microUri.empty());
+    EXPECT_EQ(0, first->key);
+
+    EXPECT_EQ(nullptr, registry.fromLong(""));
+}
+
+// Test translating between long, micro and key forms of an interned UUri.
+TEST(UriRegistry, testTranslateForms) {
+    UriRegistry registry;
+    auto uri = localMicroUri(0x1234, 3, 0x42);
+    auto entry = registry.intern(uri);
+    ASSERT_NE(nullptr, entry);
+
+    EXPECT_EQ(LongUriSerializer::serialize(uri), entry->longUri);
+    EXPECT_EQ(MicroUriSerializer::serialize(uri), entry->microUri);
+    EXPECT_EQ(0x0000'0003'1234'0042ULL, entry->key);
+
+    EXPECT_EQ(entry, registry.fromLong(entry->longUri));
+    EXPECT_EQ(entry, registry.fromMicro(entry->microUri));
+    EXPECT_EQ(entry, registry.fromKey(entry->key));
+    EXPECT_EQ(entry, registry.intern(uri));
+}
+
+// Test that unknown micro URIs and keys are parsed and interned.
+TEST(UriRegistry, testMicroAndKeyMiss) {
+    UriRegistry registry;
+    auto micro = MicroUriSerializer::serialize(localMicroUri(7, 1, 9));
+    auto from_micro = registry.fromMicro(micro);
+    ASSERT_NE(nullptr, from_micro);
+    EXPECT_EQ(7, from_micro->uri.entity().id());
+    EXPECT_EQ(UriRegistry::packKey(from_micro->uri), from_micro->key);
+
+    auto from_key = registry.fromKey(UriRegistry::packKey(localMicroUri(8, 2, 10)));
+    ASSERT_NE(nullptr, from_key);
+    EXPECT_EQ(8, from_key->uri.entity().id());
+    EXPECT_EQ(2, from_key->uri.entity().version_major());
+    EXPECT_EQ(10, from_key->uri.resource().id());
+
+    EXPECT_EQ(nullptr, registry.fromKey(0));
+    EXPECT_EQ(nullptr, registry.fromMicro(nullptr, 0));
+}
+
+// Test that each index is bounded and evicts the least recently used entries.
+TEST(UriRegistry, testBoundedLru) {
+    UriRegistry registry(32);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        registry.fromKey(UriRegistry::packKey(localMicroUri(i, 1, 1)));
+    }
+    EXPECT_LE(registry.size(), 3 * 32U + 3 * 16U);
+
+    registry.clear();
+    EXPECT_EQ(0U, registry.size());
+}
+
+// Test concurrent lookups of a shared set of URIs.
+TEST(UriRegistry, testConcurrentLookups) {
+    UriRegistry registry(256);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&registry]() {
+            for (int i = 0; i < 2000; ++i) {
+                auto uri = "/entity" + std::to_string(i % 100) + "/1/resource";
+                auto entry = registry.fromLong(uri);
+                ASSERT_NE(nullptr, entry);
+                EXPECT_EQ(uri, entry->longUri);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+auto main(int argc, const char** argv) -> int {
+    ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
+    return RUN_ALL_TESTS();
+}
@@ -26,6 +26,7 @@
 
  */
 #include <string>
+#include <random>
 #include <sstream>
 #include <arpa/inet.h>
 #include <gtest/gtest.h>
@@ -492,6 +493,71 @@ TEST(IPADDR, testFromBytesTypeMismatch) {
 
 }
 
+// Compare the parser and the formatter with inet_pton / inet_ntop
+TEST(IPADDR, testMatchesInet) {
+    std::mt19937 random(1234);
+
+    auto ntop = [](int family, const uint8_t* bytes) {
+        char buffer[INET6_ADDRSTRLEN];
+        return std::string(inet_ntop(family, bytes, buffer, sizeof(buffer)));
+    };
+
+    // Formatting random addresses, biased towards zero groups
+    for (int n = 0; n < 20000; ++n) {
+        std::vector<uint8_t> bytes(IpAddress::IpV6AddressBytes);
+        for (size_t i = 0; i < bytes.size(); i += 2) {
+            auto word = (random() % 3 == 0) ? random() : 0;
+            bytes[i] = static_cast<uint8_t>(word >> 8);
+            bytes[i + 1] = static_cast<uint8_t>((random() % 4 == 0) ? 0 : word);
+        }
+        if (random() % 8 == 0) {
+            bytes[10] = bytes[11] = 0xff;
+        }
+        auto ipv6 = IpAddress(bytes, IpAddress::Type::IpV6);
+        assertEquals(ntop(AF_INET6, bytes.data()), ipv6.getString());
+
+        bytes.resize(IpAddress::IpV4AddressBytes);
+        auto ipv4 = IpAddress(bytes, IpAddress::Type::IpV4);
+        assertEquals(ntop(AF_INET, bytes.data()), ipv4.getString());
+    }
+
+    // Parsing random strings made of address tokens
+    static const char* tokens[] = {"0", "1", "01", "255", "256", "ffff", "FfF0", "12345", "g",
+                                   ":", ":", "::", ".", ".", "1.2.3.4", "0.0.0.0"};
+    for (int n = 0; n < 20000; ++n) {
+        std::string address;
+        for (auto count = 1 + random() % 12; count > 0; --count) {
+            address += tokens[random() % (sizeof(tokens) / sizeof(tokens[0]))];
+        }
+
+        uint8_t bytes[IpAddress::IpV6AddressBytes];
+        auto ipa = IpAddress(address);
+        if (1 == inet_pton(AF_INET6, address.c_str(), bytes)) {
+            assertEquals(IpAddress::Type::IpV6, ipa.getType());
+            assertEquals(std::string(reinterpret_cast<char*>(bytes), IpAddress::IpV6AddressBytes), ipa.getBytesString());
+        } else if (1 == inet_pton(AF_INET, address.c_str(), bytes)) {
+            assertEquals(IpAddress::Type::IpV4, ipa.getType());
+            assertEquals(std::string(reinterpret_cast<char*>(bytes), IpAddress::IpV4AddressBytes), ipa.getBytesString());
+        } else {
+            assertEquals(IpAddress::Type::Invalid, ipa.getType());
+        }
+    }
+}
+
+// Make sure formatting into a caller provided buffer respects its size
+TEST(IPADDR, testFormatBuffer) {
+    auto ipa = IpAddress(std::vector<uint8_t>{192, 168, 100, 200}, IpAddress::Type::IpV4);
+    char buffer[IpAddress::MaxStringLength];
+    auto length = ipa.format(buffer, sizeof(buffer));
+    assertEquals("192.168.100.200", std::string(buffer, length));
+    assertEquals(0, ipa.format(buffer, 14));
+    assertEquals(0, IpAddress("not an address").format(buffer, sizeof(buffer)));
+
+    auto longest = IpAddress("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255");
+    assertEquals(IpAddress::Type::IpV6, longest.getType());
+    assertEquals(IpAddress::MaxStringLength, longest.format(buffer, sizeof(buffer)));
+}
+
 auto main([[maybe_unused]] int argc, [[maybe_unused]] const char** argv) -> int {
     ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
     return RUN_ALL_TESTS();
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+#include <up-cpp/uri/serializer/UriRegistry.h>
+#include <up-cpp/uri/tools/StaticUri.h>
+
+using namespace uprotocol::uri;
+using namespace uprotocol::uri::literals;
+using namespace uprotocol::v1;
+
+#define assertTrue(a) EXPECT_TRUE(a)
+#define assertEquals(a, b) EXPECT_EQ((b), (a))
+#define assertFalse(a) assertTrue(!(a))
+
+constexpr StaticUri DoorTopic("/body.access/1/door.front_left#Door", 0x1102, 0x8001);
+constexpr auto RemoteTopic = "//VCU.vin/body.access/2.7/door.front_left#Door"_uri;
+
+static_assert(DoorTopic.isMicroForm());
+static_assert(DoorTopic.micro()[2] == 0x80 && DoorTopic.micro()[5] == 0x02 && DoorTopic.micro()[6] == 1);
+static_assert(DoorTopic.key() == 0x01'1102'8001ULL);
+static_assert(!RemoteTopic.isMicroForm() && RemoteTopic.key() == 0);
+static_assert(RemoteTopic.fields().versionMinor == 7);
+static_assert(DoorTopic.hash() != StaticUri("/body.access/1/door.front_left#Door").hash());
+
+// Make sure the constants agree with the serializers
+TEST(STATICURI, testMatchesSerializers) {
+    auto uri = DoorTopic.uri();
+    assertEquals(MicroUriSerializer::serialize(uri),
+                 std::vector<uint8_t>(DoorTopic.micro().begin(), DoorTopic.micro().end()));
+    assertEquals(UriRegistry::packKey(uri), DoorTopic.key());
+    assertEquals(UriHash{}(uri), DoorTopic.hash());
+    assertEquals("/body.access/1/door.front_left#Door", LongUriSerializer::serialize(uri));
+    assertEquals(0x1102U, uri.entity().id());
+    assertEquals(0x8001U, uri.resource().id());
+
+    auto remote = RemoteTopic.uri();
+    assertTrue(LongUriSerializer::deserialize(RemoteTopic.longUri()) == remote);
+    assertEquals("vcu.vin", remote.authority().name());
+    assertEquals(UriHash{}(remote), RemoteTopic.hash());
+    assertEquals(UriHash{}(RemoteTopic.longUri()), RemoteTopic.hash());
+}
+
+// Make sure the long forms the serializer writes are accepted as they deserialize
+TEST(STATICURI, testLongForms) {
+    static const char *uris[] = {
+        "/body.access/1",
+        "/body.access/1/door",
+        "/body.access/1/door.front_left",
+        "/body.access/1/door#Door",
+        "/core.usubscription/3.1/rpc.Subscribe#SubscribeRequest",
+        "//vcu.vin/body.access/1/door.front_left#Door",
+        "//vcu.vin/body.access/0",
+    };
+    for (const auto *text : uris) {
+        StaticUri uri{std::string_view(text)};
+        assertTrue(LongUriSerializer::deserialize(text) == uri.uri());
+        assertEquals(text, LongUriSerializer::serialize(uri.uri()));
+        assertEquals(UriHash{}(std::string_view(text)), uri.hash());
+        assertTrue(InternedUri::probe(std::string_view(text)) == uri.probe());
+    }
+}
+
+// Make sure the forms a static topic may not have are rejected
+TEST(STATICURI, testInvalid) {
+    static const char *uris[] = {
+        "", "/", "body.access/1", "/body.access", "/body.access/", "/body.access/x", "/body.access/1.",
+        "/body.access/1/", "/body.access//door", "/body access/1", "/body.access/1/door.", "/body.access/1/#Door",
+        "/body.access/1/door#", "/body.access/1/door#a#b", "/body.access/1/door/more", "//vcu.vin",
+        "//vcu.vin/", "///body.access/1", "/body\\access/1", "/body.access/99999999999",
+    };
+    for (const auto *text : uris) {
+        EXPECT_THROW(StaticUri{std::string_view(text)}, std::invalid_argument) << text;
+    }
+}
+
+// Make sure static topics find what the registry and the maps hold
+TEST(STATICURI, testLookups) {
+    UriRegistry registry;
+    auto entry = registry.fromKey(DoorTopic.key());
+    assertTrue(nullptr != entry);
+    assertEquals(DoorTopic.micro().size(), entry->microUri.size());
+
+    UriMap<int> map;
+    map.emplace(DoorTopic.interned(), 1);
+    map.emplace(RemoteTopic.interned(), 2);
+    assertEquals(1, map.at(DoorTopic.probe()));
+    assertEquals(2, map.at(RemoteTopic.probe()));
+    assertEquals(2, map.at(InternedUri::probe(std::string_view("//vcu.vin/body.access/2.7/door.front_left#Door"))));
+}
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] const char** argv) -> int {
+    ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <gtest/gtest.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+#include <up-cpp/uri/serializer/UriRegistry.h>
+#include <up-cpp/uri/tools/UriHash.h>
+
+using namespace uprotocol::uri;
+using namespace uprotocol::v1;
+
+#define assertTrue(a) EXPECT_TRUE(a)
+#define assertEquals(a, b) EXPECT_EQ((b), (a))
+#define assertFalse(a) assertTrue(!(a))
+
+static auto randomMicro(std::mt19937 &random) -> std::vector<uint8_t> {
+    std::vector<uint8_t> micro(random() % 32);
+    for (auto &byte : micro) {
+        byte = static_cast<uint8_t>((random() % 4) ? random() % 3 : random());
+    }
+    if (micro.size() > 8 && (random() % 2)) {
+        micro[0] = 1;
+        micro[1] = 3;
+        micro[8] = static_cast<uint8_t>(micro.size() - 9);
+    } else if (random() % 2) {
+        micro.resize(std::vector<size_t>{8, 12, 24}[random() % 3]);
+        micro[0] = 1;
+        micro[1] = static_cast<uint8_t>(random() % 3);
+    }
+    return micro;
+}
+
+// Make sure a micro URI probe finds the UUri the URI deserializes to
+TEST(URIHASH, testMicroProbeMatchesDeserialize) {
+    std::mt19937 random(5);
+
+    for (int n = 0; n < 20000; ++n) {
+        auto micro = randomMicro(random);
+        MicroUriView view{micro.data(), micro.size()};
+        auto uri = MicroUriSerializer::deserialize(micro.data(), micro.size());
+
+        InternedUri interned(uri);
+        auto probe = InternedUri::probe(view);
+        assertEquals(interned.hash(), probe.hash());
+        assertTrue(interned == probe);
+        assertEquals(UriHash{}(uri), UriHash{}(view));
+        assertTrue(UriEqual{}(uri, view));
+        assertTrue(nullptr == probe.uri());
+    }
+}
+
+// Make sure a long URI probe finds the UUri the URI deserializes to
+TEST(URIHASH, testLongProbeMatchesDeserialize) {
+    std::mt19937 random(9);
+    static const std::string tokens[] = {"/", "/", "//", "VCU.vin", "vcu.vin", "body.access", " ", "1", "2",
+                                         "door.front#Door", "rpc.Raise", "rpc", "."};
+
+    for (int n = 0; n < 20000; ++n) {
+        std::string longUri;
+        for (auto count = random() % 8; count > 0; --count) {
+            longUri += tokens[random() % (sizeof(tokens) / sizeof(tokens[0]))];
+        }
+        /* malformed versions throw from both, like std::stoi */
+        UUri uri;
+        try {
+            uri = LongUriSerializer::deserialize(longUri);
+        } catch (const std::exception &) {
+            EXPECT_ANY_THROW(InternedUri::probe(std::string_view(longUri)));
+            continue;
+        }
+
+        InternedUri interned(uri);
+        auto probe = InternedUri::probe(std::string_view(longUri));
+        assertEquals(interned.hash(), probe.hash());
+        assertTrue(interned == probe);
+        assertTrue(UriEqual{}(std::string_view(longUri), uri));
+    }
+}
+
+// Make sure different URIs are told apart
+TEST(URIHASH, testDistinct) {
+    UriMap<int> map;
+    for (uint32_t entity = 1; entity <= 16; ++entity) {
+        for (uint32_t resource = 1; resource <= 64; ++resource) {
+            UUri uri;
+            uri.mutable_entity()->set_id(entity);
+            uri.mutable_entity()->set_version_major(1);
+            uri.mutable_resource()->set_id(resource);
+            assertTrue(map.emplace(InternedUri(uri), static_cast<int>(entity * 100 + resource)).second);
+        }
+    }
+    assertEquals(16U * 64U, map.size());
+
+    uint8_t buffer[MicroUriSerializer::MaxMicroUriLength];
+    for (uint32_t entity = 1; entity <= 16; ++entity) {
+        for (uint32_t resource = 1; resource <= 64; ++resource) {
+            UUri uri;
+            uri.mutable_entity()->set_id(entity);
+            uri.mutable_entity()->set_version_major(1);
+            uri.mutable_resource()->set_id(resource);
+            auto size = MicroUriSerializer::serialize(uri, buffer, sizeof(buffer));
+            auto found = map.find(InternedUri::probe(MicroUriView{buffer, size}));
+            assertTrue(map.end() != found);
+            if (map.end() != found) {
+                assertEquals(static_cast<int>(entity * 100 + resource), found->second);
+                assertTrue(nullptr != found->first.uri());
+            }
+        }
+    }
+
+    assertTrue(map.end() == map.find(InternedUri::probe(std::string_view("/body.access/1/door.front_left#Door"))));
+}
+
+// Make sure UUri works as a standard container key, with names compared as the long form does
+TEST(URIHASH, testStdContainers) {
+    auto uri = LongUriSerializer::deserialize("//VCU.vin/body.access/1/door.front_left#Door");
+    std::unordered_map<UUri, int> map;
+    map[uri] = 1;
+    map[LongUriSerializer::deserialize("//vcu.VIN/body.access/1/door.front_left#Door")] += 1;
+    map[LongUriSerializer::deserialize("//vcu.vin/body.access/2/door.front_left#Door")] = 3;
+    assertEquals(2U, map.size());
+    assertEquals(2, map[uri]);
+
+    UriMap<int> interned;
+    interned.emplace(InternedUri(uri), 7);
+    auto found = interned.find(InternedUri::probe(std::string_view("//Vcu.Vin/body.access/1/door.front_left#Door")));
+    assertTrue(interned.end() != found);
+    assertTrue(interned.end() == interned.find(InternedUri::probe(std::string_view("//vcu.vin/body.access/1/door.front_left"))));
+}
+
+// Make sure registry entries carry the hash of their UUri
+TEST(URIHASH, testRegistryEntries) {
+    UriRegistry registry;
+    auto entry = registry.fromLong("//vcu.vin/body.access/1/door.front_left#Door");
+    assertTrue(nullptr != entry);
+    assertEquals(UriHash{}(entry->uri), entry->hash);
+
+    InternedUri key(entry);
+    assertEquals(&entry->uri, key.uri());
+    assertTrue(key == InternedUri(entry->uri));
+
+    auto micro = registry.fromKey(0x01'0005'0007ULL);
+    assertTrue(nullptr != micro);
+    assertTrue(InternedUri(micro) ==
+               InternedUri::probe(MicroUriView{micro->microUri.data(), micro->microUri.size()}));
+}
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] const char** argv) -> int {
+    ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+#include <up-cpp/uri/tools/UriKey.h>
+#include <up-cpp/uri/validator/UriValidator.h>
+
+using namespace uprotocol::uri;
+using namespace uprotocol::v1;
+
+#define assertTrue(a) EXPECT_TRUE(a)
+#define assertEquals(a, b) EXPECT_EQ((b), (a))
+#define assertFalse(a) assertTrue(!(a))
+
+// Pick one of the values, or leave the field unset for the last one
+template<typename T, size_t N>
+static auto pick(std::mt19937 &random, const T (&values)[N]) -> const T & {
+    return values[random() % N];
+}
+
+static auto randomUri(std::mt19937 &random) -> UUri {
+    static const std::string names[] = {"", " ", "vcu.vin", "body.access", "rpc", "door", "-"};
+    static const std::string addresses[] = {"", std::string(4, '\1'), std::string(16, '\2'), "abc", " ", "id"};
+    static const uint32_t ids[] = {0, 1, 5, 255, 70000, UINT32_MAX};
+
+    UUri uri;
+    auto *authority = uri.mutable_authority();
+    if (random() % 2) {
+        authority->set_name(pick(random, names));
+    }
+    switch (random() % 3) {
+        case 0: authority->set_ip(pick(random, addresses)); break;
+        case 1: authority->set_id(pick(random, addresses)); break;
+        default: break;
+    }
+
+    auto *entity = uri.mutable_entity();
+    entity->set_name(pick(random, names));
+    if (random() % 2) {
+        entity->set_id(pick(random, ids));
+    }
+    if (random() % 2) {
+        entity->set_version_major(pick(random, ids));
+    }
+
+    auto *resource = uri.mutable_resource();
+    resource->set_name(pick(random, names));
+    if (random() % 2) {
+        resource->set_instance(pick(random, names));
+    }
+    if (random() % 2) {
+        resource->set_message(pick(random, names));
+    }
+    if (random() % 2) {
+        resource->set_id(pick(random, ids));
+    }
+
+    return uri;
+}
+
+// Make sure the classification bits agree with Utils.h and MicroUriSerializer.h
+TEST(URIKEY, testClassificationMatchesUtils) {
+    std::mt19937 random(42);
+
+    for (int n = 0; n < 50000; ++n) {
+        auto uri = randomUri(random);
+        auto key = UriKey::of(uri);
+
+        assertEquals(isEmpty(uri), key.isEmpty());
+        assertEquals(isResolved(uri), key.isResolved());
+        assertEquals(isMicroForm(uri), key.isMicroForm());
+        assertEquals(isLongForm(uri), key.isLongForm());
+        assertEquals(isLocal(uri.authority()), key.isLocal());
+        assertEquals(isRemote(uri.authority()), key.isRemote());
+        assertEquals(static_cast<uint16_t>(uri.resource().id()), key.resourceId());
+        assertEquals(static_cast<uint16_t>(uri.entity().id()), key.entityId());
+        assertEquals(static_cast<uint8_t>(uri.entity().version_major()), key.versionMajor());
+    }
+}
+
+// Make sure keys of micro URIs agree with the keys of the UUris they deserialize to
+TEST(URIKEY, testFromMicroMatchesDeserialize) {
+    std::mt19937 random(7);
+
+    for (int n = 0; n < 20000; ++n) {
+        std::vector<uint8_t> micro(random() % 32);
+        for (auto &byte : micro) {
+            byte = static_cast<uint8_t>((random() % 4) ? random() % 3 : random());
+        }
+        if (micro.size() > 8 && (random() % 2)) {
+            micro[0] = 1;
+            micro[1] = 3;
+            micro[8] = static_cast<uint8_t>(micro.size() - 9);
+            if (random() % 4 == 0) {
+                std::fill(micro.begin() + 9, micro.end(), ' ');
+            }
+        } else if (random() % 2) {
+            micro.resize(std::vector<size_t>{8, 12, 24}[random() % 3]);
+            micro[0] = 1;
+            micro[1] = static_cast<uint8_t>(random() % 3);
+        }
+
+        auto key = UriKey::fromMicro(micro.data(), micro.size());
+        auto uri = MicroUriSerializer::deserialize(micro.data(), micro.size());
+        assertEquals(UriKey::of(uri), key);
+        assertEquals(!isEmpty(uri) && isMicroForm(uri), valid_micro_uri(micro.data(), micro.size()));
+    }
+    assertTrue(UriKey::fromMicro(nullptr, 0).isEmpty());
+}
+
+// Make sure a serializable key serializes and round trips to the same key
+TEST(URIKEY, testSerializable) {
+    std::mt19937 random(3);
+    uint8_t buffer[MicroUriSerializer::MaxMicroUriLength];
+    size_t serializable = 0;
+
+    for (int n = 0; n < 20000; ++n) {
+        auto uri = randomUri(random);
+        auto key = UriKey::of(uri);
+        auto size = MicroUriSerializer::serialize(uri, buffer, sizeof(buffer));
+        assertEquals(0 != size, key.isSerializable());
+        /* a blank id authority does not survive deserialize(), see testFromMicroMatchesDeserialize */
+        if ((0 != size) && !(uri.authority().has_id() && isBlank(uri.authority().id()))) {
+            ++serializable;
+            auto micro = UriKey::fromMicro(buffer, size);
+            /* deserialize always sets the major version, so compare the micro parts */
+            assertEquals(key.resourceId(), micro.resourceId());
+            assertEquals(key.entityId(), micro.entityId());
+            assertEquals(key.versionMajor(), micro.versionMajor());
+            assertEquals(key.authorityKind(), micro.authorityKind());
+            assertEquals(key.fingerprint(), micro.fingerprint());
+        }
+    }
+    assertTrue(serializable > 0);
+}
+
+// Make sure valid_uri agrees with deserializing the long URI
+TEST(URIKEY, testValidUri) {
+    std::mt19937 random(11);
+    static const std::string tokens[] = {"/", "/", "//", "\\", "vcu.vin", "body.access", " ", "1", "2.7",
+                                         "door.front#Door", "rpc.Raise", "rpc", ".", "#"};
+
+    for (int n = 0; n < 20000; ++n) {
+        std::string uri;
+        for (auto count = random() % 8; count > 0; --count) {
+            uri += pick(random, tokens);
+        }
+        /* malformed versions throw from both, like std::stoi */
+        bool expected;
+        try {
+            expected = !isEmpty(LongUriSerializer::deserialize(uri));
+        } catch (const std::exception &) {
+            EXPECT_ANY_THROW(valid_uri(uri));
+            continue;
+        }
+        assertEquals(expected, valid_uri(uri));
+    }
+    assertTrue(valid_uri("/body.access/1/door.front_left#Door"));
+    assertTrue(valid_uri("//vcu.vin/body.access/1/door.front_left#Door"));
+    assertFalse(valid_uri("/"));
+    assertFalse(valid_uri(""));
+}
+
+// Make sure the key fields land where they are documented
+TEST(URIKEY, testLayout) {
+    UUri uri;
+    uri.mutable_entity()->set_id(0x1234);
+    uri.mutable_entity()->set_version_major(0x56);
+    uri.mutable_resource()->set_id(0x789a);
+
+    auto key = UriKey::of(uri);
+    assertEquals(0x56'1234'789aULL, key.value() & 0xff'ffff'ffffULL);
+    assertEquals(UriKey::AuthorityKind::Local, key.authorityKind());
+    assertEquals(0, key.fingerprint());
+    assertTrue(key.isLocal());
+    assertTrue(key.isMicroForm());
+    assertTrue(key.isSerializable());
+
+    auto remote = uri;
+    remote.mutable_authority()->set_ip(std::string("\xc0\xa8\x01\x64", 4));
+    auto remoteKey = UriKey::of(remote);
+    assertEquals(UriKey::AuthorityKind::IpV4, remoteKey.authorityKind());
+    assertTrue(remoteKey.isRemote());
+    assertTrue(remoteKey != key);
+    assertEquals(key.value() & 0xff'ffff'ffffULL, remoteKey.value() & 0xff'ffff'ffffULL);
+}
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] const char** argv) -> int {
+    ::testing::InitGoogleTest(&argc, const_cast<char **>(argv));
+    return RUN_ALL_TESTS();
+}
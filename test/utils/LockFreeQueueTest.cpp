@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <up-cpp/utils/CyclicQueue.h>
+#include <up-cpp/utils/LockFreeQueue.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace uprotocol::utils;
+
+// Test the FIFO order of the MPMC queue
+TEST(LockFreeQueueTest, MpmcFifoOrder)
+{
+    MpmcQueue<int> queue(8, std::chrono::milliseconds(1));
+
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_EQ(queue.size(), 5U);
+
+    int value = -1;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(queue.waitPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_FALSE(queue.waitPop(value));
+}
+
+// Test that a full queue drops the oldest element, same as CyclicQueue
+TEST(LockFreeQueueTest, DropOldestOnOverflow)
+{
+    SpscQueue<std::string> queue(3, std::chrono::milliseconds(1));
+
+    for (int i = 0; i < 5; ++i) {
+        std::string value = std::to_string(i);
+        EXPECT_TRUE(queue.push(value));
+    }
+    EXPECT_TRUE(queue.isFull());
+
+    std::string value;
+    EXPECT_TRUE(queue.waitPop(value));
+    EXPECT_EQ(value, "2");
+    EXPECT_TRUE(queue.waitPop(value));
+    EXPECT_EQ(value, "3");
+    EXPECT_TRUE(queue.waitPop(value));
+    EXPECT_EQ(value, "4");
+}
+
+// Test that tryPush refuses to overwrite when the queue is full
+TEST(LockFreeQueueTest, TryPushWhenFull)
+{
+    MpmcQueue<int> queue(2, std::chrono::milliseconds(1));
+
+    int value = 1;
+    EXPECT_TRUE(queue.tryPush(value));
+    EXPECT_TRUE(queue.tryPush(value));
+    EXPECT_FALSE(queue.tryPush(value));
+
+    queue.clear();
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+// Test that a sleeping consumer is woken up by a push
+TEST(LockFreeQueueTest, WaitPopWakesOnPush)
+{
+    MpmcQueue<int> queue(4, std::chrono::milliseconds(5000));
+
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        int value = 42;
+        queue.push(value);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    int value = 0;
+    EXPECT_TRUE(queue.waitPop(value));
+    EXPECT_EQ(value, 42);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2000));
+
+    producer.join();
+}
+
+// Test several producers and consumers without losing elements
+TEST(LockFreeQueueTest, MpmcConcurrent)
+{
+    constexpr int numProducers = 4;
+    constexpr int numPerProducer = 10000;
+    MpmcQueue<int> queue(1024, std::chrono::milliseconds(100));
+
+    std::atomic<long> sum { 0 };
+    std::atomic<int> received { 0 };
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < numProducers; ++p) {
+        threads.emplace_back([&queue]() {
+            for (int i = 1; i <= numPerProducer; ++i) {
+                int value = i;
+                while (false == queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&]() {
+            int value;
+            while (received.load() < numProducers * numPerProducer) {
+                if (queue.waitPop(value)) {
+                    sum += value;
+                    ++received;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(received.load(), numProducers * numPerProducer);
+    EXPECT_EQ(sum.load(), static_cast<long>(numProducers) * numPerProducer * (numPerProducer + 1) / 2);
+}
+
+static const WaitStrategy Strategies[] = {
+    WaitStrategy::BusySpin, WaitStrategy::SpinYield, WaitStrategy::SpinPark, WaitStrategy::Blocking
+};
+
+// Test the hand-off and the timeout of every wait strategy, for both queue types
+template<typename Queue>
+static void testWaitStrategies()
+{
+    for (auto strategy : Strategies) {
+        Queue queue(4, std::chrono::milliseconds(20), strategy, 64);
+        EXPECT_EQ(queue.waitStrategy(), strategy);
+
+        auto start = std::chrono::steady_clock::now();
+        int value = 0;
+        EXPECT_FALSE(queue.waitPop(value));
+        EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+        std::thread producer([&queue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            int pushed = 42;
+            queue.push(pushed);
+        });
+        bool popped = false;
+        for (int i = 0; (i < 10) && (false == popped); ++i) {
+            popped = queue.waitPop(value);
+        }
+        EXPECT_TRUE(popped);
+        EXPECT_EQ(value, 42);
+        producer.join();
+    }
+}
+
+TEST(LockFreeQueueTest, WaitStrategies)
+{
+    testWaitStrategies<MpmcQueue<int>>();
+    testWaitStrategies<CyclicQueue<int>>();
+}
+
+// Test that wakeAll() releases consumers that wait forever
+template<typename Queue>
+static void testWakeAll()
+{
+    for (auto strategy : Strategies) {
+        Queue queue(4, WaitForever, strategy, 64);
+
+        std::atomic<int> returned { 0 };
+        std::thread consumer([&queue, &returned]() {
+            int value = 0;
+            EXPECT_FALSE(queue.waitPop(value));
+            ++returned;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(returned.load(), 0);
+
+        /* the consumer may not have started waiting yet */
+        while (0 == returned.load()) {
+            queue.wakeAll();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        consumer.join();
+        EXPECT_EQ(returned.load(), 1);
+    }
+}
+
+TEST(LockFreeQueueTest, WaitForeverWakeAll)
+{
+    testWakeAll<MpmcQueue<int>>();
+    testWakeAll<CyclicQueue<int>>();
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/* strip info and below from this test, before anything includes Log.h */
+#undef UP_CPP_LOG_LEVEL
+#define UP_CPP_LOG_LEVEL SPDLOG_LEVEL_WARN
+#include <up-cpp/utils/Log.h>
+#include <gtest/gtest.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace uprotocol::utils;
+
+class LogTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            previous_ = spdlog::default_logger();
+            auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(output_);
+            sink->set_pattern("%l %v");
+            spdlog::set_default_logger(std::make_shared<spdlog::logger>("test", sink));
+            spdlog::set_level(spdlog::level::trace);
+        }
+
+        void TearDown() override {
+            log::disableAsync();
+            log::setRateLimit(log::DefaultBurst, log::DefaultInterval);
+            spdlog::set_default_logger(previous_);
+        }
+
+        size_t lines() const {
+            const auto text = output_.str();
+            return static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+        }
+
+        static void logOnce(int i) {
+            UP_LOG_ERROR("bad input {}", i);
+        }
+
+        std::ostringstream output_;
+        std::shared_ptr<spdlog::logger> previous_;
+};
+
+// Test that a call site only logs burst messages per interval
+TEST_F(LogTest, RateLimitedPerCallSite)
+{
+    log::setRateLimit(3, std::chrono::milliseconds(60000));
+    for (int i = 0; i < 100; ++i) {
+        logOnce(i);
+    }
+    EXPECT_EQ(lines(), 3U);
+    EXPECT_NE(std::string::npos, output_.str().find("error bad input 2\n"));
+    EXPECT_EQ(std::string::npos, output_.str().find("bad input 3"));
+
+    /* another call site has its own budget */
+    UP_LOG_WARN("other call site");
+    EXPECT_EQ(lines(), 4U);
+}
+
+// Test that the first message of a new interval reports what was held back
+TEST_F(LogTest, ReportsSuppressed)
+{
+    log::setRateLimit(1, std::chrono::milliseconds(20));
+    const auto flood = [](int i) { UP_LOG_ERROR("flood {}", i); };
+    for (int i = 0; i < 5; ++i) {
+        flood(i);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    flood(5);
+    flood(6);
+
+    EXPECT_EQ(output_.str(), "error flood 0\nerror 4 similar messages suppressed\nerror flood 5\n");
+}
+
+// Test that a rate limit of 0 never throttles
+TEST_F(LogTest, Unlimited)
+{
+    log::setRateLimit(0);
+    for (int i = 0; i < 50; ++i) {
+        UP_LOG_ERROR("message {}", i);
+    }
+    EXPECT_EQ(lines(), 50U);
+}
+
+// Test that levels below the compile time level are stripped with their arguments
+TEST_F(LogTest, CompileTimeLevel)
+{
+    int evaluated = 0;
+    UP_LOG_INFO("stripped {}", ++evaluated);
+    UP_LOG_DEBUG("stripped {}", ++evaluated);
+    UP_LOG_WARN("kept {}", ++evaluated);
+
+    EXPECT_EQ(evaluated, 1);
+    EXPECT_EQ(output_.str(), "warning kept 1\n");
+}
+
+// Test that the runtime level is checked before the rate limiter
+TEST_F(LogTest, RuntimeLevel)
+{
+    log::setRateLimit(1, std::chrono::milliseconds(60000));
+    spdlog::set_level(spdlog::level::err);
+    for (int i = 0; i < 3; ++i) {
+        UP_LOG_WARN("filtered {}", i);
+        UP_LOG_ERROR("kept {}", i);
+    }
+    EXPECT_EQ(output_.str(), "error kept 0\n");
+}
+
+// Test that the async logger writes to the same sinks
+TEST_F(LogTest, Async)
+{
+    log::setRateLimit(0);
+    log::enableAsync(64);
+    for (int i = 0; i < 20; ++i) {
+        UP_LOG_ERROR("async {}", i);
+    }
+    log::disableAsync();
+
+    EXPECT_EQ(lines(), 20U);
+    EXPECT_NE(std::string::npos, output_.str().find("error async 19\n"));
+}
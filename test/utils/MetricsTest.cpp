@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <up-cpp/utils/CyclicQueue.h>
+#include <up-cpp/utils/Metrics.h>
+#include <up-cpp/utils/ThreadPool.h>
+#include <up-cpp/uri/serializer/LongUriSerializer.h>
+#include <up-cpp/uri/serializer/MicroUriSerializer.h>
+#include <up-cpp/uuid/factory/Uuidv8Factory.h>
+#include <up-cpp/uuid/serializer/UuidSerializer.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace uprotocol::utils;
+using namespace uprotocol::utils::metrics;
+
+static uint64_t counterValue(const std::string &name, const std::string &labels = {}) {
+    const auto *counter = Registry::instance().findCounter(name, labels);
+    return (nullptr == counter) ? 0 : counter->value();
+}
+
+// Test that counter updates from many threads all land
+TEST(MetricsTest, CounterSumsShards)
+{
+    auto &counter = Registry::instance().counter("test_counter_total", "test counter");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.value(), 80000U);
+    EXPECT_EQ(&counter, Registry::instance().findCounter("test_counter_total"));
+    EXPECT_EQ(&counter, &Registry::instance().counter("test_counter_total", "test counter"));
+}
+
+// Test that labels tell metrics of the same name apart
+TEST(MetricsTest, Labels)
+{
+    auto &first = Registry::instance().counter("test_labeled_total", "labeled", "id=\"1\"");
+    auto &second = Registry::instance().counter("test_labeled_total", "labeled", "id=\"2\"");
+    first.add(3);
+    second.add(5);
+
+    EXPECT_NE(&first, &second);
+    EXPECT_EQ(counterValue("test_labeled_total", "id=\"1\""), 3U);
+    EXPECT_EQ(counterValue("test_labeled_total", "id=\"2\""), 5U);
+    EXPECT_EQ(nullptr, Registry::instance().findCounter("test_labeled_total", "id=\"3\""));
+    EXPECT_EQ(nullptr, Registry::instance().findGauge("test_labeled_total", "id=\"1\""));
+}
+
+// Test that a gauge follows add() and sub()
+TEST(MetricsTest, Gauge)
+{
+    auto &gauge = Registry::instance().gauge("test_gauge", "test gauge");
+    gauge.add(10);
+    gauge.sub(4);
+
+    EXPECT_EQ(gauge.value(), 6);
+}
+
+// Test the bucket layout and the precision of histogram percentiles
+TEST(MetricsTest, HistogramPercentiles)
+{
+    for (uint64_t value : std::vector<uint64_t>{0, 1, 7, 8, 9, 1000, 123456789, UINT64_MAX}) {
+        const auto index = Histogram::indexOf(value);
+        ASSERT_LT(index, Histogram::Buckets);
+        EXPECT_TRUE((UINT64_MAX == value) || (value < Histogram::upperBound(index)));
+        EXPECT_TRUE((0 == index) || (value >= Histogram::upperBound(index - 1)));
+    }
+
+    Histogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0U);
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram.record(i * 1000);
+    }
+
+    EXPECT_EQ(histogram.count(), 1000U);
+    EXPECT_EQ(histogram.sum(), 500500000U);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5)), 500000.0, 500000.0 / 8);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 990000.0, 990000.0 / 8);
+    EXPECT_GE(histogram.percentile(1.0), 1000000U);
+    EXPECT_EQ(histogram.countBelow(1U << 20), histogram.count());
+    EXPECT_LT(histogram.countBelow(1U << 19), 600U);
+}
+
+// Test the Prometheus text exposition
+TEST(MetricsTest, Scrape)
+{
+    Registry::instance().counter("test_scrape_total", "scraped counter", "kind=\"a\"").add(2);
+    Registry::instance().histogram("test_scrape_seconds", "scraped histogram").record(1000);
+
+    const auto text = Registry::instance().scrape();
+    EXPECT_NE(std::string::npos, text.find("# TYPE test_scrape_total counter\n"));
+    EXPECT_NE(std::string::npos, text.find("# HELP test_scrape_total scraped counter\n"));
+    EXPECT_NE(std::string::npos, text.find("test_scrape_total{kind=\"a\"} 2\n"));
+    EXPECT_NE(std::string::npos, text.find("# TYPE test_scrape_seconds histogram\n"));
+    EXPECT_NE(std::string::npos, text.find("test_scrape_seconds_bucket{le=\"2.56e-07\"} 0\n"));
+    EXPECT_NE(std::string::npos, text.find("test_scrape_seconds_bucket{le=\"1.024e-06\"} 1\n"));
+    EXPECT_NE(std::string::npos, text.find("test_scrape_seconds_bucket{le=\"+Inf\"} 1\n"));
+    EXPECT_NE(std::string::npos, text.find("test_scrape_seconds_sum 1e-06\n"));
+    EXPECT_NE(std::string::npos, text.find("test_scrape_seconds_count 1\n"));
+}
+
+// Test that a full cyclic queue reports the entries it drops and its depth
+TEST(MetricsTest, CyclicQueueDrops)
+{
+    const auto dropped = counterValue("up_cyclic_queue_dropped_total");
+    {
+        CyclicQueue<int> queue(2, std::chrono::milliseconds(1));
+        for (int i = 0; i < 5; ++i) {
+            queue.push(i);
+        }
+        EXPECT_EQ(counterValue("up_cyclic_queue_dropped_total") - dropped, 3U);
+        EXPECT_EQ(Registry::instance().findGauge("up_cyclic_queue_depth")->value(), 2);
+
+        int value;
+        EXPECT_TRUE(queue.waitPop(value));
+        EXPECT_EQ(Registry::instance().findGauge("up_cyclic_queue_depth")->value(), 1);
+    }
+    EXPECT_EQ(Registry::instance().findGauge("up_cyclic_queue_depth")->value(), 0);
+}
+
+// Test that the thread pool records task wait and run times and rejections
+TEST(MetricsTest, ThreadPool)
+{
+    const auto rejected = counterValue("up_threadpool_rejected_total");
+    {
+        ThreadPool pool(1, 1);
+        std::atomic<bool> release(false);
+        auto blocker = pool.submit([&release]() {
+            while (false == release) {
+                std::this_thread::yield();
+            }
+        });
+        while (0 != pool.queueSize()) {
+            std::this_thread::yield();
+        }
+        auto queued = pool.submit([]() {});
+        auto refused = pool.submit([]() {});
+        EXPECT_FALSE(refused.valid());
+        release = true;
+        blocker.get();
+        queued.get();
+    }
+
+    EXPECT_EQ(counterValue("up_threadpool_rejected_total") - rejected, 1U);
+    EXPECT_GE(Registry::instance().findHistogram("up_threadpool_task_wait_seconds")->count(), 2U);
+    EXPECT_GE(Registry::instance().findHistogram("up_threadpool_task_run_seconds")->count(), 2U);
+    EXPECT_EQ(Registry::instance().findGauge("up_threadpool_queued_tasks")->value(), 0);
+}
+
+// Test that serializers count their calls and failures
+TEST(MetricsTest, Serializers)
+{
+    const std::string longLabels = "serializer=\"long_uri\",op=\"deserialize\"";
+    const auto calls = counterValue("up_serializer_calls_total", longLabels);
+    const auto failures = counterValue("up_serializer_failures_total", longLabels);
+    uprotocol::uri::LongUriSerializer::deserialize("//vcu.vin/body.access/1/door.front_left#Door");
+    uprotocol::uri::LongUriSerializer::deserialize("");
+    EXPECT_EQ(counterValue("up_serializer_calls_total", longLabels) - calls, 2U);
+    EXPECT_EQ(counterValue("up_serializer_failures_total", longLabels) - failures, 1U);
+
+    const std::string microLabels = "serializer=\"micro_uri\",op=\"deserialize\"";
+    const auto microFailures = counterValue("up_serializer_failures_total", microLabels);
+    (void)uprotocol::uri::MicroUriSerializer::deserialize(std::vector<uint8_t>{9, 0, 0, 0, 0, 0, 0, 0});
+    EXPECT_EQ(counterValue("up_serializer_failures_total", microLabels) - microFailures, 1U);
+
+    const std::string uuidLabels = "serializer=\"uuid\",op=\"deserialize_bytes\"";
+    const auto uuidFailures = counterValue("up_serializer_failures_total", uuidLabels);
+    uprotocol::uuid::UuidSerializer::deserializeFromBytes(std::vector<uint8_t>(3));
+    EXPECT_EQ(counterValue("up_serializer_failures_total", uuidLabels) - uuidFailures, 1U);
+}
+
+// Test that a batch larger than one millisecond's counter range is reported
+TEST(MetricsTest, UuidCounterSaturation)
+{
+    const auto saturated = counterValue("up_uuid_counter_saturated_total");
+    std::vector<uprotocol::uuid::Uuidv8Factory::RawUuid> uuids(5000);
+    uprotocol::uuid::Uuidv8Factory::createBatch(uuids.data(), uuids.size());
+
+    EXPECT_GE(counterValue("up_uuid_counter_saturated_total") - saturated, 1U);
+}
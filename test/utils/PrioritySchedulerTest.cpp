@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <up-cpp/utils/PriorityScheduler.h>
+#include <up-cpp/transport/MessageScheduler.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace uprotocol::utils;
+using namespace uprotocol::utransport;
+
+using Scheduler = PriorityScheduler<int, 4>;
+
+// Test that strict classes are served first, highest level first
+TEST(PrioritySchedulerTest, StrictPriority)
+{
+    Scheduler scheduler(Scheduler::defaultOptions(8), std::chrono::milliseconds(1));
+
+    for (int level = 0; level < 4; ++level) {
+        int value = level;
+        EXPECT_TRUE(scheduler.push(level, value));
+    }
+
+    int value = -1;
+    EXPECT_TRUE(scheduler.tryPop(value));
+    EXPECT_EQ(3, value);
+    EXPECT_TRUE(scheduler.tryPop(value));
+    EXPECT_EQ(2, value);
+    EXPECT_EQ(2U, scheduler.size());
+}
+
+// Test that weighted classes share by weight and are not starved
+TEST(PrioritySchedulerTest, WeightedShare)
+{
+    auto options = Scheduler::defaultOptions(1000);
+    options.strictLevels = 1;
+    options.classes[0].weight = 1;
+    options.classes[1].weight = 3;
+    options.classes[2].weight = 4;
+    Scheduler scheduler(options, std::chrono::milliseconds(1));
+
+    for (int i = 0; i < 100; ++i) {
+        for (int level = 0; level < 3; ++level) {
+            int value = level;
+            EXPECT_TRUE(scheduler.push(level, value));
+        }
+    }
+
+    size_t served[3] = {};
+    for (int i = 0; i < 80; ++i) {
+        int value = -1;
+        ASSERT_TRUE(scheduler.tryPop(value));
+        ++served[value];
+    }
+    EXPECT_EQ(10U, served[0]);
+    EXPECT_EQ(30U, served[1]);
+    EXPECT_EQ(40U, served[2]);
+}
+
+// Test that an empty weighted class gives its share to the others
+TEST(PrioritySchedulerTest, IdleClassCredit)
+{
+    auto options = Scheduler::defaultOptions(16);
+    options.strictLevels = 0;
+    Scheduler scheduler(options, std::chrono::milliseconds(1));
+
+    for (int i = 0; i < 5; ++i) {
+        int value = i;
+        EXPECT_TRUE(scheduler.push(1, value));
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        int value = -1;
+        EXPECT_TRUE(scheduler.tryPop(value));
+        EXPECT_EQ(i, value);
+    }
+    int value = -1;
+    EXPECT_FALSE(scheduler.tryPop(value));
+}
+
+// Test the per class overflow policies, a full class does not affect the others
+TEST(PrioritySchedulerTest, OverflowPolicies)
+{
+    auto options = Scheduler::defaultOptions(2);
+    options.classes[0].policy = Scheduler::DropPolicy::DropOldest;
+    options.classes[3].policy = Scheduler::DropPolicy::RejectNewest;
+    Scheduler scheduler(options, std::chrono::milliseconds(1));
+
+    for (int i = 0; i < 5; ++i) {
+        int low = i;
+        EXPECT_TRUE(scheduler.push(0, low));
+        int high = 10 + i;
+        EXPECT_EQ(i < 2, scheduler.push(3, high));
+    }
+
+    EXPECT_EQ(2U, scheduler.size(0));
+    EXPECT_EQ(2U, scheduler.size(3));
+    EXPECT_EQ(3U, scheduler.dropped(0));
+    EXPECT_EQ(3U, scheduler.dropped(3));
+
+    std::vector<int> values;
+    int value;
+    while (scheduler.tryPop(value)) {
+        values.push_back(value);
+    }
+    EXPECT_EQ((std::vector<int>{10, 11, 3, 4}), values);
+}
+
+// Test that waitPop returns false after the timeout when nothing is queued
+TEST(PrioritySchedulerTest, WaitPopTimeout)
+{
+    Scheduler scheduler(Scheduler::defaultOptions(4), std::chrono::milliseconds(5));
+
+    int value = 0;
+    EXPECT_FALSE(scheduler.waitPop(value));
+    EXPECT_TRUE(scheduler.isEmpty());
+}
+
+// Test that high priority messages overtake a flood of low priority ones
+TEST(PrioritySchedulerTest, HighPriorityUnderFlood)
+{
+    MessageScheduler scheduler(MessageScheduler::defaultOptions(64), std::chrono::milliseconds(10));
+    std::atomic<bool> done(false);
+    std::atomic<size_t> urgent(0);
+
+    std::thread flood([&]() {
+        while (false == done) {
+            UMessage message;
+            message.mutableAttributes().set_priority(uprotocol::v1::UPRIORITY_CS0);
+            schedule(scheduler, message);
+        }
+    });
+
+    std::thread consumer([&]() {
+        UMessage message;
+        while (urgent < 100) {
+            if (scheduler.waitPop(message) &&
+                (uprotocol::v1::UPRIORITY_CS6 == message.attributes().priority())) {
+                ++urgent;
+            }
+        }
+    });
+
+    for (int i = 0; i < 100; ++i) {
+        UMessage message;
+        message.mutableAttributes().set_priority(uprotocol::v1::UPRIORITY_CS6);
+        while (false == schedule(scheduler, message)) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    consumer.join();
+    done = true;
+    flood.join();
+
+    EXPECT_EQ(100U, urgent);
+    EXPECT_EQ(0U, scheduler.dropped(PriorityLevels - 1));
+}
+
+// Test the mapping of UPriority to scheduler levels
+TEST(PrioritySchedulerTest, PriorityLevel)
+{
+    uprotocol::v1::UAttributes attributes;
+    EXPECT_EQ(1U, priorityLevel(attributes));
+    attributes.set_priority(uprotocol::v1::UPRIORITY_CS0);
+    EXPECT_EQ(0U, priorityLevel(attributes));
+    attributes.set_priority(uprotocol::v1::UPRIORITY_CS6);
+    EXPECT_EQ(PriorityLevels - 1, priorityLevel(attributes));
+}
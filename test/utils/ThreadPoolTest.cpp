@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <up-cpp/utils/ThreadPool.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+using namespace uprotocol::utils;
+
+/* heap allocations of the whole process, counted by the replaced global operator new */
+static std::atomic<uint64_t> allocations { 0 };
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc((0 == size) ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// Test that submitted tasks run and report their result through the future
+TEST(ThreadPoolTest, SubmitReturnsResult)
+{
+    ThreadPool pool(16, 2);
+
+    auto future = pool.submit([](int a, int b) { return a + b; }, 2, 3);
+
+    ASSERT_TRUE(future.valid());
+    EXPECT_EQ(future.get(), 5);
+}
+
+// Test that the pool rejects tasks once the queue limit is reached
+TEST(ThreadPoolTest, QueueFull)
+{
+    ThreadPool pool(2, 1);
+    std::atomic<bool> release(false);
+
+    auto blocker = pool.submit([&release]() {
+        while (false == release) {
+            std::this_thread::yield();
+        }
+    });
+    /* wait for the worker to pick up the blocking task */
+    while (0 != pool.queueSize()) {
+        std::this_thread::yield();
+    }
+
+    auto first = pool.submit([]() {});
+    auto second = pool.submit([]() {});
+    auto rejected = pool.submit([]() {});
+
+    EXPECT_TRUE(first.valid());
+    EXPECT_TRUE(second.valid());
+    EXPECT_FALSE(rejected.valid());
+
+    release = true;
+    blocker.get();
+    first.get();
+    second.get();
+}
+
+// Test that workers survive idle periods longer than the parking timeout
+TEST(ThreadPoolTest, WorkersPersistAcrossIdle)
+{
+    ThreadPool pool(16, 2);
+    std::thread::id firstId;
+    std::thread::id secondId;
+
+    pool.submit([&firstId]() { firstId = std::this_thread::get_id(); }).get();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    pool.submit([&secondId]() { secondId = std::this_thread::get_id(); }).get();
+
+    EXPECT_EQ(pool.numOfThreads(), 2U);
+    EXPECT_NE(firstId, std::this_thread::get_id());
+    EXPECT_NE(secondId, std::this_thread::get_id());
+}
+
+// Test that tasks submitted from a worker are executed (and stolen when the owner is busy)
+TEST(ThreadPoolTest, NestedSubmit)
+{
+    ThreadPool pool(1024, 4);
+    std::atomic<int> counter(0);
+
+    auto outer = pool.submit([&pool, &counter]() {
+        std::vector<std::future<void>> inner;
+        for (int i = 0; i < 100; ++i) {
+            inner.push_back(pool.submit([&counter]() { ++counter; }));
+        }
+        for (auto &f : inner) {
+            f.get();
+        }
+    });
+    outer.get();
+
+    EXPECT_EQ(counter, 100);
+}
+
+// Test that many producers can submit concurrently and the destructor drains the queues
+TEST(ThreadPoolTest, ConcurrentSubmitAndDrain)
+{
+    std::atomic<int> counter(0);
+    {
+        ThreadPool pool(100000, 4);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p) {
+            producers.emplace_back([&pool, &counter]() {
+                for (int i = 0; i < 1000; ++i) {
+                    pool.submit([&counter]() { ++counter; });
+                }
+            });
+        }
+        for (auto &t : producers) {
+            t.join();
+        }
+    }
+
+    EXPECT_EQ(counter, 4000);
+}
+
+// Test that InplaceFunction stores and moves move-only callables
+TEST(ThreadPoolTest, InplaceFunctionMoveOnly)
+{
+    auto value = std::make_unique<int>(7);
+    InplaceFunction<int(int)> func([value = std::move(value)](int add) { return *value + add; });
+
+    InplaceFunction<int(int)> moved(std::move(func));
+
+    EXPECT_FALSE(func);
+    ASSERT_TRUE(moved);
+    EXPECT_EQ(moved(3), 10);
+}
+
+// Test that posted tasks and detached submissions run without a future
+TEST(ThreadPoolTest, PostAndSubmitDetached)
+{
+    std::atomic<int> counter(0);
+    {
+        ThreadPool pool(16, 2);
+        auto owned = std::make_unique<int>(5);
+
+        EXPECT_TRUE(pool.post([&counter]() { ++counter; }));
+        EXPECT_TRUE(pool.submitDetached(
+            [&counter](std::unique_ptr<int> add) { counter += *add; },
+            std::move(owned)));
+    }
+
+    EXPECT_EQ(counter, 6);
+}
+
+// Test that posting into the preallocated worker rings never allocates
+TEST(ThreadPoolTest, PostDoesNotAllocate)
+{
+    constexpr int numPosts = 10000;
+    std::atomic<int> counter(0);
+    ThreadPool pool(numPosts, 2);
+
+    const auto before = allocations.load();
+    int posted = 0;
+    for (int i = 0; i < numPosts; ++i) {
+        posted += pool.post([&counter]() { ++counter; }) ? 1 : 0;
+    }
+    while (counter.load() != posted) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_EQ(posted, numPosts);
+    EXPECT_EQ(allocations.load() - before, 0U);
+}
+
+// Test that pooled futures deliver values, exceptions and recycle their states
+TEST(ThreadPoolTest, PooledFuture)
+{
+    ThreadPool pool(16, 2);
+    PromisePool<int> promises(2);
+
+    for (int i = 0; i < 10; ++i) {
+        auto future = pool.submit(promises, [](int v) { return v * 2; }, i);
+        ASSERT_TRUE(future.valid());
+        EXPECT_EQ(future.get(), i * 2);
+    }
+
+    auto failed = pool.submit(promises, []() -> int { throw std::runtime_error("failed"); });
+    ASSERT_TRUE(failed.valid());
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    /* the worker drops its promise reference right after completing it */
+    while (2U != promises.available()) {
+        std::this_thread::yield();
+    }
+    auto first = promises.acquire();
+    auto second = promises.acquire();
+    auto exhausted = promises.acquire();
+    EXPECT_TRUE(first.valid());
+    EXPECT_TRUE(second.valid());
+    EXPECT_FALSE(exhausted.valid());
+}
+
+// Test that an abandoned pooled promise completes its future with an error
+TEST(ThreadPoolTest, PooledFutureBrokenPromise)
+{
+    PromisePool<void> promises(1);
+    PooledFuture<void> future;
+    {
+        auto promise = promises.acquire();
+        future = promise.getFuture();
+        EXPECT_EQ(future.waitFor(std::chrono::milliseconds(1)), std::future_status::timeout);
+    }
+
+    EXPECT_THROW(future.get(), std::future_error);
+    EXPECT_EQ(promises.available(), 1U);
+}
+
+// Test that workers are pinned to their CPU and named after the options
+TEST(ThreadPoolTest, OptionsPinAndName)
+{
+    ThreadPool::Options options;
+    options.maxQueueSize = 16;
+    options.numOfThreads = 2;
+    options.cpus = {0};
+    options.pinEachWorker = true;
+    options.name = "uptest";
+    ThreadPool pool(options);
+
+    EXPECT_EQ(pool.workerCpus(1), std::vector<unsigned>{0});
+
+    auto future = pool.submit([]() {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+        char name[16] = {};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        return std::make_pair(CPU_COUNT(&set) == 1 && CPU_ISSET(0, &set), std::string(name));
+    });
+    auto [pinned, name] = future.get();
+    EXPECT_TRUE(pinned);
+    EXPECT_EQ(name.rfind("uptest-", 0), 0U);
+}
+
+// Test that NUMA groups place every worker on the CPUs of its node
+TEST(ThreadPoolTest, OptionsNumaGroups)
+{
+    ThreadPool::Options options;
+    options.maxQueueSize = 64;
+    options.numOfThreads = 4;
+    options.numaGroups = true;
+    ThreadPool pool(options);
+
+    const auto nodes = affinity::cpuNodes();
+    for (size_t i = 0; i < pool.numOfThreads(); ++i) {
+        ASSERT_FALSE(pool.workerCpus(i).empty());
+        for (auto cpu : pool.workerCpus(i)) {
+            EXPECT_EQ(nodes[cpu], pool.workerNode(i));
+        }
+    }
+
+    std::atomic<int> done(0);
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 32; ++i) {
+        futures.push_back(pool.submit([&done]() { ++done; }));
+    }
+    for (auto &future : futures) {
+        future.get();
+    }
+    EXPECT_EQ(done, 32);
+}
+
+// Test that a pool still runs its tasks when a real-time policy is refused
+TEST(ThreadPoolTest, OptionsSchedulingPolicy)
+{
+    ThreadPool::Options options;
+    options.maxQueueSize = 4;
+    options.numOfThreads = 1;
+    options.schedPolicy = SCHED_FIFO;
+    options.schedPriority = 1;
+    ThreadPool pool(options);
+
+    EXPECT_EQ(pool.submit([]() { return 7; }).get(), 7);
+}
+
+// Test that workers run tasks and shut down under every idle wait strategy
+TEST(ThreadPoolTest, OptionsWaitStrategy)
+{
+    for (auto strategy : {WaitStrategy::BusySpin, WaitStrategy::SpinYield,
+                          WaitStrategy::SpinPark, WaitStrategy::Blocking}) {
+        ThreadPool::Options options;
+        options.maxQueueSize = 16;
+        options.numOfThreads = 2;
+        options.waitStrategy = strategy;
+        options.spins = 64;
+        options.idleTimeout = (WaitStrategy::Blocking == strategy) ?
+            WaitForever : std::chrono::milliseconds(10);
+        ThreadPool pool(options);
+
+        for (int round = 0; round < 3; ++round) {
+            EXPECT_EQ(pool.submit([round]() { return round; }).get(), round);
+            std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <up-cpp/transport/CoalescingTransport.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+/* records the batches it is given and the order messages are sent in, fails every
+   message with priority UPRIORITY_CS6 */
+class RecordingTransport : public UTransport
+{
+public:
+    UStatus send(const UMessage &message) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++sends;
+        sent.push_back(message.attributes().priority());
+        UStatus status;
+        status.set_code((UPriority::UPRIORITY_CS6 == message.attributes().priority()) ?
+                        UCode::UNAVAILABLE : UCode::OK);
+        return status;
+    }
+
+    UStatus sendBatch(const UMessage *messages, size_t count, UStatus *statuses) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(count);
+            for (size_t i = 0; i < count; ++i) {
+                const auto &payload = messages[i].payload();
+                firstBytes.push_back((0 == payload.size()) ? 0 : payload.data()[0]);
+            }
+        }
+        return UTransport::sendBatch(messages, count, statuses);
+    }
+
+    UStatus registerListener(const UUri &, const UListener &) override {
+        UStatus status;
+        status.set_code(UCode::OK);
+        return status;
+    }
+
+    UStatus unregisterListener(const UUri &, const UListener &) override {
+        UStatus status;
+        status.set_code(UCode::NOT_FOUND);
+        return status;
+    }
+
+    std::vector<size_t> batchSizes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches;
+    }
+
+    std::mutex mutex;
+    std::vector<size_t> batches;
+    std::vector<uint8_t> firstBytes;
+    std::vector<UPriority> sent;
+    size_t sends = 0;
+};
+
+/* reports success for the batch but leaves the per message statuses alone */
+class SilentTransport : public RecordingTransport
+{
+public:
+    UStatus sendBatch(const UMessage *, size_t count, UStatus *) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(count);
+        UStatus status;
+        status.set_code(UCode::OK);
+        return status;
+    }
+};
+
+static UMessage makeMessage(UPriority priority) {
+    UAttributes attributes;
+    attributes.set_priority(priority);
+    return UMessage(UPayload(), std::move(attributes));
+}
+
+// Test that the default sendBatch reports every message and the first failure
+TEST(CoalescingTransportTest, DefaultSendBatch)
+{
+    RecordingTransport transport;
+    UMessage messages[3] = {makeMessage(UPriority::UPRIORITY_CS1),
+                            makeMessage(UPriority::UPRIORITY_CS6),
+                            makeMessage(UPriority::UPRIORITY_CS2)};
+    UStatus statuses[3];
+
+    auto status = transport.sendBatch(messages, 3, statuses);
+
+    EXPECT_EQ(status.code(), UCode::UNAVAILABLE);
+    EXPECT_EQ(statuses[0].code(), UCode::OK);
+    EXPECT_EQ(statuses[1].code(), UCode::UNAVAILABLE);
+    EXPECT_EQ(statuses[2].code(), UCode::OK);
+    EXPECT_EQ(transport.sends, 3U);
+}
+
+// Test that a full batch is sent right away
+TEST(CoalescingTransportTest, FlushOnSize)
+{
+    RecordingTransport transport;
+    CoalescingTransport coalescing(transport, 4, std::chrono::seconds(60), 1000);
+
+    std::atomic<int> completed(0);
+    for (int i = 0; i < 9; ++i) {
+        EXPECT_EQ(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1),
+                                       [&completed](const UStatus &status) {
+                                           EXPECT_EQ(status.code(), UCode::OK);
+                                           ++completed;
+                                       }).code(), UCode::OK);
+    }
+
+    EXPECT_EQ(transport.batchSizes(), (std::vector<size_t>{4, 4}));
+    EXPECT_EQ(completed, 8);
+
+    EXPECT_EQ(coalescing.flush().code(), UCode::OK);
+    EXPECT_EQ(transport.batchSizes(), (std::vector<size_t>{4, 4, 1}));
+    EXPECT_EQ(completed, 9);
+}
+
+// Test that send() and sendBatch() report the status of every message
+TEST(CoalescingTransportTest, ReportsMessageStatus)
+{
+    RecordingTransport transport;
+    CoalescingTransport coalescing(transport, 100, std::chrono::seconds(60), 1000);
+
+    EXPECT_EQ(coalescing.send(makeMessage(UPriority::UPRIORITY_CS6)).code(), UCode::UNAVAILABLE);
+    EXPECT_EQ(coalescing.send(makeMessage(UPriority::UPRIORITY_CS1)).code(), UCode::OK);
+
+    UMessage messages[3] = {makeMessage(UPriority::UPRIORITY_CS1),
+                            makeMessage(UPriority::UPRIORITY_CS6),
+                            makeMessage(UPriority::UPRIORITY_CS2)};
+    UStatus statuses[3];
+    EXPECT_EQ(coalescing.sendBatch(messages, 3, statuses).code(), UCode::UNAVAILABLE);
+    EXPECT_EQ(statuses[0].code(), UCode::OK);
+    EXPECT_EQ(statuses[1].code(), UCode::UNAVAILABLE);
+    EXPECT_EQ(statuses[2].code(), UCode::OK);
+
+    /* send() goes straight to the wrapped transport, sendBatch() as one batch */
+    EXPECT_EQ(transport.batchSizes(), (std::vector<size_t>{3}));
+    EXPECT_EQ(transport.sends, 5U);
+}
+
+// Test that a message the wrapped transport does not report on fails
+TEST(CoalescingTransportTest, UnreportedStatusFails)
+{
+    SilentTransport transport;
+    CoalescingTransport coalescing(transport, 100, std::chrono::seconds(60), 1000);
+
+    UCode code = UCode::OK;
+    EXPECT_EQ(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1),
+                                   [&code](const UStatus &status) { code = status.code(); }).code(), UCode::OK);
+    EXPECT_EQ(coalescing.flush().code(), UCode::OK);
+    EXPECT_EQ(code, UCode::INTERNAL);
+
+    /* statuses left over from an earlier call are not reported either */
+    UMessage messages[2] = {makeMessage(UPriority::UPRIORITY_CS1), makeMessage(UPriority::UPRIORITY_CS1)};
+    UStatus statuses[2];
+    statuses[0].set_code(UCode::OK);
+    statuses[1].set_code(UCode::OK);
+    EXPECT_EQ(coalescing.sendBatch(messages, 2, statuses).code(), UCode::OK);
+    EXPECT_EQ(statuses[0].code(), UCode::INTERNAL);
+    EXPECT_EQ(statuses[1].code(), UCode::INTERNAL);
+}
+
+// Test that send() and sendBatch() go after the queued messages, in batches of at most maxBatchSize
+TEST(CoalescingTransportTest, SendAfterQueued)
+{
+    RecordingTransport transport;
+    CoalescingTransport coalescing(transport, 2, std::chrono::seconds(60), 1000);
+
+    EXPECT_EQ(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1), nullptr).code(), UCode::OK);
+    EXPECT_EQ(coalescing.send(makeMessage(UPriority::UPRIORITY_CS2)).code(), UCode::OK);
+    EXPECT_EQ(transport.batchSizes(), (std::vector<size_t>{1}));
+
+    EXPECT_EQ(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS3), nullptr).code(), UCode::OK);
+    UMessage messages[5] = {makeMessage(UPriority::UPRIORITY_CS4), makeMessage(UPriority::UPRIORITY_CS4),
+                            makeMessage(UPriority::UPRIORITY_CS4), makeMessage(UPriority::UPRIORITY_CS4),
+                            makeMessage(UPriority::UPRIORITY_CS4)};
+    EXPECT_EQ(coalescing.sendBatch(messages, 5).code(), UCode::OK);
+
+    EXPECT_EQ(transport.batchSizes(), (std::vector<size_t>{1, 1, 2, 2, 1}));
+    EXPECT_EQ(transport.sent, (std::vector<UPriority>{UPriority::UPRIORITY_CS1, UPriority::UPRIORITY_CS2,
+                                                      UPriority::UPRIORITY_CS3, UPriority::UPRIORITY_CS4,
+                                                      UPriority::UPRIORITY_CS4, UPriority::UPRIORITY_CS4,
+                                                      UPriority::UPRIORITY_CS4, UPriority::UPRIORITY_CS4}));
+}
+
+// Test that sendAsync() refuses messages once maxQueued are waiting
+TEST(CoalescingTransportTest, QueueLimit)
+{
+    RecordingTransport transport;
+    CoalescingTransport coalescing(transport, 2, std::chrono::seconds(60), 3);
+
+    /* completions queue on the sending thread without flushing, so the queue fills up */
+    std::vector<UCode> codes;
+    int completed = 0;
+    auto refill = [&coalescing, &codes, &completed](const UStatus &) {
+        ++completed;
+        if (1 == completed) {
+            for (int i = 0; i < 4; ++i) {
+                codes.push_back(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1),
+                                                     [&completed](const UStatus &) { ++completed; }).code());
+            }
+        }
+    };
+    EXPECT_EQ(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1), std::move(refill)).code(), UCode::OK);
+    EXPECT_EQ(coalescing.flush().code(), UCode::OK);
+
+    EXPECT_EQ(codes, (std::vector<UCode>{UCode::OK, UCode::OK, UCode::OK, UCode::RESOURCE_EXHAUSTED}));
+
+    /* the refused message is not completed, the queued ones are */
+    EXPECT_EQ(coalescing.flush().code(), UCode::OK);
+    EXPECT_EQ(completed, 4);
+    EXPECT_EQ(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1), nullptr).code(), UCode::OK);
+}
+
+// Test that a queued REFERENCE payload outlives the caller's buffer
+TEST(CoalescingTransportTest, RetainsReferencePayload)
+{
+    RecordingTransport transport;
+    CoalescingTransport coalescing(transport, 100, std::chrono::seconds(60), 1000);
+
+    {
+        std::vector<uint8_t> buffer{42, 43};
+        UAttributes attributes;
+        coalescing.sendAsync(UMessage(UPayload(buffer.data(), buffer.size(), UPayloadType::REFERENCE), attributes),
+                             nullptr);
+        buffer.assign(buffer.size(), 0);
+    }
+
+    EXPECT_EQ(coalescing.flush().code(), UCode::OK);
+    EXPECT_EQ(transport.firstBytes, (std::vector<uint8_t>{42}));
+}
+
+// Test that a partial batch is sent once the window elapsed
+TEST(CoalescingTransportTest, FlushOnWindow)
+{
+    RecordingTransport transport;
+    CoalescingTransport coalescing(transport, 100, std::chrono::milliseconds(10), 1000);
+
+    coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1), nullptr);
+    coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1), nullptr);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (transport.batchSizes().empty() && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(transport.batchSizes(), (std::vector<size_t>{2}));
+}
+
+// Test that queued messages are sent when the adaptor is destroyed
+TEST(CoalescingTransportTest, FlushOnDestruction)
+{
+    RecordingTransport transport;
+    std::atomic<int> completed(0);
+    {
+        CoalescingTransport coalescing(transport, 100, std::chrono::seconds(60), 1000);
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_EQ(coalescing.sendAsync(makeMessage(UPriority::UPRIORITY_CS1),
+                                           [&completed](const UStatus &) { ++completed; }).code(), UCode::OK);
+        }
+        EXPECT_TRUE(transport.batchSizes().empty());
+        EXPECT_EQ(completed, 0);
+    }
+
+    EXPECT_EQ(transport.batchSizes(), (std::vector<size_t>{3}));
+    EXPECT_EQ(transport.sends, 3U);
+    EXPECT_EQ(completed, 3);
+}
+
+// Test that listener registration goes to the wrapped transport
+TEST(CoalescingTransportTest, ForwardsListeners)
+{
+    RecordingTransport transport;
+    CoalescingTransport coalescing(transport, 4, std::chrono::milliseconds(1), 1000);
+    class : public UListener {
+        UStatus onReceive(UMessage &) const override { return UStatus(); }
+    } listener;
+
+    EXPECT_EQ(coalescing.registerListener(UUri(), listener).code(), UCode::OK);
+    EXPECT_EQ(coalescing.unregisterListener(UUri(), listener).code(), UCode::NOT_FOUND);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <up-cpp/transport/CompletionExecutor.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::utils;
+using namespace uprotocol::v1;
+
+/* blocking transport, holds every send until released */
+class GatedTransport : public UTransport
+{
+public:
+    UStatus send(const UMessage &message) override {
+        ++entered;
+        while (false == open.load()) {
+            std::this_thread::yield();
+        }
+        if (0 != message.payload().size()) {
+            firstByte = message.payload().data()[0];
+        }
+        ++sends;
+        UStatus status;
+        status.set_code((0 != message.attributes().ttl()) ? UCode::DEADLINE_EXCEEDED : UCode::OK);
+        return status;
+    }
+
+    UStatus registerListener(const UUri &, const UListener &) override {
+        return UStatus();
+    }
+
+    UStatus unregisterListener(const UUri &, const UListener &) override {
+        return UStatus();
+    }
+
+    std::atomic<bool> open {true};
+    std::atomic<int> entered {0};
+    std::atomic<int> sends {0};
+    std::atomic<int> firstByte {-1};
+};
+
+static void waitFor(const std::atomic<int> &counter, int expected) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((counter.load() < expected) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Test that the default sendAsync completes on the calling thread
+TEST(CompletionExecutorTest, DefaultSendAsync)
+{
+    GatedTransport transport;
+    UAttributes attributes;
+    attributes.set_ttl(10);
+    UMessage message(UPayload(), attributes);
+
+    UCode code = UCode::OK;
+    auto status = transport.sendAsync(message, [&code](const UStatus &result) { code = result.code(); });
+
+    EXPECT_EQ(status.code(), UCode::OK);
+    EXPECT_EQ(code, UCode::DEADLINE_EXCEEDED);
+}
+
+// Test that many sends complete with a few workers
+TEST(CompletionExecutorTest, ManySendsInFlight)
+{
+    constexpr int numSends = 5000;
+    ThreadPool pool(numSends, 4);
+    GatedTransport transport;
+    CompletionExecutor executor(pool, numSends);
+    std::atomic<int> completed {0};
+
+    transport.open = false;
+    UMessage message;
+    for (int i = 0; i < numSends; ++i) {
+        auto status = executor.send(transport, message, [&completed](const UStatus &result) {
+            if (UCode::OK == result.code()) {
+                ++completed;
+            }
+        });
+        ASSERT_EQ(status.code(), UCode::OK);
+    }
+    EXPECT_GT(executor.pending(), 0U);
+
+    transport.open = true;
+    waitFor(completed, numSends);
+
+    EXPECT_EQ(completed.load(), numSends);
+    EXPECT_EQ(transport.sends.load(), numSends);
+}
+
+// Test that a saturated executor refuses sends
+TEST(CompletionExecutorTest, Saturated)
+{
+    ThreadPool pool(16, 1);
+    GatedTransport transport;
+    CompletionExecutor executor(pool, 2);
+    std::atomic<int> completed {0};
+
+    transport.open = false;
+    UMessage message;
+    EXPECT_EQ(executor.send(transport, message, [&completed](const UStatus &) { ++completed; }).code(), UCode::OK);
+    EXPECT_EQ(executor.send(transport, message, [&completed](const UStatus &) { ++completed; }).code(), UCode::OK);
+
+    /* the single worker may already have taken one send out of the queue */
+    int accepted = 2;
+    UCode code = UCode::OK;
+    for (int i = 0; (i < 2) && (UCode::OK == code); ++i) {
+        code = executor.send(transport, message, [&completed](const UStatus &) { ++completed; }).code();
+        accepted += (UCode::OK == code) ? 1 : 0;
+    }
+    EXPECT_EQ(code, UCode::RESOURCE_EXHAUSTED);
+
+    transport.open = true;
+    waitFor(completed, accepted);
+    EXPECT_EQ(completed.load(), accepted);
+}
+
+// Test that completions posted by a transport all run before the executor goes away
+TEST(CompletionExecutorTest, CompleteOnPool)
+{
+    ThreadPool pool(16, 2);
+    std::atomic<int> completed {0};
+
+    {
+        CompletionExecutor executor(pool, 16);
+        UStatus status;
+        status.set_code(UCode::UNAVAILABLE);
+        for (int i = 0; i < 8; ++i) {
+            executor.complete([&completed](const UStatus &result) {
+                if (UCode::UNAVAILABLE == result.code()) {
+                    ++completed;
+                }
+            }, status);
+        }
+    }
+
+    /* the destructor waits for every completion */
+    EXPECT_EQ(completed.load(), 8);
+}
+
+// Test that a prioritizing executor runs queued sends by the priority of their message
+TEST(CompletionExecutorTest, PrioritizeSends)
+{
+    ThreadPool pool(16, 1);
+    GatedTransport transport;
+    CompletionExecutor executor(pool, 16, true);
+    std::mutex mutex;
+    std::vector<UPriority> order;
+    std::atomic<int> completed {0};
+
+    auto record = [&](UPriority priority) {
+        return [&mutex, &order, &completed, priority](const UStatus &) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(priority);
+            ++completed;
+        };
+    };
+
+    transport.open = false;
+    UAttributes attributes;
+    attributes.set_priority(UPriority::UPRIORITY_CS0);
+    UMessage bulk(UPayload(), attributes);
+    /* the single worker holds the first send, the others stay queued */
+    ASSERT_EQ(executor.send(transport, bulk, record(UPriority::UPRIORITY_CS0)).code(), UCode::OK);
+    waitFor(transport.entered, 1);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(executor.send(transport, bulk, record(UPriority::UPRIORITY_CS0)).code(), UCode::OK);
+    }
+    attributes.set_priority(UPriority::UPRIORITY_CS6);
+    UMessage urgent(UPayload(), attributes);
+    ASSERT_EQ(executor.send(transport, urgent, record(UPriority::UPRIORITY_CS6)).code(), UCode::OK);
+
+    transport.open = true;
+    waitFor(completed, 5);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(order, (std::vector<UPriority>{UPriority::UPRIORITY_CS0, UPriority::UPRIORITY_CS6,
+                                             UPriority::UPRIORITY_CS0, UPriority::UPRIORITY_CS0,
+                                             UPriority::UPRIORITY_CS0}));
+}
+
+// Test that a queued REFERENCE payload outlives the caller's buffer
+TEST(CompletionExecutorTest, RetainsReferencePayload)
+{
+    ThreadPool pool(16, 1);
+    GatedTransport transport;
+    CompletionExecutor executor(pool, 16);
+    std::atomic<int> completed {0};
+
+    transport.open = false;
+    {
+        std::vector<uint8_t> buffer{42, 43};
+        UMessage message(UPayload(buffer.data(), buffer.size(), UPayloadType::REFERENCE), UAttributes());
+        auto status = executor.send(transport, message, [&completed](const UStatus &) { ++completed; });
+        ASSERT_EQ(status.code(), UCode::OK);
+        buffer.assign(buffer.size(), 0);
+    }
+
+    transport.open = true;
+    waitFor(completed, 1);
+    EXPECT_EQ(transport.firstByte.load(), 42);
+}
+
+// Test that empty completions are skipped rather than called
+TEST(CompletionExecutorTest, EmptyCompletion)
+{
+    ThreadPool pool(16, 1);
+    GatedTransport transport;
+
+    {
+        CompletionExecutor executor(pool, 16);
+        UMessage message;
+        EXPECT_EQ(executor.send(transport, message, nullptr).code(), UCode::OK);
+        executor.complete(nullptr, UStatus());
+        EXPECT_EQ(transport.sendAsync(message, nullptr).code(), UCode::OK);
+    }
+
+    EXPECT_EQ(transport.sends.load(), 2);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <up-cpp/transport/ConflatingMailbox.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+static UAttributes makeAttributes(uint32_t topic, uint32_t value) {
+    UAttributes attributes;
+    attributes.set_ttl(value);
+    auto *source = attributes.mutable_source();
+    source->mutable_entity()->set_id(100);
+    source->mutable_entity()->set_version_major(1);
+    source->mutable_resource()->set_id(static_cast<uint16_t>(topic));
+    return attributes;
+}
+
+static UMessage makeSample(uint32_t topic, uint32_t value) {
+    return UMessage(UPayload(), makeAttributes(topic, value));
+}
+
+// Test that only the newest sample of a topic reaches the consumer
+TEST(ConflatingMailboxTest, LatestValueWins)
+{
+    ConflatingMailbox mailbox;
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(mailbox.push(makeSample(1, i)).code(), UCode::OK);
+        if (i < 50) {
+            EXPECT_EQ(mailbox.push(makeSample(2, 1000 + i)).code(), UCode::OK);
+        }
+    }
+    EXPECT_EQ(mailbox.size(), 2);
+    EXPECT_EQ(mailbox.topics(), 2);
+    EXPECT_EQ(mailbox.conflated(), 148);
+
+    UMessage message;
+    ASSERT_TRUE(mailbox.tryPop(message));
+    EXPECT_EQ(message.attributes().source().resource().id(), 1);
+    EXPECT_EQ(message.attributes().ttl(), 99);
+    ASSERT_TRUE(mailbox.tryPop(message));
+    EXPECT_EQ(message.attributes().source().resource().id(), 2);
+    EXPECT_EQ(message.attributes().ttl(), 1049);
+    EXPECT_FALSE(mailbox.tryPop(message));
+    EXPECT_TRUE(mailbox.isEmpty());
+}
+
+// Test that a stored REFERENCE payload outlives the producer's buffer
+TEST(ConflatingMailboxTest, RetainsReferencePayload)
+{
+    ConflatingMailbox mailbox;
+
+    {
+        std::vector<uint8_t> buffer{42, 43};
+        UMessage sample(UPayload(buffer.data(), buffer.size(), UPayloadType::REFERENCE), makeAttributes(1, 1));
+        EXPECT_EQ(mailbox.push(sample).code(), UCode::OK);
+        buffer.assign(buffer.size(), 0);
+    }
+
+    UMessage message;
+    ASSERT_TRUE(mailbox.tryPop(message));
+    ASSERT_EQ(message.payload().size(), 2U);
+    EXPECT_EQ(message.payload().data()[0], 42);
+}
+
+// Test that a topic taken by the consumer is queued again by its next sample
+TEST(ConflatingMailboxTest, RequeueAfterPop)
+{
+    ConflatingMailbox mailbox;
+    UMessage message;
+
+    mailbox.push(makeSample(1, 1));
+    mailbox.push(makeSample(2, 2));
+    ASSERT_TRUE(mailbox.tryPop(message));
+    EXPECT_EQ(message.attributes().ttl(), 1);
+
+    /* topic 1 goes behind topic 2, which is still waiting */
+    mailbox.push(makeSample(1, 3));
+    ASSERT_TRUE(mailbox.tryPop(message));
+    EXPECT_EQ(message.attributes().ttl(), 2);
+    ASSERT_TRUE(mailbox.tryPop(message));
+    EXPECT_EQ(message.attributes().ttl(), 3);
+    EXPECT_FALSE(mailbox.tryPop(message));
+    EXPECT_EQ(mailbox.conflated(), 0);
+}
+
+// Test that the mailbox can be registered as a listener and leaves the delivered message intact
+TEST(ConflatingMailboxTest, Listener)
+{
+    ConflatingMailbox mailbox;
+    const UListener &listener = mailbox;
+
+    uint8_t data[] = {1, 2, 3};
+    auto sample = makeSample(1, 7);
+    sample.setPayload(UPayload(data, sizeof(data), UPayloadType::VALUE));
+    EXPECT_EQ(listener.onReceive(sample).code(), UCode::OK);
+    EXPECT_EQ(sample.payload().size(), sizeof(data));
+
+    UMessage message;
+    ASSERT_TRUE(mailbox.waitPop(message));
+    EXPECT_EQ(message.attributes().ttl(), 7);
+    EXPECT_EQ(message.payload().data(), sample.payload().data());
+}
+
+// Test that a source URI without a micro form is rejected
+TEST(ConflatingMailboxTest, InvalidSource)
+{
+    ConflatingMailbox mailbox;
+
+    UAttributes attributes;
+    attributes.mutable_source()->mutable_entity()->set_name("body.access");
+    EXPECT_EQ(mailbox.push(UMessage(UPayload(), attributes)).code(), UCode::INVALID_ARGUMENT);
+    EXPECT_EQ(mailbox.topics(), 0);
+}
+
+// Test that clear drops the pending samples and waitPop times out
+TEST(ConflatingMailboxTest, ClearAndTimeout)
+{
+    ConflatingMailbox mailbox(std::chrono::milliseconds(10));
+
+    mailbox.push(makeSample(1, 1));
+    mailbox.push(makeSample(2, 2));
+    mailbox.clear();
+    EXPECT_TRUE(mailbox.isEmpty());
+    EXPECT_EQ(mailbox.topics(), 2);
+
+    UMessage message;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(mailbox.waitPop(message));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+
+    mailbox.push(makeSample(1, 3));
+    ASSERT_TRUE(mailbox.waitPop(message));
+    EXPECT_EQ(message.attributes().ttl(), 3);
+}
+
+// Test that a slow consumer only sees fresh samples, in order, and always the last one
+TEST(ConflatingMailboxTest, SlowConsumer)
+{
+    ConflatingMailbox mailbox(std::chrono::milliseconds(100));
+    constexpr uint32_t Samples = 20000;
+
+    std::thread producer([&mailbox]() {
+        for (uint32_t i = 1; i <= Samples; ++i) {
+            mailbox.push(makeSample(1, i));
+        }
+    });
+
+    uint32_t last = 0;
+    size_t taken = 0;
+    UMessage message;
+    while ((last < Samples) && mailbox.waitPop(message)) {
+        EXPECT_GT(message.attributes().ttl(), last);
+        last = message.attributes().ttl();
+        ++taken;
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    producer.join();
+
+    EXPECT_EQ(last, Samples);
+    EXPECT_EQ(taken + mailbox.conflated(), Samples);
+}
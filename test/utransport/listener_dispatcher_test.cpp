@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <up-cpp/transport/ListenerDispatcher.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::utils;
+using namespace uprotocol::v1;
+
+/* listener recording the ttl of every message, holds each delivery until opened */
+class GatedListener : public UListener
+{
+public:
+    UStatus onReceive(UMessage &message) const override {
+        ++entered;
+        while (false == open.load()) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        ttls.push_back(message.attributes().ttl());
+        thread = std::this_thread::get_id();
+        return UStatus();
+    }
+
+    std::vector<uint32_t> received() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ttls;
+    }
+
+    mutable std::atomic<bool> open {true};
+    mutable std::atomic<int> entered {0};
+    mutable std::mutex mutex;
+    mutable std::vector<uint32_t> ttls;
+    mutable std::thread::id thread;
+};
+
+static UMessage makeMessage(uint32_t ttl, uint32_t topic = 1) {
+    UAttributes attributes;
+    attributes.set_ttl(ttl);
+    attributes.mutable_source()->mutable_entity()->set_id(1);
+    attributes.mutable_source()->mutable_resource()->set_id(topic);
+    return UMessage(UPayload(), attributes);
+}
+
+static bool waitUntil(const std::function<bool()> &condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((false == condition()) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return condition();
+}
+
+// Test that messages are delivered in order on a pool worker
+TEST(ListenerDispatcherTest, DeliversInOrderOffReceiveThread)
+{
+    ThreadPool pool(64, 4);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    auto &queue = dispatcher.attach(listener);
+
+    for (uint32_t i = 0; i < 200; ++i) {
+        auto message = makeMessage(i);
+        EXPECT_EQ(queue.onReceive(message).code(), UCode::OK);
+    }
+
+    ASSERT_TRUE(waitUntil([&listener]() { return 200 == listener.received().size(); }));
+    auto received = listener.received();
+    for (uint32_t i = 0; i < 200; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+    EXPECT_NE(listener.thread, std::this_thread::get_id());
+    EXPECT_EQ(queue.depth(), 0);
+}
+
+// Test that a full DROP queue rejects the newest message
+TEST(ListenerDispatcherTest, DropRejectsNewest)
+{
+    ThreadPool pool(64, 2);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    listener.open = false;
+
+    DispatchOptions options;
+    options.capacity = 4;
+    auto &queue = dispatcher.attach(listener, options);
+
+    auto first = makeMessage(0);
+    queue.onReceive(first);
+    ASSERT_TRUE(waitUntil([&listener]() { return 1 == listener.entered.load(); }));
+
+    for (uint32_t i = 1; i <= 4; ++i) {
+        auto message = makeMessage(i);
+        EXPECT_EQ(queue.onReceive(message).code(), UCode::OK);
+    }
+    auto rejected = makeMessage(5);
+    EXPECT_EQ(queue.onReceive(rejected).code(), UCode::RESOURCE_EXHAUSTED);
+    EXPECT_EQ(queue.dropped(), 1);
+    EXPECT_EQ(queue.depth(), 4);
+    EXPECT_GT(queue.lag().count(), 0);
+
+    listener.open = true;
+    ASSERT_TRUE(waitUntil([&listener]() { return 5 == listener.received().size(); }));
+    EXPECT_EQ(listener.received().back(), 4);
+}
+
+// Test that a prioritized queue delivers what is queued by priority, not arrival
+TEST(ListenerDispatcherTest, PrioritizeDelivery)
+{
+    ThreadPool pool(64, 2);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    listener.open = false;
+
+    DispatchOptions options;
+    options.capacity = 8;
+    options.prioritize = true;
+    auto &queue = dispatcher.attach(listener, options);
+
+    /* held by the listener, everything after it is queued */
+    auto first = makeMessage(0);
+    queue.onReceive(first);
+    ASSERT_TRUE(waitUntil([&listener]() { return 1 == listener.entered.load(); }));
+
+    for (uint32_t i = 1; i <= 3; ++i) {
+        auto message = makeMessage(i);
+        message.mutableAttributes().set_priority(UPriority::UPRIORITY_CS0);
+        EXPECT_EQ(queue.onReceive(message).code(), UCode::OK);
+    }
+    auto urgent = makeMessage(100);
+    urgent.mutableAttributes().set_priority(UPriority::UPRIORITY_CS6);
+    EXPECT_EQ(queue.onReceive(urgent).code(), UCode::OK);
+    EXPECT_EQ(queue.depth(), 4);
+    EXPECT_GT(queue.lag().count(), 0);
+
+    listener.open = true;
+    ASSERT_TRUE(waitUntil([&listener]() { return 5 == listener.received().size(); }));
+    EXPECT_EQ(listener.received(), (std::vector<uint32_t>{0, 100, 1, 2, 3}));
+    EXPECT_EQ(queue.depth(), 0);
+}
+
+// Test that a full BLOCK queue holds the producer until there is room or the timeout expires
+TEST(ListenerDispatcherTest, BlockWaitsForRoom)
+{
+    ThreadPool pool(64, 2);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    listener.open = false;
+
+    DispatchOptions options;
+    options.capacity = 1;
+    options.policy = OverflowPolicy::BLOCK;
+    options.blockTimeout = std::chrono::milliseconds(20);
+    auto &queue = dispatcher.attach(listener, options);
+
+    auto first = makeMessage(0);
+    queue.onReceive(first);
+    ASSERT_TRUE(waitUntil([&listener]() { return 1 == listener.entered.load(); }));
+    auto second = makeMessage(1);
+    EXPECT_EQ(queue.onReceive(second).code(), UCode::OK);
+
+    auto start = std::chrono::steady_clock::now();
+    auto timedOut = makeMessage(2);
+    EXPECT_EQ(queue.onReceive(timedOut).code(), UCode::RESOURCE_EXHAUSTED);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(queue.dropped(), 1);
+
+    options.blockTimeout = std::chrono::seconds(10);
+    auto &patient = dispatcher.attach(listener, options);
+    std::thread opener([&listener]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        listener.open = true;
+    });
+    for (uint32_t i = 3; i < 6; ++i) {
+        auto message = makeMessage(i);
+        EXPECT_EQ(patient.onReceive(message).code(), UCode::OK);
+    }
+    opener.join();
+
+    ASSERT_TRUE(waitUntil([&listener]() { return 5 == listener.received().size(); }));
+    EXPECT_EQ(patient.dropped(), 0);
+}
+
+// Test that a full COALESCE_LATEST queue keeps only the newest message per topic
+TEST(ListenerDispatcherTest, CoalesceLatestPerTopic)
+{
+    ThreadPool pool(64, 2);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    listener.open = false;
+
+    DispatchOptions options;
+    options.capacity = 2;
+    options.policy = OverflowPolicy::COALESCE_LATEST;
+    auto &queue = dispatcher.attach(listener, options);
+
+    auto first = makeMessage(0, 3);
+    queue.onReceive(first);
+    ASSERT_TRUE(waitUntil([&listener]() { return 1 == listener.entered.load(); }));
+
+    /* topic 1 is queued first and keeps its place, with the latest value */
+    for (auto [ttl, topic] : {std::pair<uint32_t, uint32_t>{10, 1}, {20, 2}, {11, 1}, {21, 2}, {12, 1}}) {
+        auto message = makeMessage(ttl, topic);
+        EXPECT_EQ(queue.onReceive(message).code(), UCode::OK);
+    }
+    auto third = makeMessage(30, 3);
+    EXPECT_EQ(queue.onReceive(third).code(), UCode::RESOURCE_EXHAUSTED);
+    EXPECT_EQ(queue.depth(), 2);
+    EXPECT_EQ(queue.coalesced(), 3);
+
+    listener.open = true;
+    ASSERT_TRUE(waitUntil([&listener]() { return 3 == listener.received().size(); }));
+    EXPECT_EQ(listener.received(), (std::vector<uint32_t>{0, 12, 21}));
+
+    /* a delivered topic is queued again */
+    auto again = makeMessage(13, 1);
+    EXPECT_EQ(queue.onReceive(again).code(), UCode::OK);
+    ASSERT_TRUE(waitUntil([&listener]() { return 4 == listener.received().size(); }));
+    EXPECT_EQ(listener.received().back(), 13);
+}
+
+// Test that COALESCE_LATEST keeps every message of a topic while the queue has room
+TEST(ListenerDispatcherTest, CoalesceOnlyWhenFull)
+{
+    ThreadPool pool(64, 2);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    listener.open = false;
+
+    DispatchOptions options;
+    options.capacity = 3;
+    options.policy = OverflowPolicy::COALESCE_LATEST;
+    auto &queue = dispatcher.attach(listener, options);
+
+    auto first = makeMessage(0, 3);
+    queue.onReceive(first);
+    ASSERT_TRUE(waitUntil([&listener]() { return 1 == listener.entered.load(); }));
+
+    /* the third sample of topic 1 fills the queue, the fourth replaces it */
+    for (uint32_t ttl : {10, 11, 12, 13}) {
+        auto message = makeMessage(ttl, 1);
+        EXPECT_EQ(queue.onReceive(message).code(), UCode::OK);
+    }
+    EXPECT_EQ(queue.depth(), 3);
+    EXPECT_EQ(queue.coalesced(), 1);
+
+    listener.open = true;
+    ASSERT_TRUE(waitUntil([&listener]() { return 4 == listener.received().size(); }));
+    EXPECT_EQ(listener.received(), (std::vector<uint32_t>{0, 10, 11, 13}));
+}
+
+// Test that the depth signal throttles and releases the producer
+TEST(ListenerDispatcherTest, PressureSignal)
+{
+    ThreadPool pool(64, 2);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    listener.open = false;
+
+    std::mutex mutex;
+    std::vector<bool> signals;
+    DispatchOptions options;
+    options.capacity = 8;
+    options.highWatermark = 3;
+    options.lowWatermark = 1;
+    options.onPressure = [&mutex, &signals](bool throttle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        signals.push_back(throttle);
+    };
+    auto &queue = dispatcher.attach(listener, options);
+
+    auto first = makeMessage(0);
+    queue.onReceive(first);
+    ASSERT_TRUE(waitUntil([&listener]() { return 1 == listener.entered.load(); }));
+
+    for (uint32_t i = 1; i <= 3; ++i) {
+        EXPECT_FALSE(queue.isThrottled());
+        auto message = makeMessage(i);
+        queue.onReceive(message);
+    }
+    EXPECT_TRUE(queue.isThrottled());
+    EXPECT_EQ(dispatcher.throttled(), 1);
+    EXPECT_EQ(dispatcher.depth(), 3);
+
+    listener.open = true;
+    ASSERT_TRUE(waitUntil([&listener]() { return 4 == listener.received().size(); }));
+    EXPECT_FALSE(queue.isThrottled());
+    EXPECT_EQ(dispatcher.throttled(), 0);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(signals, (std::vector<bool>{true, false}));
+}
+
+// Test that the lag signal throttles a queue that is not deep
+TEST(ListenerDispatcherTest, LagSignal)
+{
+    ThreadPool pool(64, 2);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener listener;
+    listener.open = false;
+
+    DispatchOptions options;
+    options.maxLag = std::chrono::milliseconds(10);
+    auto &queue = dispatcher.attach(listener, options);
+
+    auto first = makeMessage(0);
+    queue.onReceive(first);
+    ASSERT_TRUE(waitUntil([&listener]() { return 1 == listener.entered.load(); }));
+
+    auto second = makeMessage(1);
+    queue.onReceive(second);
+    EXPECT_FALSE(queue.isThrottled());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto third = makeMessage(2);
+    queue.onReceive(third);
+    EXPECT_TRUE(queue.isThrottled());
+
+    listener.open = true;
+    ASSERT_TRUE(waitUntil([&listener]() { return 3 == listener.received().size(); }));
+    EXPECT_FALSE(queue.isThrottled());
+}
+
+// Test that a group of listeners shares one queue and one detach delivers what is queued
+TEST(ListenerDispatcherTest, GroupAndDetach)
+{
+    ThreadPool pool(64, 4);
+    ListenerDispatcher dispatcher(pool);
+    GatedListener first;
+    GatedListener second;
+    auto &queue = dispatcher.attach({&first, &second});
+
+    for (uint32_t i = 0; i < 50; ++i) {
+        auto message = makeMessage(i);
+        EXPECT_EQ(queue.onReceive(message).code(), UCode::OK);
+    }
+
+    EXPECT_EQ(dispatcher.detach(queue).code(), UCode::OK);
+    EXPECT_EQ(first.received().size(), 50);
+    EXPECT_EQ(first.received(), second.received());
+
+    GatedListener other;
+    ListenerDispatcher otherDispatcher(pool);
+    auto &foreign = otherDispatcher.attach(other);
+    EXPECT_EQ(dispatcher.detach(foreign).code(), UCode::NOT_FOUND);
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <up-cpp/transport/ListenerRegistry.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+class CountingListener : public UListener
+{
+public:
+    UStatus onReceive(UMessage &) const override {
+        ++count;
+        UStatus status;
+        status.set_code(UCode::OK);
+        return status;
+    }
+
+    mutable std::atomic<int> count {0};
+};
+
+static UUri makeUri(bool authority, uint32_t entity, bool version, uint32_t resource) {
+    UUri uri;
+    if (authority) {
+        uri.mutable_authority();
+    }
+    if (0 != entity) {
+        uri.mutable_entity()->set_id(entity);
+    }
+    if (version) {
+        uri.mutable_entity()->set_version_major(1);
+    }
+    if (0 != resource) {
+        uri.mutable_resource()->set_id(resource);
+    }
+    return uri;
+}
+
+// Test exact and wildcard matches
+TEST(ListenerRegistryTest, ExactAndWildcard)
+{
+    ListenerRegistry registry;
+    CountingListener exact;
+    CountingListener anyResource;
+    CountingListener everything;
+    UMessage message;
+
+    EXPECT_EQ(registry.registerListener(makeUri(true, 10, true, 0x8001), exact).code(), UCode::OK);
+    EXPECT_EQ(registry.registerListener(makeUri(true, 10, true, 0), anyResource).code(), UCode::OK);
+    EXPECT_EQ(registry.registerListener(UUri(), everything).code(), UCode::OK);
+
+    EXPECT_EQ(registry.dispatch(makeUri(true, 10, true, 0x8001), message), 3U);
+    EXPECT_EQ(registry.dispatch(makeUri(true, 10, true, 0x8002), message), 2U);
+    EXPECT_EQ(registry.dispatch(makeUri(true, 11, true, 0x8001), message), 1U);
+
+    EXPECT_EQ(exact.count, 1);
+    EXPECT_EQ(anyResource.count, 2);
+    EXPECT_EQ(everything.count, 3);
+    EXPECT_EQ(registry.size(), 3U);
+}
+
+// Test remote authorities are part of the key
+TEST(ListenerRegistryTest, RemoteAuthority)
+{
+    ListenerRegistry registry;
+    CountingListener listener;
+    UMessage message;
+
+    auto remote = makeUri(true, 10, true, 1);
+    remote.mutable_authority()->set_id("vehicle-1234567890");
+    EXPECT_EQ(registry.registerListener(remote, listener).code(), UCode::OK);
+
+    EXPECT_EQ(registry.dispatch(remote, message), 1U);
+    EXPECT_EQ(registry.dispatch(makeUri(true, 10, true, 1), message), 0U);
+    remote.mutable_authority()->set_id("vehicle-other");
+    EXPECT_EQ(registry.dispatch(remote, message), 0U);
+}
+
+// Test duplicate registration, unregistration and invalid patterns
+TEST(ListenerRegistryTest, RegisterUnregister)
+{
+    ListenerRegistry registry;
+    CountingListener listener;
+    UMessage message;
+    auto uri = makeUri(true, 10, true, 1);
+
+    EXPECT_EQ(registry.registerListener(uri, listener).code(), UCode::OK);
+    EXPECT_EQ(registry.registerListener(uri, listener).code(), UCode::ALREADY_EXISTS);
+    EXPECT_EQ(registry.unregisterListener(uri, listener).code(), UCode::OK);
+    EXPECT_EQ(registry.unregisterListener(uri, listener).code(), UCode::NOT_FOUND);
+    EXPECT_EQ(registry.dispatch(uri, message), 0U);
+    EXPECT_EQ(registry.size(), 0U);
+
+    UUri named;
+    named.mutable_entity()->set_name("body.access");
+    EXPECT_EQ(registry.registerListener(named, listener).code(), UCode::INVALID_ARGUMENT);
+}
+
+// Test lookups while other threads register and unregister
+TEST(ListenerRegistryTest, ConcurrentLookup)
+{
+    ListenerRegistry registry(64);
+    CountingListener stable;
+    std::vector<CountingListener> churn(64);
+    auto uri = makeUri(true, 10, true, 1);
+    ASSERT_EQ(registry.registerListener(uri, stable).code(), UCode::OK);
+
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        while (false == stop) {
+            for (size_t i = 0; i < churn.size(); ++i) {
+                registry.registerListener(makeUri(true, 100 + i, true, 1), churn[i]);
+            }
+            for (size_t i = 0; i < churn.size(); ++i) {
+                registry.unregisterListener(makeUri(true, 100 + i, true, 1), churn[i]);
+            }
+        }
+    });
+
+    UMessage message;
+    for (int i = 0; i < 20000; ++i) {
+        ASSERT_EQ(registry.dispatch(uri, message), 1U);
+    }
+    stop = true;
+    writer.join();
+
+    EXPECT_EQ(stable.count, 20000);
+}
+
+// Test that unregistering waits for a dispatch that is still calling the listener
+TEST(ListenerRegistryTest, UnregisterWaitsForDispatch)
+{
+    class BlockingListener : public UListener
+    {
+    public:
+        UStatus onReceive(UMessage &) const override {
+            entered = true;
+            while (false == release) {
+                std::this_thread::yield();
+            }
+            left = true;
+            UStatus status;
+            status.set_code(UCode::OK);
+            return status;
+        }
+
+        mutable std::atomic<bool> entered {false};
+        mutable std::atomic<bool> left {false};
+        std::atomic<bool> release {false};
+    };
+
+    ListenerRegistry registry;
+    BlockingListener listener;
+    auto uri = makeUri(true, 10, true, 1);
+    ASSERT_EQ(registry.registerListener(uri, listener).code(), UCode::OK);
+
+    std::thread dispatcher([&]() {
+        UMessage message;
+        registry.dispatch(uri, message);
+    });
+    while (false == listener.entered) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<bool> unregistered(false);
+    std::thread unregisterer([&]() {
+        EXPECT_EQ(registry.unregisterListener(uri, listener).code(), UCode::OK);
+        EXPECT_TRUE(listener.left);
+        unregistered = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(unregistered);
+
+    listener.release = true;
+    unregisterer.join();
+    dispatcher.join();
+    EXPECT_TRUE(unregistered);
+
+    UMessage message;
+    EXPECT_EQ(registry.dispatch(uri, message), 0U);
+}
+
+// Test that a listener can unregister itself while it is being dispatched to
+TEST(ListenerRegistryTest, UnregisterFromDispatch)
+{
+    class SelfRemovingListener : public UListener
+    {
+    public:
+        SelfRemovingListener(ListenerRegistry &registry, const UUri &uri) : registry_(registry), uri_(uri) {}
+
+        UStatus onReceive(UMessage &) const override {
+            return registry_.unregisterListener(uri_, *this);
+        }
+
+    private:
+        ListenerRegistry &registry_;
+        UUri uri_;
+    };
+
+    ListenerRegistry registry;
+    auto uri = makeUri(true, 10, true, 1);
+    SelfRemovingListener listener(registry, uri);
+    ASSERT_EQ(registry.registerListener(uri, listener).code(), UCode::OK);
+
+    UMessage message;
+    EXPECT_EQ(registry.dispatch(uri, message), 1U);
+    EXPECT_EQ(registry.dispatch(uri, message), 0U);
+    EXPECT_EQ(registry.size(), 0U);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
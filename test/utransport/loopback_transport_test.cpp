@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <up-cpp/transport/LoopbackTransport.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::utils;
+using namespace uprotocol::v1;
+
+static UUri topic(uint32_t resource) {
+    UUri uri;
+    uri.mutable_entity()->set_id(100);
+    uri.mutable_entity()->set_version_major(1);
+    uri.mutable_resource()->set_id(resource);
+    return uri;
+}
+
+static UMessage makeMessage(uint32_t resource, int32_t ttl) {
+    UAttributes attributes;
+    *attributes.mutable_source() = topic(resource);
+    attributes.set_ttl(ttl);
+    static const uint8_t bytes[] = {1, 2, 3};
+    return UMessage(UPayload(bytes, sizeof(bytes), UPayloadType::REFERENCE), attributes);
+}
+
+/* listener recording the ttl of every message and the thread it ran on */
+class Recorder : public UListener
+{
+public:
+    explicit Recorder(UCode code = UCode::OK) : code_(code) {}
+
+    UStatus onReceive(UMessage &message) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ttls_.push_back(message.attributes().ttl());
+        thread_ = std::this_thread::get_id();
+        data_ = message.payload().data();
+        UStatus status;
+        status.set_code(code_);
+        return status;
+    }
+
+    std::vector<int32_t> received() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ttls_;
+    }
+
+    std::thread::id thread() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return thread_;
+    }
+
+    const uint8_t *data() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return data_;
+    }
+
+    bool waitFor(size_t count) const {
+        for (int i = 0; i < 1000; ++i) {
+            if (received().size() >= count) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+private:
+    const UCode code_;
+    mutable std::mutex mutex_;
+    mutable std::vector<int32_t> ttls_;
+    mutable std::thread::id thread_;
+    mutable const uint8_t *data_ = nullptr;
+};
+
+// Test that listeners run inside send() and only for their topic
+TEST(LoopbackTransportTest, SynchronousDelivery)
+{
+    LoopbackTransport transport;
+    EXPECT_FALSE(transport.isPooled());
+
+    Recorder door;
+    Recorder all;
+    EXPECT_EQ(transport.registerListener(topic(1), door).code(), UCode::OK);
+    EXPECT_EQ(transport.registerListener(topic(1), door).code(), UCode::ALREADY_EXISTS);
+    UUri entity = topic(0);
+    entity.clear_resource();
+    EXPECT_EQ(transport.registerListener(entity, all).code(), UCode::OK);
+
+    auto message = makeMessage(1, 10);
+    EXPECT_EQ(transport.send(message).code(), UCode::OK);
+    EXPECT_EQ(transport.send(makeMessage(2, 20)).code(), UCode::OK);
+    EXPECT_EQ(transport.send(makeMessage(3, 30)).code(), UCode::OK);
+
+    EXPECT_EQ(door.received(), std::vector<int32_t>({10}));
+    EXPECT_EQ(all.received(), std::vector<int32_t>({10, 20, 30}));
+    EXPECT_EQ(door.thread(), std::this_thread::get_id());
+    /* the payload reaches the listener without a copy */
+    EXPECT_EQ(door.data(), message.payload().data());
+
+    EXPECT_EQ(transport.unregisterListener(topic(1), door).code(), UCode::OK);
+    EXPECT_EQ(transport.unregisterListener(topic(1), door).code(), UCode::NOT_FOUND);
+    transport.send(makeMessage(1, 40));
+    EXPECT_EQ(door.received().size(), 1);
+    EXPECT_EQ(all.received().size(), 4);
+}
+
+// Test that the first failure of a listener is returned
+TEST(LoopbackTransportTest, ListenerStatus)
+{
+    LoopbackTransport transport;
+    Recorder ok;
+    Recorder failing(UCode::INTERNAL);
+    transport.registerListener(topic(1), ok);
+    transport.registerListener(topic(1), failing);
+
+    EXPECT_EQ(transport.send(makeMessage(1, 1)).code(), UCode::INTERNAL);
+    EXPECT_EQ(ok.received().size(), 1);
+    EXPECT_EQ(transport.send(makeMessage(2, 1)).code(), UCode::OK);
+}
+
+// Test that with a pool listeners run on the workers, in order per listener
+TEST(LoopbackTransportTest, PooledDelivery)
+{
+    ThreadPool pool(1024, 2);
+    LoopbackTransport transport(pool);
+    EXPECT_TRUE(transport.isPooled());
+
+    Recorder door;
+    Recorder window;
+    EXPECT_EQ(transport.registerListener(topic(1), door).code(), UCode::OK);
+    EXPECT_EQ(transport.registerListener(topic(2), door).code(), UCode::OK);
+    EXPECT_EQ(transport.registerListener(topic(2), window).code(), UCode::OK);
+
+    std::vector<int32_t> expected;
+    for (int32_t i = 0; i < 200; ++i) {
+        EXPECT_EQ(transport.send(makeMessage(1 + (i % 2), i)).code(), UCode::OK);
+        expected.push_back(i);
+    }
+    ASSERT_TRUE(door.waitFor(200));
+    ASSERT_TRUE(window.waitFor(100));
+    EXPECT_EQ(door.received(), expected);
+    EXPECT_NE(door.thread(), std::this_thread::get_id());
+
+    /* the queue goes with the last registration of its listener */
+    EXPECT_EQ(transport.unregisterListener(topic(1), door).code(), UCode::OK);
+    transport.send(makeMessage(2, 1000));
+    ASSERT_TRUE(door.waitFor(201));
+    EXPECT_EQ(transport.unregisterListener(topic(2), door).code(), UCode::OK);
+    EXPECT_EQ(transport.unregisterListener(topic(2), door).code(), UCode::NOT_FOUND);
+    transport.send(makeMessage(2, 2000));
+    ASSERT_TRUE(window.waitFor(102));
+    EXPECT_EQ(door.received().size(), 201);
+}
+
+// Test that a full listener queue is reported to the sender
+TEST(LoopbackTransportTest, PooledBackpressure)
+{
+    ThreadPool pool(1024, 1);
+    DispatchOptions options;
+    options.capacity = 4;
+    LoopbackTransport transport(pool, options);
+
+    std::atomic<bool> open {false};
+    class Gated : public UListener {
+        public:
+            explicit Gated(std::atomic<bool> &open) : open_(open) {}
+            UStatus onReceive(UMessage &) const override {
+                while (false == open_.load()) {
+                    std::this_thread::yield();
+                }
+                return UStatus();
+            }
+        private:
+            std::atomic<bool> &open_;
+    } gated(open);
+    transport.registerListener(topic(1), gated);
+
+    size_t exhausted = 0;
+    for (int32_t i = 0; i < 20; ++i) {
+        if (UCode::RESOURCE_EXHAUSTED == transport.send(makeMessage(1, i)).code()) {
+            ++exhausted;
+        }
+    }
+    EXPECT_GT(exhausted, 0);
+    open = true;
+    EXPECT_EQ(transport.unregisterListener(topic(1), gated).code(), UCode::OK);
+}
+
+// Test registration churn while other threads send
+TEST(LoopbackTransportTest, ConcurrentRegistration)
+{
+    ThreadPool pool(1024, 2);
+    LoopbackTransport transport(pool);
+    Recorder listener;
+    std::atomic<bool> stop {false};
+
+    std::vector<std::thread> senders;
+    for (int t = 0; t < 2; ++t) {
+        senders.emplace_back([&transport, &stop]() {
+            while (false == stop.load()) {
+                transport.send(makeMessage(1, 0));
+            }
+        });
+    }
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(transport.registerListener(topic(1), listener).code(), UCode::OK);
+        EXPECT_EQ(transport.unregisterListener(topic(1), listener).code(), UCode::OK);
+    }
+    stop = true;
+    for (auto &sender : senders) {
+        sender.join();
+    }
+}
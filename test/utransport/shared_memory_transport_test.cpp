@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <up-cpp/transport/SharedMemoryTransport.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+/* a segment name of its own for every test, so parallel test runs do not collide */
+static std::string segmentName(const char *test) {
+    return "/up-cpp-" + std::to_string(getpid()) + "-" + test;
+}
+
+static UUri topic(uint32_t resource) {
+    UUri uri;
+    uri.mutable_entity()->set_id(100);
+    uri.mutable_entity()->set_version_major(1);
+    uri.mutable_resource()->set_id(resource);
+    return uri;
+}
+
+static UMessage makeMessage(uint32_t resource, const std::string &text) {
+    UAttributes attributes;
+    *attributes.mutable_source() = topic(resource);
+    attributes.set_type(UMESSAGE_TYPE_PUBLISH);
+    UPayload payload(reinterpret_cast<const uint8_t *>(text.data()), text.size(), UPayloadType::VALUE);
+    payload.setFormat(UPayloadFormat::TEXT);
+    return UMessage(payload, attributes);
+}
+
+class Collector : public UListener {
+    public:
+        UStatus onReceive(UMessage &message) const override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            messages_.push_back(message);
+            UStatus status;
+            status.set_code(UCode::OK);
+            return status;
+        }
+
+        /* wait for count messages, for up to a second */
+        bool waitFor(size_t count) const {
+            for (int i = 0; i < 1000; ++i) {
+                if (size() >= count) {
+                    return true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return false;
+        }
+
+        size_t size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return messages_.size();
+        }
+
+        UMessage at(size_t i) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return messages_[i];
+        }
+
+        void clear() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            messages_.clear();
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        mutable std::vector<UMessage> messages_;
+};
+
+// Test that subscribers receive the payload in the segment, not a copy of it
+TEST(SharedMemoryTransportTest, PublishToSubscribers)
+{
+    auto publisher = SharedMemoryTransport::create(segmentName("publish"));
+    ASSERT_NE(publisher, nullptr);
+    auto first = SharedMemoryTransport::open(segmentName("publish"));
+    auto second = SharedMemoryTransport::open(segmentName("publish"));
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_TRUE(publisher->isPublisher());
+    EXPECT_FALSE(first->isPublisher());
+
+    Collector door;
+    Collector window;
+    Collector local;
+    EXPECT_EQ(first->registerListener(topic(1), door).code(), UCode::OK);
+    EXPECT_EQ(second->registerListener(topic(2), window).code(), UCode::OK);
+    EXPECT_EQ(publisher->registerListener(topic(1), local).code(), UCode::OK);
+
+    EXPECT_EQ(publisher->send(makeMessage(1, "open")).code(), UCode::OK);
+    EXPECT_EQ(publisher->send(makeMessage(2, "closed")).code(), UCode::OK);
+
+    ASSERT_TRUE(door.waitFor(1));
+    ASSERT_TRUE(window.waitFor(1));
+    ASSERT_EQ(local.size(), 1);
+
+    auto message = door.at(0);
+    EXPECT_EQ(message.payload().type(), UPayloadType::SHARED);
+    EXPECT_EQ(message.payload().format(), UPayloadFormat::TEXT);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(message.payload().data()), message.payload().size()), "open");
+    EXPECT_EQ(message.attributes().source().resource().id(), 1);
+    EXPECT_EQ(message.attributes().type(), UMESSAGE_TYPE_PUBLISH);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(window.at(0).payload().data()), 6), "closed");
+
+    /* the slots are held by the received payloads until they go */
+    EXPECT_GE(publisher->slotsInUse(), 2);
+    message = UMessage();
+    door.clear();
+    window.clear();
+    local.clear();
+    EXPECT_EQ(publisher->slotsInUse(), 0);
+
+    EXPECT_EQ(first->send(makeMessage(1, "denied")).code(), UCode::FAILED_PRECONDITION);
+}
+
+// Test that a local listener can send on the transport it is called by
+TEST(SharedMemoryTransportTest, ReentrantSend)
+{
+    auto publisher = SharedMemoryTransport::create(segmentName("reentrant"));
+    ASSERT_NE(publisher, nullptr);
+    auto subscriber = SharedMemoryTransport::open(segmentName("reentrant"));
+    ASSERT_NE(subscriber, nullptr);
+
+    class Replier : public UListener {
+        public:
+            explicit Replier(SharedMemoryTransport &transport) : transport_(transport) {}
+            UStatus onReceive(UMessage &) const override {
+                return transport_.send(makeMessage(2, "reply"));
+            }
+        private:
+            SharedMemoryTransport &transport_;
+    } replier(*publisher);
+    Collector local;
+    Collector remote;
+    EXPECT_EQ(publisher->registerListener(topic(1), replier).code(), UCode::OK);
+    EXPECT_EQ(publisher->registerListener(topic(2), local).code(), UCode::OK);
+    EXPECT_EQ(subscriber->registerListener(topic(2), remote).code(), UCode::OK);
+
+    EXPECT_EQ(publisher->send(makeMessage(1, "request")).code(), UCode::OK);
+    ASSERT_EQ(local.size(), 1);
+    ASSERT_TRUE(remote.waitFor(1));
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(remote.at(0).payload().data()), 5), "reply");
+}
+
+// Test that a receiver writing its payload does not change what the others read
+TEST(SharedMemoryTransportTest, ReceivedPayloadIsReadOnly)
+{
+    auto publisher = SharedMemoryTransport::create(segmentName("readonly"));
+    ASSERT_NE(publisher, nullptr);
+    auto first = SharedMemoryTransport::open(segmentName("readonly"));
+    auto second = SharedMemoryTransport::open(segmentName("readonly"));
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    Collector door;
+    Collector window;
+    Collector local;
+    first->registerListener(topic(1), door);
+    second->registerListener(topic(1), window);
+    publisher->registerListener(topic(1), local);
+
+    auto payload = publisher->loan(4);
+    std::memcpy(payload.mutableData(), "open", 4);
+    UAttributes attributes;
+    *attributes.mutable_source() = topic(1);
+    EXPECT_EQ(publisher->send(UMessage(std::move(payload), attributes)).code(), UCode::OK);
+    ASSERT_TRUE(door.waitFor(1));
+    ASSERT_TRUE(window.waitFor(1));
+    ASSERT_EQ(local.size(), 1);
+
+    /* the collectors' copies are dropped, each payload is the sole owner of its view of the slot */
+    auto received = door.at(0);
+    auto other = window.at(0);
+    auto mine = local.at(0);
+    door.clear();
+    window.clear();
+    local.clear();
+    const auto *slot = received.payload().data();
+    auto *data = received.mutablePayload().mutableData();
+    EXPECT_NE(data, slot);
+    data[0] = 'O';
+    mine.mutablePayload().mutableData()[1] = 'P';
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(other.payload().data()), 4), "open");
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(received.payload().data()), 4), "Open");
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(mine.payload().data()), 4), "oPen");
+}
+
+// Test that the segments of a gathered payload are written into one slot
+TEST(SharedMemoryTransportTest, GatheredPayload)
+{
+    auto publisher = SharedMemoryTransport::create(segmentName("gather"));
+    ASSERT_NE(publisher, nullptr);
+    auto subscriber = SharedMemoryTransport::open(segmentName("gather"));
+    ASSERT_NE(subscriber, nullptr);
+    Collector remote;
+    EXPECT_EQ(subscriber->registerListener(topic(1), remote).code(), UCode::OK);
+
+    const std::string header = "hdr:";
+    const std::string body = "open";
+    auto message = makeMessage(1, body);
+    message.setPayload(UPayload::gather({
+        UPayload(reinterpret_cast<const uint8_t *>(header.data()), header.size(), UPayloadType::REFERENCE),
+        message.payload()}));
+    ASSERT_FALSE(message.payload().isContiguous());
+
+    EXPECT_EQ(publisher->send(message).code(), UCode::OK);
+    ASSERT_TRUE(remote.waitFor(1));
+    const auto received = remote.at(0);
+    EXPECT_TRUE(received.payload().isContiguous());
+    EXPECT_EQ(received.payload().format(), UPayloadFormat::TEXT);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(received.payload().data()), received.payload().size()), "hdr:open");
+}
+
+// Test that a loaned payload is written and received in place
+TEST(SharedMemoryTransportTest, LoanedPayload)
+{
+    auto publisher = SharedMemoryTransport::create(segmentName("loan"));
+    auto subscriber = SharedMemoryTransport::open(segmentName("loan"));
+    ASSERT_NE(subscriber, nullptr);
+    Collector collector;
+    subscriber->registerListener(topic(1), collector);
+
+    auto payload = publisher->loan(5);
+    ASSERT_EQ(payload.size(), 5);
+    auto *data = payload.mutableData();
+    ASSERT_EQ(data, payload.data());
+    std::memcpy(data, "hello", 5);
+
+    UAttributes attributes;
+    *attributes.mutable_source() = topic(1);
+    UMessage message(std::move(payload), attributes);
+    EXPECT_EQ(publisher->slotsInUse(), 1);
+    EXPECT_EQ(publisher->send(message).code(), UCode::OK);
+    /* sending the same loan again copies it into a slot of its own */
+    EXPECT_EQ(publisher->send(message).code(), UCode::OK);
+
+    ASSERT_TRUE(collector.waitFor(2));
+    EXPECT_EQ(publisher->slotsInUse(), 2);
+    auto received = collector.at(0);
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(received.payload().data()), 5), "hello");
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(collector.at(1).payload().data()), 5), "hello");
+
+    EXPECT_EQ(subscriber->loan(5).size(), 0);
+    EXPECT_EQ(publisher->loan(1 << 20).size(), 0);
+}
+
+// Test the limits of slots and rings
+TEST(SharedMemoryTransportTest, Backpressure)
+{
+    SharedMemoryOptions options;
+    options.slots = 4;
+    options.subscribers = 1;
+    options.ringCapacity = 2;
+    options.payloadCapacity = 16;
+    auto publisher = SharedMemoryTransport::create(segmentName("limits"), options);
+    ASSERT_NE(publisher, nullptr);
+
+    EXPECT_EQ(publisher->send(makeMessage(1, std::string(17, 'x'))).code(), UCode::INVALID_ARGUMENT);
+
+    /* without subscribers a slot is only held while sending */
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(publisher->send(makeMessage(1, "x")).code(), UCode::OK);
+    }
+    EXPECT_EQ(publisher->slotsInUse(), 0);
+
+    std::vector<UPayload> loans;
+    for (int i = 0; i < 4; ++i) {
+        loans.push_back(publisher->loan(1));
+        EXPECT_EQ(loans.back().size(), 1);
+    }
+    EXPECT_EQ(publisher->send(makeMessage(1, "x")).code(), UCode::RESOURCE_EXHAUSTED);
+    loans.clear();
+
+    auto subscriber = SharedMemoryTransport::open(segmentName("limits"));
+    ASSERT_NE(subscriber, nullptr);
+    EXPECT_EQ(SharedMemoryTransport::open(segmentName("limits")), nullptr);
+
+    /* a listener that does not return fills the ring */
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    class Blocking : public UListener {
+        public:
+            explicit Blocking(std::mutex &gate) : gate_(gate) {}
+            UStatus onReceive(UMessage &) const override {
+                std::lock_guard<std::mutex> lock(gate_);
+                return UStatus();
+            }
+        private:
+            std::mutex &gate_;
+    } blocking(gate);
+    subscriber->registerListener(topic(1), blocking);
+
+    size_t exhausted = 0;
+    for (int i = 0; i < 6; ++i) {
+        if (UCode::RESOURCE_EXHAUSTED == publisher->send(makeMessage(1, "x")).code()) {
+            ++exhausted;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_GT(exhausted, 0);
+    EXPECT_EQ(publisher->dropped(), exhausted);
+    closed.unlock();
+
+    /* detaching releases what the subscriber did not receive */
+    subscriber.reset();
+    EXPECT_EQ(publisher->slotsInUse(), 0);
+    EXPECT_NE(SharedMemoryTransport::open(segmentName("limits")), nullptr);
+}
+
+// Test delivery to a subscriber in another process
+TEST(SharedMemoryTransportTest, CrossProcess)
+{
+    /* named before forking, the child has a pid of its own */
+    const auto name = segmentName("process");
+    auto publisher = SharedMemoryTransport::create(name);
+    ASSERT_NE(publisher, nullptr);
+
+    int attached[2];
+    ASSERT_EQ(pipe(attached), 0);
+    auto child = fork();
+    ASSERT_NE(child, -1);
+    if (0 == child) {
+        int result = 1;
+        {
+            auto subscriber = SharedMemoryTransport::open(name);
+            Collector collector;
+            if (nullptr != subscriber) {
+                subscriber->registerListener(topic(7), collector);
+            }
+            char ready = (nullptr != subscriber) ? 1 : 0;
+            if (1 != write(attached[1], &ready, 1)) {
+                _exit(2);
+            }
+            if ((0 != ready) && collector.waitFor(100)) {
+                result = (std::string(reinterpret_cast<const char *>(collector.at(99).payload().data()), 3) == "099")
+                    ? 0 : 3;
+            }
+        }
+        _exit(result);
+    }
+
+    char ready = 0;
+    ASSERT_EQ(read(attached[0], &ready, 1), 1);
+    ASSERT_EQ(ready, 1);
+    for (int i = 0; i < 100; ++i) {
+        char text[4];
+        snprintf(text, sizeof(text), "%03d", i);
+        EXPECT_EQ(publisher->send(makeMessage(7, text)).code(), UCode::OK);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    close(attached[0]);
+    close(attached[1]);
+    EXPECT_EQ(publisher->slotsInUse(), 0);
+}
@@ -24,7 +24,9 @@
  */
 
 #include <up-cpp/transport/builder/UAttributesBuilder.h>
+#include <up-cpp/transport/builder/UAttributesTemplate.h>
 #include <up-cpp/uuid/factory/UuidFactory.h>
+#include <up-cpp/uuid/factory/Uuidv8Factory.h>
 #include <gtest/gtest.h>
 
 using namespace uprotocol::uuid;
@@ -53,6 +55,98 @@ TEST(UAttributesTest, Class)
     EXPECT_EQ(nonEmptyAttributes.priority(), priority);
 }
 
+// Test building UAttributes on an arena and in place
+TEST(UAttributesTest, Arena)
+{
+    google::protobuf::Arena arena;
+    UUri source;
+    source.mutable_entity()->set_name("body.access");
+
+    auto builder = UAttributesBuilder::publish(source, UPriority::UPRIORITY_CS1, &arena);
+    UAttributes* attributes = builder.buildInPlace();
+
+    EXPECT_EQ(attributes->GetArena(), &arena);
+    EXPECT_EQ(attributes->type(), UMessageType::UMESSAGE_TYPE_PUBLISH);
+    EXPECT_EQ(attributes->source().entity().name(), "body.access");
+
+    UAttributes target;
+    UAttributesBuilder(&target).setTTL(100).setPriority(UPriority::UPRIORITY_CS2);
+    EXPECT_EQ(target.ttl(), 100);
+    EXPECT_EQ(target.priority(), UPriority::UPRIORITY_CS2);
+}
+
+// Test that a template encodes the same bytes as serializing the built attributes
+TEST(UAttributesTest, TemplateMatchesSerialization)
+{
+    UUri source;
+    source.mutable_entity()->set_name("body.access");
+    source.mutable_entity()->set_id(0x1234);
+    source.mutable_resource()->set_name("door");
+    UUri sink;
+    sink.mutable_entity()->set_name("hvac");
+
+    auto fixed = UAttributesBuilder::request(source, sink, UPriority::UPRIORITY_CS4, 1000)
+        .setToken("token").setPermissionLevel(3).build();
+    UAttributesTemplate header(fixed);
+
+    for (int i = 0; i < 3; ++i) {
+        auto id = Uuidv8Factory::create();
+        UAttributes attributes = fixed;
+        UAttributesBuilder(&attributes).setId(id);
+        auto expected = attributes.SerializeAsString();
+
+        std::string encoded(header.encodedSize(), '\0');
+        auto written = header.encodeTo(reinterpret_cast<uint8_t*>(encoded.data()), id);
+        EXPECT_EQ(written, encoded.size());
+        EXPECT_EQ(encoded, expected);
+
+        auto payload = header.encode(id);
+        EXPECT_EQ(payload.format(), UPayloadFormat::PROTOBUF);
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(payload.data()), payload.size()), expected);
+    }
+}
+
+// Test the per message ttl, reqid and id patching of a template
+TEST(UAttributesTest, TemplateOverrides)
+{
+    UUri source;
+    source.mutable_entity()->set_name("body.access");
+    UUri sink;
+    sink.mutable_entity()->set_name("hvac");
+
+    auto request = Uuidv8Factory::create();
+    UAttributesTemplate header(UAttributesBuilder::response(source, sink, UPriority::UPRIORITY_CS4, request)
+        .setReqid(request).build());
+
+    auto id = Uuidv8Factory::create();
+    auto reqid = Uuidv8Factory::create();
+    std::string encoded(header.encodedSize(-5, &reqid), '\0');
+    auto* buffer = reinterpret_cast<uint8_t*>(encoded.data());
+    EXPECT_EQ(header.encodeTo(buffer, id, -5, &reqid), encoded.size());
+
+    UAttributes parsed;
+    ASSERT_TRUE(parsed.ParseFromString(encoded));
+    EXPECT_EQ(parsed.id().msb(), id.msb());
+    EXPECT_EQ(parsed.id().lsb(), id.lsb());
+    EXPECT_EQ(parsed.reqid().lsb(), reqid.lsb());
+    EXPECT_EQ(parsed.ttl(), -5);
+    EXPECT_EQ(parsed.type(), UMessageType::UMESSAGE_TYPE_RESPONSE);
+    EXPECT_EQ(parsed.sink().entity().name(), "hvac");
+    EXPECT_EQ(parsed.SerializeAsString(), header.build(id, -5, &reqid).SerializeAsString());
+
+    auto next = Uuidv8Factory::create();
+    UAttributesTemplate::patchId(buffer, next);
+    ASSERT_TRUE(parsed.ParseFromString(encoded));
+    EXPECT_EQ(parsed.id().msb(), next.msb());
+    EXPECT_EQ(parsed.id().lsb(), next.lsb());
+
+    // without overrides the reqid of the template is used
+    auto payload = header.encode(id);
+    ASSERT_TRUE(parsed.ParseFromArray(payload.data(), static_cast<int>(payload.size())));
+    EXPECT_EQ(parsed.reqid().lsb(), request.lsb());
+    EXPECT_FALSE(parsed.has_ttl());
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
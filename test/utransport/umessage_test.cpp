@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 General Motors GTO LLC
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ * 
+ * SPDX-FileType: SOURCE
+ * SPDX-FileCopyrightText: 2024 General Motors GTO LLC
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+#include <up-cpp/transport/datamodel/UMessage.h>
+
+using namespace uprotocol::utransport;
+using namespace uprotocol::v1;
+
+// Test fixture for UMessage class
+class UMessageTest : public ::testing::Test
+{
+protected:
+    const uint8_t* testData = reinterpret_cast<const uint8_t*>("Hello, World!");
+    const size_t testDataSize = 13;
+
+    UAttributes attributes() {
+        UAttributes attr;
+        attr.set_type(UMessageType::UMESSAGE_TYPE_PUBLISH);
+        attr.set_ttl(1000);
+        return attr;
+    }
+};
+
+// Test that the default constructor creates an empty message
+TEST_F(UMessageTest, DefaultConstructor)
+{
+    UMessage message;
+
+    EXPECT_TRUE(message.payload().isEmpty());
+    EXPECT_EQ(message.payload().data(), nullptr);
+}
+
+// Test that the rvalue constructor takes ownership of the payload buffer
+TEST_F(UMessageTest, MoveConstructor)
+{
+    UPayload payload(testData, testDataSize, UPayloadType::VALUE);
+    const uint8_t* buffer = payload.data();
+
+    UMessage message(std::move(payload), attributes());
+
+    EXPECT_EQ(message.payload().data(), buffer);
+    EXPECT_EQ(message.payload().buffer().use_count(), 1);
+    EXPECT_EQ(message.attributes().ttl(), 1000);
+}
+
+// Test that the in-place constructor forwards the payload arguments
+TEST_F(UMessageTest, InPlaceConstructor)
+{
+    UMessage message(std::in_place, attributes(), testData, testDataSize, UPayloadType::REFERENCE);
+
+    EXPECT_EQ(message.payload().data(), testData);
+    EXPECT_EQ(message.payload().size(), testDataSize);
+    EXPECT_EQ(message.attributes().type(), UMessageType::UMESSAGE_TYPE_PUBLISH);
+}
+
+// Test the copy and move setters
+TEST_F(UMessageTest, Setters)
+{
+    UMessage message;
+    UPayload payload(testData, testDataSize, UPayloadType::VALUE);
+
+    message.setPayload(payload);
+    EXPECT_EQ(message.payload().data(), payload.data());
+
+    UPayload other(testData, testDataSize, UPayloadType::VALUE);
+    const uint8_t* buffer = other.data();
+    message.setPayload(std::move(other));
+    EXPECT_EQ(message.payload().data(), buffer);
+
+    auto attr = attributes();
+    message.setAttributes(std::move(attr));
+    EXPECT_EQ(message.attributes().ttl(), 1000);
+
+    message.mutableAttributes().set_ttl(5);
+    EXPECT_EQ(message.attributes().ttl(), 5);
+}
+
+int main(int argc, char** argv) 
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -24,6 +24,12 @@
  */
 #include <gtest/gtest.h>
 #include <up-cpp/transport/datamodel/UPayload.h>
+#include <up-core-api/uri.pb.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
 
 using namespace uprotocol::utransport;
 
@@ -64,6 +70,301 @@ TEST_F(UPayloadTest, IsEmptyTrue)
     EXPECT_TRUE(emptyPayload.isEmpty());
 }
 
+// Test that copies of a VALUE payload share the buffer instead of copying it
+TEST_F(UPayloadTest, CopySharesBuffer)
+{
+    UPayload value(testData, testDataSize, UPayloadType::VALUE);
+    UPayload copy(value);
+    UPayload assigned(nullptr, 0, UPayloadType::REFERENCE);
+    assigned = value;
+
+    EXPECT_NE(value.data(), testData);
+    EXPECT_EQ(copy.data(), value.data());
+    EXPECT_EQ(assigned.data(), value.data());
+    EXPECT_EQ(copy.size(), testDataSize);
+    EXPECT_EQ(value.buffer().use_count(), 3);
+}
+
+// Test that a payload built from a shared buffer does not copy it
+TEST_F(UPayloadTest, SharedBufferConstructor)
+{
+    std::shared_ptr<const uint8_t[]> buffer(new uint8_t[4]{1, 2, 3, 4});
+    UPayload shared(buffer, 4);
+
+    EXPECT_EQ(shared.data(), buffer.get());
+    EXPECT_EQ(shared.size(), 4U);
+    EXPECT_EQ(shared.type(), UPayloadType::SHARED);
+}
+
+// Test that mutableData() detaches shared and referenced buffers before writing
+TEST_F(UPayloadTest, MutableDataCopyOnWrite)
+{
+    UPayload value(testData, testDataSize, UPayloadType::VALUE);
+    const uint8_t* original = value.data();
+    EXPECT_EQ(value.mutableData(), original);
+
+    UPayload copy(value);
+    copy.mutableData()[0] = 'J';
+    EXPECT_NE(copy.data(), original);
+    EXPECT_EQ(value.data()[0], 'H');
+    EXPECT_EQ(copy.data()[0], 'J');
+
+    payload.mutableData()[0] = 'Y';
+    EXPECT_EQ(payload.type(), UPayloadType::VALUE);
+    EXPECT_EQ(testData[0], 'H');
+    EXPECT_EQ(payload.data()[0], 'Y');
+}
+
+// Test that mutableData() never writes into storage the caller handed in
+TEST_F(UPayloadTest, MutableDataExternalConstStorage)
+{
+    /* read-only storage, writing it in place would fault */
+    static const uint8_t rodata[] = {1, 2, 3, 4};
+    UPayload shared(std::shared_ptr<const uint8_t[]>(rodata, [](const uint8_t*) {}), sizeof(rodata));
+    ASSERT_EQ(shared.data(), rodata);
+
+    auto* data = shared.mutableData();
+    EXPECT_NE(data, rodata);
+    data[0] = 9;
+    EXPECT_EQ(shared.type(), UPayloadType::VALUE);
+    EXPECT_EQ(rodata[0], 1);
+    EXPECT_EQ(shared.data()[0], 9);
+    /* the copy is the payload's own, later writes stay in place */
+    EXPECT_EQ(shared.mutableData(), data);
+
+    std::unique_ptr<uint8_t[]> adopted(new uint8_t[4]{5, 6, 7, 8});
+    const uint8_t* raw = adopted.get();
+    UPayload fromUnique(std::move(adopted), 4);
+    EXPECT_NE(fromUnique.mutableData(), raw);
+    EXPECT_EQ(fromUnique.data()[3], 8);
+
+    auto slice = UPayload(testData, testDataSize, UPayloadType::VALUE).slice(1, 2);
+    const uint8_t* sliced = slice.data();
+    EXPECT_NE(slice.mutableData(), sliced);
+    EXPECT_EQ(slice.data()[0], testData[1]);
+}
+
+// Test that receive buffers are adopted without copying them
+TEST_F(UPayloadTest, AdoptReceiveBuffer)
+{
+    std::vector<uint8_t> received(4096, 0xAB);
+    const uint8_t* bytes = received.data();
+    UPayload fromVector(std::move(received));
+
+    EXPECT_EQ(fromVector.data(), bytes);
+    EXPECT_EQ(fromVector.size(), 4096U);
+    EXPECT_EQ(fromVector.type(), UPayloadType::SHARED);
+
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[16]());
+    const uint8_t* raw = buffer.get();
+    UPayload fromUnique(std::move(buffer), 16);
+
+    EXPECT_EQ(fromUnique.data(), raw);
+    EXPECT_EQ(fromUnique.type(), UPayloadType::SHARED);
+}
+
+// Test that retain() only copies referenced bytes
+TEST_F(UPayloadTest, Retain)
+{
+    UPayload value(testData, testDataSize, UPayloadType::VALUE);
+    const uint8_t* original = value.data();
+    value.retain();
+    EXPECT_EQ(value.data(), original);
+
+    payload.retain();
+    EXPECT_NE(payload.data(), testData);
+    EXPECT_EQ(payload.type(), UPayloadType::VALUE);
+    EXPECT_EQ(0, std::memcmp(payload.data(), testData, testDataSize));
+}
+
+// Test that VALUE payloads draw their buffers from the pool and give them back
+TEST_F(UPayloadTest, PooledBufferReused)
+{
+    const uint8_t* first = nullptr;
+    {
+        UPayload value(testData, testDataSize, UPayloadType::VALUE);
+        first = value.data();
+    }
+    UPayload value(testData, testDataSize, UPayloadType::VALUE);
+    EXPECT_EQ(value.data(), first);
+    EXPECT_EQ(0, std::memcmp(value.data(), testData, testDataSize));
+
+    EXPECT_EQ(PayloadBufferPool::classOf(1), 0U);
+    EXPECT_EQ(PayloadBufferPool::classOf(64), 0U);
+    EXPECT_EQ(PayloadBufferPool::classOf(65), 1U);
+    EXPECT_EQ(PayloadBufferPool::classOf(PayloadBufferPool::MaxBufferSize), PayloadBufferPool::NumOfClasses - 1);
+    EXPECT_EQ(PayloadBufferPool::classOf(PayloadBufferPool::MaxBufferSize + 1), PayloadBufferPool::NumOfClasses);
+
+    // larger buffers bypass the pool
+    auto large = PayloadBufferPool::instance().acquire(PayloadBufferPool::MaxBufferSize + 1);
+    EXPECT_NE(large, nullptr);
+}
+
+// Test that the buffers of an exiting thread are handed over to the other threads
+TEST_F(UPayloadTest, PooledBufferThreadExit)
+{
+    auto &pool = PayloadBufferPool::instance();
+    pool.trim();
+    std::thread([&pool]() {
+        auto buffer = pool.acquire(4096);
+        buffer[0] = 1;
+    }).join();
+    EXPECT_EQ(pool.sharedBytes(), 4096U);
+
+    // the buffer released on the other thread is taken from the shared list
+    auto buffer = pool.acquire(4000);
+    EXPECT_EQ(pool.sharedBytes(), 0U);
+    pool.trim();
+}
+
+// Test serializing straight into a pooled buffer
+TEST_F(UPayloadTest, WriteAndFromMessage)
+{
+    uprotocol::v1::UUri uri;
+    uri.mutable_entity()->set_name("body.access");
+    uri.mutable_resource()->set_id(7);
+
+    auto payload = UPayload::fromMessage(uri);
+    EXPECT_EQ(payload.format(), UPayloadFormat::PROTOBUF);
+    EXPECT_EQ(payload.size(), uri.ByteSizeLong());
+
+    uprotocol::v1::UUri parsed;
+    ASSERT_TRUE(parsed.ParseFromArray(payload.data(), static_cast<int>(payload.size())));
+    EXPECT_EQ(parsed.entity().name(), "body.access");
+    EXPECT_EQ(parsed.resource().id(), 7U);
+
+    auto written = UPayload::write(16, [](uint8_t* buffer, size_t) {
+        std::memcpy(buffer, "abc", 3);
+        return std::optional<size_t>(3);
+    });
+    EXPECT_EQ(written.size(), 3U);
+    EXPECT_EQ(0, std::memcmp(written.data(), "abc", 3));
+
+    auto failed = UPayload::write(16, [](uint8_t*, size_t) { return std::optional<size_t>(); });
+    EXPECT_TRUE(failed.isEmpty());
+}
+
+// Test that a gathered payload keeps its segments until data() flattens them
+TEST_F(UPayloadTest, GatherSegments)
+{
+    const uint8_t header[] = {0xAA, 0xBB};
+    UPayload body(testData, testDataSize, UPayloadType::VALUE);
+    body.setFormat(UPayloadFormat::PROTOBUF);
+
+    auto gathered = UPayload::gather({UPayload(header, sizeof(header), UPayloadType::VALUE), UPayload(), body});
+    EXPECT_FALSE(gathered.isContiguous());
+    EXPECT_EQ(gathered.segmentCount(), 2U);
+    EXPECT_EQ(gathered.size(), sizeof(header) + testDataSize);
+    EXPECT_EQ(gathered.format(), UPayloadFormat::PROTOBUF);
+    EXPECT_EQ(gathered.segment(1).data(), body.data());
+
+    struct iovec iov[2];
+    EXPECT_EQ(gathered.toIovec(iov, 1), 0U);
+    ASSERT_EQ(gathered.toIovec(iov, 2), 2U);
+    EXPECT_EQ(iov[0].iov_len, sizeof(header));
+    EXPECT_EQ(iov[1].iov_base, body.data());
+
+    std::vector<uint8_t> copied(gathered.size());
+    gathered.copyTo(copied.data());
+    EXPECT_EQ(0, std::memcmp(copied.data() + sizeof(header), testData, testDataSize));
+
+    // copies share the flattened buffer
+    const UPayload copy = gathered;
+    const uint8_t* flat = gathered.data();
+    EXPECT_EQ(copy.data(), flat);
+    EXPECT_EQ(0, std::memcmp(flat, copied.data(), copied.size()));
+
+    // nested gathers are spliced, a single segment is returned as it is
+    EXPECT_EQ(UPayload::gather({gathered, body}).segmentCount(), 3U);
+    EXPECT_TRUE(UPayload::gather({body}).isContiguous());
+    EXPECT_TRUE(UPayload::gather({}).isEmpty());
+}
+
+// Test that retain() and mutableData() of a gathered payload do not touch the segments
+TEST_F(UPayloadTest, GatherRetainAndMutate)
+{
+    auto gathered = UPayload::gather({payload, payload});
+    EXPECT_EQ(gathered.type(), UPayloadType::REFERENCE);
+    gathered.retain();
+    EXPECT_EQ(gathered.type(), UPayloadType::SHARED);
+    EXPECT_NE(gathered.segment(0).data(), testData);
+    EXPECT_EQ(gathered.segmentCount(), 2U);
+
+    auto* data = gathered.mutableData();
+    EXPECT_TRUE(gathered.isContiguous());
+    data[0] = 'J';
+    EXPECT_EQ(0, std::memcmp(gathered.data() + testDataSize, testData, testDataSize));
+    EXPECT_EQ(gathered.data()[0], 'J');
+    EXPECT_EQ(testData[0], 'H');
+}
+
+// Test mapping a file region and slicing it into chunks
+TEST_F(UPayloadTest, MapFileAndSlice)
+{
+    char path[] = "/tmp/upayload-XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    std::vector<uint8_t> content(3 * 4096 + 100);
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<uint8_t>(i * 7);
+    }
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    close(fd);
+
+    auto whole = UPayload::mapFile(path);
+    auto region = UPayload::mapFile(path, 4097, 5000);
+    auto tail = UPayload::mapFile(path, content.size() - 10, 100);
+    // the mappings outlive the file name
+    unlink(path);
+
+    EXPECT_EQ(whole.type(), UPayloadType::SHARED);
+    ASSERT_EQ(whole.size(), content.size());
+    EXPECT_EQ(0, std::memcmp(whole.data(), content.data(), content.size()));
+    ASSERT_EQ(region.size(), 5000U);
+    EXPECT_EQ(0, std::memcmp(region.data(), content.data() + 4097, 5000));
+    EXPECT_EQ(tail.size(), 10U);
+
+    EXPECT_TRUE(UPayload::mapFile("/nonexistent/upayload").isEmpty());
+    EXPECT_TRUE(UPayload::mapFile(path).isEmpty());
+
+    size_t offset = 0;
+    while (offset < whole.size()) {
+        auto chunk = whole.slice(offset, 4096);
+        EXPECT_EQ(chunk.data(), whole.data() + offset);
+        EXPECT_EQ(0, std::memcmp(chunk.data(), content.data() + offset, chunk.size()));
+        offset += chunk.size();
+    }
+    EXPECT_EQ(offset, content.size());
+    EXPECT_TRUE(whole.slice(content.size() + 1).isEmpty());
+}
+
+// Test writing a mapped file, which is read-only, through its sole owner
+TEST_F(UPayloadTest, MapFileMutableDataCopies)
+{
+    char path[] = "/tmp/upayload-XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    const std::string content = "mapped read-only";
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    close(fd);
+
+    auto mapped = UPayload::mapFile(path);
+    ASSERT_EQ(mapped.size(), content.size());
+    const auto *mapping = mapped.data();
+
+    auto *data = mapped.mutableData();
+    ASSERT_NE(data, nullptr);
+    EXPECT_NE(data, mapping);
+    data[0] = 'M';
+    EXPECT_EQ(mapped.data()[0], 'M');
+    EXPECT_EQ(mapped.mutableData(), data);
+
+    std::ifstream file(path);
+    std::string onDisk((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(onDisk, content);
+    unlink(path);
+}
+
 int main(int argc, char** argv) 
 {
     ::testing::InitGoogleTest(&argc, argv);
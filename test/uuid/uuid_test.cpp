@@ -26,6 +26,9 @@
 #include <up-cpp/uuid/factory/Uuidv8Factory.h>
 #include <up-cpp/uuid/serializer/UuidSerializer.h>
 #include "uuid.pb.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 using namespace uprotocol::uuid;
 using namespace uprotocol::v1;
@@ -44,6 +47,115 @@ TEST(UUIDTest, Class)
     EXPECT_EQ(UuidSerializer::serializeToString(uuIdNew), str);
 }
 
+//UUIDs created concurrently are unique, also beyond 4096 per millisecond
+TEST(UUIDTest, ConcurrentCreateUnique)
+{
+    constexpr size_t numThreads = 8;
+    constexpr size_t numPerThread = 20000;
+    std::vector<std::vector<uint64_t>> created(numThreads);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&created, t]() {
+            created[t].reserve(numPerThread);
+            for (size_t i = 0; i < numPerThread; ++i) {
+                created[t].push_back(Uuidv8Factory::create().msb());
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (const auto &msbs : created) {
+        /* every thread sees increasing UUIDs */
+        EXPECT_TRUE(std::is_sorted(msbs.begin(), msbs.end()));
+        all.insert(all.end(), msbs.begin(), msbs.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+}
+
+//A batch continues the counter into the next milliseconds instead of saturating
+TEST(UUIDTest, CreateBatch)
+{
+    constexpr size_t batchSize = 10000;
+    std::vector<Uuidv8Factory::RawUuid> raw(batchSize);
+    std::vector<UUID> uuids(16);
+
+    auto before = Uuidv8Factory::create();
+    Uuidv8Factory::createBatch(raw.data(), raw.size());
+    Uuidv8Factory::createBatch(uuids.data(), uuids.size());
+
+    EXPECT_LT(before.msb(), raw.front().msb);
+    for (size_t i = 1; i < batchSize; ++i) {
+        ASSERT_LT(raw[i - 1].msb, raw[i].msb);
+        EXPECT_EQ(raw[i].lsb, before.lsb());
+    }
+    /* 10000 UUIDs need at least three milliseconds of counter space */
+    EXPECT_GE((raw.back().msb >> 16) - (raw.front().msb >> 16), 2U);
+    EXPECT_EQ((raw.back().msb >> 12) & 0xF, 8U);
+
+    EXPECT_LT(raw.back().msb, uuids.front().msb());
+    for (size_t i = 1; i < uuids.size(); ++i) {
+        EXPECT_LT(uuids[i - 1].msb(), uuids[i].msb());
+    }
+    EXPECT_LT(uuids.back().msb(), Uuidv8Factory::create().msb());
+}
+
+//UUID string format into and out of caller buffers
+TEST(UUIDTest, Chars)
+{
+    UUID uuid = UuidSerializer::deserializeFromString("0080b636-8303-8701-8ebe-7a9a9e767a9f");
+    char out[UuidSerializer::StringLength];
+    UuidSerializer::serializeToChars(uuid, out);
+    EXPECT_EQ(std::string(out, sizeof(out)), "0080b636-8303-8701-8ebe-7a9a9e767a9f");
+
+    UUID parsed;
+    EXPECT_TRUE(UuidSerializer::deserializeFromChars(out, sizeof(out), parsed));
+    EXPECT_EQ(parsed.msb(), uuid.msb());
+    EXPECT_EQ(parsed.lsb(), uuid.lsb());
+
+    const std::string upper = "0080B636-8303-8701-8EBE-7A9A9E767A9F";
+    EXPECT_TRUE(UuidSerializer::deserializeFromChars(upper.data(), upper.size(), parsed));
+    EXPECT_EQ(parsed.msb(), uuid.msb());
+
+    UUID untouched;
+    const std::string badDigit = "0080b636-8303-8701-8ebe-7a9a9e767a9g";
+    const std::string badDash = "0080b636+8303-8701-8ebe-7a9a9e767a9f";
+    const std::string highBit = "0080b636-8303-8701-8ebe-7a9a9e767a9\xb0";
+    EXPECT_FALSE(UuidSerializer::deserializeFromChars(badDigit.data(), badDigit.size(), untouched));
+    EXPECT_FALSE(UuidSerializer::deserializeFromChars(badDash.data(), badDash.size(), untouched));
+    EXPECT_FALSE(UuidSerializer::deserializeFromChars(highBit.data(), highBit.size(), untouched));
+    EXPECT_FALSE(UuidSerializer::deserializeFromChars(out, sizeof(out) - 1, untouched));
+    EXPECT_EQ(untouched.msb(), 0U);
+}
+
+//UUID byte stream format without heap buffers
+TEST(UUIDTest, BytesWithoutAllocation)
+{
+    static_assert(UuidSerializer::pack(0x0102030405060708ULL, 0x1112131415161718ULL)[0] == 0x08,
+                  "pack is usable in constant expressions");
+
+    UUID uuid = Uuidv8Factory::create();
+    auto array = UuidSerializer::serializeToArray(uuid);
+    auto vect = UuidSerializer::serializeToBytes(uuid);
+    EXPECT_TRUE(std::equal(array.begin(), array.end(), vect.begin(), vect.end()));
+
+    uint8_t frame[4 + UuidSerializer::ByteLength] = {};
+    UuidSerializer::serializeToBytes(uuid, frame + 4);
+    auto fromFrame = UuidSerializer::deserializeFromBytes(frame + 4, UuidSerializer::ByteLength);
+    EXPECT_EQ(fromFrame.msb(), uuid.msb());
+    EXPECT_EQ(fromFrame.lsb(), uuid.lsb());
+
+    auto fromArray = UuidSerializer::deserializeFromBytes(array);
+    EXPECT_EQ(fromArray.msb(), uuid.msb());
+    EXPECT_EQ(fromArray.lsb(), uuid.lsb());
+
+    EXPECT_EQ(UuidSerializer::deserializeFromBytes(frame, 15).msb(), 0U);
+}
+
 //Negative test - serialize and deserialize
 TEST(UUIDTest, NegStringConstructor)
 {
@@ -117,6 +229,27 @@ TEST(UUIDTest, NegInvalidByteVector)
     EXPECT_NE(UuidSerializer::getCount(uuIdFromByteArr), val);
 }
 
+// tryDeserialize* report why the input is not a UUID instead of returning the nil UUID
+TEST(UUIDTest, TryDeserializeErrors)
+{
+    auto uuid = Uuidv8Factory::create();
+    auto fromString = UuidSerializer::tryDeserializeFromString(UuidSerializer::serializeToString(uuid));
+    ASSERT_TRUE(fromString.has_value());
+    EXPECT_EQ(uuid.msb(), fromString->msb());
+    EXPECT_EQ(uuid.lsb(), fromString->lsb());
+
+    auto bytes = UuidSerializer::serializeToArray(uuid);
+    auto fromBytes = UuidSerializer::tryDeserializeFromBytes(bytes.data(), bytes.size());
+    ASSERT_TRUE(fromBytes.has_value());
+    EXPECT_EQ(uuid.lsb(), fromBytes->lsb());
+
+    EXPECT_EQ(UuidError::InvalidCharacter, UuidSerializer::tryDeserializeFromString("0000-xyz").error());
+    EXPECT_EQ(UuidError::InvalidLength,
+              UuidSerializer::tryDeserializeFromString("00000000-0000-0000-0000-0000000000000").error());
+    EXPECT_EQ(UuidError::InvalidLength, UuidSerializer::tryDeserializeFromBytes(bytes.data(), 15).error());
+    EXPECT_EQ("invalid character", toString(UuidError::InvalidCharacter));
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);